@@ -0,0 +1,337 @@
+"""Benchmark the hdf5 writes of the SPADE c++ executable with synthetic models.
+
+Runs a fixed matrix of synthetic model sizes, formats, layouts, and compression filters through the executable's
+``--synthetic`` option and writes the throughput, peak memory, and output size of each scenario to a JSON file, which
+can be diffed against the file written for another commit. Only uses the standard library, so it runs in the SCons build
+environment without installing the package.
+"""
+
+import argparse
+import itertools
+import json
+import pathlib
+import platform
+import re
+import subprocess
+import sys
+import time
+import typing
+
+_exclude_from_namespace = set(globals().keys())
+
+#: Synthetic model specifications of the benchmark sizes
+model_sizes = {
+    "small": "instances=1,nodes=20000,elements=C3D8R:20000,sets=2,steps=1,frames=5,fields=2",
+    "large": "instances=2,nodes=100000,elements=C3D8R:80000+S4R:20000,sets=4,steps=1,frames=10,fields=4",
+    # A single frame, so the elements per second are dominated by storing and writing the mesh
+    "mesh": "instances=1,nodes=200000,elements=C3D8R:800000+S4R:200000,sets=4,steps=1,frames=1,fields=1",
+}
+#: Synthetic model of the memory ceiling check, with bulk data blocks much smaller than the ceilings it's checked with
+memory_check_model = "instances=8,nodes=25000,elements=C3D8R:20000+S4R:5000,sets=4,steps=1,frames=10,fields=4"
+#: Format and layout pairs of the benchmark, the stacked layout is only written in the extract format
+format_layouts = [("odb", "frame"), ("extract", "frame"), ("extract", "stacked")]
+#: Compression filters of the benchmark
+compressions = ["none", "gzip"]
+#: Default settings of the c++ synthetic model, used for the keys a specification leaves out
+synthetic_defaults = {
+    "instances": 1,
+    "nodes": 1000,
+    "elements": {"C3D8R": 1000},
+    "sets": 2,
+    "steps": 1,
+    "frames": 10,
+    "fields": 2,
+    "components": 6,
+    "integration-points": 8,
+    "seed": 0,
+}
+
+
+def get_parser() -> argparse.ArgumentParser:
+    """Return the parser of the benchmark command line.
+
+    :return: parser
+    """
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--executable", type=pathlib.Path, required=True, help="Path to the spade c++ executable")
+    parser.add_argument(
+        "--output-file",
+        type=pathlib.Path,
+        default=pathlib.Path("benchmark.json"),
+        help="JSON file to write the results to (default: %(default)s)",
+    )
+    parser.add_argument(
+        "--repeat",
+        type=int,
+        default=3,
+        help="Number of runs of each scenario, the fastest is reported (default: %(default)s)",
+    )
+    parser.add_argument(
+        "--size",
+        choices=list(model_sizes.keys()),
+        action="append",
+        default=None,
+        help="Model size to run, repeat for more than one (default: all)",
+    )
+    parser.add_argument(
+        "--check-max-memory",
+        type=int,
+        default=None,
+        help=(
+            "Instead of the benchmark scenarios, check that the peak memory use of a synthetic model extracted with "
+            "this memory ceiling in megabytes stays within the ceiling"
+        ),
+    )
+    return parser
+
+
+def scenarios(sizes: typing.Iterable[str] | None = None) -> list[dict[str, str]]:
+    """Return the matrix of benchmark scenarios.
+
+    :param sizes: Names of the model sizes to include, all of them if None
+
+    :returns: scenarios, each with a name, synthetic model specification, format, layout, and compression
+    """
+    sizes = list(model_sizes.keys()) if sizes is None else list(sizes)
+    matrix = []
+    for size, (extract_format, layout), compression in itertools.product(sizes, format_layouts, compressions):
+        matrix.append(
+            {
+                "name": f"{size}-{extract_format}-{layout}-{compression}",
+                "synthetic": model_sizes[size],
+                "format": extract_format,
+                "layout": layout,
+                "compression": compression,
+            }
+        )
+    return matrix
+
+
+def memory_check_scenarios(max_memory: int) -> list[dict[str, str]]:
+    """Return the scenarios of the memory ceiling check.
+
+    The peak memory use also holds the executable, the HDF5 library, and the model, which the ceiling doesn't cover. The
+    baseline scenario extracts the same instances and mesh with a single frame of one scalar field output, so its peak
+    memory use is that of everything but the buffered field output.
+
+    :param max_memory: Memory ceiling in megabytes
+
+    :returns: the baseline scenario and the scenario of the whole synthetic model, both with the memory ceiling
+    """
+    baseline_model = f"{memory_check_model},frames=1,fields=1,components=1,integration-points=1"
+    return [
+        {
+            "name": f"{name}-max-memory-{max_memory}",
+            "synthetic": specification,
+            "format": "extract",
+            "layout": "frame",
+            "compression": "none",
+            "max_memory": str(max_memory),
+        }
+        for name, specification in [("baseline", baseline_model), ("model", memory_check_model)]
+    ]
+
+
+def parse_specification(specification: str) -> dict[str, typing.Any]:
+    """Parse a synthetic model specification the same way the c++ executable does.
+
+    :param specification: Comma separated key=value pairs
+
+    :returns: settings of the synthetic model, with the defaults of the keys left out
+
+    :raises ValueError: If a key is unknown or a value can't be parsed
+    """
+    settings = dict(synthetic_defaults)
+    for setting in filter(None, specification.split(",")):
+        key, separator, value = setting.partition("=")
+        if not separator or key not in synthetic_defaults:
+            raise ValueError(f"Unknown synthetic model setting '{setting}'")
+        if key == "elements":
+            element_counts = {}
+            for element_count in value.split("+"):
+                element_type, _, count = element_count.partition(":")
+                element_counts[element_type] = int(count)
+            settings[key] = element_counts
+        else:
+            settings[key] = int(value)
+    return settings
+
+
+def model_counts(specification: str) -> dict[str, int]:
+    """Return the number of elements and nodes written by the frames of a synthetic model.
+
+    :param specification: Synthetic model specification
+
+    :returns: elements and nodes of every instance summed over every frame
+    """
+    settings = parse_specification(specification)
+    frames = settings["steps"] * settings["frames"]
+    return {
+        "elements": settings["instances"] * sum(settings["elements"].values()) * frames,
+        "nodes": settings["instances"] * settings["nodes"] * frames,
+    }
+
+
+def peak_memory(log_text: str) -> int | None:
+    """Return the peak memory use reported at the end of a log file.
+
+    :param log_text: Content of the log file
+
+    :returns: peak memory use in megabytes, None if it isn't reported
+    """
+    match = re.search(r"Peak memory use: (\d+) MB", log_text)
+    return int(match.group(1)) if match else None
+
+
+def field_output_bytes(log_text: str) -> int | None:
+    """Return the uncompressed bytes of field output data reported at the end of a log file.
+
+    :param log_text: Content of the log file
+
+    :returns: number of bytes, None if it isn't reported
+    """
+    match = re.search(r"Field output data written: (\d+) bytes", log_text)
+    return int(match.group(1)) if match else None
+
+
+def throughput(data_bytes: int, elements: int, seconds: float) -> dict[str, float]:
+    """Return the write throughput of a scenario.
+
+    The megabytes are those of the uncompressed data, so the compression filters are compared by the time it takes to
+    write the same data instead of by the size of the file they write.
+
+    :param data_bytes: Uncompressed bytes of the data written
+    :param elements: Elements written, summed over the frames
+    :param seconds: Wall time of the run
+
+    :returns: megabytes and elements per second
+    """
+    seconds = max(seconds, sys.float_info.epsilon)
+    return {
+        "megabytes_per_second": round(data_bytes / 1048576 / seconds, 3),
+        "elements_per_second": round(elements / seconds, 1),
+    }
+
+
+def run_scenario(
+    executable: pathlib.Path,
+    scenario: dict[str, str],
+    working_directory: pathlib.Path,
+    repeat: int = 1,
+) -> dict[str, typing.Any]:
+    """Run one scenario with the c++ executable and measure it.
+
+    :param executable: Path to the spade c++ executable
+    :param scenario: Scenario from :meth:`scenarios`
+    :param working_directory: Directory for the extracted and log files
+    :param repeat: Number of runs, the fastest is reported
+
+    :returns: scenario with its wall time, throughput, peak memory, and output size
+
+    :raises RuntimeError: If the executable fails
+    """
+    output_file = working_directory / f"{scenario['name']}.h5"
+    log_file = working_directory / f"{scenario['name']}.spade.log"
+    command = [
+        str(executable),
+        "--synthetic",
+        scenario["synthetic"],
+        "--format",
+        scenario["format"],
+        "--layout",
+        scenario["layout"],
+        "--compression",
+        scenario["compression"],
+        "--extracted-file",
+        str(output_file),
+        "--log-file",
+        str(log_file),
+        "--force-overwrite",
+    ]
+    if "max_memory" in scenario:
+        command.extend(["--max-memory", scenario["max_memory"]])
+    seconds = None
+    for _ in range(max(repeat, 1)):
+        start = time.perf_counter()
+        try:
+            subprocess.run(command, cwd=working_directory, check=True, stdout=subprocess.DEVNULL)
+        except subprocess.CalledProcessError as err:
+            raise RuntimeError(f"Benchmark scenario {scenario['name']} failed: {err!s}") from err
+        elapsed = time.perf_counter() - start
+        seconds = elapsed if seconds is None else min(seconds, elapsed)
+    output_bytes = output_file.stat().st_size
+    log_text = log_file.read_text()
+    data_bytes = field_output_bytes(log_text)
+    if data_bytes is None:
+        raise RuntimeError(f"Benchmark scenario {scenario['name']} didn't report the field output data it wrote")
+    counts = model_counts(scenario["synthetic"])
+    result = dict(scenario)
+    result.update(
+        {
+            "seconds": round(seconds, 4),
+            "output_bytes": output_bytes,
+            "data_bytes": data_bytes,
+            "peak_memory_mb": peak_memory(log_text),
+            **counts,
+            **throughput(data_bytes, counts["elements"], seconds),
+        }
+    )
+    output_file.unlink()
+    return result
+
+
+def check_max_memory(
+    executable: pathlib.Path,
+    max_memory: int,
+    working_directory: pathlib.Path,
+) -> dict[str, typing.Any]:
+    """Check that the peak memory use of a synthetic model stays within a memory ceiling.
+
+    :param executable: Path to the spade c++ executable
+    :param max_memory: Memory ceiling in megabytes
+    :param working_directory: Directory for the extracted and log files
+
+    :returns: the scenarios of :meth:`memory_check_scenarios` with their peak memory use
+
+    :raises RuntimeError: If the executable fails, doesn't report its peak memory use, or goes over the ceiling
+    """
+    baseline, model = (
+        run_scenario(executable, scenario, working_directory) for scenario in memory_check_scenarios(max_memory)
+    )
+    if baseline["peak_memory_mb"] is None or model["peak_memory_mb"] is None:
+        raise RuntimeError("The memory ceiling check didn't report the peak memory use")
+    buffered_memory = model["peak_memory_mb"] - baseline["peak_memory_mb"]
+    if buffered_memory > max_memory:
+        raise RuntimeError(
+            f"Peak memory use of {model['peak_memory_mb']} MB is {buffered_memory} MB above the baseline of "
+            f"{baseline['peak_memory_mb']} MB, which is more than the memory ceiling of {max_memory} MB"
+        )
+    return {"max_memory_mb": max_memory, "scenarios": [baseline, model]}
+
+
+def main(args: argparse.Namespace) -> None:
+    """Run the benchmark scenarios and write the results to a JSON file.
+
+    :param args: parsed command line arguments from :meth:`get_parser`
+    """
+    working_directory = args.output_file.resolve().parent
+    working_directory.mkdir(parents=True, exist_ok=True)
+    if args.check_max_memory is not None:
+        print(f"Checking the memory ceiling of {args.check_max_memory} MB", file=sys.stdout)
+        result = check_max_memory(args.executable.resolve(), args.check_max_memory, working_directory)
+        args.output_file.write_text(json.dumps(result, indent=2, sort_keys=True) + "\n")
+        return
+    results = []
+    for scenario in scenarios(args.size):
+        print(f"Running benchmark scenario {scenario['name']}", file=sys.stdout)
+        results.append(run_scenario(args.executable.resolve(), scenario, working_directory, args.repeat))
+    report = {"platform": platform.platform(), "python": platform.python_version(), "scenarios": results}
+    args.output_file.write_text(json.dumps(report, indent=2, sort_keys=True) + "\n")
+
+
+# Limit help() and 'from module import *' behavior to the module's public API
+_module_objects = set(globals().keys()) - _exclude_from_namespace
+__all__ = [name for name in _module_objects if not name.startswith("_")]
+
+if __name__ == "__main__":
+    main(get_parser().parse_args())
@@ -24,10 +24,15 @@ def main(args: argparse.Namespace) -> None:
 
     :param args: argument namespace
 
-    :raises RuntimeError: If any subprocess returns a non-zero exit code or an Abaqus ODB file is not provided.
+    :raises RuntimeError: If any subprocess returns a non-zero exit code, an Abaqus ODB file is not provided, or
+        --append is used with --jobs.
     """
     if args.debug:
         args.verbose = True
+    if args.append and args.jobs > 1:
+        raise RuntimeError(
+            "--append is not available with --jobs, the workers would each append to their own shard file"
+        )
 
     # TODO: Find a better way to define optional print functions when using API instead of CLI/main function
     # https://re-git.lanl.gov/aea/python-projects/spade/-/issues/40
@@ -70,6 +75,7 @@ def main(args: argparse.Namespace) -> None:
                 abaqus_bin=abaqus_bin,
                 args=args,
                 environment=current_env,
+                shard_directory=temporary_path,
             )
     except OSError as err:
         if err.errno == errno.ENOTEMPTY:
@@ -166,7 +172,133 @@ def get_parser() -> argparse.ArgumentParser:
         type=str,
         choices=["extract", "odb", "vtk"],
         default="extract",
-        help="Specify the format of the data in the output file",
+        help=(
+            "Specify the format of the data in the output file. The vtk format is a VTKHDF file that ParaView can open "
+            "(default: %(default)s)"
+        ),
+    )
+    parser.add_argument(
+        "--compression",
+        type=str,
+        choices=["none", "gzip", "szip", "lzf", "zstd"],
+        default="none",
+        help="Compression filter for the numeric datasets in the output file (default: %(default)s)",
+    )
+    parser.add_argument(
+        "--compression-level",
+        type=int,
+        help="Compression level for the chosen filter (default: gzip 4, szip 16, zstd 3)",
+    )
+    parser.add_argument(
+        "--chunk-shape",
+        type=str,
+        help="Chunk shape for the numeric datasets: 'auto' or RxC, e.g. 1024x8 (default: auto when compressing)",
+    )
+    parser.add_argument(
+        "--layout",
+        type=str,
+        choices=["frame", "stacked"],
+        default="frame",
+        help=(
+            "Layout of the field output data in the extract format. 'frame' writes a group per frame, 'stacked' "
+            "appends each frame to datasets with a leading frame dimension (default: %(default)s)"
+        ),
+    )
+    parser.add_argument(
+        "--invariants",
+        type=str,
+        choices=["computed", "odb", "none"],
+        default="odb",
+        help=(
+            "Source of the field output invariants. 'computed' calculates them from the bulk data and writes them "
+            "next to it, 'odb' reads the mises values stored in the odb, 'none' skips them (default: %(default)s)"
+        ),
+    )
+    parser.add_argument(
+        "-j",
+        "--jobs",
+        type=_utilities.positive_integer,
+        default=1,
+        help=(
+            "Number of worker processes extracting the frames round-robin into separate files, which are then merged "
+            "into the extracted file. Not available with the vtk format or the stacked layout (default: %(default)s)"
+        ),
+    )
+    parser.add_argument(
+        "--write-buffer-mb",
+        type=int,
+        help=(
+            "Memory budget in megabytes for field output data waiting to be written by the writer thread. "
+            "0 writes serially (default: 256)"
+        ),
+    )
+    parser.add_argument(
+        "--upgrade-cache",
+        type=str,
+        help=(
+            "Directory keeping the upgraded copies of ODB files written by older versions of Abaqus, so extracting the "
+            "same ODB file again skips the upgrade. 'none' upgrades the ODB file every time "
+            "(default: the directory of the ODB file)"
+        ),
+    )
+    parser.add_argument(
+        "--upgrade-cache-size",
+        type=int,
+        help=(
+            "Size limit in megabytes of the upgraded copies in the upgrade cache directory. The least recently used "
+            "copies are removed first. 0 for no limit (default: 10240)"
+        ),
+    )
+    parser.add_argument(
+        "--profile",
+        type=str,
+        help=(
+            "Name of a JSON file to write the time spent in each phase of the extraction to, with the byte and element "
+            "counts of the data written, as Chrome trace events for Perfetto or chrome://tracing. With --jobs each "
+            "worker process writes its own file with the shard number added to the name"
+        ),
+    )
+    parser.add_argument(
+        "--max-memory",
+        type=int,
+        help=(
+            "Memory ceiling in megabytes for buffered data. The model is released once it is written and field output "
+            "is read and written in parts to stay under it. With --jobs the ceiling is shared by the worker processes. "
+            "0 for no ceiling (default: 0)"
+        ),
+    )
+    parser.add_argument(
+        "--metadata-layout",
+        type=str,
+        choices=["attributes", "compact", "datasets"],
+        default="attributes",
+        help=(
+            "How single values like descriptions, types, dimensions, and frame values are written to the h5 extracted "
+            "file. 'attributes' of their group, 'compact' datasets stored in the object header, or 'datasets' of "
+            "their own, the layout of earlier versions (default: %(default)s)"
+        ),
+    )
+    parser.add_argument(
+        "--h5-profile",
+        type=str,
+        help=(
+            "File creation and access properties of the h5 extracted file tuned for the storage it is written to. "
+            "'default' keeps the HDF5 library defaults, 'lustre', 'nvme', and 'nfs' are presets, and "
+            "'custom:<file name>' reads 'key = value' lines from a file. The metadata cache hit rate and the free "
+            "space of the file are logged when it is closed (default: default)"
+        ),
+    )
+    parser.add_argument(
+        "--split-by",
+        type=str,
+        help=(
+            "Split the h5 extracted file into a root file with the mesh, history output, and other data outside of the "
+            "partitions and one partition file of frame data per 'step', 'instance', 'field', or "
+            "'frame-range:<number of frames>' of each step, named after the extracted file and joined to it by "
+            "external links. With --jobs each worker writes whole partitions. Partition files completed by an earlier "
+            "run from the same ODB file with the same options are kept, so a rerun with --force-overwrite only "
+            "extracts the missing partitions (default: none)"
+        ),
     )
 
     # True or false inputs
@@ -184,6 +316,16 @@ def get_parser() -> argparse.ArgumentParser:
         default=False,
         help="Overwrite the extracted and log file(s)",
     )
+    parser.add_argument(
+        "--append",
+        action="store_true",
+        default=False,
+        help=(
+            "Add the frames and history output samples written to the ODB since the last extraction to the extracted "
+            "file, e.g. while the analysis is still running. The file is created if it does not exist. Only h5 files "
+            "with the odb or extract format, extracted with --append, can be appended to. Not available with --jobs"
+        ),
+    )
     parser.add_argument(
         "-d",
         "--debug",
@@ -255,15 +397,21 @@ def cpp_execute(
     args: argparse.Namespace,
     environment: dict | None = None,
     working_directory: pathlib.Path = pathlib.Path(),
+    shard_directory: pathlib.Path = pathlib.Path(),
 ) -> None:
     """Run the SPADE c++ executable.
 
+    With more than one job, one worker process per job extracts every n-th frame into a shard file in the shard
+    directory, then the shard files are merged into the extracted file.
+
     :param spade_executable: Spade c++ executable path
     :param abaqus_bin: Abaqus bin path
     :param args: The Spade Python CLI namespace
     :param environment: compilation environment for the ``subprocess.run`` shell call
+    :param working_directory: working directory for the ``subprocess.run`` shell call
+    :param shard_directory: directory for the shard files written by the worker processes
 
-    :raises RuntimeError: If the spade c++ command raises a ``subprocess.CalledProcessError``
+    :raises RuntimeError: If the spade c++ command raises a ``subprocess.CalledProcessError`` or a worker process fails
     """
     if environment is None:
         environment = {}
@@ -275,6 +423,23 @@ def cpp_execute(
             environment["LD_LIBRARY_PATH"] = f"{abaqus_bin}:{environment['LD_LIBRARY_PATH']}"
         except KeyError:
             environment["LD_LIBRARY_PATH"] = f"{abaqus_bin}"
+    if args.jobs > 1:
+        shard_files = [shard_directory / f"shard_{index}.h5" for index in range(args.jobs)]
+        processes = []
+        for index, shard_file in enumerate(shard_files):
+            shard_command_line_arguments = full_command_line_arguments + cpp_shard_wrapper(args, index, shard_file)
+            shard_command = shlex.split(shard_command_line_arguments, posix=(os.name == "posix"))
+            print_debug(f"Running {_settings._project_name_short} worker {index} with command {shard_command}")
+            processes.append(subprocess.Popen(shard_command, env=environment, cwd=working_directory))
+        failed_shards = [str(index) for index, process in enumerate(processes) if process.wait() != 0]
+        if failed_shards:
+            message = (
+                f"{_settings._project_name_short} extract failed in Abaqus ODB application for worker(s) "
+                f"{_utilities.character_delimited_list(failed_shards)}"
+            )
+            raise RuntimeError(message)
+        merge_shards = _utilities.quoted_string([str(shard_file) for shard_file in shard_files])
+        full_command_line_arguments += f" --merge-shards {merge_shards}"
     command_line_arguments = shlex.split(full_command_line_arguments, posix=(os.name == "posix"))
     print_debug(f"Running {_settings._project_name_short} with command {command_line_arguments}")
     try:
@@ -318,18 +483,83 @@ def cpp_wrapper(args: argparse.Namespace) -> str:
         full_command_line_arguments += f" --instance {_utilities.quoted_string(args.instance)}"
     if args.format:
         full_command_line_arguments += f" --format {args.format}"
+    if args.compression:
+        full_command_line_arguments += f" --compression {args.compression}"
+    if args.compression_level is not None:
+        full_command_line_arguments += f" --compression-level {args.compression_level}"
+    if args.chunk_shape:
+        full_command_line_arguments += f" --chunk-shape {args.chunk_shape}"
+    if args.layout:
+        full_command_line_arguments += f" --layout {args.layout}"
+    if args.invariants:
+        full_command_line_arguments += f" --invariants {args.invariants}"
+    if args.write_buffer_mb is not None:
+        full_command_line_arguments += f" --write-buffer-mb {args.write_buffer_mb}"
+    if args.max_memory is not None:
+        full_command_line_arguments += f" --max-memory {args.max_memory}"
+    if args.upgrade_cache:
+        full_command_line_arguments += f" --upgrade-cache {_utilities.quoted_string(args.upgrade_cache)}"
+    if args.upgrade_cache_size is not None:
+        full_command_line_arguments += f" --upgrade-cache-size {args.upgrade_cache_size}"
+    if args.profile:
+        full_command_line_arguments += f" --profile {_utilities.quoted_string(args.profile)}"
+    if args.metadata_layout:
+        full_command_line_arguments += f" --metadata-layout {args.metadata_layout}"
+    if args.h5_profile:
+        full_command_line_arguments += f" --h5-profile {_utilities.quoted_string(args.h5_profile)}"
+    if args.split_by:
+        full_command_line_arguments += f" --split-by {args.split_by}"
 
     # True or False inputs
     if args.verbose:
         full_command_line_arguments += " --verbose"
     if args.force_overwrite:
         full_command_line_arguments += " --force-overwrite"
+    if args.append:
+        full_command_line_arguments += " --append"
     if args.debug:
         full_command_line_arguments += " --debug"
 
     return full_command_line_arguments
 
 
+def cpp_shard_wrapper(args: argparse.Namespace, shard_index: int, shard_file: pathlib.Path) -> str:
+    """Return the c++ executable CLI options for one worker process, added after the :meth:`cpp_wrapper` options.
+
+    Each worker writes its own shard file and log file. The log file is named after the extracted data log file with
+    the shard number added, as is the profile file when one is requested. A memory ceiling is split evenly between the
+    workers. Partition files of a split extracted file are named after the merged extracted file, since they are
+    linked to it by file name.
+
+    :param args: The Spade Python CLI namespace
+    :param shard_index: Position of the worker among the workers
+    :param shard_file: Shard file written by the worker
+
+    :returns: c++ CLI arguments
+    """
+    if args.log_file:
+        log_file = pathlib.Path(args.log_file)
+    else:
+        log_file = pathlib.Path(args.ODB_FILE).with_suffix(f".{_settings._project_name_short}.log")
+    shard_log_file = log_file.with_name(f"{log_file.stem}.shard{shard_index}{log_file.suffix}")
+    shard_command_line_arguments = (
+        f" --shard-index {shard_index} --shard-count {args.jobs}"
+        f" --extracted-file {_utilities.quoted_string(str(shard_file))}"
+        f" --log-file {_utilities.quoted_string(str(shard_log_file))}"
+    )
+    if args.max_memory:  # The workers run at the same time, so each one gets its share of the ceiling
+        shard_command_line_arguments += f" --max-memory {max(1, args.max_memory // args.jobs)}"
+    if args.profile:
+        profile_file = pathlib.Path(args.profile)
+        shard_profile_file = profile_file.with_name(f"{profile_file.stem}.shard{shard_index}{profile_file.suffix}")
+        shard_command_line_arguments += f" --profile {_utilities.quoted_string(str(shard_profile_file))}"
+    if args.split_by and args.split_by != "none":
+        extracted_file = pathlib.Path(args.extracted_file) if args.extracted_file else pathlib.Path(args.ODB_FILE)
+        partition_prefix = extracted_file.with_suffix("")
+        shard_command_line_arguments += f" --partition-prefix {_utilities.quoted_string(str(partition_prefix))}"
+    return shard_command_line_arguments
+
+
 # Limit help() and 'from module import *' behavior to the module's public API
 _module_objects = set(globals().keys()) - _exclude_from_namespace
 __all__ = [name for name in _module_objects if not name.startswith("_")]
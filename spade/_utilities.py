@@ -1,4 +1,5 @@
 #! /usr/bin/env python
+import argparse
 import pathlib
 import re
 import shutil
@@ -104,6 +105,24 @@ def abaqus_official_version(abaqus_command: pathlib.Path) -> str:
     return official_version
 
 
+def positive_integer(argument: str) -> int:
+    """Convert a command line argument to an integer of at least one.
+
+    :param argument: command line argument
+
+    :returns: argument as an integer
+
+    :raises argparse.ArgumentTypeError: If the argument is not an integer of at least one
+    """
+    try:
+        value = int(argument)
+    except ValueError as err:
+        raise argparse.ArgumentTypeError(f"'{argument}' is not an integer") from err
+    if value < 1:
+        raise argparse.ArgumentTypeError(f"'{argument}' is less than one")
+    return value
+
+
 # Ripped from Turbo-Turtle. Probably worth keeping a project specific version.
 def character_delimited_list(sequence: typing.Iterable, character: str = " ") -> str:
     """Map a list of non-strings to a character delimited string.
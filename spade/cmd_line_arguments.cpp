@@ -24,6 +24,7 @@
 //#include <cctype>
 #include <algorithm>
 #include <chrono>  // For getting milliseconds on timestamps
+#include <regex>
 
 #include <cmd_line_arguments.h>
 
@@ -39,6 +40,7 @@ CmdLineArguments::CmdLineArguments (int &argc, char **argv) {
     this->debug_output = false;
     this->help_command = false;
     this->force_overwrite = false;
+    this->append_output = false;
     this->command_line_arguments["odb-file"] = "";
     this->command_line_arguments["extracted-file"] = "";
     this->command_line_arguments["extracted-file-type"] = "";
@@ -51,6 +53,25 @@ CmdLineArguments::CmdLineArguments (int &argc, char **argv) {
     this->command_line_arguments["instance"] = "";
     this->command_line_arguments["log-file"] = "";
     this->command_line_arguments["format"] = "extract";
+    this->command_line_arguments["compression"] = "none";
+    this->command_line_arguments["compression-level"] = "";
+    this->command_line_arguments["chunk-shape"] = "";
+    this->command_line_arguments["write-buffer-mb"] = "256";
+    this->command_line_arguments["max-memory"] = "0";
+    this->command_line_arguments["layout"] = "frame";
+    this->command_line_arguments["invariants"] = "odb";
+    this->command_line_arguments["shard-index"] = "0";
+    this->command_line_arguments["shard-count"] = "1";
+    this->command_line_arguments["merge-shards"] = "";
+    this->command_line_arguments["mpi-io"] = "independent";
+    this->command_line_arguments["h5-profile"] = "default";
+    this->command_line_arguments["metadata-layout"] = "attributes";
+    this->command_line_arguments["split-by"] = "none";
+    this->command_line_arguments["partition-prefix"] = "";
+    this->command_line_arguments["upgrade-cache"] = "";
+    this->command_line_arguments["upgrade-cache-size"] = "10240";
+    this->command_line_arguments["profile"] = "";
+    this->command_line_arguments["synthetic"] = "";
     this->start_time = this->getTimeStamp(true);
 
     while (1) {
@@ -62,6 +83,7 @@ CmdLineArguments::CmdLineArguments (int &argc, char **argv) {
             {"verbose",             no_argument,       0,  'v'},
             {"debug",               no_argument,       0,  'd'},
             {"force-overwrite",     no_argument,       0,  'f'},
+            {"append",              no_argument,       0,  0 },
             {"step",                required_argument, 0,  0 },
             {"frame",               required_argument, 0,  0 },
             {"frame-value",         required_argument, 0,  0 },
@@ -71,6 +93,25 @@ CmdLineArguments::CmdLineArguments (int &argc, char **argv) {
             {"instance",            required_argument, 0,  0 },
             {"log-file",            required_argument, 0,  0 },
             {"format",              required_argument, 0,  0 },
+            {"compression",         required_argument, 0,  0 },
+            {"compression-level",   required_argument, 0,  0 },
+            {"chunk-shape",         required_argument, 0,  0 },
+            {"write-buffer-mb",     required_argument, 0,  0 },
+            {"max-memory",          required_argument, 0,  0 },
+            {"layout",              required_argument, 0,  0 },
+            {"invariants",          required_argument, 0,  0 },
+            {"shard-index",         required_argument, 0,  0 },
+            {"shard-count",         required_argument, 0,  0 },
+            {"merge-shards",        required_argument, 0,  0 },
+            {"mpi-io",              required_argument, 0,  0 },
+            {"h5-profile",          required_argument, 0,  0 },
+            {"metadata-layout",     required_argument, 0,  0 },
+            {"split-by",            required_argument, 0,  0 },
+            {"partition-prefix",    required_argument, 0,  0 },
+            {"upgrade-cache",       required_argument, 0,  0 },
+            {"upgrade-cache-size",  required_argument, 0,  0 },
+            {"profile",             required_argument, 0,  0 },
+            {"synthetic",           required_argument, 0,  0 },
             {0,0,0,0 }
         };
 
@@ -82,6 +123,8 @@ CmdLineArguments::CmdLineArguments (int &argc, char **argv) {
                 string option_name =  string(long_options[option_index].name);
                 if (optarg) {
                     this->command_line_arguments[option_name] = string(optarg);
+                } else if (option_name == "append") {
+                    this->append_output = true;
                 }
                 break;
             }
@@ -137,12 +180,18 @@ CmdLineArguments::CmdLineArguments (int &argc, char **argv) {
         throw std::runtime_error("Found unexpected arguments");
     }
 
+    bool synthetic = !this->command_line_arguments["synthetic"].empty();  // A synthetic model is extracted instead of an odb file
     if (!this->help_command) {
+#ifdef SPADE_WITHOUT_ABAQUS
+        if (!synthetic) {
+            throw std::runtime_error("Built without Abaqus, only a synthetic model can be extracted");
+        }
+#endif
         // Check for odb-file and if it exists
-        if (this->command_line_arguments["odb-file"].empty()) {
+        if ((!synthetic) && (this->command_line_arguments["odb-file"].empty())) {
             throw std::runtime_error("ODB file not provided on command line");
         }
-        if (!std::filesystem::exists(std::filesystem::path(this->command_line_arguments["odb-file"]))) {
+        if ((!synthetic) && (!std::filesystem::exists(std::filesystem::path(this->command_line_arguments["odb-file"])))) {
             throw std::runtime_error(this->command_line_arguments["odb-file"] + " does not exist");
         }
 
@@ -150,7 +199,7 @@ CmdLineArguments::CmdLineArguments (int &argc, char **argv) {
         std::transform(this->command_line_arguments["extracted-file-type"].begin(), this->command_line_arguments["extracted-file-type"].end(), this->command_line_arguments["extracted-file-type"].begin(), ::tolower);
         if ((this->command_line_arguments["extracted-file-type"] != "json") && (this->command_line_arguments["extracted-file-type"] != "yaml")) this->command_line_arguments["extracted-file-type"] = "h5";
 
-        string base_file_name = std::filesystem::path(this->command_line_arguments["odb-file"]).replace_extension("").generic_string();
+        string base_file_name = (synthetic) ? "synthetic" : std::filesystem::path(this->command_line_arguments["odb-file"]).replace_extension("").generic_string();
 
         // Handle extracted file name
         if (this->command_line_arguments["extracted-file"].empty()) { 
@@ -167,7 +216,7 @@ CmdLineArguments::CmdLineArguments (int &argc, char **argv) {
         }
 
         // Check if extracted file already exists
-        if (std::filesystem::exists(file_path)) {
+        if ((std::filesystem::exists(file_path)) && (!this->append_output)) {  // Appending extends the existing file
             if (!this->force_overwrite) {
                 cerr << this->command_line_arguments["extracted-file"] + " already exists. Appending time stamp to extracted file\n";
                 this->command_line_arguments["extracted-file"] = base_file_name + "_" + this->start_time + "." + this->command_line_arguments["extracted-file-type"];
@@ -206,6 +255,129 @@ CmdLineArguments::CmdLineArguments (int &argc, char **argv) {
         if (this->command_line_arguments["history-region"].empty()) { this->command_line_arguments["history-region"] = "all"; }
         if (this->command_line_arguments["instance"].empty()) { this->command_line_arguments["instance"] = "all"; }
 
+        // Check the dataset compression and chunking options
+        string &compression = this->command_line_arguments["compression"];
+        std::transform(compression.begin(), compression.end(), compression.begin(), ::tolower);
+        const vector<string> compression_filters = {"none", "gzip", "szip", "lzf", "zstd"};
+        if (std::find(compression_filters.begin(), compression_filters.end(), compression) == compression_filters.end()) {
+            throw std::runtime_error("Unknown compression filter: " + compression + ". Choose from none, gzip, szip, lzf, or zstd");
+        }
+        string &compression_level = this->command_line_arguments["compression-level"];
+        if (compression_level.empty()) {
+            if (compression == "gzip") { compression_level = "4"; }
+            else if (compression == "szip") { compression_level = "16"; }  // szip level is the number of pixels per block
+            else if (compression == "zstd") { compression_level = "3"; }
+        } else {
+            int level;
+            try {
+                level = std::stoi(compression_level);
+            } catch (const std::exception& e) {
+                throw std::runtime_error("Compression level must be an integer: " + compression_level);
+            }
+            if ((compression == "gzip") && ((level < 0) || (level > 9))) {
+                throw std::runtime_error("The gzip compression level must be between 0 and 9");
+            } else if ((compression == "szip") && ((level < 2) || (level > 32) || (level % 2))) {
+                throw std::runtime_error("The szip compression level (pixels per block) must be an even number between 2 and 32");
+            } else if ((compression == "zstd") && ((level < 1) || (level > 22))) {
+                throw std::runtime_error("The zstd compression level must be between 1 and 22");
+            }
+        }
+        string &chunk_shape = this->command_line_arguments["chunk-shape"];
+        if (chunk_shape.empty()) {
+            chunk_shape = (compression == "none") ? "none" : "auto";  // Filters can only be applied to chunked datasets
+        } else if ((chunk_shape != "auto") && (!std::regex_match(chunk_shape, std::regex("[1-9][0-9]*(x[1-9][0-9]*)*")))) {
+            throw std::runtime_error("Chunk shape must be 'auto' or a list of positive integers separated by 'x', e.g. 1024x8");
+        }
+        if (!std::regex_match(this->command_line_arguments["write-buffer-mb"], std::regex("[0-9]+"))) {
+            throw std::runtime_error("Write buffer size must be a non-negative integer number of megabytes: " + this->command_line_arguments["write-buffer-mb"]);
+        }
+        if (!std::regex_match(this->command_line_arguments["max-memory"], std::regex("[0-9]+"))) {
+            throw std::runtime_error("Maximum memory must be a non-negative integer number of megabytes: " + this->command_line_arguments["max-memory"]);
+        }
+        if ((this->command_line_arguments["layout"] != "frame") && (this->command_line_arguments["layout"] != "stacked")) {
+            throw std::runtime_error("Unknown layout: " + this->command_line_arguments["layout"] + ". Choose from frame or stacked");
+        }
+        if ((this->command_line_arguments["layout"] == "stacked") && (this->command_line_arguments["format"] != "extract")) {
+            throw std::runtime_error("The stacked layout is only available with the extract format");
+        }
+        string &invariants = this->command_line_arguments["invariants"];
+        if ((invariants != "computed") && (invariants != "odb") && (invariants != "none")) {
+            throw std::runtime_error("Unknown invariants option: " + invariants + ". Choose from computed, odb, or none");
+        }
+        if ((!std::regex_match(this->command_line_arguments["shard-index"], std::regex("[0-9]+"))) || (!std::regex_match(this->command_line_arguments["shard-count"], std::regex("[1-9][0-9]*")))) {
+            throw std::runtime_error("Shard index must be a non-negative integer and shard count a positive integer");
+        }
+        if (std::stoi(this->command_line_arguments["shard-index"]) >= std::stoi(this->command_line_arguments["shard-count"])) {
+            throw std::runtime_error("Shard index must be less than the shard count");
+        }
+        if (this->command_line_arguments["shard-count"] != "1") {
+            if (this->command_line_arguments["extracted-file-type"] != "h5") {
+                throw std::runtime_error("Sharding is only available for h5 extracted files");
+            }
+            if ((this->command_line_arguments["format"] == "vtk") || (this->command_line_arguments["layout"] == "stacked")) {
+                throw std::runtime_error("Sharding is only available with the odb format and the frame layout of the extract format");
+            }
+        }
+        if ((this->command_line_arguments["mpi-io"] != "independent") && (this->command_line_arguments["mpi-io"] != "collective")) {
+            throw std::runtime_error("Unknown mpi-io option: " + this->command_line_arguments["mpi-io"] + ". Choose from independent or collective");
+        }
+        string &metadata_layout = this->command_line_arguments["metadata-layout"];
+        if ((metadata_layout != "attributes") && (metadata_layout != "compact") && (metadata_layout != "datasets")) {
+            throw std::runtime_error("Unknown metadata layout: " + metadata_layout + ". Choose from attributes, compact, or datasets");
+        }
+        string &h5_profile = this->command_line_arguments["h5-profile"];
+        if (h5_profile.rfind("custom:", 0) == 0) {
+            if (!std::filesystem::exists(std::filesystem::path(h5_profile.substr(7)))) {
+                throw std::runtime_error("The hdf5 profile file " + h5_profile.substr(7) + " doesn't exist");
+            }
+        } else if ((h5_profile != "default") && (h5_profile != "lustre") && (h5_profile != "nvme") && (h5_profile != "nfs")) {
+            throw std::runtime_error("Unknown hdf5 profile: " + h5_profile + ". Choose from default, lustre, nvme, nfs, or custom:<file name>");
+        }
+        string &split_by = this->command_line_arguments["split-by"];
+        if ((split_by != "none") && (split_by != "step") && (split_by != "instance") && (split_by != "field") && (!std::regex_match(split_by, std::regex("frame-range:[1-9][0-9]*")))) {
+            throw std::runtime_error("Unknown split-by option: " + split_by + ". Choose from none, step, instance, field, or frame-range:<number of frames>");
+        }
+        if (split_by != "none") {
+            if ((this->command_line_arguments["extracted-file-type"] != "h5") || (this->command_line_arguments["format"] == "vtk")) {
+                throw std::runtime_error("Splitting is only available for h5 extracted files with the odb or extract format");
+            }
+            if (this->append_output) {
+                throw std::runtime_error("Splitting is not available when appending, rerun the extraction to write the missing partitions");
+            }
+            if ((split_by.rfind("frame-range:", 0) == 0) && (this->command_line_arguments["layout"] == "stacked")) {
+                throw std::runtime_error("The stacked layout holds every frame of a step in one dataset, so it can't be split by frame range");
+            }
+            if (this->command_line_arguments["partition-prefix"].empty()) {
+                this->command_line_arguments["partition-prefix"] = std::filesystem::path(this->command_line_arguments["extracted-file"]).replace_extension("").string();
+            }
+            // The partition files are linked by file name, so they have to be next to the file holding the links. Workers writing shards link from the merged extracted file instead
+            std::filesystem::path partition_directory = std::filesystem::absolute(this->command_line_arguments["partition-prefix"]).lexically_normal().parent_path();
+            std::filesystem::path extracted_directory = std::filesystem::absolute(this->command_line_arguments["extracted-file"]).lexically_normal().parent_path();
+            if ((this->command_line_arguments["shard-count"] == "1") && (partition_directory != extracted_directory)) {
+                throw std::runtime_error("The partition prefix " + this->command_line_arguments["partition-prefix"] + " has to be in the directory of the extracted file " + this->command_line_arguments["extracted-file"]);
+            }
+        }
+        if (!std::regex_match(this->command_line_arguments["upgrade-cache-size"], std::regex("[0-9]+"))) {
+            throw std::runtime_error("Upgrade cache size must be a non-negative integer number of megabytes: " + this->command_line_arguments["upgrade-cache-size"]);
+        }
+        if (this->append_output) {
+            if ((this->command_line_arguments["extracted-file-type"] != "h5") || (this->command_line_arguments["format"] == "vtk")) {
+                throw std::runtime_error("Appending is only available for h5 extracted files with the odb or extract format");
+            }
+            if (this->command_line_arguments["shard-count"] != "1") {
+                throw std::runtime_error("Appending is not available for shards, the worker processes write new files");
+            }
+        }
+
+        if (synthetic) {
+            if (this->command_line_arguments["extracted-file-type"] != "h5") {
+                throw std::runtime_error("A synthetic model is only extracted to h5 files");
+            }
+            if ((this->append_output) || (!this->command_line_arguments["merge-shards"].empty())) {
+                throw std::runtime_error("A synthetic model can't be appended or merged");
+            }
+        }
+
         this->command_line = this->command_name + " ";
         for (int i=1; i<argc; ++i) { this->command_line += string(argv[i]) + " "; }  // concatenate options into single string
 
@@ -237,6 +409,25 @@ string CmdLineArguments::verboseArguments () {
     arguments += "\thistory: " + this->command_line_arguments["history"] + "\n";
     arguments += "\thistory region: " + this->command_line_arguments["history-region"] + "\n";
     arguments += "\tinstance: " + this->command_line_arguments["instance"] + "\n";
+    arguments += "\tcompression: " + this->command_line_arguments["compression"] + "\n";
+    arguments += "\tcompression level: " + this->command_line_arguments["compression-level"] + "\n";
+    arguments += "\tchunk shape: " + this->command_line_arguments["chunk-shape"] + "\n";
+    arguments += "\twrite buffer: " + this->command_line_arguments["write-buffer-mb"] + " MB\n";
+    arguments += "\tmax memory: " + this->command_line_arguments["max-memory"] + " MB\n";
+    arguments += "\tlayout: " + this->command_line_arguments["layout"] + "\n";
+    arguments += "\tinvariants: " + this->command_line_arguments["invariants"] + "\n";
+    if (this->append_output) { arguments += "\tappend: True\n"; } else { arguments += "\tappend: False\n"; }
+    arguments += "\tshard: " + this->command_line_arguments["shard-index"] + " of " + this->command_line_arguments["shard-count"] + "\n";
+    arguments += "\tmpi-io: " + this->command_line_arguments["mpi-io"] + "\n";
+    arguments += "\tmetadata layout: " + this->command_line_arguments["metadata-layout"] + "\n";
+    arguments += "\tsplit by: " + this->command_line_arguments["split-by"] + "\n";
+    if (!this->command_line_arguments["partition-prefix"].empty()) { arguments += "\tpartition prefix: " + this->command_line_arguments["partition-prefix"] + "\n"; }
+    arguments += "\th5 profile: " + this->command_line_arguments["h5-profile"] + "\n";
+    arguments += "\tupgrade cache: " + ((this->command_line_arguments["upgrade-cache"].empty()) ? string("<odb file directory>") : this->command_line_arguments["upgrade-cache"]) + "\n";
+    arguments += "\tupgrade cache size: " + this->command_line_arguments["upgrade-cache-size"] + " MB\n";
+    if (!this->command_line_arguments["profile"].empty()) { arguments += "\tprofile: " + this->command_line_arguments["profile"] + "\n"; }
+    if (!this->command_line_arguments["synthetic"].empty()) { arguments += "\tsynthetic model: " + this->command_line_arguments["synthetic"] + "\n"; }
+    if (!this->command_line_arguments["merge-shards"].empty()) { arguments += "\tmerge shards: " + this->command_line_arguments["merge-shards"] + "\n"; }
     arguments += "\tlog file: " + this->command_line_arguments["log-file"];
 
     return arguments;
@@ -263,6 +454,26 @@ string CmdLineArguments::helpMessage () {
     help_message += "\t--instance\tget information from specified instance (default: all)\n";
     help_message += "\t--log-file\tname of log file (default: <odb file name>.spade.log)\n";
     help_message += "\t--format\tSpecify the format of the data in the output file\n";
+    help_message += "\t--compression\tcompression filter for numeric datasets: none, gzip, szip, lzf, or zstd (default: none)\n";
+    help_message += "\t--compression-level\tcompression level for the chosen filter (default: gzip 4, szip 16, zstd 3)\n";
+    help_message += "\t--chunk-shape\tchunk shape for numeric datasets, 'auto' or RxC (default: auto when compressing, otherwise none)\n";
+    help_message += "\t--write-buffer-mb\tmemory budget in megabytes for field output data waiting to be written by the writer thread, 0 writes serially (default: 256)\n";
+    help_message += "\t--max-memory\tmemory ceiling in megabytes for buffered data: the model is released once it's written, field output is read and written in parts, and half of the ceiling is left for the writer thread, 0 for no ceiling (default: 0)\n";
+    help_message += "\t--layout\tlayout of the field output data in the extract format: 'frame' writes a group per frame, 'stacked' appends each frame to datasets with a leading frame dimension (default: frame)\n";
+    help_message += "\t--invariants\tsource of field output invariants: 'computed' calculates them from the bulk data and writes them next to it, 'odb' reads the mises values stored in the odb, 'none' skips them (default: odb)\n";
+    help_message += "\t--append\tadd the frames and history output samples written to the odb since the last extraction to an existing extracted file, which records what it already holds, or create the file if it doesn't exist (h5 files with the odb or extract format)\n";
+    help_message += "\t--shard-index\tposition of this worker among the workers extracting the frames round-robin, the first worker also writes the mesh and history output (default: 0)\n";
+    help_message += "\t--shard-count\tnumber of workers extracting the frames (default: 1)\n";
+    help_message += "\t--merge-shards\tcomma separated list of files written by the workers, starting with the first worker, to merge into the extracted file instead of extracting data\n";
+    help_message += "\t--mpi-io\thow the ranks of an MPI run write the data of their frames into the extracted file, with 'independent' or 'collective' MPI-IO writes, only used by executables built with MPI (default: independent)\n";
+    help_message += "\t--metadata-layout\thow single values like descriptions, types, dimensions, and frame values are written to h5 extracted files: 'attributes' of their group, 'compact' datasets stored in the object header, or 'datasets' of their own (default: attributes)\n";
+    help_message += "\t--split-by\tsplit h5 extracted files into a root file with the mesh, history output, and other data outside of the partitions and one partition file of frame data per 'step', 'instance', 'field', or 'frame-range:<number of frames>' of each step, joined to the root file by external links at the paths the data would have in one file. Each worker of a sharded run writes whole partitions, and partition files completed by an earlier run from the same odb file with the same options are linked again instead of being extracted (default: none)\n";
+    help_message += "\t--partition-prefix\tdirectory and start of the partition file names, which are linked by file name and have to be in the directory of the extracted file. Workers writing shards set it to the merged extracted file name (default: extracted file name without its extension)\n";
+    help_message += "\t--h5-profile\tfile creation and access properties of h5 extracted files tuned for the storage they're written to: 'default' keeps the HDF5 library defaults, 'lustre', 'nvme', or 'nfs', or 'custom:<file name>' reading 'key = value' lines of libver-low, libver-high, alignment-threshold, alignment, meta-block-size, file-space-strategy, file-space-page-size, page-buffer-size, mdc-initial-size, mdc-max-size, sieve-buffer-size, and fill-time (default: default)\n";
+    help_message += "\t--upgrade-cache\tdirectory keeping the upgraded copies of odb files written by older versions of Abaqus, so the same odb file isn't upgraded again, 'none' upgrades the odb file every time (default: the directory of the odb file)\n";
+    help_message += "\t--upgrade-cache-size\tsize limit in megabytes of the upgraded copies in the upgrade cache directory, the least recently used are removed first, 0 for no limit (default: 10240)\n";
+    help_message += "\t--profile\tname of a json file to write the time spent in each phase of the extraction to, with the byte and element counts of the data written, as Chrome trace events for Perfetto or chrome://tracing\n";
+    help_message += "\t--synthetic\textract a generated model instead of an odb file, described by comma separated key=value pairs: instances, nodes, elements (e.g. C3D8R:8000+S4R:2000), sets, steps, frames, fields, components, integration-points, and seed, e.g. for benchmarking the writes (h5 files only)\n";
     // TODO: Add more here
     help_message += "\nExample: " + this->command_name + " odb_file.odb\n";
     help_message += "\n";
@@ -320,4 +531,5 @@ const string& CmdLineArguments::startTime() const { return this->start_time; }
 bool CmdLineArguments::verbose() const { return this->verbose_output; }
 bool CmdLineArguments::debug() const { return this->debug_output; }
 bool CmdLineArguments::force() const { return this->force_overwrite; }
+bool CmdLineArguments::append() const { return this->append_output; }
 bool CmdLineArguments::help() const { return this->help_command; }
@@ -111,6 +111,12 @@ class CmdLineArguments {
           \return boolean indicating whether the force option is used
         */
         bool force() const;
+        //! Return the value of the append flag.
+        /*!
+          If the user gives the append option, a flag is set, this function returns the value of that flag. This is a getter method.
+          \return boolean indicating whether the append option is used
+        */
+        bool append() const;
         bool debug() const; // docstring not given, more for developer use
 
     private:
@@ -124,6 +130,7 @@ class CmdLineArguments {
         bool verbose_output;
         bool debug_output;
         bool force_overwrite;
+        bool append_output;
 
 };
 #endif // __CMD_LINE_ARGUMENTS_H_INCLUDED__
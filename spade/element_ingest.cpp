@@ -0,0 +1,31 @@
+#include <map>
+#include <string>
+
+#include <element_ingest.h>
+
+using namespace std;
+
+ElementIngest::ElementIngest (map<string, mesh_elements_type> &elements, mesh_set_type* element_set) {
+    this->elements = &elements;
+    this->element_set = element_set;
+}
+
+mesh_elements_type* ElementIngest::add (const int &label, const char* type, const int* connectivity, const int &connectivity_size) {
+    if (label == this->previous_label) { return nullptr; }  // Node based sequences repeat an element once for each of its nodes
+    this->previous_label = label;
+    if (this->element_set) {
+        if ((!this->element_set->labels.empty()) && (label <= this->element_set->labels.back())) { this->element_set->sorted = false; }
+        this->element_set->labels.push_back(label);
+    }
+    if ((this->type_elements == nullptr) || (this->previous_type != type)) {
+        this->previous_type = type;
+        this->type_elements = &(*this->elements)[this->previous_type];
+    }
+    mesh_elements_type* stored_elements = this->type_elements;
+    if (!stored_elements->label_index.try_emplace(label, stored_elements->labels.size()).second) { return nullptr; }  // Element already stored
+    if ((!stored_elements->labels.empty()) && (label < stored_elements->labels.back())) { stored_elements->sorted = false; }
+    stored_elements->labels.push_back(label);
+    stored_elements->connectivity.insert(stored_elements->connectivity.end(), connectivity, connectivity + connectivity_size);
+    stored_elements->connectivity_offsets.push_back(stored_elements->connectivity.size());
+    return stored_elements;
+}
@@ -0,0 +1,45 @@
+//! An object for storing the elements of a mesh one element at a time
+
+#include <map>
+#include <string>
+
+#include "spade_types.h"
+
+#ifndef __ELEMENT_INGEST_H_INCLUDED__
+#define __ELEMENT_INGEST_H_INCLUDED__
+
+using namespace std;
+
+/*!
+   This class stores a sequence of elements in the per element type containers of a mesh. Elements of the same type
+   usually come in runs, so the container of a type is only looked up when the type changes, and the type name is compared
+   without copying it into a string. An element already stored in the mesh, whether it was seen earlier in the sequence or
+   in an earlier sequence, is found with the label index of its type and skipped.
+*/
+class ElementIngest {
+    public:
+        //! The constructor.
+        /*!
+          \param elements Containers of the mesh to store the elements in, keyed by element type
+          \param element_set Set to add the label of every element in the sequence to, nullptr if the sequence isn't a set
+        */
+        ElementIngest (map<string, mesh_elements_type> &elements, mesh_set_type* element_set);
+        //! Store the label and connectivity of an element
+        /*!
+          The caller stores the section category and instance names of the element in the returned container.
+          \param label Element label
+          \param type Abaqus element type, e.g. C3D8R
+          \param connectivity Node labels of the element
+          \param connectivity_size Number of node labels
+          \return container of the element type, nullptr if the element was already stored
+        */
+        mesh_elements_type* add (const int &label, const char* type, const int* connectivity, const int &connectivity_size);
+
+    private:
+        map<string, mesh_elements_type>* elements;
+        mesh_set_type* element_set;
+        mesh_elements_type* type_elements = nullptr;  // Container of the previous element's type
+        string previous_type;
+        int previous_label = -2;
+};
+#endif  // __ELEMENT_INGEST_H_INCLUDED__
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <field_invariants.h>
+
+using namespace std;
+
+// The kernels are built for AVX-512, AVX2, and the baseline instruction set where the compiler supports function
+// multiversioning, and the best version for the machine running spade is picked when the program loads. Only loops
+// without branches or calls to the math library, other than sqrt, are vectorized by the optimizer
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+    #define INVARIANT_TARGET_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+    #define INVARIANT_INLINE inline __attribute__((always_inline))
+#else
+    #define INVARIANT_TARGET_CLONES
+    #define INVARIANT_INLINE inline
+#endif
+
+namespace {
+
+struct invariant_outputs_type {
+    float* magnitude;
+    float* mises;
+    float* tresca;
+    float* press;
+    float* inv3;
+    float* max_principal;
+    float* mid_principal;
+    float* min_principal;
+    float* max_in_plane_principal;
+    float* min_in_plane_principal;
+    float* out_of_plane_principal;
+};
+
+float* output_buffer (map<string, vector<float>> &invariants, const string &name, const size_t &length) {
+    auto invariant = invariants.find(name);
+    if (invariant == invariants.end()) { return nullptr; }
+    invariant->second.resize(length);
+    return invariant->second.data();
+}
+
+invariant_outputs_type output_buffers (map<string, vector<float>> &invariants, const size_t &length) {
+    invariant_outputs_type outputs;
+    outputs.magnitude = output_buffer(invariants, "magnitude", length);
+    outputs.mises = output_buffer(invariants, "mises", length);
+    outputs.tresca = output_buffer(invariants, "tresca", length);
+    outputs.press = output_buffer(invariants, "press", length);
+    outputs.inv3 = output_buffer(invariants, "inv3", length);
+    outputs.max_principal = output_buffer(invariants, "maxPrincipal", length);
+    outputs.mid_principal = output_buffer(invariants, "midPrincipal", length);
+    outputs.min_principal = output_buffer(invariants, "minPrincipal", length);
+    outputs.max_in_plane_principal = output_buffer(invariants, "maxInPlanePrincipal", length);
+    outputs.min_in_plane_principal = output_buffer(invariants, "minInPlanePrincipal", length);
+    outputs.out_of_plane_principal = output_buffer(invariants, "outOfPlanePrincipal", length);
+    return outputs;
+}
+
+template <typename T>
+INVARIANT_INLINE void vector_invariants (const T* data, const size_t &length, const invariant_layout_type &layout, const invariant_outputs_type &outputs) {
+    if (outputs.magnitude == nullptr) { return; }
+    const int width = layout.width;
+    for (size_t i=0; i<length; i++) {
+        const T* row = data + i * width;
+        double sum = 0.0;
+        for (int j=0; j<width; j++) { sum += static_cast<double>(row[j]) * row[j]; }
+        outputs.magnitude[i] = static_cast<float>(sqrt(sum));
+    }
+}
+
+struct tensor_type {  // Components of a symmetric tensor
+    double a11, a22, a33, a12, a13, a23;
+};
+
+template <typename T>
+INVARIANT_INLINE tensor_type load_tensor (const T* row, const invariant_layout_type &layout) {
+    return {row[layout.index[0]] * layout.scale[0], row[layout.index[1]] * layout.scale[1], row[layout.index[2]] * layout.scale[2],
+            row[layout.index[3]] * layout.scale[3], row[layout.index[4]] * layout.scale[4], row[layout.index[5]] * layout.scale[5]};
+}
+
+INVARIANT_INLINE double tensor_mean (const tensor_type &a) {
+    return (a.a11 + a.a22 + a.a33) / 3.0;
+}
+
+INVARIANT_INLINE double second_deviatoric_invariant (const tensor_type &a) {
+    const double mean = tensor_mean(a);
+    const double d11 = a.a11 - mean, d22 = a.a22 - mean, d33 = a.a33 - mean;
+    return 0.5 * (d11 * d11 + d22 * d22 + d33 * d33) + a.a12 * a.a12 + a.a13 * a.a13 + a.a23 * a.a23;
+}
+
+INVARIANT_INLINE double third_deviatoric_invariant (const tensor_type &a) {  // Determinant of the deviator
+    const double mean = tensor_mean(a);
+    const double d11 = a.a11 - mean, d22 = a.a22 - mean, d33 = a.a33 - mean;
+    return d11 * (d22 * d33 - a.a23 * a.a23) - a.a12 * (a.a12 * d33 - a.a23 * a.a13) + a.a13 * (a.a12 * a.a23 - d22 * a.a13);
+}
+
+// Each requested invariant gets its own loop without branches, so the loops of the arithmetic invariants can be vectorized.
+// The principal values share the trigonometric solution of the characteristic equation in one loop, which calls acos and
+// cos and is only vectorized where the compiler has a vector math library for them.
+template <typename T>
+INVARIANT_INLINE void tensor_invariants (const T* data, const size_t &length, const invariant_layout_type &layout, const invariant_outputs_type &outputs) {
+    const int width = layout.width;
+    if (outputs.mises) {
+        for (size_t i=0; i<length; i++) {
+            outputs.mises[i] = static_cast<float>(sqrt(3.0 * second_deviatoric_invariant(load_tensor(data + i * width, layout))));
+        }
+    }
+    if (outputs.press) {
+        for (size_t i=0; i<length; i++) {
+            outputs.press[i] = static_cast<float>(-tensor_mean(load_tensor(data + i * width, layout)));
+        }
+    }
+    if (outputs.inv3) {
+        for (size_t i=0; i<length; i++) {
+            outputs.inv3[i] = static_cast<float>(cbrt(13.5 * third_deviatoric_invariant(load_tensor(data + i * width, layout))));
+        }
+    }
+    if (outputs.max_in_plane_principal) {
+        for (size_t i=0; i<length; i++) {
+            const tensor_type a = load_tensor(data + i * width, layout);
+            outputs.max_in_plane_principal[i] = static_cast<float>(0.5 * (a.a11 + a.a22) + sqrt(0.25 * (a.a11 - a.a22) * (a.a11 - a.a22) + a.a12 * a.a12));
+        }
+    }
+    if (outputs.min_in_plane_principal) {
+        for (size_t i=0; i<length; i++) {
+            const tensor_type a = load_tensor(data + i * width, layout);
+            outputs.min_in_plane_principal[i] = static_cast<float>(0.5 * (a.a11 + a.a22) - sqrt(0.25 * (a.a11 - a.a22) * (a.a11 - a.a22) + a.a12 * a.a12));
+        }
+    }
+    if (outputs.out_of_plane_principal) {
+        for (size_t i=0; i<length; i++) {
+            outputs.out_of_plane_principal[i] = static_cast<float>(data[i * width + layout.index[2]] * layout.scale[2]);
+        }
+    }
+    if ((!outputs.tresca) && (!outputs.max_principal) && (!outputs.mid_principal) && (!outputs.min_principal)) { return; }
+
+    // The principal values that weren't requested are written to scratch buffers, so the loop has no branches
+    vector<float> scratch[4];
+    auto principal_output = [&] (float* output, vector<float> &buffer) {
+        if (output) { return output; }
+        buffer.resize(length);
+        return buffer.data();
+    };
+    float* tresca = principal_output(outputs.tresca, scratch[0]);
+    float* max_principal = principal_output(outputs.max_principal, scratch[1]);
+    float* mid_principal = principal_output(outputs.mid_principal, scratch[2]);
+    float* min_principal = principal_output(outputs.min_principal, scratch[3]);
+    const double third_of_circle = 2.0 * acos(-1.0) / 3.0;
+    for (size_t i=0; i<length; i++) {
+        const tensor_type a = load_tensor(data + i * width, layout);
+        const double mean = tensor_mean(a);
+        const double p = sqrt(second_deviatoric_invariant(a) / 3.0);
+        const double r = (p > 0.0) ? third_deviatoric_invariant(a) / (2.0 * p * p * p) : 0.0;
+        const double phi = acos(min(1.0, max(-1.0, r))) / 3.0;
+        const double max_value = mean + 2.0 * p * cos(phi);
+        const double min_value = mean + 2.0 * p * cos(phi + third_of_circle);
+        tresca[i] = static_cast<float>(max_value - min_value);
+        max_principal[i] = static_cast<float>(max_value);
+        mid_principal[i] = static_cast<float>(3.0 * mean - max_value - min_value);
+        min_principal[i] = static_cast<float>(min_value);
+    }
+}
+
+INVARIANT_TARGET_CLONES
+void float_invariants (const float* data, const size_t &length, const invariant_layout_type &layout, const invariant_outputs_type &outputs) {
+    if (layout.tensor) {
+        tensor_invariants(data, length, layout, outputs);
+    } else {
+        vector_invariants(data, length, layout, outputs);
+    }
+}
+
+INVARIANT_TARGET_CLONES
+void double_invariants (const double* data, const size_t &length, const invariant_layout_type &layout, const invariant_outputs_type &outputs) {
+    if (layout.tensor) {
+        tensor_invariants(data, length, layout, outputs);
+    } else {
+        vector_invariants(data, length, layout, outputs);
+    }
+}
+
+}  // namespace
+
+bool invariant_layout (const vector<string> &component_labels, const bool &tensor, const bool &engineering_shear, invariant_layout_type &layout) {
+    layout.width = component_labels.size();
+    layout.tensor = tensor;
+    for (int i=0; i<6; i++) {
+        layout.index[i] = 0;
+        layout.scale[i] = 0.0;
+    }
+    if (component_labels.empty()) { return false; }
+    const string tensor_components[6] = {"11", "22", "33", "12", "13", "23"};
+    for (size_t i=0; i<component_labels.size(); i++) {
+        const string &label = component_labels[i];
+        int component = -1;
+        if ((tensor) && (label.size() >= 2)) {
+            string suffix = label.substr(label.size() - 2);
+            component = distance(tensor_components, find(tensor_components, tensor_components + 6, suffix));
+            if (component == 6) { component = -1; }
+        } else if ((!tensor) && (!label.empty()) && (isdigit(label.back()))) {
+            component = label.back() - '1';  // Vector components only need to be counted
+            if (component > 2) { component = -1; }
+        }
+        if (component < 0) { return false; }
+        layout.index[component] = i;
+        layout.scale[component] = ((engineering_shear) && (component > 2)) ? 0.5 : 1.0;
+    }
+    return true;
+}
+
+void compute_invariants (const float* data, const size_t &length, const invariant_layout_type &layout, map<string, vector<float>> &invariants) {
+    if ((data == nullptr) || (length == 0)) { return; }
+    float_invariants(data, length, layout, output_buffers(invariants, length));
+}
+
+void compute_invariants (const double* data, const size_t &length, const invariant_layout_type &layout, map<string, vector<float>> &invariants) {
+    if ((data == nullptr) || (length == 0)) { return; }
+    double_invariants(data, length, layout, output_buffers(invariants, length));
+}
@@ -0,0 +1,53 @@
+//! Functions for computing field output invariants from bulk data
+
+#include <map>
+#include <string>
+#include <vector>
+
+#ifndef __FIELD_INVARIANTS_H_INCLUDED__
+#define __FIELD_INVARIANTS_H_INCLUDED__
+
+using namespace std;
+
+/*!
+   Describes where the components of a vector or symmetric tensor are found in each row of bulk data. Tensor components
+   are stored in the order 11, 22, 33, 12, 13, 23. Components missing from the bulk data (e.g. 33 for plane stress) point
+   at the first value in the row with a scale of zero, so they are read as zero without a branch.
+*/
+struct invariant_layout_type {
+    int width;  // Number of values in each row of bulk data
+    bool tensor;  // True for symmetric tensors, false for vectors
+    int index[6];  // Position of each component in a row
+    double scale[6];  // Multiplier for each component: zero if missing, one half for engineering shear strains, otherwise one
+};
+
+//! Work out where the vector or tensor components are in the bulk data rows
+/*!
+  The component numbers are read from the end of the labels, e.g. S11 or U2
+  \param component_labels Labels of the values in each row of bulk data
+  \param tensor True if the field is a symmetric tensor, false if it is a vector
+  \param engineering_shear True if the shear components are engineering strains, which are twice the tensor shear strains
+  \param layout Layout to be filled in
+  \return true if every label could be matched to a component
+*/
+bool invariant_layout (const vector<string> &component_labels, const bool &tensor, const bool &engineering_shear, invariant_layout_type &layout);
+
+//! Compute invariants from single precision bulk data
+/*!
+  Compute the requested invariants for every row of bulk data. The keys of the invariants map select what is computed:
+  magnitude (vectors), and mises, tresca, press, inv3, maxPrincipal, midPrincipal, minPrincipal, maxInPlanePrincipal,
+  minInPlanePrincipal, and outOfPlanePrincipal (tensors). Each requested vector is resized to length.
+  \param data Bulk data with length rows of layout.width values
+  \param length Number of rows of bulk data
+  \param layout Location of the components in each row
+  \param invariants Map of invariant names to vectors of values to be filled in
+*/
+void compute_invariants (const float* data, const size_t &length, const invariant_layout_type &layout, map<string, vector<float>> &invariants);
+
+//! Compute invariants from double precision bulk data
+/*!
+  \sa compute_invariants(const float*, const size_t&, const invariant_layout_type&, map<string, vector<float>>&)
+*/
+void compute_invariants (const double* data, const size_t &length, const invariant_layout_type &layout, map<string, vector<float>> &invariants);
+
+#endif  // __FIELD_INVARIANTS_H_INCLUDED__
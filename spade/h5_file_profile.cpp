@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include <h5_file_profile.h>
+
+using namespace std;
+
+H5FileProfile::H5FileProfile (CmdLineArguments &command_line_arguments, Logging &log_file) {
+    this->log_file = &log_file;
+    this->name = command_line_arguments["h5-profile"];
+    if (this->name == "lustre") {  // Objects start on stripe boundaries, so each stripe is written by one client
+        this->libver_low = H5F_LIBVER_V18;
+        this->alignment_threshold = 65536;
+        this->alignment = 1048576;
+        this->meta_block_size = 1048576;
+        this->mdc_initial_size = 8388608;
+        this->mdc_max_size = 67108864;
+        this->sieve_buffer_size = 4194304;
+        this->fill_never = true;
+    } else if (this->name == "nvme") {  // Metadata and raw data are kept in separate pages, which are read and written whole
+        this->libver_low = H5F_LIBVER_V110;
+        this->file_space_strategy = H5F_FSPACE_STRATEGY_PAGE;
+        this->file_space_page_size = 65536;
+        this->page_buffer_size = 4194304;
+        this->mdc_initial_size = 4194304;
+        this->mdc_max_size = 33554432;
+        this->sieve_buffer_size = 1048576;
+        this->fill_never = true;
+    } else if (this->name == "nfs") {  // Every write is a round trip to the server, so metadata is written in fewer larger blocks
+        this->libver_low = H5F_LIBVER_V18;
+        this->meta_block_size = 4194304;
+        this->mdc_initial_size = 16777216;
+        this->mdc_max_size = 134217728;
+        this->sieve_buffer_size = 8388608;
+        this->fill_never = true;
+    } else if (this->name.rfind("custom:", 0) == 0) {
+        read_profile_file(this->name.substr(7));
+    }
+    if (this->page_buffer_size > 0) {
+        this->page_buffer_size = std::max<size_t>(this->page_buffer_size, this->file_space_page_size);  // The library requires at least one page
+    }
+    if (this->mdc_max_size < this->mdc_initial_size) { this->mdc_max_size = this->mdc_initial_size; }
+    this->log_file->logVerbose("HDF5 file profile: " + this->name);
+}
+
+void H5FileProfile::read_profile_file (const string &file_name) {
+    ifstream profile_file(file_name);
+    if (!profile_file) { throw std::runtime_error("Unable to read the hdf5 profile file " + file_name); }
+    string line;
+    while (std::getline(profile_file, line)) {
+        line = line.substr(0, line.find('#'));  // Comments run to the end of the line
+        if (line.find_first_not_of(" \t\r") == string::npos) { continue; }
+        size_t equals_position = line.find('=');
+        if (equals_position == string::npos) {
+            throw std::runtime_error("Unable to read line '" + line + "' of the hdf5 profile file " + file_name + ". Expected key = value");
+        }
+        string key, value;
+        stringstream(line.substr(0, equals_position)) >> key;
+        stringstream(line.substr(equals_position + 1)) >> value;
+        try {
+            set(key, value);
+        } catch (const std::logic_error&) {  // Thrown by std::stoull for values that aren't numbers
+            throw std::runtime_error("Invalid value " + value + " for " + key + " in the hdf5 profile file " + file_name);
+        }
+    }
+}
+
+void H5FileProfile::set (const string &key, const string &value) {
+    map<string, H5F_libver_t> library_versions = {
+        {"earliest", H5F_LIBVER_EARLIEST}, {"v18", H5F_LIBVER_V18}, {"v110", H5F_LIBVER_V110},
+#if H5_VERSION_GE(1, 12, 0)
+        {"v112", H5F_LIBVER_V112},
+#endif
+        {"latest", H5F_LIBVER_LATEST}
+    };
+    map<string, H5F_fspace_strategy_t> file_space_strategies = {
+        {"fsm-aggr", H5F_FSPACE_STRATEGY_FSM_AGGR}, {"page", H5F_FSPACE_STRATEGY_PAGE},
+        {"aggr", H5F_FSPACE_STRATEGY_AGGR}, {"none", H5F_FSPACE_STRATEGY_NONE}
+    };
+    if ((key == "libver-low") || (key == "libver-high")) {
+        if (!library_versions.count(value)) { throw std::invalid_argument(value); }
+        ((key == "libver-low") ? this->libver_low : this->libver_high) = library_versions[value];
+    } else if (key == "alignment-threshold") {
+        this->alignment_threshold = std::stoull(value);
+    } else if (key == "alignment") {
+        this->alignment = std::stoull(value);
+    } else if (key == "meta-block-size") {
+        this->meta_block_size = std::stoull(value);
+    } else if (key == "file-space-strategy") {
+        if (!file_space_strategies.count(value)) { throw std::invalid_argument(value); }
+        this->file_space_strategy = file_space_strategies[value];
+    } else if (key == "file-space-page-size") {
+        this->file_space_page_size = std::stoull(value);
+    } else if (key == "page-buffer-size") {
+        this->page_buffer_size = std::stoull(value);
+    } else if (key == "mdc-initial-size") {
+        this->mdc_initial_size = std::stoull(value);
+    } else if (key == "mdc-max-size") {
+        this->mdc_max_size = std::stoull(value);
+    } else if (key == "sieve-buffer-size") {
+        this->sieve_buffer_size = std::stoull(value);
+    } else if (key == "fill-time") {
+        if ((value != "never") && (value != "ifset")) { throw std::invalid_argument(value); }
+        this->fill_never = (value == "never");
+    } else {
+        throw std::runtime_error("Unknown hdf5 profile setting: " + key);
+    }
+}
+
+H5::FileCreatPropList H5FileProfile::creation_properties () const {
+    H5::FileCreatPropList properties;
+    properties.setFileSpaceStrategy(this->file_space_strategy, false, 1);
+    if (this->file_space_strategy == H5F_FSPACE_STRATEGY_PAGE) { properties.setFileSpacePagesize(this->file_space_page_size); }
+    return properties;
+}
+
+H5::FileAccPropList H5FileProfile::access_properties (const bool &parallel) const {
+    H5::FileAccPropList properties;
+    properties.setLibverBounds(this->libver_low, this->libver_high);
+    properties.setAlignment(this->alignment_threshold, this->alignment);
+    H5Pset_meta_block_size(properties.getId(), this->meta_block_size);
+    properties.setSieveBufSize(this->sieve_buffer_size);
+    if ((this->page_buffer_size > 0) && (this->file_space_strategy == H5F_FSPACE_STRATEGY_PAGE) && (!parallel)) {
+        H5Pset_page_buffer_size(properties.getId(), this->page_buffer_size, 0, 0);
+    }
+    if (this->mdc_initial_size > 0) {
+        H5AC_cache_config_t cache_config;
+        cache_config.version = H5AC__CURR_CACHE_CONFIG_VERSION;
+        H5Pget_mdc_config(properties.getId(), &cache_config);
+        cache_config.set_initial_size = true;
+        cache_config.initial_size = this->mdc_initial_size;
+        cache_config.max_size = this->mdc_max_size;
+        cache_config.min_size = std::min(cache_config.min_size, this->mdc_initial_size);
+        H5Pset_mdc_config(properties.getId(), &cache_config);
+    }
+    return properties;
+}
+
+void H5FileProfile::log_statistics (H5::H5File &h5_file) const {
+    // The hit rate is reset at the start of each epoch of the automatic cache resizing, so it covers the recent accesses
+    double hit_rate = 0.0;
+    size_t max_size = 0, minimum_clean_size = 0, current_size = 0;
+    int entry_count = 0;
+    if ((H5Fget_mdc_hit_rate(h5_file.getId(), &hit_rate) >= 0) && (H5Fget_mdc_size(h5_file.getId(), &max_size, &minimum_clean_size, &current_size, &entry_count) >= 0)) {
+        stringstream hit_rate_stream;
+        hit_rate_stream << std::fixed << std::setprecision(1) << hit_rate * 100.0;
+        this->log_file->log("Metadata cache hit rate: " + hit_rate_stream.str() + "%, " + to_string(entry_count) + " entries in " + to_string(current_size) + " of " + to_string(max_size) + " bytes");
+    }
+    hsize_t file_size = 0;
+    hssize_t free_space = H5Fget_freespace(h5_file.getId());
+    ssize_t free_section_count = H5Fget_free_sections(h5_file.getId(), H5FD_MEM_DEFAULT, 0, nullptr);
+    if ((free_space >= 0) && (free_section_count >= 0) && (H5Fget_filesize(h5_file.getId(), &file_size) >= 0)) {
+        this->log_file->log("File free space: " + to_string(free_space) + " bytes in " + to_string(free_section_count) + " sections of a " + to_string(file_size) + " byte file");
+    }
+}
@@ -0,0 +1,80 @@
+//! An object for tuning the hdf5 file creation and access properties to the storage the extracted file is written to
+
+#include <string>
+
+#include "H5Cpp.h"
+
+#include "cmd_line_arguments.h"
+#include "logging.h"
+
+#ifndef __H5_FILE_PROFILE_H_INCLUDED__
+#define __H5_FILE_PROFILE_H_INCLUDED__
+
+using namespace std;
+
+/*!
+   This class holds the file format bounds, alignment, metadata aggregation, file space strategy, metadata cache size,
+   sieve buffer size, and dataset fill time chosen by the h5-profile command line argument. The default profile keeps
+   the hdf5 library defaults. The lustre profile aligns large objects to 1 MiB stripes and aggregates metadata in stripe
+   sized blocks, the nvme profile uses paged aggregation with a page buffer, and the nfs profile makes fewer and larger
+   metadata writes. A custom profile reads "key = value" lines from a file, starting from the library defaults.
+*/
+class H5FileProfile {
+    public:
+        //! The constructor.
+        /*!
+          \param command_line_arguments CmdLineArguments object storing command line arguments
+          \param log_file Logging object for writing log messages
+        */
+        H5FileProfile (CmdLineArguments &command_line_arguments, Logging &log_file);
+        //! Return the file creation properties of the profile
+        /*!
+          \return file creation property list
+        */
+        H5::FileCreatPropList creation_properties () const;
+        //! Return the file access properties of the profile
+        /*!
+          \param parallel Leave out the page buffer, which parallel hdf5 doesn't support
+          \return file access property list
+        */
+        H5::FileAccPropList access_properties (const bool &parallel=false) const;
+        //! Return whether datasets are allocated without writing fill values
+        /*!
+          \return true if the fill time of datasets is never
+        */
+        bool skip_fill () const { return this->fill_never; }
+        //! Log the metadata cache hit rate and the free space of an open file, which has to be called before closing it
+        /*!
+          \param h5_file Open hdf5 file
+        */
+        void log_statistics (H5::H5File &h5_file) const;
+
+    private:
+        //! Read the settings of a custom profile file
+        /*!
+          \param file_name Name of the profile file
+        */
+        void read_profile_file (const string &file_name);
+        //! Set a single profile setting
+        /*!
+          \param key Name of the setting, e.g. meta-block-size
+          \param value Value of the setting
+        */
+        void set (const string &key, const string &value);
+
+        string name;
+        H5F_libver_t libver_low = H5F_LIBVER_EARLIEST;
+        H5F_libver_t libver_high = H5F_LIBVER_LATEST;
+        hsize_t alignment_threshold = 1;
+        hsize_t alignment = 1;
+        hsize_t meta_block_size = 2048;
+        H5F_fspace_strategy_t file_space_strategy = H5F_FSPACE_STRATEGY_FSM_AGGR;
+        hsize_t file_space_page_size = 4096;
+        size_t page_buffer_size = 0;  // Only used with the page file space strategy
+        size_t mdc_initial_size = 0;  // Zero keeps the library default metadata cache size
+        size_t mdc_max_size = 0;
+        size_t sieve_buffer_size = 65536;
+        bool fill_never = false;
+        Logging* log_file;
+};
+#endif  // __H5_FILE_PROFILE_H_INCLUDED__
@@ -0,0 +1,221 @@
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <vector>
+#include <filesystem>
+#include <system_error>
+#include <tuple>
+
+#include "H5Cpp.h"
+#include <hdf5_hl.h>
+
+#include <h5_merger.h>
+
+using namespace std;
+
+H5Merger::H5Merger (CmdLineArguments &command_line_arguments, Logging &log_file) {
+    this->log_file = &log_file;
+
+    vector<string> shard_file_names;
+    stringstream shard_stream(command_line_arguments["merge-shards"]);
+    string shard_file_name;
+    while (getline(shard_stream, shard_file_name, ',')) {
+        if (!shard_file_name.empty()) { shard_file_names.push_back(shard_file_name); }
+    }
+    if (shard_file_names.empty()) {
+        throw std::runtime_error("No shard files given to merge");
+    }
+    for (const string &name : shard_file_names) {
+        if (!std::filesystem::exists(std::filesystem::path(name))) {
+            throw std::runtime_error(name + " does not exist");
+        }
+    }
+
+    // The first shard holds the mesh and the data outside of the steps, so it becomes the extracted file
+    string merged_file_name = command_line_arguments["extracted-file"];
+    this->log_file->log("Moving shard " + shard_file_names[0] + " to " + merged_file_name);
+    std::error_code rename_error;
+    std::filesystem::rename(shard_file_names[0], merged_file_name, rename_error);
+    if (rename_error) {  // The shards may be on another file system
+        std::filesystem::copy_file(shard_file_names[0], merged_file_name, std::filesystem::copy_options::overwrite_existing);
+    }
+
+    H5::Exception::dontPrint();
+    H5FileProfile file_profile(command_line_arguments, log_file);
+    H5::H5File merged_file;
+    try {
+        merged_file.openFile(merged_file_name, H5F_ACC_RDWR, file_profile.access_properties());
+    } catch(const H5::FileIException&) {
+        throw std::runtime_error("Issue opening file: " + merged_file_name);
+    }
+    for (size_t i=1; i<shard_file_names.size(); i++) {
+        merge_shard(merged_file, shard_file_names[i]);
+    }
+    file_profile.log_statistics(merged_file);
+    merged_file.close();
+    this->log_file->log("Closing hdf5 file.");
+}
+
+H5Merger::H5Merger (Logging &log_file) {
+    this->log_file = &log_file;
+}
+
+void H5Merger::merge_shard (H5::H5File &merged_file, const string &shard_file_name) {
+    this->log_file->log("Merging shard " + shard_file_name);
+    H5::H5File shard_file;
+    try {
+        shard_file.openFile(shard_file_name, H5F_ACC_RDONLY);
+    } catch(const H5::FileIException&) {
+        throw std::runtime_error("Issue opening file: " + shard_file_name);
+    }
+    merge_group(shard_file, merged_file, "/");
+    shard_file.close();
+}
+
+void H5Merger::merge_group (H5::H5File &shard_file, H5::H5File &merged_file, const string &group_name) {
+    vector<string> missing_names;
+    vector<string> shared_group_names;
+    H5::Group merged_group;
+    try {
+        H5::Group shard_group = shard_file.openGroup(group_name);
+        merged_group = merged_file.openGroup(group_name);
+        string prefix = (group_name == "/") ? group_name : group_name + "/";
+        for (hsize_t i=0; i<shard_group.getNumObjs(); i++) {
+            string member_name = shard_group.getObjnameByIdx(i);
+            if (!merged_group.nameExists(member_name)) {
+                missing_names.push_back(member_name);
+            } else if ((is_external_link(shard_group.getId(), member_name)) || (is_external_link(merged_group.getId(), member_name))) {
+                continue;  // Partition files are only linked to, not merged
+            } else if ((shard_group.childObjType(member_name) == H5O_TYPE_GROUP) && (merged_group.childObjType(member_name) == H5O_TYPE_GROUP)) {
+                shared_group_names.push_back(prefix + member_name);
+            }
+        }
+    } catch(H5::Exception& e) {
+        this->log_file->logWarning("Unable to merge group " + group_name + ". " + e.getDetailMsg());
+        return;
+    }
+    this->log_file->logDebug("Merging " + to_string(missing_names.size()) + " members of group " + group_name);
+
+    // The object references of dimension scales aren't expanded, which would copy the scales they point to once more for
+    // every dataset, since reattach_scales() makes the attachments again in the extracted file
+    bool staged = false;
+    string staging_group_name = "/_spade_merge";
+    if ((!missing_names.empty()) && (shared_group_names.empty()) && (group_name != "/")) {
+        staged = (H5Ocopy(shard_file.getId(), group_name.c_str(), merged_file.getId(), staging_group_name.c_str(), H5P_DEFAULT, H5P_DEFAULT) >= 0);
+    }
+    vector<string> copied_names;
+    for (const string &missing_name : missing_names) {
+        herr_t status;
+        string shard_name = ((group_name == "/") ? group_name : group_name + "/") + missing_name;
+        if (staged) {
+            string staged_name = staging_group_name + "/" + missing_name;
+            status = H5Lmove(merged_file.getId(), staged_name.c_str(), merged_group.getId(), missing_name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+        } else if (is_external_link(shard_file.getId(), shard_name)) {
+            status = copy_external_link(shard_file, shard_name, merged_group.getId(), missing_name);
+        } else {
+            status = H5Ocopy(shard_file.getId(), shard_name.c_str(), merged_group.getId(), missing_name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+        }
+        if (status < 0) {
+            this->log_file->logWarning("Unable to merge " + missing_name + " into group " + group_name + ".");
+        } else {
+            copied_names.push_back(shard_name);
+        }
+    }
+    if (staged) {
+        H5Ldelete(merged_file.getId(), staging_group_name.c_str(), H5P_DEFAULT);  // Members shared with the extracted file are dropped
+    }
+    reattach_scales(shard_file, merged_file, copied_names);
+
+    for (const string &shared_group_name : shared_group_names) {
+        merge_group(shard_file, merged_file, shared_group_name);
+    }
+}
+
+void H5Merger::reattach_scales (H5::H5File &shard_file, H5::H5File &merged_file, const vector<string> &object_names) {
+    vector<string> dataset_names;
+    for (const string &object_name : object_names) {
+        find_datasets(shard_file, object_name, dataset_names);
+    }
+
+    // Read the attachments from the shard file, where the references are still valid
+    vector<tuple<string, unsigned, string>> attachments;  // Dataset name, dimension, and scale name
+    for (const string &dataset_name : dataset_names) {
+        try {
+            H5::DataSet shard_dataset = shard_file.openDataSet(dataset_name);
+            if (!shard_dataset.attrExists("DIMENSION_LIST")) { continue; }
+            int rank = shard_dataset.getSpace().getSimpleExtentNdims();
+            for (int dimension=0; dimension<rank; dimension++) {
+                vector<string> scale_names;
+                H5DSiterate_scales(shard_dataset.getId(), dimension, nullptr, [] (hid_t, unsigned, hid_t scale_id, void* scale_names) -> herr_t {
+                    ssize_t name_size = H5Iget_name(scale_id, nullptr, 0);  // The length of the full path, which has no limit
+                    if (name_size > 0) {
+                        string scale_name(name_size, '\0');
+                        H5Iget_name(scale_id, scale_name.data(), name_size + 1);
+                        static_cast<vector<string>*>(scale_names)->push_back(scale_name);
+                    }
+                    return 0;
+                }, &scale_names);
+                for (const string &scale_name : scale_names) { attachments.emplace_back(dataset_name, dimension, scale_name); }
+            }
+        } catch(H5::Exception& e) {
+            this->log_file->logWarning("Unable to read dimension scales of " + dataset_name + ". " + e.getDetailMsg());
+        }
+    }
+
+    // Remove the copied attachments before making them again, since their references point into the shard file
+    for (const string &dataset_name : dataset_names) {
+        try {
+            H5::DataSet merged_dataset = merged_file.openDataSet(dataset_name);
+            if (merged_dataset.attrExists("DIMENSION_LIST")) { merged_dataset.removeAttr("DIMENSION_LIST"); }
+            if (merged_dataset.attrExists("REFERENCE_LIST")) { merged_dataset.removeAttr("REFERENCE_LIST"); }
+        } catch(H5::Exception& e) {
+            this->log_file->logWarning("Unable to remove dimension scales of " + dataset_name + ". " + e.getDetailMsg());
+        }
+    }
+    for (const auto& [dataset_name, dimension, scale_name] : attachments) {
+        try {
+            H5::DataSet merged_dataset = merged_file.openDataSet(dataset_name);
+            H5::DataSet merged_scale = merged_file.openDataSet(scale_name);
+            if (H5DSattach_scale(merged_dataset.getId(), merged_scale.getId(), dimension) < 0) {
+                this->log_file->logWarning("Unable to attach dimension scale " + scale_name + " to " + dataset_name + ".");
+            }
+        } catch(H5::Exception& e) {
+            this->log_file->logWarning("Unable to attach dimension scale " + scale_name + " to " + dataset_name + ". " + e.getDetailMsg());
+        }
+    }
+}
+
+void H5Merger::find_datasets (H5::H5File &shard_file, const string &object_name, vector<string> &dataset_names) {
+    if (is_external_link(shard_file.getId(), object_name)) { return; }  // The datasets of partition files stay where they are
+    try {
+        H5O_type_t object_type = shard_file.childObjType(object_name);
+        if (object_type == H5O_TYPE_DATASET) {
+            dataset_names.push_back(object_name);
+        } else if (object_type == H5O_TYPE_GROUP) {
+            H5::Group group = shard_file.openGroup(object_name);
+            for (hsize_t i=0; i<group.getNumObjs(); i++) {
+                find_datasets(shard_file, object_name + "/" + group.getObjnameByIdx(i), dataset_names);
+            }
+        }
+    } catch(H5::Exception& e) {
+        this->log_file->logWarning("Unable to read " + object_name + ". " + e.getDetailMsg());
+    }
+}
+
+bool H5Merger::is_external_link (const hid_t &location, const string &link_name) {
+    H5L_info_t link_info;
+    return (H5Lget_info(location, link_name.c_str(), &link_info, H5P_DEFAULT) >= 0) && (link_info.type == H5L_TYPE_EXTERNAL);
+}
+
+herr_t H5Merger::copy_external_link (H5::H5File &shard_file, const string &link_name, const hid_t &merged_location, const string &merged_link_name) {
+    H5L_info_t link_info;
+    if (H5Lget_info(shard_file.getId(), link_name.c_str(), &link_info, H5P_DEFAULT) < 0) { return -1; }
+    vector<char> link_value(link_info.u.val_size);
+    if (H5Lget_val(shard_file.getId(), link_name.c_str(), link_value.data(), link_value.size(), H5P_DEFAULT) < 0) { return -1; }
+    unsigned flags;
+    const char* file_name;
+    const char* object_name;
+    if (H5Lunpack_elink_val(link_value.data(), link_value.size(), &flags, &file_name, &object_name) < 0) { return -1; }
+    return H5Lcreate_external(file_name, object_name, merged_location, merged_link_name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+}
@@ -0,0 +1,94 @@
+//! An object for merging hdf5 files written by spade worker processes
+
+#include <string>
+#include <vector>
+
+#include "H5Cpp.h"
+
+#include "cmd_line_arguments.h"
+#include "logging.h"
+#include "h5_file_profile.h"
+
+#ifndef __H5_MERGER_H_INCLUDED__
+#define __H5_MERGER_H_INCLUDED__
+
+using namespace std;
+
+/*!
+   This class builds the extracted file from the shard files written by worker processes that each extracted a disjoint
+   set of frames. The first shard, which holds the mesh and the data outside of the steps, becomes the extracted file and
+   the groups and datasets from the other shards that it doesn't have are copied into it. Datasets found in more than one
+   shard, such as the field output metadata, are taken from the first shard. External links to the partition files of
+   an extracted file split with the split-by option are copied as links, without reading the partition files.
+*/
+class H5Merger {
+    public:
+        //! The constructor.
+        /*!
+          The constructor does all of the merging, using the comma separated list of shard files in the merge-shards
+          command line argument.
+          \param command_line_arguments CmdLineArguments object storing command line arguments
+          \param log_file Logging object for writing log messages
+        */
+        H5Merger (CmdLineArguments &command_line_arguments, Logging &log_file);
+
+    protected:
+        //! The constructor for mergers that build the extracted file in their own way
+        /*!
+          \param log_file Logging object for writing log messages
+        */
+        H5Merger (Logging &log_file);
+        //! Make the dimension scale attachments of copied datasets again
+        /*!
+          Copying objects between files doesn't update the object references held in the DIMENSION_LIST attribute of a
+          dataset, so the copied attachments are removed and made again from the names of the scales in the shard file.
+          Objects keep their names when they are merged, so the same names are found in the extracted file.
+          \param shard_file Open shard file
+          \param merged_file Open extracted file
+          \param object_names Full paths of the copied groups and datasets
+        */
+        void reattach_scales (H5::H5File &shard_file, H5::H5File &merged_file, const vector<string> &object_names);
+        //! Find the datasets in a group of the shard file and all of its sub groups
+        /*!
+          \param shard_file Open shard file
+          \param object_name Full path of a group or dataset
+          \param dataset_names Will store the full paths of the datasets found
+        */
+        void find_datasets (H5::H5File &shard_file, const string &object_name, vector<string> &dataset_names);
+        //! Check whether a link is an external link
+        /*!
+          \param location Open file or group holding the link
+          \param link_name Path of the link
+          \return true if the link exists and is an external link
+        */
+        bool is_external_link (const hid_t &location, const string &link_name);
+        //! Make an external link in the extracted file to the same file and object as an external link of a shard file
+        /*!
+          \param shard_file Open shard file
+          \param link_name Full path of the external link in the shard file
+          \param merged_location Open file or group of the extracted file to make the link in
+          \param merged_link_name Path of the new link, relative to the merged location
+          \return negative value if the link couldn't be made
+        */
+        herr_t copy_external_link (H5::H5File &shard_file, const string &link_name, const hid_t &merged_location, const string &merged_link_name);
+
+        Logging* log_file;
+
+    private:
+        //! Copy the contents of a shard file into the extracted file
+        /*!
+          \param merged_file Open extracted file
+          \param shard_file_name Name of the shard file
+        */
+        void merge_shard (H5::H5File &merged_file, const string &shard_file_name);
+        //! Copy the members of a group in a shard file that are missing from the same group in the extracted file
+        /*!
+          When none of the members are groups found in both files, the whole group is copied in one call and the missing
+          members are moved into place, so hard links between them, e.g. between the frames of a step, are kept. Otherwise the missing members are copied one at a time and the shared groups are merged recursively.
+          \param shard_file Open shard file
+          \param merged_file Open extracted file
+          \param group_name Full path of the group in both files
+        */
+        void merge_group (H5::H5File &shard_file, H5::H5File &merged_file, const string &group_name);
+};
+#endif  // __H5_MERGER_H_INCLUDED__
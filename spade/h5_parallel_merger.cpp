@@ -0,0 +1,345 @@
+#ifdef SPADE_MPI
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <mpi.h>
+#include "H5Cpp.h"
+#include <hdf5_hl.h>
+
+#include <h5_parallel_merger.h>
+
+using namespace std;
+
+H5ParallelMerger::H5ParallelMerger (CmdLineArguments &command_line_arguments, Logging &log_file, const vector<string> &shard_file_names, MPI_Comm communicator) : H5Merger(log_file) {
+    this->communicator = communicator;
+    MPI_Comm_rank(communicator, &this->rank);
+    MPI_Comm_size(communicator, &this->rank_count);
+    H5::Exception::dontPrint();
+
+    // Every rank reads the layout of every shard, so they all make the same plan and the same collective calls
+    for (size_t i=0; i<shard_file_names.size(); i++) {
+        try {
+            this->shard_files.emplace_back(shard_file_names[i], H5F_ACC_RDONLY);
+        } catch(const H5::FileIException&) {
+            throw std::runtime_error("Issue opening file: " + shard_file_names[i]);
+        }
+        map<string, string> object_links;
+        plan_group(this->shard_files.back(), i, "/", object_links);
+    }
+    this->log_file->logDebug("Merge plan holds " + to_string(this->plan.size()) + " links from " + to_string(this->shard_files.size()) + " shards");
+
+    string merged_file_name = command_line_arguments["extracted-file"];
+    this->log_file->log("Creating hdf5 file with " + to_string(this->rank_count) + " MPI ranks: " + merged_file_name);
+    long long bytes = 0;
+    double seconds = 0.0;
+    H5FileProfile file_profile(command_line_arguments, log_file);
+    {
+        H5::FileAccPropList access_properties = file_profile.access_properties(true);
+        H5Pset_fapl_mpio(access_properties.getId(), communicator, MPI_INFO_NULL);
+        H5Pset_all_coll_metadata_ops(access_properties.getId(), true);  // Metadata is read once and broadcast instead of by every rank
+        H5Pset_coll_metadata_write(access_properties.getId(), true);
+        H5::H5File merged_file;
+        try {
+            merged_file = H5::H5File(merged_file_name, H5F_ACC_TRUNC, file_profile.creation_properties(), access_properties);
+        } catch(const H5::FileIException&) {
+            throw std::runtime_error("Issue opening file: " + merged_file_name);
+        }
+        {
+            Logging::Span span(*this->log_file, "create merged objects");
+            create_objects(merged_file);
+        }
+        MPI_Barrier(communicator);
+        double start = MPI_Wtime();
+        {
+            Logging::Span span(*this->log_file, "write merged datasets");
+            bytes = write_datasets(merged_file, command_line_arguments["mpi-io"] == "collective");
+        }
+        seconds = MPI_Wtime() - start;
+        merged_file.close();  // Collective, so every rank has finished writing once it returns
+    }
+    report_bandwidth(bytes, seconds);
+
+    if (this->rank == 0) {
+        Logging::Span span(*this->log_file, "finish merged objects");
+        H5::H5File merged_file;
+        try {
+            merged_file.openFile(merged_file_name, H5F_ACC_RDWR, file_profile.access_properties());
+        } catch(const H5::FileIException&) {
+            throw std::runtime_error("Issue opening file: " + merged_file_name);
+        }
+        finish_objects(merged_file);
+        file_profile.log_statistics(merged_file);
+        merged_file.close();
+    }
+    for (H5::H5File &shard_file : this->shard_files) { shard_file.close(); }
+    MPI_Barrier(communicator);  // The extracted file is complete once the first rank has finished it
+    this->log_file->log("Closing hdf5 file.");
+}
+
+void H5ParallelMerger::plan_group (H5::H5File &shard_file, const int &shard, const string &group_name, map<string, string> &object_links) {
+    try {
+        H5::Group group = shard_file.openGroup(group_name);
+        string prefix = (group_name == "/") ? group_name : group_name + "/";
+        for (hsize_t i=0; i<group.getNumObjs(); i++) {
+            string member_name = group.getObjnameByIdx(i);
+            string name = prefix + member_name;
+            H5L_info_t link_info;
+            if ((H5Lget_info(shard_file.getId(), name.c_str(), &link_info, H5P_DEFAULT) < 0) || ((link_info.type != H5L_TYPE_HARD) && (link_info.type != H5L_TYPE_EXTERNAL))) {
+                this->log_file->logWarning("Unable to merge " + name + ", only hard and external links are merged in parallel.");
+                continue;
+            }
+            if (link_info.type == H5L_TYPE_EXTERNAL) {
+                if (!this->planned_names.count(name)) {  // Links to partition files are made by the first rank after the parallel writes
+                    merge_object_type merge_object;
+                    merge_object.name = name;
+                    merge_object.shard = shard;
+                    merge_object.type = H5O_TYPE_UNKNOWN;
+                    merge_object.parallel = false;
+                    merge_object.external_link = true;
+                    this->planned_names[name] = this->plan.size();
+                    this->plan.push_back(merge_object);
+                }
+                continue;
+            }
+            H5O_type_t type = group.childObjType(member_name);
+            auto [first_link, first] = object_links.try_emplace(object_identifier(shard_file, name), name);
+            if (!this->planned_names.count(name)) {
+                merge_object_type merge_object;
+                merge_object.name = name;
+                merge_object.shard = shard;
+                merge_object.type = type;
+                merge_object.hard_link = (first) ? "" : first_link->second;
+                merge_object.parallel = (type == H5O_TYPE_GROUP) || (type == H5O_TYPE_DATASET);
+                if (!merge_object.hard_link.empty()) {  // Made when the object it links to is made
+                    auto linked_object = this->planned_names.find(merge_object.hard_link);
+                    if (linked_object == this->planned_names.end()) {
+                        this->log_file->logErrorAndExit("Unable to merge " + name + ", the object it links to, " + merge_object.hard_link + ", isn't in the merge plan.");
+                    }
+                    merge_object.parallel = this->plan[linked_object->second].parallel;
+                } else if (type == H5O_TYPE_DATASET) {
+                    H5::DataSet dataset = shard_file.openDataSet(name);
+                    hid_t data_type = H5Dget_type(dataset.getId());
+                    merge_object.parallel = (H5Tdetect_class(data_type, H5T_VLEN) <= 0) && (H5Tis_variable_str(data_type) <= 0) && (H5Tdetect_class(data_type, H5T_REFERENCE) <= 0);
+                    H5Tclose(data_type);
+                }
+                this->planned_names[name] = this->plan.size();
+                this->plan.push_back(merge_object);
+            }
+            if ((type == H5O_TYPE_GROUP) && (first)) {  // Groups found in earlier shards are still searched for the frames of this one
+                plan_group(shard_file, shard, name, object_links);
+            }
+        }
+    } catch(H5::Exception& e) {
+        this->log_file->logWarning("Unable to read group " + group_name + ". " + e.getDetailMsg());
+    }
+}
+
+string H5ParallelMerger::object_identifier (H5::H5File &file, const string &name) {
+#if H5_VERSION_GE(1, 12, 0)
+    H5O_info2_t object_info;
+    memset(&object_info, 0, sizeof(object_info));
+    H5Oget_info_by_name3(file.getId(), name.c_str(), &object_info, H5O_INFO_BASIC, H5P_DEFAULT);
+    return string(reinterpret_cast<const char*>(&object_info.token), sizeof(object_info.token));
+#else
+    H5O_info_t object_info;
+    memset(&object_info, 0, sizeof(object_info));
+    H5Oget_info_by_name2(file.getId(), name.c_str(), &object_info, H5O_INFO_BASIC, H5P_DEFAULT);
+    return string(reinterpret_cast<const char*>(&object_info.addr), sizeof(object_info.addr));
+#endif
+}
+
+void H5ParallelMerger::create_objects (H5::H5File &merged_file) {
+    for (const merge_object_type &merge_object : this->plan) {
+        if (!merge_object.parallel) { continue; }
+        herr_t status = 0;
+        if (!merge_object.hard_link.empty()) {
+            status = H5Lcreate_hard(merged_file.getId(), merge_object.hard_link.c_str(), merged_file.getId(), merge_object.name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+        } else if (merge_object.type == H5O_TYPE_GROUP) {
+            hid_t group = H5Gcreate2(merged_file.getId(), merge_object.name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+            status = (group < 0) ? -1 : H5Gclose(group);
+        } else {
+            hid_t shard_dataset = H5Dopen2(this->shard_files[merge_object.shard].getId(), merge_object.name.c_str(), H5P_DEFAULT);
+            hid_t data_type = H5Dget_type(shard_dataset);
+            hid_t data_space = H5Dget_space(shard_dataset);
+            hid_t create_properties = H5Dget_create_plist(shard_dataset);
+            if (H5Pget_layout(create_properties) == H5D_COMPACT) {  // Every rank would have to write the same data to a compact dataset
+                H5Pset_layout(create_properties, H5D_CONTIGUOUS);
+            }
+            hid_t dataset = H5Dcreate2(merged_file.getId(), merge_object.name.c_str(), data_type, data_space, H5P_DEFAULT, create_properties, H5P_DEFAULT);
+            status = (dataset < 0) ? -1 : H5Dclose(dataset);
+            H5Pclose(create_properties);
+            H5Sclose(data_space);
+            H5Tclose(data_type);
+            H5Dclose(shard_dataset);
+        }
+        if (status < 0) {
+            this->log_file->logWarning("Unable to create " + merge_object.name + " in the merged file.");
+        }
+    }
+}
+
+long long H5ParallelMerger::write_datasets (H5::H5File &merged_file, const bool &collective) {
+    const hsize_t slab_bytes = 67108864;  // Bounds the memory of the copy buffer, large datasets are copied in slabs of rows
+    long long bytes_written = 0;
+    vector<char> buffer(1);
+    hid_t transfer_properties = H5Pcreate(H5P_DATASET_XFER);
+    for (const merge_object_type &merge_object : this->plan) {
+        if ((merge_object.type != H5O_TYPE_DATASET) || (!merge_object.parallel) || (!merge_object.hard_link.empty())) { continue; }
+        bool owner = ((merge_object.shard % this->rank_count) == this->rank);
+        hid_t merged_dataset = H5Dopen2(merged_file.getId(), merge_object.name.c_str(), H5P_DEFAULT);
+        if (merged_dataset < 0) { continue; }  // Not created, which was logged by every rank
+        hid_t create_properties = H5Dget_create_plist(merged_dataset);
+        bool collective_dataset = (collective) || (H5Pget_nfilters(create_properties) > 0);  // Parallel hdf5 only writes filtered datasets collectively
+        H5Pclose(create_properties);
+        if ((!owner) && (!collective_dataset)) {
+            H5Dclose(merged_dataset);
+            continue;
+        }
+        H5Pset_dxpl_mpio(transfer_properties, (collective_dataset) ? H5FD_MPIO_COLLECTIVE : H5FD_MPIO_INDEPENDENT);
+
+        hid_t shard_dataset = H5Dopen2(this->shard_files[merge_object.shard].getId(), merge_object.name.c_str(), H5P_DEFAULT);
+        hid_t data_space = H5Dget_space(shard_dataset);
+        hid_t data_type = H5Dget_type(shard_dataset);
+        hid_t memory_type = H5Tget_native_type(data_type, H5T_DIR_DEFAULT);
+        int dimension_count = H5Sget_simple_extent_ndims(data_space);
+        vector<hsize_t> dimensions(std::max(dimension_count, 1), 1);
+        H5Sget_simple_extent_dims(data_space, dimensions.data(), nullptr);
+        hsize_t row_bytes = H5Tget_size(memory_type);
+        for (int i=1; i<dimension_count; i++) { row_bytes *= dimensions[i]; }
+        hsize_t rows = (dimension_count == 0) ? 1 : dimensions[0];
+        hsize_t slab_rows = std::max<hsize_t>(1, std::min<hsize_t>(rows, slab_bytes / std::max<hsize_t>(1, row_bytes)));
+        if (H5Sget_simple_extent_npoints(data_space) == 0) { rows = 0; }  // The same on every rank, so no collective write is skipped by only some
+        for (hsize_t start=0; start<rows; start+=slab_rows) {
+            hsize_t slab_size = std::min(slab_rows, rows - start);
+            hid_t slab_space = H5Scopy(data_space);
+            hid_t memory_space;
+            if (dimension_count > 0) {
+                vector<hsize_t> offset(dimension_count, 0);
+                vector<hsize_t> count(dimensions.begin(), dimensions.end());
+                offset[0] = start;
+                count[0] = slab_size;
+                H5Sselect_hyperslab(slab_space, H5S_SELECT_SET, offset.data(), nullptr, count.data(), nullptr);
+                memory_space = H5Screate_simple(dimension_count, count.data(), nullptr);
+            } else {
+                memory_space = H5Screate(H5S_SCALAR);
+            }
+            if (owner) {
+                buffer.resize(std::max<hsize_t>(1, slab_size * row_bytes));
+                if (H5Dread(shard_dataset, memory_type, memory_space, slab_space, H5P_DEFAULT, buffer.data()) < 0) {
+                    this->log_file->logWarning("Unable to read " + merge_object.name + " from shard " + to_string(merge_object.shard) + ".");
+                }
+                bytes_written += slab_size * row_bytes;
+            } else {  // Takes part in the collective write without data of its own
+                H5Sselect_none(memory_space);
+                H5Sselect_none(slab_space);
+            }
+            if (H5Dwrite(merged_dataset, memory_type, memory_space, slab_space, transfer_properties, buffer.data()) < 0) {
+                this->log_file->logWarning("Unable to write " + merge_object.name + " to the merged file.");
+            }
+            H5Sclose(memory_space);
+            H5Sclose(slab_space);
+        }
+        H5Tclose(memory_type);
+        H5Tclose(data_type);
+        H5Sclose(data_space);
+        H5Dclose(shard_dataset);
+        H5Dclose(merged_dataset);
+    }
+    H5Pclose(transfer_properties);
+    return bytes_written;
+}
+
+void H5ParallelMerger::finish_objects (H5::H5File &merged_file) {
+    vector<vector<string>> shard_dataset_names(this->shard_files.size());  // Datasets whose dimension scales are attached again
+    for (const merge_object_type &merge_object : this->plan) {
+        H5::H5File &shard_file = this->shard_files[merge_object.shard];
+        if (merge_object.parallel) {
+            if (!merge_object.hard_link.empty()) { continue; }
+            copy_attributes(shard_file, merged_file, merge_object.name);
+            if (merge_object.type == H5O_TYPE_DATASET) { shard_dataset_names[merge_object.shard].push_back(merge_object.name); }
+            continue;
+        }
+        herr_t status;
+        if (merge_object.external_link) {
+            status = copy_external_link(shard_file, merge_object.name, merged_file.getId(), merge_object.name);
+        } else if (!merge_object.hard_link.empty()) {
+            status = H5Lcreate_hard(merged_file.getId(), merge_object.hard_link.c_str(), merged_file.getId(), merge_object.name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+        } else {  // Variable length data is written without MPI-IO, so the whole object is copied with its attributes
+            status = H5Ocopy(shard_file.getId(), merge_object.name.c_str(), merged_file.getId(), merge_object.name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+            if (merge_object.type == H5O_TYPE_DATASET) { shard_dataset_names[merge_object.shard].push_back(merge_object.name); }
+        }
+        if (status < 0) {
+            this->log_file->logWarning("Unable to merge " + merge_object.name + " into the merged file.");
+        }
+    }
+    for (size_t i=0; i<this->shard_files.size(); i++) {
+        reattach_scales(this->shard_files[i], merged_file, shard_dataset_names[i]);
+    }
+}
+
+void H5ParallelMerger::copy_attributes (H5::H5File &shard_file, H5::H5File &merged_file, const string &object_name) {
+    hid_t shard_object = H5Oopen(shard_file.getId(), object_name.c_str(), H5P_DEFAULT);
+    hid_t merged_object = H5Oopen(merged_file.getId(), object_name.c_str(), H5P_DEFAULT);
+    if ((shard_object >= 0) && (merged_object >= 0)) {
+        H5Aiterate2(shard_object, H5_INDEX_NAME, H5_ITER_NATIVE, nullptr, [] (hid_t location, const char* attribute_name, const H5A_info_t*, void* merged_object) -> herr_t {
+            if ((strcmp(attribute_name, "DIMENSION_LIST") == 0) || (strcmp(attribute_name, "REFERENCE_LIST") == 0)) { return 0; }
+            hid_t attribute = H5Aopen(location, attribute_name, H5P_DEFAULT);
+            hid_t data_type = H5Aget_type(attribute);
+            hid_t data_space = H5Aget_space(attribute);
+            hid_t memory_type = H5Tget_native_type(data_type, H5T_DIR_DEFAULT);
+            vector<char> buffer(std::max<size_t>(1, H5Sget_simple_extent_npoints(data_space) * H5Tget_size(memory_type)));
+            if (H5Aread(attribute, memory_type, buffer.data()) >= 0) {
+                hid_t merged_attribute = H5Acreate2(*static_cast<hid_t*>(merged_object), attribute_name, data_type, data_space, H5P_DEFAULT, H5P_DEFAULT);
+                if (merged_attribute >= 0) {
+                    H5Awrite(merged_attribute, memory_type, buffer.data());
+                    H5Aclose(merged_attribute);
+                }
+#if H5_VERSION_GE(1, 12, 0)
+                H5Treclaim(memory_type, data_space, H5P_DEFAULT, buffer.data());  // Frees the variable length strings that were read
+#else
+                H5Dvlen_reclaim(memory_type, data_space, H5P_DEFAULT, buffer.data());  // Frees the variable length strings that were read
+#endif
+            }
+            H5Tclose(memory_type);
+            H5Sclose(data_space);
+            H5Tclose(data_type);
+            H5Aclose(attribute);
+            return 0;
+        }, &merged_object);
+    } else {
+        this->log_file->logWarning("Unable to copy the attributes of " + object_name + ".");
+    }
+    if (shard_object >= 0) { H5Oclose(shard_object); }
+    if (merged_object >= 0) { H5Oclose(merged_object); }
+}
+
+void H5ParallelMerger::report_bandwidth (const long long &bytes, const double &seconds) {
+    auto megabytes_per_second = [] (const double &megabytes, const double &seconds) {
+        stringstream rate;
+        rate << std::fixed << std::setprecision(1) << megabytes / std::max(seconds, 1.0e-9);
+        return rate.str();
+    };
+    double megabytes = bytes / 1048576.0;
+    this->log_file->log("Rank " + to_string(this->rank) + " wrote " + to_string(bytes) + " bytes in " + to_string(seconds) + " seconds: " + megabytes_per_second(megabytes, seconds) + " MB/s");
+    vector<double> rank_megabytes(this->rank_count);
+    vector<double> rank_seconds(this->rank_count);
+    MPI_Gather(&megabytes, 1, MPI_DOUBLE, rank_megabytes.data(), 1, MPI_DOUBLE, 0, this->communicator);
+    MPI_Gather(&seconds, 1, MPI_DOUBLE, rank_seconds.data(), 1, MPI_DOUBLE, 0, this->communicator);
+    MPI_Allreduce(&bytes, &this->total_bytes, 1, MPI_LONG_LONG, MPI_SUM, this->communicator);
+    if (this->rank != 0) { return; }
+    for (int i=0; i<this->rank_count; i++) {
+        this->log_file->log("\tRank " + to_string(i) + " dataset copy bandwidth: " + megabytes_per_second(rank_megabytes[i], rank_seconds[i]) + " MB/s");
+    }
+}
+
+long long H5ParallelMerger::merged_bytes () const {
+    return this->total_bytes;
+}
+
+#endif  // SPADE_MPI
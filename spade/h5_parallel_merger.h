@@ -0,0 +1,120 @@
+//! An object for merging the shard files of MPI ranks into the extracted file with parallel hdf5
+
+#ifdef SPADE_MPI
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <mpi.h>
+#include "H5Cpp.h"
+
+#include "cmd_line_arguments.h"
+#include "logging.h"
+#include "h5_merger.h"
+
+#ifndef __H5_PARALLEL_MERGER_H_INCLUDED__
+#define __H5_PARALLEL_MERGER_H_INCLUDED__
+
+using namespace std;
+
+/*!
+   This class builds the extracted file from the shard files written by the ranks of an MPI run, each of which extracted
+   a disjoint set of frames. Every rank reads the layout of all of the shard files, so the ranks make the same calls when
+   they create the groups and datasets of the extracted file collectively through the MPI-IO file driver. Each rank then
+   writes the data of the datasets from its own shard, with independent or collective writes chosen by the mpi-io command
+   line argument. Parallel hdf5 doesn't write variable length data, so datasets of variable length strings, the
+   attributes, and the dimension scale attachments are added by the first rank after the file is closed collectively.
+   Objects found in more than one shard are taken from the first shard, the same as H5Merger.
+*/
+class H5ParallelMerger : public H5Merger {
+    public:
+        //! The constructor.
+        /*!
+          The constructor does all of the merging and has to be called by every rank of the communicator.
+          \param command_line_arguments CmdLineArguments object storing command line arguments
+          \param log_file Logging object for writing log messages
+          \param shard_file_names Shard files, in the order of the ranks that wrote them
+          \param communicator MPI communicator of the ranks
+        */
+        H5ParallelMerger (CmdLineArguments &command_line_arguments, Logging &log_file, const vector<string> &shard_file_names, MPI_Comm communicator);
+        //! Return the bytes of dataset data written to the extracted file by all of the ranks
+        /*!
+          \return number of bytes
+        */
+        long long merged_bytes () const;
+
+    private:
+        struct merge_object_type {  // A link of the extracted file and the object of a shard file it is made from
+            string name;  // Full path of the link, which is the same in the shard and extracted files
+            int shard;  // Index of the shard the object is taken from, which is also the rank writing its data
+            H5O_type_t type;
+            string hard_link;  // Earlier link to the same object in the shard, empty if this is the first link to it
+            bool parallel;  // False for datasets holding variable length data, which are copied after the parallel writes
+            bool external_link = false;  // Link to a partition file, made without reading the partition file
+        };
+
+        //! Add the links of a group in a shard file that aren't in the plan yet, and those of all of its sub groups
+        /*!
+          \param shard_file Open shard file
+          \param shard Index of the shard file
+          \param group_name Full path of the group
+          \param object_links Will store the first link to each object of the shard, keyed by its object identifier
+        */
+        void plan_group (H5::H5File &shard_file, const int &shard, const string &group_name, map<string, string> &object_links);
+        //! Return an identifier of an object that is the same for every link to the object in its file
+        /*!
+          \param file Open file holding the object
+          \param name Full path of a link to the object
+          \return bytes of the object address or token
+        */
+        static string object_identifier (H5::H5File &file, const string &name);
+        //! Create the groups, datasets, and hard links of the plan in the extracted file, on every rank in the same order
+        /*!
+          \param merged_file Extracted file opened by every rank with the MPI-IO file driver
+        */
+        void create_objects (H5::H5File &merged_file);
+        //! Write the data of the datasets of the plan, each rank writing those of its own shard
+        /*!
+          Datasets written collectively, which are all of them with the collective mpi-io option and the datasets with
+          filters with the independent one, are written in slabs by every rank, with the ranks not owning the dataset
+          selecting nothing. The other datasets are written by their own rank only.
+          \param merged_file Extracted file opened by every rank with the MPI-IO file driver
+          \param collective Write every dataset collectively
+          \return number of bytes written by this rank
+        */
+        long long write_datasets (H5::H5File &merged_file, const bool &collective);
+        //! Copy the attributes of the objects of the plan, the variable length datasets, and the dimension scale attachments
+        /*!
+          \param merged_file Extracted file opened by the first rank alone
+        */
+        void finish_objects (H5::H5File &merged_file);
+        //! Copy the attributes of an object in a shard file to the same object in the extracted file
+        /*!
+          The DIMENSION_LIST and REFERENCE_LIST attributes of dimension scales are skipped, since they hold references into
+          the shard file. They are made again by reattach_scales.
+          \param shard_file Open shard file
+          \param merged_file Open extracted file
+          \param object_name Full path of the object in both files
+        */
+        void copy_attributes (H5::H5File &shard_file, H5::H5File &merged_file, const string &object_name);
+        //! Log the bandwidth of the parallel dataset writes of each rank and add up the bytes written by all of the ranks
+        /*!
+          The bandwidth only covers copying the datasets from the shard files. The throughput of the whole run, including
+          the extraction of the shard files and the objects made by the first rank, is logged by the caller.
+          \param bytes Bytes written by this rank
+          \param seconds Time taken by this rank to write them
+          \sa merged_bytes()
+        */
+        void report_bandwidth (const long long &bytes, const double &seconds);
+
+        vector<H5::H5File> shard_files;
+        vector<merge_object_type> plan;
+        map<string, size_t> planned_names;  // Position of each link in the plan
+        MPI_Comm communicator;
+        int rank;
+        int rank_count;
+        long long total_bytes = 0;  // Bytes written by all of the ranks
+};
+#endif  // __H5_PARALLEL_MERGER_H_INCLUDED__
+#endif  // SPADE_MPI
@@ -0,0 +1,97 @@
+#include <iostream>
+#include <string>
+#include <fstream>
+
+#include "H5Cpp.h"
+
+#include <h5_writer.h>
+
+using namespace std;
+
+H5Writer::H5Writer (Logging &log_file, const size_t &buffer_bytes) {
+    this->log_file = &log_file;
+    this->buffer_bytes = buffer_bytes;
+    this->queued_bytes = 0;
+    this->writer_busy = false;
+    this->stopping = false;
+    this->task_failed = false;
+    if (this->buffer_bytes > 0) {
+        this->writer_thread = thread(&H5Writer::run, this);
+        this->log_file->logDebug("Started hdf5 writer thread with a " + to_string(this->buffer_bytes) + " byte buffer.");
+    }
+}
+
+H5Writer::~H5Writer () {
+    if (this->writer_thread.joinable()) {
+        {
+            lock_guard<mutex> lock(this->queue_mutex);
+            this->stopping = true;
+        }
+        this->task_available.notify_one();
+        this->writer_thread.join();
+    }
+}
+
+void H5Writer::enqueue (function<void()> task, const size_t &task_bytes) {
+    if (!this->writer_thread.joinable()) {  // Serial behavior
+        task();
+        return;
+    }
+    {
+        unique_lock<mutex> lock(this->queue_mutex);
+        this->space_available.wait(lock, [this, &task_bytes] {
+            return (this->task_exception) || (this->tasks.empty()) || (this->queued_bytes + task_bytes <= this->buffer_bytes);
+        });
+        this->rethrow_task_exception();
+        this->tasks.emplace_back(std::move(task), task_bytes);
+        this->queued_bytes += task_bytes;
+    }
+    this->task_available.notify_one();
+}
+
+void H5Writer::finish () {
+    if (!this->writer_thread.joinable()) { return; }
+    unique_lock<mutex> lock(this->queue_mutex);
+    this->space_available.wait(lock, [this] { return (this->tasks.empty()) && (!this->writer_busy); });
+    this->rethrow_task_exception();
+}
+
+void H5Writer::run () {
+    H5::Exception::dontPrint();  // Thread-safe hdf5 keeps the automatic error printing of each thread apart
+    while (true) {
+        pair<function<void()>, size_t> task;
+        {
+            unique_lock<mutex> lock(this->queue_mutex);
+            this->task_available.wait(lock, [this] { return (this->stopping) || (!this->tasks.empty()); });
+            if (this->tasks.empty()) { return; }  // Only stop once all the tasks have been written
+            task = std::move(this->tasks.front());
+            this->tasks.pop_front();
+            this->writer_busy = true;
+        }
+        if (!this->task_failed) {  // Skip the remaining writes after a failure
+            try {
+                task.first();
+            } catch (...) {
+                lock_guard<mutex> lock(this->queue_mutex);
+                this->task_exception = current_exception();
+                this->task_failed = true;
+            }
+        }
+        task.first = nullptr;  // Release the data owned by the task before freeing up the budget
+        {
+            lock_guard<mutex> lock(this->queue_mutex);
+            this->queued_bytes -= task.second;
+            this->writer_busy = false;
+        }
+        this->space_available.notify_all();
+    }
+}
+
+void H5Writer::rethrow_task_exception () {
+    // Called with queue_mutex held
+    if (this->task_exception) {
+        exception_ptr task_exception = this->task_exception;
+        this->task_exception = nullptr;
+        rethrow_exception(task_exception);
+    }
+}
@@ -0,0 +1,72 @@
+//! An object for writing hdf5 data on a dedicated thread
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "logging.h"
+
+#ifndef __H5_WRITER_H_INCLUDED__
+#define __H5_WRITER_H_INCLUDED__
+
+using namespace std;
+
+/*!
+   This class runs hdf5 write tasks on a single writer thread so that reading the odb and writing the hdf5 file can happen
+   at the same time. Tasks are run in the order they are enqueued. The amount of data held by queued tasks is capped by a
+   memory budget, and the code enqueueing tasks waits while the budget is used up. A budget of zero runs every task
+   immediately on the calling thread, which is the serial behavior.
+
+   While the writer thread is running it must be the only thread using the hdf5 library.
+*/
+class H5Writer {
+    public:
+        //! The constructor.
+        /*!
+          The constructor starts the writer thread if the memory budget is larger than zero.
+          \param log_file Logging object for writing log messages
+          \param buffer_bytes maximum number of bytes held by tasks waiting in the queue, zero to write serially
+        */
+        H5Writer (Logging &log_file, const size_t &buffer_bytes);
+        //! The destructor.
+        /*!
+          The destructor runs any remaining tasks and stops the writer thread.
+        */
+        ~H5Writer ();
+        //! Add a write task to the queue.
+        /*!
+          Add a task to the end of the queue, waiting until enough of the memory budget is free to hold it. A task larger
+          than the whole budget is accepted once the queue is empty. If a previous task threw an exception, it is rethrown here.
+          \param task function performing the hdf5 writes, it must own all the data it writes
+          \param task_bytes approximate number of bytes of data owned by the task
+        */
+        void enqueue (function<void()> task, const size_t &task_bytes);
+        //! Wait for all queued tasks to finish.
+        /*!
+          Block until the queue is empty and the writer thread is idle. If a task threw an exception, it is rethrown here.
+        */
+        void finish ();
+
+    private:
+        //! Main loop of the writer thread.
+        void run ();
+        //! Rethrow an exception caught on the writer thread.
+        void rethrow_task_exception ();
+
+        Logging* log_file;
+        size_t buffer_bytes;
+        size_t queued_bytes;
+        bool writer_busy;
+        bool stopping;
+        bool task_failed;  // Only read and written by the writer thread
+        deque<pair<function<void()>, size_t>> tasks;
+        exception_ptr task_exception;
+        mutex queue_mutex;
+        condition_variable task_available;
+        condition_variable space_available;
+        thread writer_thread;
+};
+#endif  // __H5_WRITER_H_INCLUDED__
@@ -6,11 +6,48 @@
 #include <cstring>
 #include <cstdlib>
 #include <ctime>
+#include <mutex>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#ifdef SPADE_MPI
+    #include <mpi.h>
+#endif
 
 #include <logging.h>
 
 using namespace std;
 
+namespace {
+
+thread_local int span_depth = 0;  // Spans open on this thread, used to indent nested spans
+std::atomic<int> thread_count(0);
+thread_local int thread_number = ++thread_count;  // Trace event thread id, numbered in the order the threads start their first span
+const size_t profile_batch_events = 4096;  // Trace events kept before they're written to the profile file
+
+//! Quote a string for a JSON file
+string json_string (string const &value) {
+    stringstream quoted;
+    quoted << '"';
+    for (const char character : value) {
+        switch (character) {
+            case '"': quoted << "\\\""; break;
+            case '\\': quoted << "\\\\"; break;
+            case '\n': quoted << "\\n"; break;
+            case '\t': quoted << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(character) < 0x20) {
+                    quoted << "\\u" << hex << setw(4) << setfill('0') << static_cast<int>(character) << dec;
+                } else { quoted << character; }
+        }
+    }
+    quoted << '"';
+    return quoted.str();
+}
+
+}  // namespace
+
 Logging::Logging (string const &log_file_name, bool const &log_verbose, bool const &log_debug) {
     this->log_file.open(log_file_name.c_str());
     if (!this->log_file.is_open()) {
@@ -23,25 +60,159 @@ Logging::Logging (string const &log_file_name, bool const &log_verbose, bool con
     this->log_debug = log_debug;
     this->log_verbose = log_verbose;
     if (log_debug) { this->log_verbose = true; }  // Print verbose output as well if debug output has been specified
+    this->start_time = std::chrono::steady_clock::now();
+    this->running = true;
+    this->logging_thread = thread(&Logging::write_messages, this);
 }
 
 Logging::~Logging () {
+    this->stop();
+    this->write_profile();
     time_t now = time(0);
     char* dt = ctime(&now);
     *this->output_stream << "Finished at time: " << dt << endl;
     if (this->log_file.is_open()) { this->log_file.close(); }
 }
 
-void Logging::log (string const &output) { *this->output_stream << output << endl; }
-void Logging::logVerbose (string const &output) { if (this->log_verbose) { *this->output_stream << output << endl; } }
-void Logging::logWarning (string const &output) { *this->output_stream << "WARNING: " << output << endl;  }
-void Logging::logDebug (string const &output) { if (this->log_debug) { *this->output_stream << output << endl; } }
+void Logging::log (string const &output) { this->enqueue(string(output)); }
+void Logging::logVerbose (string const &output) { if (this->log_verbose) { this->enqueue(string(output)); } }
+void Logging::logWarning (string const &output) { this->enqueue("WARNING: " + output); }
+void Logging::logDebug (string const &output) { if (this->log_debug) { this->enqueue(string(output)); } }
+bool Logging::debug () const { return this->log_debug; }
+
+void Logging::profile (string const &profile_file_name) {
+    this->profile_file.open(profile_file_name);
+    if (!this->profile_file.is_open()) {
+        this->logWarning("Couldn't open: " + profile_file_name + " The profile won't be written.");
+        return;
+    }
+    this->profile_file << "{\"traceEvents\":[\n";
+    this->profile_file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"spade\"}}";
+    this->profile_file_name = profile_file_name;
+}
+
+bool Logging::profiling () const { return !this->profile_file_name.empty(); }
 
 void Logging::logErrorAndExit (string const &output) {
-    *this->output_stream << output << endl;
+    this->enqueue(string(output));
+    this->stop();
+    this->write_profile();  // The spans up to the error can show where it happened
     time_t now = time(0);
     char* dt = ctime(&now);
     *this->output_stream << "Exited with error at: " << dt << endl;
     if (this->log_file.is_open()) { this->log_file.close(); }
+#ifdef SPADE_MPI
+    int mpi_initialized = 0;
+    MPI_Initialized(&mpi_initialized);
+    if (mpi_initialized) {  // Callers may catch the exception and go on, while the other ranks wait on this one forever
+        cerr << output << endl;
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+#endif
     throw std::runtime_error(output);
 }
+
+void Logging::enqueue (string &&output) {
+    unique_lock<mutex> lock(this->output_mutex);
+    if (!this->running) {  // The logging thread has stopped, so write the message here
+        *this->output_stream << output << '\n';
+        return;
+    }
+    bool was_empty = this->queued_messages.empty();
+    this->queued_messages.push_back(std::move(output));
+    lock.unlock();
+    if (was_empty) { this->messages_queued.notify_one(); }  // The logging thread only waits when the queue is empty
+}
+
+void Logging::write_messages () {
+    vector<string> messages;
+    while (true) {
+        {
+            unique_lock<mutex> lock(this->output_mutex);
+            this->messages_queued.wait(lock, [this] { return (!this->running) || (!this->queued_messages.empty()); });
+            if ((!this->running) && (this->queued_messages.empty())) { return; }
+            messages.swap(this->queued_messages);  // Take the whole queue, so writing doesn't hold up the code logging
+        }
+        for (const string &message : messages) { *this->output_stream << message << '\n'; }
+        this->output_stream->flush();  // Flush once per batch instead of once per message
+        messages.clear();
+    }
+}
+
+void Logging::stop () {
+    {
+        lock_guard<mutex> lock(this->output_mutex);
+        if (!this->running) { return; }
+        this->running = false;
+    }
+    this->messages_queued.notify_one();
+    this->logging_thread.join();  // The thread writes the remaining messages before it returns
+    this->output_stream->flush();
+}
+
+void Logging::record (string &&event) {
+    lock_guard<mutex> lock(this->profile_mutex);
+    this->profile_events.push_back(std::move(event));
+    if (this->profile_events.size() >= profile_batch_events) { this->flush_profile(); }
+}
+
+void Logging::flush_profile () {
+    for (const string &event : this->profile_events) { this->profile_file << ",\n" << event; }
+    this->profile_event_count += this->profile_events.size();
+    this->profile_events.clear();
+}
+
+void Logging::write_profile () {
+    if (this->profile_file_name.empty()) { return; }
+    lock_guard<mutex> lock(this->profile_mutex);
+    this->flush_profile();
+    this->profile_file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    this->profile_file.close();
+    *this->output_stream << "Wrote " << this->profile_event_count << " spans to profile file: " << this->profile_file_name << endl;
+    this->profile_file_name.clear();  // Only written once, even if the log is closed after an error
+}
+
+Logging::Span::Span (Logging &log_file, const char* name) {
+    this->log_file = &log_file;
+    this->timed = (log_file.debug()) || (log_file.profiling());
+    if (!this->timed) { return; }
+    this->name = name;
+    this->thread = thread_number;
+    this->start = std::chrono::steady_clock::now();
+    span_depth++;
+}
+
+Logging::Span::~Span () {
+    if (!this->timed) { return; }
+    span_depth--;
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    if (this->log_file->debug()) {
+        double start_seconds = std::chrono::duration<double>(this->start - this->log_file->start_time).count();
+        double duration_seconds = std::chrono::duration<double>(end - this->start).count();
+        stringstream message;
+        message << string(span_depth, '\t') << "Span " << this->name << " started at " << fixed << setprecision(6) << start_seconds << " s and took " << duration_seconds << " s";
+        this->log_file->enqueue(message.str());
+    }
+    if (this->log_file->profiling()) {
+        double start_microseconds = std::chrono::duration<double, std::micro>(this->start - this->log_file->start_time).count();
+        double duration_microseconds = std::chrono::duration<double, std::micro>(end - this->start).count();
+        stringstream event;
+        event << "{\"name\":" << json_string(this->name) << ",\"cat\":\"spade\",\"ph\":\"X\",\"ts\":" << fixed << setprecision(3) << start_microseconds;
+        event << ",\"dur\":" << duration_microseconds << ",\"pid\":1,\"tid\":" << this->thread << ",\"args\":{" << this->arguments << "}}";
+        this->log_file->record(event.str());
+    }
+}
+
+bool Logging::Span::active () const { return this->timed; }
+
+void Logging::Span::add (string const &key, long long const &value) {
+    if (!this->timed) { return; }
+    if (!this->arguments.empty()) { this->arguments += ","; }
+    this->arguments += json_string(key) + ":" + to_string(value);
+}
+
+void Logging::Span::add (string const &key, string const &value) {
+    if (!this->timed) { return; }
+    if (!this->arguments.empty()) { this->arguments += ","; }
+    this->arguments += json_string(key) + ":" + json_string(value);
+}
@@ -3,10 +3,23 @@
 #ifndef __LOGGING_H_INCLUDED__
 #define __LOGGING_H_INCLUDED__
 
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
 using namespace std;
 
 /*!
    This class handles the log file. The constructor creates the log file, the destructor closes it, and other functions write to it.
+   Messages are queued and written by a logging thread, so logging doesn't wait on the file. The verbose and debug functions
+   also take a function returning the message, which is only called when that level of logging is turned on, so messages in
+   loops over large models aren't built when they won't be written. With a profile file given, the spans are also written
+   to it as a Chrome trace event file, in batches while the code runs and the rest when the log is closed.
 */
 class Logging {
     public:
@@ -34,6 +47,12 @@ class Logging {
           \param output string containing the log message
         */
         void logVerbose (string const &output);
+        //! Function for logging verbose messages built on demand
+        /*!
+          \param make_output function returning the log message, only called if the verbose option is used
+        */
+        template <typename MessageFunction, typename = enable_if_t<is_invocable_r_v<string, MessageFunction>>>
+        void logVerbose (MessageFunction const &make_output) { if (this->log_verbose) { this->enqueue(make_output()); } }
         //! Function for logging a warning message
         /*!
           If something unextpected occurs, but execution may continue, the word 'WARNING' will be prepended to the log message
@@ -42,17 +61,96 @@ class Logging {
         void logWarning (string const &output);
         // logDebug is for debugging and therefore there is no API documentation for it
         void logDebug (string const &output);
+        template <typename MessageFunction, typename = enable_if_t<is_invocable_r_v<string, MessageFunction>>>
+        void logDebug (MessageFunction const &make_output) { if (this->log_debug) { this->enqueue(make_output()); } }
+        //! Return the value of the debug flag
+        bool debug () const;
+        //! Record the spans and write them to a profile file when the log is closed
+        /*!
+          The profile file holds Chrome trace events, which can be opened with Perfetto or chrome://tracing.
+          \param profile_file_name string containing the name of the profile file
+        */
+        void profile (string const &profile_file_name);
+        //! Return whether the spans are recorded for a profile file
+        bool profiling () const;
         //! Function for logging an error message and exiting the code.
         /*!
           If a fatal error is reached, i.e. code execution cannot successfully continue, this function will be used to log a message and exit the execution of the program.
+          Built with MPI, every rank of the run is aborted instead of only this one.
           \param output string containing the log message
         */
         void logErrorAndExit (string const &output);
 
+        /*!
+           A span times the code from its construction to the end of its scope. With debug logging turned on the name of
+           the span, its start time since the log was opened, and its duration are logged when it ends, indented by the
+           number of spans it is nested in on the same thread. With a profile file the span is recorded as a trace event,
+           with the arguments added to it. With neither a span does nothing.
+        */
+        class Span {
+            public:
+                //! The constructor starts the span
+                /*!
+                  \param log_file Logging object the span is logged to
+                  \param name Name of the timed code, a string literal that is only copied when the span is logged or recorded
+                */
+                Span (Logging &log_file, const char* name);
+                //! The destructor ends the span and logs it
+                ~Span ();
+                Span (const Span&) = delete;
+                Span& operator= (const Span&) = delete;
+                //! Return whether the span is timed, so arguments that are costly to find can be skipped when it isn't
+                bool active () const;
+                //! Add a count, e.g. of bytes or elements, to the arguments of the trace event
+                /*!
+                  \param key Name of the argument
+                  \param value Value of the argument
+                */
+                void add (string const &key, long long const &value);
+                //! Add a name, e.g. of a dataset, to the arguments of the trace event
+                /*!
+                  \param key Name of the argument
+                  \param value Value of the argument
+                */
+                void add (string const &key, string const &value);
+
+            private:
+                Logging* log_file;
+                bool timed;
+                int thread;
+                const char* name;
+                string arguments;  // JSON members of the trace event arguments
+                std::chrono::steady_clock::time_point start;
+        };
+
     private:
+        //! Hand a message to the logging thread
+        void enqueue (string &&output);
+        //! Write the queued messages until the logger stops
+        void write_messages ();
+        //! Write the remaining messages and stop the logging thread
+        void stop ();
+        //! Keep a trace event for the profile file, writing the kept events to it once there are enough of them
+        void record (string &&event);
+        //! Write the kept trace events to the profile file, called with the profile mutex held
+        void flush_profile ();
+        //! Write the remaining trace events to the profile file and close it
+        void write_profile ();
+
         bool log_verbose;
         bool log_debug;
         std::ofstream log_file;
         std::ostream* output_stream;
+        std::chrono::steady_clock::time_point start_time;
+        std::mutex output_mutex;  // Messages may come from both the odb reading thread and the hdf5 writer thread
+        std::condition_variable messages_queued;
+        vector<string> queued_messages;
+        bool running = false;
+        std::thread logging_thread;
+        string profile_file_name;
+        std::mutex profile_mutex;  // Spans end on both the odb reading thread and the hdf5 writer thread
+        std::ofstream profile_file;
+        vector<string> profile_events;  // Trace events not yet written to the profile file
+        size_t profile_event_count = 0;  // Trace events written to the profile file
 };
 #endif  // __LOGGING_H_INCLUDED__
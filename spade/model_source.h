@@ -0,0 +1,65 @@
+//! An interface for reading the frames and field outputs of a model, from an odb file or something else
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "spade_types.h"
+
+#ifndef __MODEL_SOURCE_H_INCLUDED__
+#define __MODEL_SOURCE_H_INCLUDED__
+
+using namespace std;
+
+/*!
+   A model source hands the writers of the extracted file the frames and field outputs of the steps as the same data
+   types whether they are read from an odb file or generated, e.g. by a synthetic model for benchmarking, so the frames of
+   every source go through the same selection, invariant computation, and hdf5 writes. The data is read one frame and one
+   field output at a time, and a field output one bulk data block at a time.
+*/
+class ModelSource {
+    public:
+        virtual ~ModelSource () = default;
+        //! Return the names of the steps in the order they were run
+        /*!
+          \return names of the steps
+        */
+        virtual vector<string> step_names () = 0;
+        //! Return the total time at the start of a step
+        /*!
+          \param step_name Name of the step
+          \return sum of the time periods of the steps before it
+        */
+        virtual double step_total_time (const string &step_name) = 0;
+        //! Return the number of frames in a step
+        /*!
+          \param step_name Name of the step
+          \return number of frames
+        */
+        virtual int frame_count (const string &step_name) = 0;
+        //! Read the data describing a frame
+        /*!
+          \param step_name Name of the step
+          \param frame_number Number of the frame in the step, starting at zero
+          \return frame_type
+        */
+        virtual frame_type read_frame (const string &step_name, const int &frame_number) = 0;
+        //! Return the names of the field outputs in a frame
+        /*!
+          \param step_name Name of the step
+          \param frame_number Number of the frame in the step, starting at zero
+          \return names of the field outputs
+        */
+        virtual vector<string> field_output_names (const string &step_name, const int &frame_number) = 0;
+        //! Read a field output of a frame one bulk data block at a time
+        /*!
+          \param step_name Name of the step
+          \param frame_number Number of the frame in the step, starting at zero
+          \param field_output_name Name of the field output
+          \param read_instance Returns whether the data of an instance is read, the bulk data blocks of other instances are skipped without reading them
+          \param add_block Called after each bulk data block is added to the end of the bulkValues of the field output, it may take the blocks with SpadeObject::split_field_output()
+          \return field_output_type with the blocks add_block didn't take
+        */
+        virtual field_output_type read_field_output (const string &step_name, const int &frame_number, const string &field_output_name, const function<bool(const string&)> &read_instance, const function<void(field_output_type&)> &add_block) = 0;
+};
+#endif  // __MODEL_SOURCE_H_INCLUDED__
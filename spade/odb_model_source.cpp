@@ -0,0 +1,385 @@
+#include <cmath>
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <odb_API.h>
+
+#include <odb_model_source.h>
+
+using namespace std;
+
+OdbModelSource::OdbModelSource (odb_Odb &odb, const string &default_instance_name, const bool &read_field_values, Logging &log_file) {
+    this->odb = &odb;
+    this->default_instance_name = default_instance_name;
+    this->read_field_values = read_field_values;
+    this->log_file = &log_file;
+}
+
+vector<string> OdbModelSource::step_names () {
+    vector<string> names;
+    odb_StepRepositoryIT step_iter (this->odb->steps());
+    for (step_iter.first(); !step_iter.isDone(); step_iter.next()) { names.push_back(step_iter.currentKey().CStr()); }
+    return names;
+}
+
+double OdbModelSource::step_total_time (const string &step_name) {
+    return this->odb->steps()[step_name.c_str()].totalTime();
+}
+
+const odb_SequenceFrame& OdbModelSource::step_frames (const string &step_name) {
+    return this->odb->steps()[step_name.c_str()].frames();
+}
+
+int OdbModelSource::frame_count (const string &step_name) {
+    return step_frames(step_name).size();
+}
+
+frame_type OdbModelSource::read_frame (const string &step_name, const int &frame_number) {
+    return process_frame(step_frames(step_name).constGet(frame_number), frame_number);
+}
+
+vector<string> OdbModelSource::field_output_names (const string &step_name, const int &frame_number) {
+    vector<string> names;
+    odb_FieldOutputRepositoryIT field_outputs_iterator(step_frames(step_name).constGet(frame_number).fieldOutputs());
+    for (field_outputs_iterator.first(); !field_outputs_iterator.isDone(); field_outputs_iterator.next()) {
+        names.push_back(field_outputs_iterator.currentKey().CStr());
+    }
+    return names;
+}
+
+field_output_type OdbModelSource::read_field_output (const string &step_name, const int &frame_number, const string &field_output_name, const function<bool(const string&)> &read_instance, const function<void(field_output_type&)> &add_block) {
+    const odb_FieldOutput& field_output = step_frames(step_name).constGet(frame_number).fieldOutputs()[field_output_name.c_str()];
+    field_output_type new_field_output;
+    new_field_output.name = field_output.name().CStr();
+    new_field_output.description = field_output.description().CStr();
+    new_field_output.type = get_field_type_enum(field_output.type());
+    new_field_output.dim = field_output.dim();
+    new_field_output.dim2 = field_output.dim2();
+    new_field_output.isComplex = field_output.isComplex();
+    new_field_output.engineeringShear = engineering_shear(new_field_output.name, new_field_output.type);
+    new_field_output.writeMetadata = true;
+    new_field_output.maxWidth = 0;
+    new_field_output.maxLength = 0;
+
+    odb_SequenceString available_components = field_output.componentLabels();
+    for (int i=0; i<available_components.size(); i++) {
+        new_field_output.componentLabels.push_back(available_components[i].CStr());
+    }
+    for (int i=0; i<field_output.validInvariants().size(); i++) {
+        new_field_output.validInvariants.push_back(get_valid_invariant_enum(field_output.validInvariants().constGet(i)));
+    }
+
+    odb_SequenceFieldLocation field_locations = field_output.locations();
+    for (int i=0; i<field_locations.size(); i++) {
+        odb_FieldLocation field_location = field_locations.constGet(i);
+        field_location_type new_field_location;
+        new_field_location.position = get_position_enum(field_location.position());
+        for (int j=0; j<field_location.sectionPoint().size(); j++) {
+            section_point_type section_point;
+            section_point.number = to_string(field_location.sectionPoint(j).number());
+            section_point.description = field_location.sectionPoint(j).description().CStr();
+            new_field_location.sectionPoint.push_back(section_point);
+        }
+        new_field_output.locations.push_back(new_field_location);
+    }
+
+    odb_SequenceFieldValue field_values = field_output.values();
+    set<string> instance_names;
+    bool write_mises = false;
+    if (field_output.validInvariants().size() > 0) {
+        for (int i=0; (this->read_field_values) && (i<field_values.size()); i++) {  // Reading each field value is slow, so skip it unless asked for
+            odb_FieldValue field_value  = field_values.constGet(i);
+            string instance_name = field_value.instance().name().CStr();
+            if (instance_name.empty()) { instance_name = this->default_instance_name; }
+            if (instance_names.find(instance_name) == instance_names.end()) {
+                field_value_type &values = new_field_output.values[instance_name];
+                values.magnitudeEmpty = true;
+                values.trescaEmpty = true;
+                values.pressEmpty = true;
+                values.inv3Empty = true;
+                values.maxPrincipalEmpty = true;
+                values.midPrincipalEmpty = true;
+                values.minPrincipalEmpty = true;
+                values.maxInPlanePrincipalEmpty = true;
+                values.minInPlanePrincipalEmpty = true;
+                values.outOfPlanePrincipalEmpty = true;
+                values.elementEmpty = true;
+                values.nodeEmpty = true;
+                values.integrationPointEmpty = true;
+                values.typeEmpty = true;
+                values.sectionPointNumberEmpty = true;
+                values.sectionPointDescriptionEmpty = true;
+                instance_names.insert(instance_name);
+            }
+            process_field_values(field_value, field_output.validInvariants(), new_field_output.values[instance_name]);
+        }
+        if (field_output.validInvariants().isMember(odb_Enum::MISES)) {
+            write_mises = true;
+        }
+    }
+
+    set<string> field_data_names;
+    const odb_SequenceFieldBulkData& field_bulk_values = field_output.bulkDataBlocks();
+    this->log_file->logDebug("Reading " + to_string(field_bulk_values.size()) + " blocks of bulk field output data for " + new_field_output.name);
+    for (int i=0; i<field_bulk_values.size(); i++) {  // There seems to be a "block" per element type and if the element type is the same per section point
+                                                    // e.g. In one odb the "E" field values had three "blocks" One for element type B23 (section point 1)
+                                                    // one for element type B23 (section point 5), and one for element type GAPUNI
+        const odb_FieldBulkData& field_bulk_value = field_bulk_values[i];
+
+        // Skip instance if 'all' not specified and instance doesn't match user input
+        string instance_name = field_bulk_value.instance().name().CStr();
+        bool instance_value_exists = false;
+        if (instance_names.find(instance_name) != instance_names.end()) {
+            instance_names.erase(instance_name);  // Remove from set to indicate it has already been processed
+            instance_value_exists = true;
+        }
+        bool assembly_data = instance_name.empty();
+        if (assembly_data) { instance_name = this->default_instance_name; }
+        if (!read_instance(instance_name)) { continue; }
+
+        // Get name of group where to write data
+        string data_name = field_bulk_value.baseElementType().CStr();
+        if (data_name.empty()) {
+            data_name = get_position_enum(field_bulk_value.position());
+        }
+        if (field_data_names.find(data_name) != field_data_names.end()) {  // If this name already exists, append the index to it
+            data_name = data_name + "_" + to_string(i);   // It would be nice to append the section point number to it, but I'm not sure how to do that reliably
+        }
+        field_data_names.insert(data_name);
+
+        if (field_bulk_value.width() > new_field_output.maxWidth) {  new_field_output.maxWidth = field_bulk_value.width(); }
+        if (field_bulk_value.length() > new_field_output.maxLength) {  new_field_output.maxLength = field_bulk_value.length(); }
+
+        this->log_file->logDebug([&] { return "Read field bulk data " + data_name; });
+        Logging::Span block_span(*this->log_file, "bulk block");
+        field_bulk_type new_field_bulk = process_field_bulk_data(field_bulk_value, new_field_output.isComplex, write_mises);
+        new_field_bulk.instanceName = instance_name;
+        new_field_bulk.dataName = data_name;
+        new_field_bulk.assemblyData = assembly_data;
+        new_field_bulk.writeFieldValues = instance_value_exists;
+        if (block_span.active()) {
+            block_span.add("instance", instance_name);
+            block_span.add("block", data_name);
+            block_span.add("elements", new_field_bulk.numberOfElements);
+            block_span.add("values", new_field_bulk.length);
+        }
+        new_field_output.bulkValues.push_back(std::move(new_field_bulk));
+        add_block(new_field_output);
+    }
+
+    // Instances with field values but no bulk data are written after the bulk data
+    for (const string& instance_name : instance_names) {
+        if (read_instance(instance_name)) { new_field_output.remainingInstances.insert(instance_name); }
+    }
+    return new_field_output;
+}
+
+field_bulk_type OdbModelSource::process_field_bulk_data (const odb_FieldBulkData &field_bulk_data, bool complex_data, bool write_mises) {
+    field_bulk_type new_field_bulk;
+    new_field_bulk.position = get_position_enum(field_bulk_data.position());
+    new_field_bulk.precision = (field_bulk_data.precision() == odb_Enum::SINGLE_PRECISION) ? "Single Precision" : "Double Precision";
+    new_field_bulk.orientationWidth = field_bulk_data.orientationWidth();
+    new_field_bulk.numberOfElements = field_bulk_data.numberOfElements();
+    new_field_bulk.length = field_bulk_data.length();
+    new_field_bulk.valuesPerElement = field_bulk_data.valuesPerElement();
+    new_field_bulk.width = field_bulk_data.width();
+    new_field_bulk.baseElementType = field_bulk_data.baseElementType().CStr();
+    new_field_bulk.emptyFaces = true;
+    odb_SequenceString component_labels = field_bulk_data.componentLabels();
+    for (int i=0; i<component_labels.size(); i++) {  // Usually just around 4 labels or less
+        new_field_bulk.componentLabels.push_back(component_labels[i].CStr());
+    }
+
+    // The odb owns the bulk data arrays, so they are copied to let the hdf5 writer thread use them after the odb moves on
+    int length = new_field_bulk.length;
+    int data_length = length * new_field_bulk.width;
+    bool single_precision = (field_bulk_data.precision() == odb_Enum::SINGLE_PRECISION);
+    if ((single_precision) && (field_bulk_data.data())) {
+        new_field_bulk.data.assign(field_bulk_data.data(), field_bulk_data.data() + data_length);
+        if ((complex_data) && (field_bulk_data.conjugateData())) {
+            new_field_bulk.conjugateData.assign(field_bulk_data.conjugateData(), field_bulk_data.conjugateData() + data_length);
+        }
+    } else if ((!single_precision) && (field_bulk_data.dataDouble())) {
+        new_field_bulk.dataDouble.assign(field_bulk_data.dataDouble(), field_bulk_data.dataDouble() + data_length);
+        if ((complex_data) && (field_bulk_data.conjugateDataDouble())) {
+            new_field_bulk.conjugateDataDouble.assign(field_bulk_data.conjugateDataDouble(), field_bulk_data.conjugateDataDouble() + data_length);
+        }
+    }
+
+    if(field_bulk_data.numberOfElements() && field_bulk_data.elementLabels()) { // If elements
+        new_field_bulk.elementLabels.assign(field_bulk_data.elementLabels(), field_bulk_data.elementLabels() + length);
+        if (field_bulk_data.integrationPoints()) {
+            new_field_bulk.integrationPoints.assign(field_bulk_data.integrationPoints(), field_bulk_data.integrationPoints() + length);
+        }
+        if ((write_mises) && (field_bulk_data.mises())) {
+            new_field_bulk.mises.assign(field_bulk_data.mises(), field_bulk_data.mises() + length);
+        }
+        int coord_length = length * field_bulk_data.orientationWidth();
+        if ((single_precision) && (field_bulk_data.localCoordSystem()) && (coord_length)) {
+            new_field_bulk.localCoordSystem.assign(field_bulk_data.localCoordSystem(), field_bulk_data.localCoordSystem() + coord_length);
+        } else if ((!single_precision) && (field_bulk_data.localCoordSystemDouble()) && (coord_length)) {
+            new_field_bulk.localCoordSystemDouble.assign(field_bulk_data.localCoordSystemDouble(), field_bulk_data.localCoordSystemDouble() + coord_length);
+        }
+        odb_Enum::odb_ElementFaceEnum* faces = field_bulk_data.faces();
+        if (faces) {
+            new_field_bulk.emptyFaces = false;
+            new_field_bulk.faces.reserve(length);
+            for (int i=0; i<length; i++) { new_field_bulk.faces.push_back(face_enum_value(faces[i])); }
+        }
+    } else if (field_bulk_data.nodeLabels()) {  // Nodes
+        new_field_bulk.nodeLabels.assign(field_bulk_data.nodeLabels(), field_bulk_data.nodeLabels() + length);
+    }
+    return new_field_bulk;
+}
+
+void OdbModelSource::process_field_values (const odb_FieldValue &field_value, const odb_SequenceInvariant& invariants, field_value_type &values) {
+    int elementLabel = field_value.elementLabel();
+    if (elementLabel != -1) {
+        values.elementEmpty = false;
+    }
+    values.elementLabel.push_back(elementLabel);
+    int nodeLabel = field_value.nodeLabel();
+    if (nodeLabel != -1) {
+        values.nodeEmpty = false;
+    }
+    values.nodeLabel.push_back(nodeLabel);
+    int integrationPoint = field_value.integrationPoint();
+    if (integrationPoint != -1) {
+        values.integrationPointEmpty = false;
+    }
+    values.integrationPoint.push_back(integrationPoint);
+    signed char type_code = get_field_type_code(field_value.type());
+    values.type.push_back(type_code);
+    if (type_code) { values.typeEmpty = false; }
+    if ((invariants.isMember(odb_Enum::MAGNITUDE)) && (field_value.magnitude() != 0)) {
+        values.magnitude.push_back(field_value.magnitude());
+        values.magnitudeEmpty = false;
+    } else { values.magnitude.push_back(NAN); }
+    if ((invariants.isMember(odb_Enum::TRESCA)) && (field_value.tresca() != 0)) {
+        values.tresca.push_back(field_value.tresca());
+        values.trescaEmpty = false;
+    } else { values.tresca.push_back(NAN); }
+    if ((invariants.isMember(odb_Enum::PRESS)) && (field_value.press() != 0)) {
+        values.press.push_back(field_value.press());
+        values.pressEmpty = false;
+    } else { values.press.push_back(NAN); }
+    if ((invariants.isMember(odb_Enum::INV3)) && (field_value.inv3() != 0)) {
+        values.inv3.push_back(field_value.inv3());
+        values.inv3Empty = false;
+    } else { values.inv3.push_back(NAN); }
+    if ((invariants.isMember(odb_Enum::MAX_PRINCIPAL)) && (field_value.maxPrincipal() != 0)) {
+        values.maxPrincipal.push_back(field_value.maxPrincipal());
+        values.maxPrincipalEmpty = false;
+    } else { values.maxPrincipal.push_back(NAN); }
+    if ((invariants.isMember(odb_Enum::MID_PRINCIPAL)) && (field_value.midPrincipal() != 0)) {
+        values.midPrincipal.push_back(field_value.midPrincipal());
+        values.midPrincipalEmpty = false;
+    } else { values.midPrincipal.push_back(NAN); }
+    if ((invariants.isMember(odb_Enum::MIN_PRINCIPAL)) && (field_value.minPrincipal() != 0)) {
+        values.minPrincipal.push_back(field_value.minPrincipal());
+        values.minPrincipalEmpty = false;
+    } else { values.minPrincipal.push_back(NAN); }
+    if ((invariants.isMember(odb_Enum::MAX_INPLANE_PRINCIPAL)) && (field_value.maxInPlanePrincipal() != 0)) {
+        values.maxInPlanePrincipal.push_back(field_value.maxInPlanePrincipal());
+        values.maxInPlanePrincipalEmpty = false;
+    } else { values.maxInPlanePrincipal.push_back(NAN); }
+    if ((invariants.isMember(odb_Enum::MIN_INPLANE_PRINCIPAL)) && (field_value.minInPlanePrincipal() != 0)) {
+        values.minInPlanePrincipal.push_back(field_value.minInPlanePrincipal());
+        values.minInPlanePrincipalEmpty = false;
+    } else { values.minInPlanePrincipal.push_back(NAN); }
+    if ((invariants.isMember(odb_Enum::OUTOFPLANE_PRINCIPAL)) && (field_value.outOfPlanePrincipal() != 0)) {
+        values.outOfPlanePrincipal.push_back(field_value.outOfPlanePrincipal());
+        values.outOfPlanePrincipalEmpty = false;
+    } else { values.outOfPlanePrincipal.push_back(NAN); }
+    string section_point_number =  to_string(field_value.sectionPoint().number());
+    if (section_point_number != "-1") {
+        values.sectionPointNumber.push_back(section_point_number);
+        values.sectionPointNumberEmpty = false;
+    } else { values.sectionPointNumber.push_back(""); }
+    string section_point_description = "";
+    section_point_description =  field_value.sectionPoint().description().CStr();
+    if (section_point_description != "") {
+        values.sectionPointDescriptionEmpty = false;
+    }
+    values.sectionPointDescription.push_back(section_point_description);
+}
+
+frame_type OdbModelSource::process_frame (const odb_Frame &frame, const int &number) {
+    frame_type new_frame;
+    new_frame.description = frame.description().CStr();
+    new_frame.loadCase = frame.loadCase().name().CStr();
+    switch(frame.domain()) {
+        case odb_Enum::TIME: new_frame.domain = "Time"; break;
+        case odb_Enum::FREQUENCY: new_frame.domain = "Frequency"; break;
+        case odb_Enum::MODAL: new_frame.domain = "Modal"; break;
+    }
+    new_frame.incrementNumber = frame.incrementNumber();
+    new_frame.cyclicModeNumber = frame.cyclicModeNumber();
+    new_frame.mode = frame.mode();
+    new_frame.frameValue = frame.frameValue();
+    new_frame.frequency = frame.frequency();
+    new_frame.number = number;  // Frame number is different than increment number, which can repeat
+
+    return new_frame;
+}
+
+bool OdbModelSource::engineering_shear (const string &field_output_name, const string &type) {
+    if (type.rfind("Tensor", 0) != 0) { return false; }
+    // Total, elastic, inelastic, logarithmic, nominal, plastic, thermal, and viscous strains, and the strain rate
+    static const set<string> strain_variables = {"E", "EE", "IE", "LE", "NE", "PE", "THE", "VE", "ER"};
+    return strain_variables.count(field_output_name) > 0;
+}
+
+string OdbModelSource::get_field_type_enum (odb_Enum::odb_DataTypeEnum type_enum) {
+    signed char type_code = get_field_type_code(type_enum);
+    return (type_code) ? data_type_enum_names[type_code].name : "";
+}
+
+signed char OdbModelSource::get_field_type_code (odb_Enum::odb_DataTypeEnum type_enum) {
+    switch(type_enum) {
+        case odb_Enum::SCALAR: return 1;
+        case odb_Enum::VECTOR: return 2;
+        case odb_Enum::TENSOR_3D_FULL: return 3;
+        case odb_Enum::TENSOR_3D_PLANAR: return 4;
+        case odb_Enum::TENSOR_3D_SURFACE: return 5;
+        case odb_Enum::TENSOR_2D_PLANAR: return 6;
+        case odb_Enum::TENSOR_2D_SURFACE: return 7;
+        default: return 0;
+    }
+}
+
+string OdbModelSource::get_valid_invariant_enum (odb_Enum::odb_InvariantEnum invariant_enum) {
+    string invariant = "";
+    switch(invariant_enum) {
+        case odb_Enum::MAGNITUDE: invariant = "Magnitude"; break;
+        case odb_Enum::MISES: invariant = "Mises"; break;
+        case odb_Enum::TRESCA: invariant = "Tresca"; break;
+        case odb_Enum::PRESS: invariant = "Press"; break;
+        case odb_Enum::INV3: invariant = "Inv3"; break;
+        case odb_Enum::MAX_PRINCIPAL: invariant = "Max Principal"; break;
+        case odb_Enum::MID_PRINCIPAL: invariant = "Mid Principal"; break;
+        case odb_Enum::MIN_PRINCIPAL: invariant = "Min Principal"; break;
+        case odb_Enum::MAX_INPLANE_PRINCIPAL: invariant = "Max Inplane Principal"; break;
+        case odb_Enum::MIN_INPLANE_PRINCIPAL: invariant = "Min Inplane Principal"; break;
+        case odb_Enum::OUTOFPLANE_PRINCIPAL: invariant = "Out of Plane Principal"; break;
+    }
+    return invariant;
+}
+
+string OdbModelSource::get_position_enum (odb_Enum::odb_ResultPositionEnum position_enum) {
+    string position = "";
+    switch(position_enum) {
+        case odb_Enum::NODAL: position = "Nodal"; break;
+        case odb_Enum::ELEMENT_NODAL: position = "Element Nodal"; break;
+        case odb_Enum::INTEGRATION_POINT: position = "Integration Point"; break;
+        case odb_Enum::ELEMENT_FACE: position = "Element Face"; break;
+        case odb_Enum::ELEMENT_FACE_INTEGRATION_POINT: position = "Element Face Integration Point"; break;
+        case odb_Enum::WHOLE_ELEMENT: position = "Whole Element"; break;
+        case odb_Enum::WHOLE_REGION: position = "Whole Region"; break;
+        case odb_Enum::WHOLE_PART_INSTANCE: position = "Whole Part Instance"; break;
+        case odb_Enum::WHOLE_MODEL: position = "Whole Model"; break;
+    }
+    return position;
+}
@@ -0,0 +1,114 @@
+//! A model source reading the frames and field outputs of an open odb file
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <odb_API.h>
+
+#include "logging.h"
+#include "model_source.h"
+#include "spade_types.h"
+
+#ifndef __ODB_MODEL_SOURCE_H_INCLUDED__
+#define __ODB_MODEL_SOURCE_H_INCLUDED__
+
+using namespace std;
+
+/*!
+   This class reads the steps, frames, and field outputs of an odb file and copies them into the data types written to
+   the extracted file. The odb owns the bulk data arrays, so each bulk data block is copied when it's read, which lets the
+   hdf5 writer thread write it while the odb moves on to the next block.
+*/
+class OdbModelSource : public ModelSource {
+    public:
+        //! The constructor.
+        /*!
+          \param odb An open odb object
+          \param default_instance_name Name given to the data of the root assembly, whose instance name is blank
+          \param read_field_values Read the invariants and labels of each field value, which is slow, instead of only the bulk data blocks
+          \param log_file Logging object for writing log messages
+        */
+        OdbModelSource (odb_Odb &odb, const string &default_instance_name, const bool &read_field_values, Logging &log_file);
+        vector<string> step_names () override;
+        double step_total_time (const string &step_name) override;
+        int frame_count (const string &step_name) override;
+        frame_type read_frame (const string &step_name, const int &frame_number) override;
+        vector<string> field_output_names (const string &step_name, const int &frame_number) override;
+        field_output_type read_field_output (const string &step_name, const int &frame_number, const string &field_output_name, const function<bool(const string&)> &read_instance, const function<void(field_output_type&)> &add_block) override;
+        //! Process a frame from the odb file
+        /*!
+          Process a frame object and store the results
+          \param frame An odb frame object
+          \param number An integer storing the frame number
+          \return frame_type with data stored from the odb
+        */
+        static frame_type process_frame (const odb_Frame &frame, const int &number);
+        //! Check whether the shear components of a field output are engineering shear strains
+        /*!
+          Abaqus writes the shear components of its strain tensors, e.g. E, LE, and PE, as engineering shear strains, which are twice the tensor shear strains
+          \param field_output_name Name of the field output, which is the Abaqus output variable
+          \param type Type of the field output from get_field_type_enum()
+          \return true for the strain tensor output variables
+        */
+        static bool engineering_shear (const string &field_output_name, const string &type);
+        //! Return a string representing a type of field value
+        /*!
+          From an odb_Enum return a string representation 
+          \param type An odb_Enum type to be represented as a string
+          \return string representation of odb_Enum
+        */
+        static string get_field_type_enum (odb_Enum::odb_DataTypeEnum type_enum);
+        //! Return the code of a type of field value
+        /*!
+          \param type_enum An odb_Enum type
+          \return value of the type in data_type_enum_names, zero for an unknown type
+        */
+        static signed char get_field_type_code (odb_Enum::odb_DataTypeEnum type_enum);
+        //! Return a string representing a valid invariant enum
+        /*!
+          From an odb_Enum return a string representation 
+          \param invariant An odb_Enum type to be represented as a string
+          \return string representation of odb_Enum
+        */
+        static string get_valid_invariant_enum (odb_Enum::odb_InvariantEnum invariant_enum);
+        //! Return a string representing a position enum
+        /*!
+          From an odb_Enum return a string representation 
+          \param invariant An odb_Enum type to be represented as a string
+          \return string representation of odb_Enum
+        */
+        static string get_position_enum (odb_Enum::odb_ResultPositionEnum position_enum);
+
+    private:
+        //! Return the frames of a step
+        /*!
+          \param step_name Name of the step
+          \return frames of the step
+        */
+        const odb_SequenceFrame& step_frames (const string &step_name);
+        //! Process field value from the odb file
+        /*!
+          Process a field value object and store the results
+          \param field_value An odb field value object
+          \param invariants An odb sequence invariant object
+          \param values Data structure for storing processed data
+        */
+        void process_field_values (const odb_FieldValue &field_value, const odb_SequenceInvariant& invariants, field_value_type &values);
+        //! Process field bulk data from the odb file
+        /*!
+          Copy the arrays of a block of field bulk data out of the odb
+          \param field_bulk_data An odb field bulk data object
+          \param complex_data Boolean indicating if the data is complex
+          \param write_mises Boolean indicating if mises data should be kept
+          \return field_bulk_type with data stored from the odb
+          \sa read_field_output()
+        */
+        field_bulk_type process_field_bulk_data (const odb_FieldBulkData &field_bulk_data, bool complex_data, bool write_mises);
+
+        odb_Odb* odb;
+        string default_instance_name;
+        bool read_field_values;
+        Logging* log_file;
+};
+#endif  // __ODB_MODEL_SOURCE_H_INCLUDED__
@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+    #include <process.h>
+    #define getpid _getpid
+#else
+    #include <unistd.h>
+#endif
+
+#include <odb_upgrade_cache.h>
+
+using namespace std;
+
+OdbUpgradeCache::OdbUpgradeCache (CmdLineArguments &command_line_arguments, Logging &log_file) {
+    this->log_file = &log_file;
+    string cache = command_line_arguments["upgrade-cache"];
+    this->cache_enabled = (cache != "none");
+    if ((this->cache_enabled) && (!cache.empty())) {  // Without a cache directory the copies are kept next to the odb files
+        this->cache_directory = cache;
+        std::error_code directory_error;
+        std::filesystem::create_directories(this->cache_directory, directory_error);
+        if (directory_error) {
+            throw std::runtime_error("Unable to create the upgrade cache directory " + cache + ". " + directory_error.message());
+        }
+    }
+    this->cache_bytes = std::stoull(command_line_arguments["upgrade-cache-size"]) * 1024 * 1024;
+    this->temporary_suffix = to_string(getpid()) + "." + command_line_arguments["shard-index"];
+}
+
+string OdbUpgradeCache::upgraded_file (const string &odb_file_name, const function<void(const string&, const string&)> &upgrade) {
+    std::filesystem::path odb_path(odb_file_name);
+    if (!this->cache_enabled) {
+        string upgraded_file_name = std::filesystem::path(odb_path).replace_extension(".upgraded.odb").generic_string();
+        this->log_file->log("Upgrading file:" + odb_file_name);
+        upgrade(odb_file_name, upgraded_file_name);
+        return upgraded_file_name;
+    }
+
+    std::filesystem::path directory = (this->cache_directory.empty()) ? odb_path.parent_path() : this->cache_directory;
+    string key = cache_key(odb_file_name);
+    std::filesystem::path cached_path = directory / (odb_path.stem().string() + "." + key + ".upgraded.odb");
+    if (std::filesystem::exists(cached_path)) {
+        this->log_file->log("Using upgraded file from the cache: " + cached_path.generic_string());
+        std::error_code time_error;  // Mark the copy as recently used, failing to do so only affects the eviction order
+        std::filesystem::last_write_time(cached_path, std::filesystem::file_time_type::clock::now(), time_error);
+        return cached_path.generic_string();
+    }
+
+    std::filesystem::path temporary_path = directory / (odb_path.stem().string() + "." + key + ".upgrading" + this->temporary_suffix + ".odb");
+    this->log_file->log("Upgrading file:" + odb_file_name + " into the cache as " + cached_path.generic_string());
+    try {
+        upgrade(odb_file_name, temporary_path.generic_string());
+    } catch (...) {
+        std::error_code remove_error;
+        std::filesystem::remove(temporary_path, remove_error);
+        throw;
+    }
+    std::error_code rename_error;
+    std::filesystem::rename(temporary_path, cached_path, rename_error);
+    if (rename_error) {
+        // Another process can finish the same upgrade first, on Windows the rename then fails while that copy is open
+        std::error_code remove_error;
+        std::filesystem::remove(temporary_path, remove_error);
+        if (!std::filesystem::exists(cached_path)) {
+            throw std::runtime_error("Unable to move the upgraded file into the cache as " + cached_path.generic_string() + ". " + rename_error.message());
+        }
+        this->log_file->log("Using upgraded file from the cache written by another process: " + cached_path.generic_string());
+        return cached_path.generic_string();
+    }
+    evict(cached_path);
+    return cached_path.generic_string();
+}
+
+string OdbUpgradeCache::cache_key (const string &odb_file_name) {
+    const uintmax_t block_bytes = 65536;
+    const int block_count = 16;
+    uintmax_t file_bytes = std::filesystem::file_size(odb_file_name);
+    long long modified_time = std::filesystem::last_write_time(odb_file_name).time_since_epoch().count();
+    string fingerprint = to_string(file_bytes) + ":" + to_string(modified_time) + ":";
+
+    ifstream odb_file(odb_file_name, ios::binary);
+    if (!odb_file) {
+        throw std::runtime_error("Unable to read " + odb_file_name + " to make its upgrade cache key");
+    }
+    vector<char> block(block_bytes);
+    for (int i=0; i<block_count; i++) {
+        uintmax_t offset = (file_bytes > block_bytes) ? (file_bytes - block_bytes) * i / (block_count - 1) : 0;
+        odb_file.seekg(offset);
+        odb_file.read(block.data(), block_bytes);
+        fingerprint.append(block.data(), odb_file.gcount());
+        odb_file.clear();  // Reading the last block sets the end of file flag
+        if (file_bytes <= block_bytes) { break; }  // The whole file fits in one block
+    }
+
+    stringstream key;
+    key << hex << setw(16) << setfill('0') << hash<string>{}(fingerprint);
+    return key.str();
+}
+
+void OdbUpgradeCache::evict (const std::filesystem::path &keep) {
+    if (this->cache_bytes == 0) { return; }
+    std::filesystem::path directory = (keep.has_parent_path()) ? keep.parent_path() : std::filesystem::path(".");
+    const std::regex cached_name(".+\\.[0-9a-f]{16}\\.upgraded\\.odb");  // Only copies made by the cache are removed
+
+    uintmax_t total_bytes = 0;
+    vector<pair<std::filesystem::file_time_type, std::filesystem::path>> cached_files;
+    std::error_code directory_error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, directory_error)) {
+        std::error_code entry_error;
+        if ((!entry.is_regular_file(entry_error)) || (!std::regex_match(entry.path().filename().string(), cached_name))) { continue; }
+        total_bytes += entry.file_size(entry_error);
+        cached_files.emplace_back(entry.last_write_time(entry_error), entry.path());
+    }
+    std::sort(cached_files.begin(), cached_files.end());  // Least recently used first
+
+    for (const auto& [last_used, cached_path] : cached_files) {
+        if (total_bytes <= this->cache_bytes) { break; }
+        if (cached_path.filename() == keep.filename()) { continue; }
+        std::error_code remove_error;
+        uintmax_t file_bytes = std::filesystem::file_size(cached_path, remove_error);
+        if (std::filesystem::remove(cached_path, remove_error)) {
+            total_bytes -= file_bytes;
+            this->log_file->log("Removed " + cached_path.generic_string() + " from the upgrade cache");
+        }
+    }
+    if (total_bytes > this->cache_bytes) {
+        this->log_file->logWarning("The upgrade cache holds " + to_string(total_bytes / 1048576) + " MB, which is more than its size limit.");
+    }
+}
@@ -0,0 +1,63 @@
+//! An object for keeping upgraded copies of odb files written by older versions of Abaqus
+
+#include <filesystem>
+#include <functional>
+#include <string>
+
+#include "cmd_line_arguments.h"
+#include "logging.h"
+
+#ifndef __ODB_UPGRADE_CACHE_H_INCLUDED__
+#define __ODB_UPGRADE_CACHE_H_INCLUDED__
+
+using namespace std;
+
+/*!
+   This class keeps the upgraded copies of odb files in a cache directory, so extracting the same legacy odb file again
+   doesn't rewrite the whole file. Each copy is named after a key made from the size, modification time, and a fingerprint
+   of sampled blocks of the content of the odb file, so a changed odb file is upgraded again. When the cache has a size
+   limit, the least recently used copies are removed until the cache fits in it.
+*/
+class OdbUpgradeCache {
+    public:
+        //! The constructor.
+        /*!
+          \param command_line_arguments CmdLineArguments object storing command line arguments
+          \param log_file Logging object for writing log messages
+        */
+        OdbUpgradeCache (CmdLineArguments &command_line_arguments, Logging &log_file);
+        //! Return the name of an upgraded copy of an odb file
+        /*!
+          Return the copy in the cache if there is one for the current content of the odb file, otherwise upgrade the odb file
+          into the cache first. The upgrade is written to a temporary file that is renamed once it's finished, so an
+          interrupted upgrade doesn't leave a broken copy in the cache. When another process puts the same copy in the cache
+          first, its copy is used and this upgrade is discarded. With the upgrade-cache command line argument set to
+          none, the odb file is upgraded to <odb file name>.upgraded.odb every time.
+          \param odb_file_name Name of the odb file
+          \param upgrade Function upgrading the odb file given as the first argument into the file given as the second
+          \return name of the upgraded odb file
+        */
+        string upgraded_file (const string &odb_file_name, const function<void(const string&, const string&)> &upgrade);
+
+    private:
+        //! Make the cache key of an odb file
+        /*!
+          The content is sampled in blocks at the start, the end, and evenly spaced in between, so the key doesn't require
+          reading a file that can be many gigabytes.
+          \param odb_file_name Name of the odb file
+          \return hexadecimal key
+        */
+        string cache_key (const string &odb_file_name);
+        //! Remove the least recently used upgraded copies until the cache fits in its size limit
+        /*!
+          \param keep Upgraded copy used by this run, which is never removed
+        */
+        void evict (const std::filesystem::path &keep);
+
+        std::filesystem::path cache_directory;
+        bool cache_enabled;
+        uintmax_t cache_bytes;  // Size limit of the cache, zero for no limit
+        string temporary_suffix;  // Keeps the upgrades of concurrent processes and workers apart
+        Logging* log_file;
+};
+#endif  // __ODB_UPGRADE_CACHE_H_INCLUDED__
@@ -13,13 +13,98 @@
 #include <set>
 #include <fstream>
 #include <vector>
+#include <filesystem>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
 
 #include "cmd_line_arguments.h"
 #include "logging.h"
 #include "spade_object.h"
+#include "h5_merger.h"
+#include "synthetic_model.h"
+#ifdef SPADE_MPI
+    #include <mpi.h>
+    #include "h5_parallel_merger.h"
+#endif
 
 using namespace std;
 
+//! Peak resident memory of the process
+/*!
+  \return peak resident set size, or peak working set size on Windows, in megabytes
+*/
+double peak_memory_mb() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS memory_counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &memory_counters, sizeof(memory_counters))) { return 0.0; }
+    return memory_counters.PeakWorkingSetSize / 1048576.0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) { return 0.0; }
+    #ifdef __APPLE__
+        return usage.ru_maxrss / 1048576.0;  // Bytes on macOS
+    #else
+        return usage.ru_maxrss / 1024.0;  // Kilobytes on Linux
+    #endif
+#endif
+}
+
+//! Name of the file a rank of an MPI run writes in place of a file shared by the ranks
+/*!
+  \param file_name Name of the shared file
+  \param rank Rank of the MPI run
+  \return file name with the rank added before the extension
+*/
+string rank_file_name(const string &file_name, const int &rank) {
+    std::filesystem::path rank_path(file_name);
+    return rank_path.replace_extension(".rank" + to_string(rank) + rank_path.extension().string()).string();
+}
+
+#ifdef SPADE_MPI
+//! Extract the frames of this rank into its own shard file, then merge the shard files of all the ranks in parallel
+/*!
+  \param command_line_arguments CmdLineArguments object storing command line arguments
+  \param log_file Logging object for writing log messages
+  \param rank Rank of the MPI run
+  \param rank_count Number of ranks of the MPI run
+*/
+void extract_parallel(CmdLineArguments &command_line_arguments, Logging &log_file, const int &rank, const int &rank_count) {
+    string extracted_file_name = command_line_arguments["extracted-file"];
+    vector<string> shard_file_names;
+    for (int i=0; i<rank_count; i++) { shard_file_names.push_back(rank_file_name(extracted_file_name, i)); }
+    command_line_arguments.set("extracted-file", shard_file_names[rank]);
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start = MPI_Wtime();
+    if (!command_line_arguments["synthetic"].empty()) {
+        SyntheticModel synthetic_model(command_line_arguments["synthetic"]);
+        SpadeObject spade_object(command_line_arguments, log_file, synthetic_model);
+#ifndef SPADE_WITHOUT_ABAQUS
+    } else {
+        SpadeObject spade_object(command_line_arguments, log_file);
+#endif
+    }
+    command_line_arguments.set("extracted-file", extracted_file_name);
+    MPI_Barrier(MPI_COMM_WORLD);  // Every shard file is written
+    H5ParallelMerger h5_merger(command_line_arguments, log_file, shard_file_names, MPI_COMM_WORLD);
+    MPI_Barrier(MPI_COMM_WORLD);  // The first rank has finished the merged file
+    double seconds = MPI_Wtime() - start;
+    if (rank == 0) {  // From reading the model to the finished merged file, which is what a user of the MPI build waits on
+        stringstream rate;
+        rate << std::fixed << std::setprecision(1) << h5_merger.merged_bytes() / 1048576.0 / std::max(seconds, 1.0e-9);
+        log_file.log("End to end throughput of " + to_string(rank_count) + " ranks: " + to_string(h5_merger.merged_bytes()) + " bytes in " + to_string(seconds) + " seconds: " + rate.str() + " MB/s");
+    }
+    std::filesystem::remove(shard_file_names[rank]);
+}
+#endif
+
 //! Main function called when code is compiled
 /*!
   This function mostly sets up the various objects required to extract the data from the odb. Most of the work is then
@@ -30,24 +115,69 @@ using namespace std;
 */
 int ABQmain(int argc, char **argv)
 {
+    int rank = 0;
+    int rank_count = 1;
+#ifdef SPADE_MPI
+    // With more than one rank, each rank extracts every n-th frame the same way the workers of --jobs do
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &rank_count);
+    vector<string> rank_arguments(argv, argv + argc);
+    if (rank_count > 1) {
+        rank_arguments.insert(rank_arguments.end(), {"--shard-index", to_string(rank), "--shard-count", to_string(rank_count)});
+    }
+    vector<char*> rank_argv;
+    for (string &argument : rank_arguments) { rank_argv.push_back(argument.data()); }
+    argc = rank_argv.size();
+    argv = rank_argv.data();
+    struct MpiFinalize { ~MpiFinalize() { MPI_Finalize(); } } mpi_finalize;  // Called on every return
+#endif
     try {
         CmdLineArguments command_line_arguments(argc, argv);
         // If help option used, print help and exit
-        if (command_line_arguments.help()) { cout<<command_line_arguments.helpMessage(); return 0; }
+        if (command_line_arguments.help()) { if (rank == 0) { cout<<command_line_arguments.helpMessage(); } return 0; }
         Logging log_file(
-            command_line_arguments["log-file"],
+            (rank == 0) ? command_line_arguments["log-file"] : rank_file_name(command_line_arguments["log-file"], rank),
             command_line_arguments.verbose(),
             command_line_arguments.debug()
         );
+        if (!command_line_arguments["profile"].empty()) {
+            log_file.profile((rank == 0) ? command_line_arguments["profile"] : rank_file_name(command_line_arguments["profile"], rank));
+        }
         log_file.log("Command line used: "+ command_line_arguments.commandLine());
         log_file.logVerbose("Arguments given:" + command_line_arguments.verboseArguments());
         log_file.logDebug("Debug logging turned on");
-        SpadeObject spade_object(command_line_arguments, log_file);
+        if (!command_line_arguments["merge-shards"].empty()) {  // Build the extracted file from the files written by workers
+            H5Merger h5_merger(command_line_arguments, log_file);
+#ifdef SPADE_MPI
+        } else if (rank_count > 1) {
+            extract_parallel(command_line_arguments, log_file, rank, rank_count);
+#endif
+        } else if (!command_line_arguments["synthetic"].empty()) {  // Generate the model instead of reading an odb file
+            SyntheticModel synthetic_model(command_line_arguments["synthetic"]);
+            SpadeObject spade_object(command_line_arguments, log_file, synthetic_model);
+#ifndef SPADE_WITHOUT_ABAQUS
+        } else {
+            SpadeObject spade_object(command_line_arguments, log_file);
+#endif
+        }
+        log_file.log("Peak memory use: " + to_string(static_cast<long long>(peak_memory_mb())) + " MB");
         log_file.logVerbose("Successful completion of " + command_line_arguments.commandName());
     } catch (const std::runtime_error &err) {
         cerr << err.what() << std::endl;
+#ifdef SPADE_MPI
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);  // The other ranks would wait on this one forever
+#endif
         return EXIT_FAILURE;
     }
 
     return 0;
 }
+
+#ifdef SPADE_WITHOUT_ABAQUS
+//! Main function of a build without Abaqus, which calls ABQmain() itself instead of the Abaqus main
+int main(int argc, char **argv)
+{
+    return ABQmain(argc, argv);
+}
+#endif
@@ -29,6 +29,8 @@ using namespace std;
 #include <vector>
 #include <array>
 #include <iterator>
+#include <numeric>
+#include <unordered_map>
 #include <regex>
 #include <stdlib.h>
 #include <cmath>
@@ -36,104 +38,75 @@ using namespace std;
 #include <filesystem>
 #include <optional>
 
+#ifndef SPADE_WITHOUT_ABAQUS
 #include <odb_API.h>
 #include <odb_Coupling.h>
 #include <odb_MPC.h>
 #include <odb_ShellSolidCoupling.h>
 #include <odb_MaterialTypes.h>
 #include <odb_SectionTypes.h>
+#endif
 
 #include "H5Cpp.h"
 #include <hdf5_hl.h>
 using namespace H5;
 
 #include <spade_object.h>
+#include <odb_upgrade_cache.h>
 
+#ifndef SPADE_WITHOUT_ABAQUS
 SpadeObject::SpadeObject (CmdLineArguments &command_line_arguments, Logging &log_file) {
     log_file.log("Reading file at time: " + command_line_arguments.getTimeStamp(false));
     log_file.log("Reading file: " + command_line_arguments["odb-file"]);
     odb_String file_name = command_line_arguments["odb-file"].c_str();
 
     if (isUpgradeRequiredForOdb(file_name)) {
-        log_file.log("Upgrading file:" + command_line_arguments["odb-file"]);
-        odb_String upgraded_file_name = std::filesystem::path(command_line_arguments["odb-file"]).replace_extension(".upgraded.odb").generic_string().c_str();
-        upgradeOdb(file_name, upgraded_file_name);
-        file_name = upgraded_file_name;
+        OdbUpgradeCache upgrade_cache(command_line_arguments, log_file);
+        string upgraded_file_name = upgrade_cache.upgraded_file(command_line_arguments["odb-file"], [] (const string &odb_file_name, const string &upgraded_file_name) {
+            upgradeOdb(odb_file_name.c_str(), upgraded_file_name.c_str());
+        });
+        file_name = upgraded_file_name.c_str();
     }
-    // Set up enum strings to be used with multiple functions later
-    // Found at: /apps/SIMULIA/EstProducts/2023/SMAOdb/PublicInterfaces/odb_Enum.h
-    this->dimension_enum_strings[0] = "Unknown Dimension";
-    this->dimension_enum_strings[1] = "Three Dimensional";
-    this->dimension_enum_strings[2] = "Two Dimensional Planar";
-    this->dimension_enum_strings[3] = "AxiSymmetric";
-    this->faces_enum_strings[0] = "FACE_UNKNOWN";
-    this->faces_enum_strings[1] = "END1";
-    this->faces_enum_strings[2] = "END2";
-    this->faces_enum_strings[3] = "END3";
-    this->faces_enum_strings[11] = "FACE1";
-    this->faces_enum_strings[12] = "FACE2";
-    this->faces_enum_strings[13] = "FACE3";
-    this->faces_enum_strings[14] = "FACE4";
-    this->faces_enum_strings[15] = "FACE5";
-    this->faces_enum_strings[16] = "FACE6";
-    this->faces_enum_strings[101] = "EDGE1";
-    this->faces_enum_strings[102] = "EDGE2";
-    this->faces_enum_strings[103] = "EDGE3";
-    this->faces_enum_strings[104] = "EDGE4";
-    this->faces_enum_strings[105] = "EDGE5";
-    this->faces_enum_strings[106] = "EDGE6";
-    this->faces_enum_strings[107] = "EDGE7";
-    this->faces_enum_strings[108] = "EDGE8";
-    this->faces_enum_strings[109] = "EDGE9";
-    this->faces_enum_strings[110] = "EDGE10";
-    this->faces_enum_strings[111] = "EDGE11";
-    this->faces_enum_strings[112] = "EDGE12";
-    this->faces_enum_strings[113] = "EDGE13";
-    this->faces_enum_strings[114] = "EDGE14";
-    this->faces_enum_strings[115] = "EDGE15";
-    this->faces_enum_strings[116] = "EDGE16";
-    this->faces_enum_strings[117] = "EDGE17";
-    this->faces_enum_strings[118] = "EDGE18";
-    this->faces_enum_strings[119] = "EDGE19";
-    this->faces_enum_strings[120] = "EDGE20";
-    this->faces_enum_strings[1001] = "SIDE1|SPOS";
-    this->faces_enum_strings[1002] = "SIDE2|SNEG";
-    this->faces_enum_strings[1003] = "DOUBLE_SIDED"; // = DOUBLE SIDED SHELLS
-    this->default_instance_name = "ASSEMBLY";  // If the name of the instance is blank, it will be assigned this value
-
-    this->command_line_arguments = &command_line_arguments;
-    create_string_sets();  // Create sets of strings for each command line option that can receive multiple strings
-    this->log_file = &log_file;
+    initialize(command_line_arguments, log_file);
     try {  // Since the odb object isn't recognized outside the scope of the try/except, block the processing has to be done within the try block
         odb_Odb& odb = openOdb(file_name, true);  // Open as read only
-        process_odb_without_steps(odb);
-        log_file.log("Non step data from the odb processed and stored.");
+        // An extracted file being appended to already has the data outside of the steps
+        bool append_file = (command_line_arguments.append()) && (std::filesystem::exists(std::filesystem::path(command_line_arguments["extracted-file"])));
+        if (!append_file) {
+            process_odb_without_steps(odb);
+            sort_mesh();
+            log_file.log("Non step data from the odb processed and stored.");
+        }
         log_file.log("Writing extracted file at time: " + command_line_arguments.getTimeStamp(false));
         if (command_line_arguments["extracted-file-type"] == "h5") {
-            // Open file for writing
-            std::ifstream hdf5File (this->command_line_arguments->get("extracted-file").c_str());
-            this->log_file->log("Creating hdf5 file: " + this->command_line_arguments->get("extracted-file"));
-            const H5std_string FILE_NAME(this->command_line_arguments->get("extracted-file"));
-
-            H5::Exception::dontPrint();
-            H5::H5File* h5_file_pointer = 0;
-            try {
-                h5_file_pointer = new H5::H5File(FILE_NAME, H5F_ACC_TRUNC);
-            } catch(const H5::FileIException&) {
-                throw std::runtime_error("Issue opening file: " + this->command_line_arguments->get("extracted-file"));
+            H5::H5File h5_file = open_h5_file(append_file);
+            if (append_file) {
+                read_manifest(h5_file);
+            } else if (command_line_arguments.append()) {
+                H5::Group manifest_group = create_group(h5_file, "/manifest");
+                write_string_attribute(manifest_group, "format", command_line_arguments["format"]);
+                write_string_attribute(manifest_group, "layout", command_line_arguments["layout"]);
+                write_string_attribute(manifest_group, "metadata-layout", command_line_arguments["metadata-layout"]);
             }
-            H5::H5File h5_file = *h5_file_pointer;
 
-            this->write_h5_without_steps(h5_file);
+            bool first_shard = ((command_line_arguments["shard-index"] == "0") && (!append_file));  // Only the first shard of a new file writes data outside of the frames
+            if (first_shard) { this->write_h5_without_steps(h5_file); }
+            OdbModelSource odb_source(odb, this->default_instance_name, (command_line_arguments["invariants"] == "odb"), log_file);
             if (command_line_arguments["format"] == "extract") {  //Write extract format
-                write_mesh(h5_file);
-                write_step_data_h5 (odb, h5_file);
+                if (first_shard) { write_mesh(h5_file); }
+                if (this->max_memory_bytes > 0) { release_model(); }
+                write_step_data_h5 (odb, odb_source, h5_file);
             } else if (command_line_arguments["format"] == "odb") {
-                write_step_data_h5 (odb, h5_file);
+                if (this->max_memory_bytes > 0) { release_model(); }
+                write_step_data_h5 (odb, odb_source, h5_file);
             } else if (command_line_arguments["format"] == "vtk") {  //Write vtk format
-                this->write_vtk_data(h5_file);
+                this->write_vtk_data(odb_source, h5_file);
             }
 
+            this->close_groups();
+            finish_partitions(h5_file);
+            this->file_profile->log_statistics(h5_file);
+            this->log_file->log("Field output data written: " + to_string(this->field_output_bytes) + " bytes");
             h5_file.close();  // Close the hdf5 file
             this->log_file->log("Closing hdf5 file.");
         } else if (command_line_arguments["extracted-file-type"] == "json") {
@@ -153,6 +126,105 @@ SpadeObject::SpadeObject (CmdLineArguments &command_line_arguments, Logging &log
     }
 
 }
+#endif
+
+SpadeObject::SpadeObject (CmdLineArguments &command_line_arguments, Logging &log_file, SyntheticModel &synthetic_model) {
+    log_file.log("Reading model at time: " + command_line_arguments.getTimeStamp(false));
+    log_file.log("Reading model: " + synthetic_model.name());
+    initialize(command_line_arguments, log_file);
+    this->name = synthetic_model.name();
+    this->isReadOnly = "true";
+    this->sector_definition.numSectors = 0;
+    {
+        Logging::Span span(log_file, "read_assembly");
+        synthetic_model.read_assembly(this->root_assembly, this->instance_mesh, this->mesh_section_categories, this->mesh_set_names);
+    }
+    for (size_t i=0; i<this->mesh_set_names.size(); i++) { this->mesh_set_name_ids[this->mesh_set_names[i]] = i; }
+    this->root_assembly.nodes = &this->assembly_mesh[this->root_assembly.name].nodes;
+    this->root_assembly.elements = &this->assembly_mesh[this->root_assembly.name].elements;
+    sort_mesh();
+    log_file.log("Non step data from the model stored.");
+
+    log_file.log("Writing extracted file at time: " + command_line_arguments.getTimeStamp(false));
+    H5::H5File h5_file = open_h5_file(false);
+    bool first_shard = (command_line_arguments["shard-index"] == "0");  // Only the first shard writes data outside of the frames
+    if (first_shard) { this->write_h5_without_steps(h5_file); }
+    if (command_line_arguments["format"] == "vtk") {
+        write_vtk_data(synthetic_model, h5_file);
+    } else {
+        if ((first_shard) && (command_line_arguments["format"] == "extract")) { write_mesh(h5_file); }
+        if (this->max_memory_bytes > 0) { release_model(); }
+        write_source_step_data_h5(synthetic_model, h5_file);
+    }
+    this->close_groups();
+    finish_partitions(h5_file);
+    this->file_profile->log_statistics(h5_file);
+    this->log_file->log("Field output data written: " + to_string(this->field_output_bytes) + " bytes");
+    h5_file.close();
+    this->log_file->log("Closing hdf5 file.");
+}
+
+void SpadeObject::initialize (CmdLineArguments &command_line_arguments, Logging &log_file) {
+    // Set up enum strings to be used with multiple functions later
+    // Found at: /apps/SIMULIA/EstProducts/2023/SMAOdb/PublicInterfaces/odb_Enum.h
+    this->dimension_enum_strings[0] = "Unknown Dimension";
+    this->dimension_enum_strings[1] = "Three Dimensional";
+    this->dimension_enum_strings[2] = "Two Dimensional Planar";
+    this->dimension_enum_strings[3] = "AxiSymmetric";
+    this->face_enum_type = H5::EnumType(H5::IntType(H5::PredType::NATIVE_SHORT));
+    for (const enum_name_type &face : face_enum_names) {
+        short value = face.value;
+        this->face_enum_type.insert(face.name, &value);
+    }
+    this->data_type_enum_type = H5::EnumType(H5::IntType(H5::PredType::NATIVE_SCHAR));
+    for (const enum_name_type &data_type : data_type_enum_names) {
+        signed char value = data_type.value;
+        this->data_type_enum_type.insert(data_type.name, &value);
+    }
+    this->default_instance_name = "ASSEMBLY";  // If the name of the instance is blank, it will be assigned this value
+
+    this->command_line_arguments = &command_line_arguments;
+    this->max_memory_bytes = std::stoull(command_line_arguments["max-memory"]) * 1024 * 1024;
+    this->shard_index = std::stoi(command_line_arguments["shard-index"]);
+    this->shard_count = std::stoi(command_line_arguments["shard-count"]);
+    this->split_by = command_line_arguments["split-by"];
+    if (this->split_by.rfind("frame-range:", 0) == 0) {
+        this->frame_range_size = std::stoi(this->split_by.substr(12));
+        this->split_by = "frame-range";
+    } else if (this->split_by == "none") {
+        this->split_by.clear();
+    }
+    if (!this->split_by.empty()) {  // The shard and output options are left out, so any worker of a rerun can keep the partitions
+        string source = command_line_arguments["synthetic"];
+        if (source.empty()) {
+            std::filesystem::path odb_path = std::filesystem::absolute(command_line_arguments["odb-file"]);
+            std::error_code file_error;
+            source = odb_path.string() + " of " + to_string(std::filesystem::file_size(odb_path, file_error)) + " bytes modified at " + to_string(std::filesystem::last_write_time(odb_path, file_error).time_since_epoch().count());
+        }
+        this->partition_manifest = "source: " + source + "\n";
+        for (const string &option : {"format", "layout", "metadata-layout", "split-by", "step", "frame", "frame-value", "field", "instance", "compression", "compression-level", "chunk-shape", "invariants"}) {
+            this->partition_manifest += option + ": " + command_line_arguments[option] + "\n";
+        }
+    }
+    create_string_sets();  // Create sets of strings for each command line option that can receive multiple strings
+    this->log_file = &log_file;
+    this->file_profile.emplace(command_line_arguments, log_file);  // Read a custom profile before the odb, so a bad profile file fails early
+}
+
+H5::H5File SpadeObject::open_h5_file (const bool &append_file) {
+    this->log_file->log("Creating hdf5 file: " + this->command_line_arguments->get("extracted-file"));
+    const H5std_string FILE_NAME(this->command_line_arguments->get("extracted-file"));
+
+    H5::Exception::dontPrint();
+    this->create_dataset_creation_properties();
+    this->intermediate_group_properties.setCreateIntermediateGroup(true);
+    try {
+        if (append_file) { return H5::H5File(FILE_NAME, H5F_ACC_RDWR, H5::FileCreatPropList::DEFAULT, this->file_profile->access_properties()); }
+        return H5::H5File(FILE_NAME, H5F_ACC_TRUNC, this->file_profile->creation_properties(), this->file_profile->access_properties());
+    } catch(const H5::FileIException&) {
+        throw std::runtime_error("Issue opening file: " + this->command_line_arguments->get("extracted-file"));
+    }
+}
 
 void SpadeObject::create_string_sets () {
     bool all_given = false;
@@ -186,7 +258,9 @@ set<string> SpadeObject::create_string_set (const string &string_value, bool &al
     return values;
 }
 
+#ifndef SPADE_WITHOUT_ABAQUS
 void SpadeObject::process_odb_without_steps(odb_Odb &odb) {
+    Logging::Span span(*this->log_file, "process_odb_without_steps");
 
     this->log_file->logVerbose("Reading top level attributes of odb.");
     this->name = odb.name().CStr();
@@ -352,10 +426,36 @@ tangential_behavior_type SpadeObject::process_interaction_property (const odb_In
     return interaction;
 }
 
-map<int, node_type>* SpadeObject::process_nodes (const odb_SequenceNode &nodes, const string &instance_name, const string &assembly_name, const string &set_name, const string &part_name, const int &embedded_space) {
-    map<int, node_type>* new_nodes;
+int SpadeObject::intern_section_category (const odb_SectionCategory &section_category) {
+    string key = string(section_category.name().CStr()) + "\n" + section_category.description().CStr();
+    auto [category_id, inserted] = this->mesh_section_category_ids.try_emplace(key, this->mesh_section_categories.size());
+    if (inserted) {
+        this->mesh_section_categories.push_back(process_section_category(section_category));
+    }
+    return category_id->second;
+}
+#endif
+
+int SpadeObject::intern_instance_name (const string &instance_name) {
+    auto [name_id, inserted] = this->mesh_instance_name_ids.try_emplace(instance_name, this->mesh_instance_names.size());
+    if (inserted) {
+        this->mesh_instance_names.push_back(instance_name);
+    }
+    return name_id->second;
+}
+
+int SpadeObject::intern_set_name (const string &set_name) {
+    auto [name_id, inserted] = this->mesh_set_name_ids.try_emplace(set_name, this->mesh_set_names.size());
+    if (inserted) {
+        this->mesh_set_names.push_back(set_name);
+    }
+    return name_id->second;
+}
+
+#ifndef SPADE_WITHOUT_ABAQUS
+mesh_nodes_type* SpadeObject::process_nodes (const odb_SequenceNode &nodes, const string &instance_name, const string &assembly_name, const string &set_name, const string &part_name, const int &embedded_space) {
+    mesh_nodes_type* new_nodes;
     mesh_type* mesh;
-    set<int> new_node_set;
     string name;
     if (!part_name.empty()) {
         try {  // If the node has been stored in nodes, just return the address to it
@@ -385,31 +485,34 @@ map<int, node_type>* SpadeObject::process_nodes (const odb_SequenceNode &nodes,
         new_nodes = &this->assembly_mesh[name].nodes;
         mesh = &this->assembly_mesh[name];
     }
+    if (new_nodes->labels.empty()) {
+        new_nodes->coordinate_size = ((embedded_space == 2) || (embedded_space == 3)) ? 2 : 3;
+        new_nodes->labels.reserve(nodes.size());
+        new_nodes->coordinates.reserve(nodes.size() * new_nodes->coordinate_size);
+        new_nodes->label_index.reserve(nodes.size());
+    }
+    mesh_set_type* node_set = (set_name.empty()) ? nullptr : &mesh->node_sets[intern_set_name(set_name)];
     for (int i=0; i < nodes.size(); i++) {
         odb_Node node = nodes.node(i);
         int node_label = node.label();
-        new_node_set.insert(node_label);
-        node_type coords_sets = (*new_nodes)[node_label];
-        if (coords_sets.coordinates.empty()) {
-            if ((embedded_space == 2) || (embedded_space == 3)) {
-                (*new_nodes)[node_label].coordinates = {node.coordinates()[0], node.coordinates()[1]};
-            } else {
-                (*new_nodes)[node_label].coordinates = {node.coordinates()[0], node.coordinates()[1], node.coordinates()[2]};
-            }
+        if (node_set) {
+            if ((!node_set->labels.empty()) && (node_label <= node_set->labels.back())) { node_set->sorted = false; }
+            node_set->labels.push_back(node_label);
         }
-    }
-    if (!set_name.empty()) {
-        mesh->node_sets[set_name].insert(new_node_set.begin(), new_node_set.end());
+        if (!new_nodes->label_index.try_emplace(node_label, new_nodes->labels.size()).second) { continue; }  // Node already stored
+        if ((!new_nodes->labels.empty()) && (node_label < new_nodes->labels.back())) { new_nodes->sorted = false; }
+        new_nodes->labels.push_back(node_label);
+        const float* const coordinates = node.coordinates();
+        new_nodes->coordinates.insert(new_nodes->coordinates.end(), coordinates, coordinates + new_nodes->coordinate_size);
     }
    return new_nodes;
 }
 
-map<string, map<int, element_type>>* SpadeObject::process_elements (const odb_SequenceElement &elements, const string &instance_name, const string &assembly_name, const string &set_name, const string &part_name) {
-    map<string, map<int, element_type>>* new_elements;
+map<string, mesh_elements_type>* SpadeObject::process_elements (const odb_SequenceElement &elements, const string &instance_name, const string &assembly_name, const string &set_name, const string &part_name) {
+    map<string, mesh_elements_type>* new_elements;
     mesh_type* mesh;
-    set<int> new_element_set;
     string name;
-    this->log_file->logDebug("\t\tCall to process_elements at time: " + this->command_line_arguments->getTimeStamp(true));
+    Logging::Span span(*this->log_file, "process_elements");
     if (!part_name.empty()) {
         try {  // If the element has been stored in elements, just return the address to it
             new_elements = &this->part_mesh.at(part_name).elements;  // Use 'at' member function instead of brackets to get exception raised instead of creating blank value for key in map
@@ -436,42 +539,113 @@ map<string, map<int, element_type>>* SpadeObject::process_elements (const odb_Se
         new_elements = &this->assembly_mesh[name].elements;
         mesh = &this->assembly_mesh[name];
     }
-    this->log_file->logDebug("\t\tElements map retrieved in process_elements at time: " + this->command_line_arguments->getTimeStamp(true));
-    int previous_label = -2;
+    this->log_file->logDebug([&] { return "\t\tElements map retrieved in process_elements at time: " + this->command_line_arguments->getTimeStamp(true); });
+    ElementIngest ingest(*new_elements, (set_name.empty()) ? nullptr : &mesh->element_sets[intern_set_name(set_name)]);
+    int section_category_id = -1;
+    string previous_category_name;  // Section categories usually come in runs too, so only intern a changed one
+    string previous_category_description;
     for (int i=0; i < elements.size(); i++) {
         odb_Element element = elements.element(i);
         int element_label = element.label();
-        if (element_label == previous_label) {  // For a typical hex element we were processing it 6 times
-            continue;
-        } else {
-            previous_label = element_label;    // This will help ensure it's processed once
-        }
-        string type = element.type().CStr();
-        new_element_set.insert(element_label);
+        odb_String type = element.type();
+        int element_connectivity_size;
+        const int* const connectivity = element.connectivity(element_connectivity_size);
+        mesh_elements_type* type_elements = ingest.add(element_label, type.CStr(), connectivity, element_connectivity_size);
+        if (type_elements == nullptr) { continue; }  // Element already stored
 
+        int instance_count = 0;
         if (instance_name.empty()) {
-            if ((*new_elements)[type][element_label].instanceNames.empty()) {
-                odb_SequenceString instance_names = element.instanceNames();
-                for (int j=0; j < instance_names.size(); j++) { (*new_elements)[type][element_label].instanceNames.push_back(instance_names[j].CStr()); }
-            }
-        }
-        if ((*new_elements)[type][element_label].connectivity.empty()) {
-            int element_connectivity_size;
-            const int* const connectivity = element.connectivity(element_connectivity_size);
-            for (int j=0; j < element_connectivity_size; j++) { (*new_elements)[type][element_label].connectivity.push_back(connectivity[j]); }
-            this->log_file->logDebug("\t\tElement " + to_string(element_label) + ": connectivity count: " + to_string((*new_elements)[type][element_label].connectivity.size()) + " instances count:" + to_string((*new_elements)[type][element_label].instanceNames.size()) + " at time: " + this->command_line_arguments->getTimeStamp(true));
+            odb_SequenceString instance_names = element.instanceNames();
+            instance_count = instance_names.size();
+            for (int j=0; j < instance_count; j++) { type_elements->instance_name_ids.push_back(intern_instance_name(instance_names[j].CStr())); }
         }
-        if ((*new_elements)[type][element_label].sectionCategory.name.empty()) {
-            (*new_elements)[type][element_label].sectionCategory = process_section_category(element.sectionCategory());
+        type_elements->instance_name_offsets.push_back(type_elements->instance_name_ids.size());
+        const odb_SectionCategory &section_category = element.sectionCategory();
+        odb_String category_name = section_category.name();
+        odb_String category_description = section_category.description();
+        if ((section_category_id < 0) || (previous_category_name != category_name.CStr()) || (previous_category_description != category_description.CStr())) {
+            section_category_id = intern_section_category(section_category);
+            previous_category_name = category_name.CStr();
+            previous_category_description = category_description.CStr();
         }
+        type_elements->section_category_ids.push_back(section_category_id);
+        this->log_file->logDebug([&] { return "\t\tElement " + to_string(element_label) + ": connectivity count: " + to_string(element_connectivity_size) + " instances count:" + to_string(instance_count); });
     }
-    if (!set_name.empty()) {
-        mesh->element_sets[set_name].insert(new_element_set.begin(), new_element_set.end());
-    }
-    this->log_file->logDebug("\t\tFinished process_elements at time: " + this->command_line_arguments->getTimeStamp(true));
     return new_elements;
 }
+#endif
+
+void SpadeObject::sort_mesh () {
+    for (map<string, mesh_type>* meshes : {&this->part_mesh, &this->instance_mesh, &this->assembly_mesh}) {
+        for (auto& [mesh_name, mesh] : *meshes) {
+            sort_mesh_nodes(mesh.nodes);
+            for (auto& [type, type_elements] : mesh.elements) { sort_mesh_elements(type_elements); }
+            for (auto& [set_id, element_set] : mesh.element_sets) { sort_mesh_set(element_set); }
+            for (auto& [set_id, node_set] : mesh.node_sets) { sort_mesh_set(node_set); }
+        }
+    }
+}
+
+void SpadeObject::sort_mesh_nodes (mesh_nodes_type &nodes) {
+    if (nodes.sorted) { return; }
+    vector<size_t> order(nodes.labels.size());
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [&nodes](const size_t &a, const size_t &b) { return nodes.labels[a] < nodes.labels[b]; });
+    vector<int> labels(order.size());
+    vector<float> coordinates(nodes.coordinates.size());
+    for (size_t i=0; i < order.size(); i++) {
+        labels[i] = nodes.labels[order[i]];
+        copy_n(nodes.coordinates.begin() + order[i] * nodes.coordinate_size, nodes.coordinate_size, coordinates.begin() + i * nodes.coordinate_size);
+        nodes.label_index[labels[i]] = i;
+    }
+    nodes.labels.swap(labels);
+    nodes.coordinates.swap(coordinates);
+    nodes.sorted = true;
+}
 
+void SpadeObject::sort_mesh_elements (mesh_elements_type &elements) {
+    if (elements.sorted) { return; }
+    vector<size_t> order(elements.labels.size());
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [&elements](const size_t &a, const size_t &b) { return elements.labels[a] < elements.labels[b]; });
+    vector<int> labels(order.size());
+    vector<int> section_category_ids(order.size());
+    vector<int> connectivity;
+    vector<size_t> connectivity_offsets = {0};
+    vector<int> instance_name_ids;
+    vector<size_t> instance_name_offsets = {0};
+    connectivity.reserve(elements.connectivity.size());
+    connectivity_offsets.reserve(elements.connectivity_offsets.size());
+    instance_name_ids.reserve(elements.instance_name_ids.size());
+    instance_name_offsets.reserve(elements.instance_name_offsets.size());
+    for (size_t i=0; i < order.size(); i++) {
+        size_t old_index = order[i];
+        labels[i] = elements.labels[old_index];
+        section_category_ids[i] = elements.section_category_ids[old_index];
+        connectivity.insert(connectivity.end(), elements.connectivity.begin() + elements.connectivity_offsets[old_index], elements.connectivity.begin() + elements.connectivity_offsets[old_index + 1]);
+        connectivity_offsets.push_back(connectivity.size());
+        instance_name_ids.insert(instance_name_ids.end(), elements.instance_name_ids.begin() + elements.instance_name_offsets[old_index], elements.instance_name_ids.begin() + elements.instance_name_offsets[old_index + 1]);
+        instance_name_offsets.push_back(instance_name_ids.size());
+        elements.label_index[labels[i]] = i;
+    }
+    elements.labels.swap(labels);
+    elements.section_category_ids.swap(section_category_ids);
+    elements.connectivity.swap(connectivity);
+    elements.connectivity_offsets.swap(connectivity_offsets);
+    elements.instance_name_ids.swap(instance_name_ids);
+    elements.instance_name_offsets.swap(instance_name_offsets);
+    elements.sorted = true;
+}
+
+void SpadeObject::sort_mesh_set (mesh_set_type &mesh_set) {
+    if (mesh_set.sorted) { return; }
+    sort(mesh_set.labels.begin(), mesh_set.labels.end());
+    mesh_set.labels.erase(unique(mesh_set.labels.begin(), mesh_set.labels.end()), mesh_set.labels.end());
+    mesh_set.labels.shrink_to_fit();
+    mesh_set.sorted = true;
+}
+
+#ifndef SPADE_WITHOUT_ABAQUS
 set_type SpadeObject::process_set(const odb_Set &odb_set) {
     set_type new_set;
     new_set.nodes = nullptr;
@@ -481,6 +655,9 @@ set_type SpadeObject::process_set(const odb_Set &odb_set) {
     }
 
     new_set.name = odb_set.name().CStr();
+    Logging::Span span(*this->log_file, "process_set");
+    size_t node_count = 0;
+    size_t element_count = 0;
     switch(odb_set.type()) {
         case odb_Enum::NODE_SET: new_set.type = "Node Set"; break;
         case odb_Enum::ELEMENT_SET: new_set.type = "Element Set"; break;
@@ -492,15 +669,17 @@ set_type SpadeObject::process_set(const odb_Set &odb_set) {
     for (int i=0; i<names.size(); i++) {
         odb_String name = names.constGet(i);
         string instance_name = name.CStr();
-        this->log_file->logDebug("\t\t\tProcessing set " + new_set.name + " of type " + new_set.type + " for" + instance_name + " at time: " + this->command_line_arguments->getTimeStamp(true));
+        this->log_file->logDebug([&] { return "\t\t\tProcessing set " + new_set.name + " of type " + new_set.type + " for" + instance_name + " at time: " + this->command_line_arguments->getTimeStamp(true); });
         if (!instance_name.empty()) { new_set.instanceNames.push_back(instance_name); }
         if (new_set.type == "Node Set") {
             const odb_SequenceNode& set_nodes = odb_set.nodes(name);
+            node_count += set_nodes.size();
             if (!instance_name.empty()) {  // Don't process nodes or elements in set that doesn't belong to an instance
                 new_set.nodes = process_nodes(set_nodes, instance_name, "", new_set.name, "", 0);
             }
         } else if (new_set.type == "Element Set") {
             const odb_SequenceElement& set_elements = odb_set.elements(name);
+            element_count += set_elements.size();
             if (!instance_name.empty()) {  // Don't process nodes or elements in set that doesn't belong to an instance
                 new_set.elements = process_elements(set_elements, instance_name, "", new_set.name, "");
             }
@@ -508,18 +687,14 @@ set_type SpadeObject::process_set(const odb_Set &odb_set) {
             const odb_SequenceElement& set_elements = odb_set.elements(name);
             const odb_SequenceElementFace& set_faces = odb_set.faces(name);
             const odb_SequenceNode& set_nodes = odb_set.nodes(name);
+            node_count += set_nodes.size();
+            element_count += set_elements.size();
 
             if(set_elements.size() && set_faces.size())
             {
+                new_set.faces.reserve(set_elements.size());
                 for (int n=0; n<set_elements.size(); n++) {
-                    string face_name;
-                    int index = set_faces.constGet(n);
-                    try {
-                        face_name = this->faces_enum_strings.at(index);
-                    } catch (const std::out_of_range& e) {
-                        face_name = this->faces_enum_strings[0];
-                    }
-                    new_set.faces.push_back(face_name);
+                    new_set.faces.push_back(face_enum_value(set_faces.constGet(n)));
                 }
                 if (!instance_name.empty()) {  // Don't process nodes or elements in set that doesn't belong to an instance
                     new_set.elements = process_elements(set_elements, instance_name, "", new_set.name, "");
@@ -536,6 +711,10 @@ set_type SpadeObject::process_set(const odb_Set &odb_set) {
             this->log_file->logWarning("Unknown set type.");
         }
     }
+    span.add("set", new_set.name);
+    span.add("type", new_set.type);
+    span.add("nodes", static_cast<long long>(node_count));
+    span.add("elements", static_cast<long long>(element_count));
     return new_set;
 }
 
@@ -733,10 +912,14 @@ part_type SpadeObject::process_part (const odb_Part &part, odb_Odb &odb) {
     new_part.elements = nullptr;
     new_part.name = part.name().CStr();
     new_part.embeddedSpace = this->dimension_enum_strings[part.embeddedSpace()];
+    Logging::Span span(*this->log_file, "process_part");
+    span.add("part", new_part.name);
 
     const odb_SequenceNode& nodes = part.nodes();
     new_part.nodes = process_nodes(nodes, "", "", "", new_part.name, part.embeddedSpace());
     odb_SequenceElement elements = part.elements();
+    span.add("nodes", nodes.size());
+    span.add("elements", elements.size());
     new_part.elements = process_elements(elements, "", "", "", new_part.name);
 
     odb_SetRepositoryIT node_iter(part.nodeSets());
@@ -879,6 +1062,8 @@ instance_type SpadeObject::process_instance (const odb_Instance &instance, odb_O
     new_instance.elements = nullptr;
     new_instance.name = instance.name().CStr();
     new_instance.embeddedSpace = this->dimension_enum_strings[instance.embeddedSpace()];
+    Logging::Span span(*this->log_file, "process_instance");
+    span.add("instance", new_instance.name);
 
     this->log_file->log("Instance: " + new_instance.name);
     this->log_file->log("\tnode count: " + to_string(instance.nodes().size()));
@@ -888,6 +1073,8 @@ instance_type SpadeObject::process_instance (const odb_Instance &instance, odb_O
     new_instance.nodes = process_nodes(nodes, new_instance.name, "", "", "", instance.embeddedSpace());
     odb_SequenceElement elements = instance.elements();
     new_instance.elements = process_elements(elements, new_instance.name, "", "", "");
+    span.add("nodes", nodes.size());
+    span.add("elements", elements.size());
 
     this->log_file->logVerbose("\tnodeSets:");
     odb_SetRepositoryIT node_iter(instance.nodeSets());
@@ -1006,146 +1193,127 @@ assembly_type SpadeObject::process_assembly (odb_Assembly &assembly, odb_Odb &od
     for (int i=0; i<connector_orientations.size(); i++)  { new_assembly.connectorOrientations.push_back(process_connector_orientation(connector_orientations[i])); }
     return new_assembly;
 }
+#endif
+
+void SpadeObject::compute_field_bulk_invariants(const field_output_type &field_output, field_bulk_type &field_bulk) {
+    bool tensor = (field_output.type.rfind("Tensor", 0) == 0);
+    if ((!tensor) && (field_output.type != "Vector")) { return; }
+    map<string, string> invariant_names = {
+        {"Magnitude", "magnitude"}, {"Mises", "mises"}, {"Tresca", "tresca"}, {"Press", "press"}, {"Inv3", "inv3"},
+        {"Max Principal", "maxPrincipal"}, {"Mid Principal", "midPrincipal"}, {"Min Principal", "minPrincipal"},
+        {"Max Inplane Principal", "maxInPlanePrincipal"}, {"Min Inplane Principal", "minInPlanePrincipal"},
+        {"Out of Plane Principal", "outOfPlanePrincipal"}
+    };
+    for (const string &valid_invariant : field_output.validInvariants) {
+        auto invariant_name = invariant_names.find(valid_invariant);
+        if (invariant_name == invariant_names.end()) { continue; }
+        if ((invariant_name->second == "mises") && (!field_bulk.mises.empty())) { continue; }  // Already provided by the odb
+        field_bulk.invariants[invariant_name->second];
+    }
+    if (field_bulk.invariants.empty()) { return; }
+
+    invariant_layout_type layout;
+    if ((!invariant_layout(field_bulk.componentLabels, tensor, field_output.engineeringShear, layout)) || (layout.width != field_bulk.width)) {
+        this->log_file->logWarning("Unable to compute invariants for " + field_output.name + " " + field_bulk.dataName + " from component labels.");
+        field_bulk.invariants.clear();
+        return;
+    }
+    if (!field_bulk.data.empty()) {
+        compute_invariants(field_bulk.data.data(), field_bulk.length, layout, field_bulk.invariants);
+    } else if (!field_bulk.dataDouble.empty()) {
+        compute_invariants(field_bulk.dataDouble.data(), field_bulk.length, layout, field_bulk.invariants);
+    } else {
+        field_bulk.invariants.clear();
+    }
+}
+
+field_output_type SpadeObject::split_field_output(field_output_type &field_output) {
+    field_output_type part;
+    part.name = field_output.name;
+    part.description = field_output.description;
+    part.type = field_output.type;
+    part.dim = field_output.dim;
+    part.dim2 = field_output.dim2;
+    part.isComplex = field_output.isComplex;
+    part.engineeringShear = field_output.engineeringShear;
+    part.componentLabels = field_output.componentLabels;
+    part.validInvariants = field_output.validInvariants;
+    part.locations = field_output.locations;
+    part.writeMetadata = field_output.writeMetadata;
+    part.maxWidth = field_output.maxWidth;
+    part.maxLength = field_output.maxLength;
+    part.bulkValues = std::move(field_output.bulkValues);
+    field_output.bulkValues.clear();
+    part.remainingInstances = std::move(field_output.remainingInstances);  // Only set once all the blocks have been read
+    field_output.remainingInstances.clear();
+    vector<string> instance_names(part.remainingInstances.begin(), part.remainingInstances.end());
+    for (const field_bulk_type &field_bulk_value : part.bulkValues) {
+        if (field_bulk_value.writeFieldValues) { instance_names.push_back(field_bulk_value.instanceName); }
+    }
+    for (const string &instance_name : instance_names) {
+        auto values = field_output.values.find(instance_name);
+        if (values != field_output.values.end()) {
+            part.values[values->first] = std::move(values->second);
+            field_output.values.erase(values);
+        }
+    }
+    field_output.writeMetadata = false;
+    return part;
+}
+
+size_t SpadeObject::write_buffer_bytes() {
+    size_t buffer_bytes = std::stoull(this->command_line_arguments->get("write-buffer-mb")) * 1024 * 1024;
+    if (this->max_memory_bytes > 0) {  // The other half of the ceiling is for the field output being read
+        buffer_bytes = std::min(buffer_bytes, this->max_memory_bytes / 2);
+    }
+    return buffer_bytes;
+}
+
+void SpadeObject::release_model() {
+    this->log_file->logVerbose("Releasing the model data to stay under the memory ceiling.");
+    vector<part_type>().swap(this->parts);
+    vector<section_category_type>().swap(this->section_categories);
+    vector<user_xy_data_type>().swap(this->user_xy_data);
+    vector<contact_standard_type>().swap(this->standard_interactions);
+    vector<contact_explicit_type>().swap(this->explicit_interactions);
+    this->constraints = constraint_type();
+    this->root_assembly = assembly_type();  // Holds pointers into the meshes, so it goes first
+    map<string, mesh_type>().swap(this->instance_mesh);
+    map<string, mesh_type>().swap(this->part_mesh);
+    map<string, mesh_type>().swap(this->assembly_mesh);
+    vector<section_category_type>().swap(this->mesh_section_categories);
+    unordered_map<string, int>().swap(this->mesh_section_category_ids);
+    vector<string>().swap(this->mesh_instance_names);
+    unordered_map<string, int>().swap(this->mesh_instance_name_ids);
+    vector<string>().swap(this->mesh_set_names);
+    unordered_map<string, int>().swap(this->mesh_set_name_ids);
+}
+
+size_t SpadeObject::field_bulk_size(const field_bulk_type &field_bulk) {
+    size_t bytes = 0;
+    bytes += field_bulk.data.size() * sizeof(float) + field_bulk.conjugateData.size() * sizeof(float);
+    bytes += field_bulk.dataDouble.size() * sizeof(double) + field_bulk.conjugateDataDouble.size() * sizeof(double);
+    bytes += field_bulk.localCoordSystem.size() * sizeof(float) + field_bulk.localCoordSystemDouble.size() * sizeof(double);
+    bytes += field_bulk.mises.size() * sizeof(float) + field_bulk.faces.size() * sizeof(short);
+    for (const auto& [invariant_name, invariant_values] : field_bulk.invariants) { bytes += invariant_values.size() * sizeof(float); }
+    bytes += (field_bulk.elementLabels.size() + field_bulk.nodeLabels.size() + field_bulk.integrationPoints.size()) * sizeof(int);
+    return bytes;
+}
 
-void SpadeObject::process_field_values(const odb_FieldValue &field_value, const odb_SequenceInvariant& invariants, field_value_type &values) {
-    int elementLabel = field_value.elementLabel();
-    if (elementLabel != -1) {
-        values.elementEmpty = false;
-    }
-    values.elementLabel.push_back(elementLabel);
-    int nodeLabel = field_value.nodeLabel();
-    if (nodeLabel != -1) {
-        values.nodeEmpty = false;
-    }
-    values.nodeLabel.push_back(nodeLabel);
-    int integrationPoint = field_value.integrationPoint();
-    if (integrationPoint != -1) {
-        values.integrationPointEmpty = false;
-    }
-    values.integrationPoint.push_back(integrationPoint);
-    string value_type = get_field_type_enum(field_value.type());
-    values.type.push_back(value_type);
-    if (value_type != "") { values.typeEmpty = false; }
-    if ((invariants.isMember(odb_Enum::MAGNITUDE)) && (field_value.magnitude() != 0)) {
-        values.magnitude.push_back(field_value.magnitude());
-        values.magnitudeEmpty = false;
-    } else { values.magnitude.push_back(NAN); }
-    if ((invariants.isMember(odb_Enum::TRESCA)) && (field_value.tresca() != 0)) {
-        values.tresca.push_back(field_value.tresca());
-        values.trescaEmpty = false;
-    } else { values.tresca.push_back(NAN); }
-    if ((invariants.isMember(odb_Enum::PRESS)) && (field_value.press() != 0)) {
-        values.press.push_back(field_value.press());
-        values.pressEmpty = false;
-    } else { values.press.push_back(NAN); }
-    if ((invariants.isMember(odb_Enum::INV3)) && (field_value.inv3() != 0)) {
-        values.inv3.push_back(field_value.inv3());
-        values.inv3Empty = false;
-    } else { values.inv3.push_back(NAN); }
-    if ((invariants.isMember(odb_Enum::MAX_PRINCIPAL)) && (field_value.maxPrincipal() != 0)) {
-        values.maxPrincipal.push_back(field_value.maxPrincipal());
-        values.maxPrincipalEmpty = false;
-    } else { values.maxPrincipal.push_back(NAN); }
-    if ((invariants.isMember(odb_Enum::MID_PRINCIPAL)) && (field_value.midPrincipal() != 0)) {
-        values.midPrincipal.push_back(field_value.midPrincipal());
-        values.midPrincipalEmpty = false;
-    } else { values.midPrincipal.push_back(NAN); }
-    if ((invariants.isMember(odb_Enum::MIN_PRINCIPAL)) && (field_value.minPrincipal() != 0)) {
-        values.minPrincipal.push_back(field_value.minPrincipal());
-        values.minPrincipalEmpty = false;
-    } else { values.minPrincipal.push_back(NAN); }
-    if ((invariants.isMember(odb_Enum::MAX_INPLANE_PRINCIPAL)) && (field_value.maxInPlanePrincipal() != 0)) {
-        values.maxInPlanePrincipal.push_back(field_value.maxInPlanePrincipal());
-        values.maxInPlanePrincipalEmpty = false;
-    } else { values.maxInPlanePrincipal.push_back(NAN); }
-    if ((invariants.isMember(odb_Enum::MIN_INPLANE_PRINCIPAL)) && (field_value.minInPlanePrincipal() != 0)) {
-        values.minInPlanePrincipal.push_back(field_value.minInPlanePrincipal());
-        values.minInPlanePrincipalEmpty = false;
-    } else { values.minInPlanePrincipal.push_back(NAN); }
-    if ((invariants.isMember(odb_Enum::OUTOFPLANE_PRINCIPAL)) && (field_value.outOfPlanePrincipal() != 0)) {
-        values.outOfPlanePrincipal.push_back(field_value.outOfPlanePrincipal());
-        values.outOfPlanePrincipalEmpty = false;
-    } else { values.outOfPlanePrincipal.push_back(NAN); }
-    string section_point_number =  to_string(field_value.sectionPoint().number());
-    if (section_point_number != "-1") {
-        values.sectionPointNumber.push_back(section_point_number);
-        values.sectionPointNumberEmpty = false;
-    } else { values.sectionPointNumber.push_back(""); }
-    string section_point_description = "";
-    section_point_description =  field_value.sectionPoint().description().CStr();
-    if (section_point_description != "") {
-        values.sectionPointDescriptionEmpty = false;
-    }
-    values.sectionPointDescription.push_back(section_point_description);
-}
-
-string SpadeObject::get_field_type_enum(odb_Enum::odb_DataTypeEnum type_enum) {
-    string value_type = "";
-    switch(type_enum) {
-        case odb_Enum::SCALAR: value_type = "Scalar"; break;
-        case odb_Enum::VECTOR: value_type = "Vector"; break;
-        case odb_Enum::TENSOR_3D_FULL: value_type = "Tensor 3D Full"; break;
-        case odb_Enum::TENSOR_3D_PLANAR: value_type = "Tensor 3D Planar"; break;
-        case odb_Enum::TENSOR_3D_SURFACE: value_type = "Tensor 3D Surface"; break;
-        case odb_Enum::TENSOR_2D_PLANAR: value_type = "Tensor 2D Planar"; break;
-        case odb_Enum::TENSOR_2D_SURFACE: value_type = "Tensor 2D Surface"; break;
-    }
-    return value_type;
-}
-
-string SpadeObject::get_valid_invariant_enum(odb_Enum::odb_InvariantEnum invariant_enum) {
-    string invariant = "";
-    switch(invariant_enum) {
-        case odb_Enum::MAGNITUDE: invariant = "Magnitude"; break;
-        case odb_Enum::MISES: invariant = "Mises"; break;
-        case odb_Enum::TRESCA: invariant = "Tresca"; break;
-        case odb_Enum::PRESS: invariant = "Press"; break;
-        case odb_Enum::INV3: invariant = "Inv3"; break;
-        case odb_Enum::MAX_PRINCIPAL: invariant = "Max Principal"; break;
-        case odb_Enum::MID_PRINCIPAL: invariant = "Mid Principal"; break;
-        case odb_Enum::MIN_PRINCIPAL: invariant = "Min Principal"; break;
-        case odb_Enum::MAX_INPLANE_PRINCIPAL: invariant = "Max Inplane Principal"; break;
-        case odb_Enum::MIN_INPLANE_PRINCIPAL: invariant = "Min Inplane Principal"; break;
-        case odb_Enum::OUTOFPLANE_PRINCIPAL: invariant = "Out of Plane Principal"; break;
-    }
-    return invariant;
-}
-
-string SpadeObject::get_position_enum(odb_Enum::odb_ResultPositionEnum position_enum) {
-    string position = "";
-    switch(position_enum) {
-        case odb_Enum::NODAL: position = "Nodal"; break;
-        case odb_Enum::ELEMENT_NODAL: position = "Element Nodal"; break;
-        case odb_Enum::INTEGRATION_POINT: position = "Integration Point"; break;
-        case odb_Enum::ELEMENT_FACE: position = "Element Face"; break;
-        case odb_Enum::ELEMENT_FACE_INTEGRATION_POINT: position = "Element Face Integration Point"; break;
-        case odb_Enum::WHOLE_ELEMENT: position = "Whole Element"; break;
-        case odb_Enum::WHOLE_REGION: position = "Whole Region"; break;
-        case odb_Enum::WHOLE_PART_INSTANCE: position = "Whole Part Instance"; break;
-        case odb_Enum::WHOLE_MODEL: position = "Whole Model"; break;
-    }
-    return position;
-}
-
-frame_type SpadeObject::process_frame (const odb_Frame &frame, const int &number) {
-    frame_type new_frame;
-    new_frame.description = frame.description().CStr();
-    new_frame.loadCase = frame.loadCase().name().CStr();
-    switch(frame.domain()) {
-        case odb_Enum::TIME: new_frame.domain = "Time"; break;
-        case odb_Enum::FREQUENCY: new_frame.domain = "Frequency"; break;
-        case odb_Enum::MODAL: new_frame.domain = "Modal"; break;
-    }
-    new_frame.incrementNumber = frame.incrementNumber();
-    new_frame.cyclicModeNumber = frame.cyclicModeNumber();
-    new_frame.mode = frame.mode();
-    new_frame.frameValue = frame.frameValue();
-    new_frame.frequency = frame.frequency();
-    new_frame.number = number;  // Frame number is different than increment number, which can repeat
-
-    return new_frame;
+size_t SpadeObject::field_output_size(const field_output_type &field_output) {
+    size_t bytes = 0;
+    for (const field_bulk_type &field_bulk : field_output.bulkValues) {
+        bytes += field_bulk_size(field_bulk);
+    }
+    for (const auto& [instance_name, values] : field_output.values) {
+        bytes += (values.elementLabel.size() + values.nodeLabel.size() + values.integrationPoint.size()) * sizeof(int);
+        bytes += values.magnitude.size() * 10 * sizeof(float);  // Each invariant vector has one entry per value
+        bytes += values.type.size() + (values.sectionPointNumber.size() + values.sectionPointDescription.size()) * sizeof(string);
+    }
+    return bytes;
 }
 
+#ifndef SPADE_WITHOUT_ABAQUS
 history_point_type SpadeObject::process_history_point (const odb_HistoryPoint history_point) {
     history_point_type new_history_point;
     new_history_point.instanceName = history_point.instance().name().CStr();
@@ -1188,7 +1356,7 @@ history_point_type SpadeObject::process_history_point (const odb_HistoryPoint hi
         case odb_Enum::END2: new_history_point.face = "End 2"; break;
         case odb_Enum::END3: new_history_point.face = "End 3"; break;
     }
-    new_history_point.position = get_position_enum(history_point.position());
+    new_history_point.position = OdbModelSource::get_position_enum(history_point.position());
 
     return new_history_point;
 }
@@ -1197,12 +1365,91 @@ history_region_type SpadeObject::process_history_region(const odb_HistoryRegion
     history_region_type new_history_region;
     new_history_region.name = history_region.name().CStr();
     new_history_region.description = history_region.description().CStr();
-    new_history_region.position = get_position_enum(history_region.position());
+    new_history_region.position = OdbModelSource::get_position_enum(history_region.position());
     new_history_region.loadCase = history_region.loadCase().name().CStr();
     new_history_region.point = process_history_point(history_region.historyPoint());
     return new_history_region;
 }
 
+history_matrix_type SpadeObject::read_history_matrix (const odb_HistoryOutputRepository &history_outputs) {
+    history_matrix_type history_matrix;
+    vector<odb_HistoryOutput> requested_outputs;
+    bool all_outputs = (this->command_line_arguments->get("history") == "all");
+    bool conjugate_data_exists = false;
+    odb_HistoryOutputRepositoryIT history_outputs_iterator (history_outputs);
+    for (history_outputs_iterator.first(); !history_outputs_iterator.isDone(); history_outputs_iterator.next()) {
+        odb_HistoryOutput history_output = history_outputs_iterator.currentValue();
+        string history_output_name = history_output.name().CStr();
+        this->log_file->logVerbose("Processing data for history output " + history_output_name);
+        if ((!all_outputs) && (!this->history_set.count(history_output_name))) { continue; }
+        history_matrix.names.push_back(history_output_name);
+        history_matrix.descriptions.push_back(history_output.description().CStr());
+        string history_output_type_name = "";
+        switch(history_output.type()) {
+            case odb_Enum::SCALAR: history_output_type_name = "Scalar"; break;
+        }
+        history_matrix.types.push_back(history_output_type_name);
+        merge_time_axis(history_matrix.frame_values, history_output.data());
+        const odb_SequenceSequenceFloat& conjugate_data = history_output.conjugateData();
+        if (conjugate_data.size() != 0) {
+            conjugate_data_exists = true;
+            merge_time_axis(history_matrix.conjugate_frame_values, conjugate_data);
+        }
+        requested_outputs.push_back(history_output);
+    }
+
+    size_t rows = requested_outputs.size();
+    size_t columns = history_matrix.frame_values.size();
+    size_t conjugate_columns = history_matrix.conjugate_frame_values.size();
+    history_matrix.data.assign(rows * columns, NAN);
+    if (conjugate_data_exists) { history_matrix.conjugate_data.assign(rows * conjugate_columns, NAN); }
+    for (size_t i=0; i<rows; i++) {
+        fill_history_row(history_matrix.data.data() + i * columns, history_matrix.frame_values, requested_outputs[i].data());
+        if (conjugate_data_exists) {
+            fill_history_row(history_matrix.conjugate_data.data() + i * conjugate_columns, history_matrix.conjugate_frame_values, requested_outputs[i].conjugateData());
+        }
+    }
+    return history_matrix;
+}
+
+void SpadeObject::merge_time_axis (vector<float> &time_axis, const odb_SequenceSequenceFloat &data) {
+    int samples = data.size();
+    int i = 0;
+    for (; i<samples; i++) {  // The history outputs of a region are usually written at the same frame values
+        float frame_value = data.constGet(i).constGet(0);
+        if (i < time_axis.size()) {
+            if (frame_value != time_axis[i]) { break; }
+        } else if ((time_axis.empty()) || (frame_value > time_axis.back())) {
+            time_axis.push_back(frame_value);
+        } else {
+            break;
+        }
+    }
+    if (i == samples) { return; }
+    vector<float> frame_values(samples);
+    for (int j=0; j<samples; j++) { frame_values[j] = data.constGet(j).constGet(0); }
+    sort(frame_values.begin(), frame_values.end());
+    vector<float> merged_axis;
+    merged_axis.reserve(time_axis.size() + samples);
+    set_union(time_axis.begin(), time_axis.end(), frame_values.begin(), frame_values.end(), back_inserter(merged_axis));
+    merged_axis.erase(unique(merged_axis.begin(), merged_axis.end()), merged_axis.end());
+    time_axis.swap(merged_axis);
+}
+
+void SpadeObject::fill_history_row (float* row, const vector<float> &time_axis, const odb_SequenceSequenceFloat &data) {
+    int samples = data.size();
+    size_t column = 0;
+    for (int i=0; i<samples; i++) {
+        const odb_SequenceFloat& sample = data.constGet(i);
+        float frame_value = sample.constGet(0);
+        if ((column >= time_axis.size()) || (time_axis[column] != frame_value)) {  // Only when the samples skip frame values
+            column = lower_bound(time_axis.begin(), time_axis.end(), frame_value) - time_axis.begin();
+            if (column == time_axis.size()) { continue; }
+        }
+        row[column++] = sample.constGet(1);
+    }
+}
+
 step_type SpadeObject::process_step(const odb_Step &step, odb_Odb &odb) {
     step_type new_step;
     new_step.name = step.name().CStr();
@@ -1234,7 +1481,7 @@ step_type SpadeObject::process_step(const odb_Step &step, odb_Odb &odb) {
     return new_step;
 }
 
-void SpadeObject::write_step_data_h5 (odb_Odb &odb, H5::H5File &h5_file) {
+void SpadeObject::write_step_data_h5 (odb_Odb &odb, ModelSource &model_source, H5::H5File &h5_file) {
 
     this->log_file->logVerbose("Reading steps.");
     odb_StepRepository step_repository = odb.steps();
@@ -1248,18 +1495,26 @@ void SpadeObject::write_step_data_h5 (odb_Odb &odb, H5::H5File &h5_file) {
         if ((this->command_line_arguments->get("step") != "all") && (!this->step_set.count(current_step.name().CStr()))) {
             continue;
         }
+        Logging::Span span(*this->log_file, "step");
+        span.add("step", current_step.name().CStr());
         step_type new_step = process_step(current_step, odb);  // Process and write step data that isn't history or field output
 
-        string step_group_name = steps_group_name + "/" + replace_slashes(new_step.name);
+        string step_safe_name = replace_slashes(new_step.name);
+        string step_group_name = steps_group_name + "/" + step_safe_name;
         H5::Group step_group = create_group(h5_file, step_group_name);
-        write_string_attribute(step_group, "name", new_step.name);
-        this->log_file->logVerbose("Writing top level step data for " + new_step.name);
-        write_step(h5_file, step_group, new_step);
+        if (!this->manifest.count(step_safe_name)) {  // Steps in the manifest were written by an earlier extraction
+            write_string_attribute(step_group, "name", new_step.name);
+            this->log_file->logVerbose("Writing top level step data for " + new_step.name);
+            write_step(h5_file, step_group, new_step);
+        }
 
         // Read and write history output data
-        write_history_data_h5 (odb, h5_file, current_step, step_group_name);
+        if (this->command_line_arguments->get("shard-index") == "0") {
+            write_history_data_h5 (odb, h5_file, current_step, step_group_name);
+        }
         // Read and write field output data
-        write_frame_data_h5 (odb, h5_file, current_step, step_group_name);
+        write_frame_data_h5 (model_source, h5_file, new_step.name, step_group_name);
+        if (this->command_line_arguments->append()) { write_manifest_step(h5_file, step_safe_name); }
     }
 }
 
@@ -1274,13 +1529,19 @@ void SpadeObject::write_history_data_h5 (odb_Odb &odb, H5::H5File &h5_file, cons
         const odb_HistoryRegion& history_region = history_region_iterator.currentValue();
         string history_region_name = history_region.name().CStr();
         if ((this->command_line_arguments->get("history-region") == "all") || (this->history_region_set.count(history_region_name))) {
+            Logging::Span span(*this->log_file, "history region");
+            span.add("history region", history_region_name);
             this->log_file->logVerbose("Reading data for history region " + history_region_name);
             history_region_type new_history_region = process_history_region(history_region);
             string history_outputs_group_name;
             this->log_file->logVerbose("Writing data for history region " + history_region_name);
             string history_region_group_name = history_regions_group_name + "/" + replace_slashes(history_region_name);
-            write_history_region(h5_file, history_region_group_name, new_history_region);
-            write_string_attribute(h5_file, history_region_group_name, "name", history_region_name);
+            map<string, int> written_samples;  // Samples of each history output, kept in the manifest when appending
+            map<string, int> &history_samples = (this->command_line_arguments->append()) ? this->manifest[replace_slashes(step.name().CStr())].history_samples[replace_slashes(history_region_name)] : written_samples;
+            if (history_samples.empty()) {
+                write_history_region(h5_file, history_region_group_name, new_history_region);
+                write_string_attribute(h5_file, history_region_group_name, "name", history_region_name);
+            }
             if (this->command_line_arguments->get("format") == "odb") {
                 history_outputs_group_name = history_region_group_name + "/HistoryOutputs";
                 H5::Group history_outputs_group = create_group(h5_file, history_outputs_group_name);
@@ -1292,25 +1553,139 @@ void SpadeObject::write_history_data_h5 (odb_Odb &odb, H5::H5File &h5_file, cons
                     string history_output_name = history_output.name().CStr();
                     this->log_file->logVerbose("Writing data for history output " + history_output_name);
                     if ((this->command_line_arguments->get("history") == "all") || (this->history_set.count(history_output_name))) {
-                        write_history_output(h5_file, history_outputs_group_name + "/" + replace_slashes(history_output_name), history_output);
+                        write_history_output(h5_file, history_outputs_group_name + "/" + replace_slashes(history_output_name), history_output, history_samples[replace_slashes(history_output_name)]);
                     }
                 }
             } else if (this->command_line_arguments->get("format") == "extract") {
                 history_outputs_group_name = step.name().CStr();  // Initialize group name
                 create_extract_history_group(h5_file, new_history_region, history_outputs_group_name);  // Modifies group name
-                write_extract_history_output(h5_file, history_outputs_group_name, history_region.historyOutputs());
+                write_extract_history_output(h5_file, history_outputs_group_name, history_region.historyOutputs(), history_samples["frame_values"], history_samples["conjugateFrameValues"]);
             }
 
         }
     }
 }
+#endif
 
-void SpadeObject::write_frame_data_h5 (odb_Odb &odb, H5::H5File &h5_file, const odb_Step &step, const string &group_name) {
+void SpadeObject::write_frame_data_h5 (ModelSource &model_source, H5::H5File &h5_file, const string &step_name, const string &group_name) {
     // Read and write frame data
     string frames_group_name = group_name + "/frames";
     H5::Group frames_group = create_group(h5_file, frames_group_name);
-    const odb_SequenceFrame& frames = step.frames();
 
+    // Reading the model happens on this thread while the writer thread does all of the hdf5 writes for the frames
+    H5Writer h5_writer(*this->log_file, write_buffer_bytes());
+    manifest_step_type* step_manifest = (this->command_line_arguments->append()) ? &this->manifest[replace_slashes(step_name)] : nullptr;
+    int frame_index = (step_manifest) ? step_manifest->frames.size() : 0;  // Position of the frame in the stacked layout datasets, which only hold the requested frames
+    auto read_instance = [this] (const string &instance_name) { return selected_instance(instance_name); };
+    for (int f : select_frames(model_source, step_name)) {
+        if ((step_manifest) && (step_manifest->frames.count(f))) {  // Extracted by an earlier run
+            continue;
+        }
+        string frame_number = to_string(f);
+        if (skip_frame(step_name, f)) { continue; }
+        Logging::Span span(*this->log_file, "frame");
+        span.add("frame", f);
+        frame_type new_frame = model_source.read_frame(step_name, f);
+
+        string frame_group_name = frames_group_name + "/" + frame_number;
+        enqueue_frame(h5_writer, h5_file, frame_group_name, new_frame);
+
+        new_frame.max_length = 0;
+        new_frame.max_width = 0;
+        this->log_file->logVerbose("Reading field outputs for " + new_frame.description + ".");
+        auto write_part = field_output_writer(h5_writer, h5_file, frame_group_name, frame_number, frame_index, step_name, new_frame.frameValue);
+        for (const string &field_output_name : model_source.field_output_names(step_name, f)) {
+            if ((this->command_line_arguments->get("field") != "all") && (!this->field_set.count(field_output_name))) {
+                continue;
+            }
+            if ((this->split_by == "field") && (skip_partition("field_" + replace_slashes(field_output_name)))) { continue; }
+            this->log_file->logVerbose("Reading field output data for " + field_output_name);
+            Logging::Span field_output_span(*this->log_file, "field output");
+            field_output_span.add("field output", field_output_name);
+            size_t block_count = 0;
+            size_t field_output_bytes = 0;
+            field_output_type new_field_output = model_source.read_field_output(step_name, f, field_output_name, read_instance, [&] (field_output_type &field_output) {
+                block_count++;
+                field_output_bytes += add_field_bulk(field_output, write_part);
+            });
+            this->field_output_bytes += field_output_bytes;
+            if (field_output_span.active()) {
+                field_output_span.add("blocks", static_cast<long long>(block_count));
+                field_output_span.add("bytes", static_cast<long long>(field_output_bytes));
+            }
+            if (new_field_output.maxWidth > new_frame.max_width) {  new_frame.max_width = new_field_output.maxWidth; }
+            if (new_field_output.maxLength > new_frame.max_length) {  new_frame.max_length = new_field_output.maxLength; }
+            write_part(new_field_output);
+        }
+        frame_index++;
+        if (step_manifest) {
+            step_manifest->frames.insert(f);
+            step_manifest->new_frames.push_back(f);
+        }
+        enqueue_frame_size(h5_writer, h5_file, frame_group_name, new_frame);
+    }
+    Logging::Span span(*this->log_file, "finish writes");  // Time spent waiting on the writer thread after the last frame is read
+    h5_writer.finish();
+}
+
+void SpadeObject::write_source_step_data_h5 (ModelSource &model_source, H5::H5File &h5_file) {
+    this->log_file->logVerbose("Reading steps.");
+    string steps_group_name = "/odb/steps";
+    H5::Group steps_group = create_group(h5_file, steps_group_name);
+    for (const string &step_name : model_source.step_names()) {
+        if ((this->command_line_arguments->get("step") != "all") && (!this->step_set.count(step_name))) {
+            continue;
+        }
+        Logging::Span span(*this->log_file, "step");
+        span.add("step", step_name);
+        string step_group_name = steps_group_name + "/" + replace_slashes(step_name);
+        H5::Group step_group = create_group(h5_file, step_group_name);
+        write_string_attribute(step_group, "name", step_name);
+        write_frame_data_h5(model_source, h5_file, step_name, step_group_name);
+    }
+}
+
+bool SpadeObject::selected_instance (const string &instance_name) {
+    if ((this->command_line_arguments->get("instance") != "all") && (!this->instance_set.count(instance_name))) {
+        return false;
+    }
+    return !((this->split_by == "instance") && (skip_partition("instance_" + instance_name)));
+}
+
+size_t SpadeObject::add_field_bulk (field_output_type &field_output, const function<void(field_output_type&)> &write_part) {
+    field_bulk_type &field_bulk = field_output.bulkValues.back();
+    if ((this->command_line_arguments->get("invariants") == "computed") && (!field_output.validInvariants.empty())) {
+        compute_field_bulk_invariants(field_output, field_bulk);
+    }
+    size_t block_bytes = field_bulk_size(field_bulk);
+    if ((write_part) && (this->max_memory_bytes > 0) && (field_output_size(field_output) > this->max_memory_bytes / 2)) {
+        this->log_file->logDebug("Writing the " + to_string(field_output.bulkValues.size()) + " blocks read so far of " + field_output.name + " to stay under the memory ceiling");
+        write_part(field_output);
+    }
+    return block_bytes;
+}
+
+void SpadeObject::enqueue_frame (H5Writer &h5_writer, H5::H5File &h5_file, const string &frame_group_name, const frame_type &frame) {
+    h5_writer.enqueue([this, &h5_file, frame_group_name, new_frame = frame] () mutable {
+        this->log_file->logVerbose("Writing frame " + to_string(new_frame.number) + " data");
+        H5::Group frame_group = create_group(h5_file, frame_group_name);
+        write_frame(h5_file, frame_group, new_frame);
+    }, 0);
+}
+
+void SpadeObject::enqueue_frame_size (H5Writer &h5_writer, H5::H5File &h5_file, const string &frame_group_name, const frame_type &frame) {
+    h5_writer.enqueue([this, &h5_file, frame_group_name, max_width = frame.max_width, max_length = frame.max_length] {
+        H5::Group frame_group = create_group(h5_file, frame_group_name);
+        write_string_attribute(frame_group, "max_width", to_string(max_width));
+        write_string_attribute(frame_group, "max_length", to_string(max_length));
+    }, 0);
+    if (this->max_memory_bytes > 0) {  // Groups of this frame aren't opened again, so the cache doesn't need to keep them
+        h5_writer.enqueue([this] { close_groups(); }, 0);
+    }
+}
+
+vector<int> SpadeObject::select_frames (ModelSource &model_source, const string &step_name) {
+    int frame_count = model_source.frame_count(step_name);
     bool all_frames = true;
     stringstream string_stream(this->command_line_arguments->get("frame"));
     string each_word;
@@ -1329,8 +1704,8 @@ void SpadeObject::write_frame_data_h5 (odb_Odb &odb, H5::H5File &h5_file, const
             continue;
         }
         if (each_word[0] == '-') {  // Used for negative indexing
-            int frame_index = frames.size() + converted_int;
-            if ((frame_index < 0) || (frame_index > frames.size())) {
+            int frame_index = frame_count + converted_int;
+            if ((frame_index < 0) || (frame_index > frame_count)) {
                 this->log_file->logWarning("Invalid frame number specified.");
                 continue;
             }
@@ -1359,34 +1734,275 @@ void SpadeObject::write_frame_data_h5 (odb_Odb &odb, H5::H5File &h5_file, const
         frame_values.insert(converted_value); // Insert each word into the set
     }
 
-    for (int f=0; f<frames.size(); f++) {
-        const odb_Frame& frame = frames.constGet(f);
-        string frame_number = to_string(f);
+    vector<int> selected_frames;
+    for (int f=0; f<frame_count; f++) {
         if ((!all_frames) && (!frame_numbers.count(f))) {  // If frame number not in set of frames specified by user
             continue;
         }
-        if ((!all_frame_values) && (!frame_values.count(frame.frameValue()))) {
+        if ((!all_frame_values) && (!frame_values.count(model_source.read_frame(step_name, f).frameValue))) {
             continue;
         }
-        frame_type new_frame = process_frame(frame, f);
+        selected_frames.push_back(f);
+    }
+    return selected_frames;
+}
 
-        this->log_file->logVerbose("Writing frame " + frame_number + " data");
-        string frame_group_name = frames_group_name + "/" + frame_number;
-        H5::Group frame_group = create_group(h5_file, frame_group_name);
-        write_frame(h5_file, frame_group, new_frame);
+bool SpadeObject::skip_frame (const string &step_name, const int &frame_number) {
+    if (this->split_by.empty()) {  // Frames are shared round-robin between shards
+        return ((this->selected_frame_count++ % this->shard_count) != this->shard_index);
+    } else if (this->split_by == "step") {
+        return skip_partition("step_" + replace_slashes(step_name));
+    } else if (this->split_by == "frame-range") {
+        return skip_partition(frame_range_partition(replace_slashes(step_name), frame_number));
+    }
+    return false;  // Every shard reads the frames when split by field or instance
+}
 
-        new_frame.max_length = 0;
-        new_frame.max_width = 0;
-        this->log_file->logVerbose("Writing field outputs for " + new_frame.description + ".");
-        if (this->command_line_arguments->get("format") == "odb") {
-            write_field_outputs(h5_file, frame, frame_group_name, new_frame.max_width, new_frame.max_length);
-        } else if (this->command_line_arguments->get("format") == "extract") {
-            write_extract_field_outputs(h5_file, frame, frame_number, step.name().CStr(), new_frame.max_width, new_frame.max_length);
+bool SpadeObject::skip_partition (const string &partition) {
+    auto [skipped_partition, inserted] = this->skipped_partitions.try_emplace(partition, false);
+    if (!inserted) { return skipped_partition->second; }
+    if (((this->skipped_partitions.size() - 1) % this->shard_count) != this->shard_index) {
+        skipped_partition->second = true;
+    } else if (std::filesystem::exists(std::filesystem::path(partition_file_name(partition)))) {
+        if (partition_matches(partition_file_name(partition))) {
+            this->log_file->log("Keeping partition " + partition + " written by an earlier run");
+            this->reused_partitions.push_back(partition);
+            skipped_partition->second = true;
+        } else {
+            this->log_file->log("Replacing partition " + partition + " written by an earlier run from another odb file or with other options");
+            std::error_code remove_error;
+            std::filesystem::remove(std::filesystem::path(partition_file_name(partition)), remove_error);
+        }
+    }
+    return skipped_partition->second;
+}
+
+bool SpadeObject::partition_matches (const string &file_name) {
+    string manifest;
+    try {
+        H5::H5File partition_file(file_name, H5F_ACC_RDONLY);
+        H5::Group root_group = partition_file.openGroup("/");
+        if (!root_group.attrExists("manifest")) { return false; }
+        H5::Attribute attribute = root_group.openAttribute("manifest");
+        attribute.read(attribute.getStrType(), manifest);
+    } catch(H5::Exception& e) {
+        return false;  // E.g. a file left by a run that was killed while renaming it
+    }
+    return manifest == this->partition_manifest;
+}
+
+string SpadeObject::frame_range_partition (const string &step_name, const int &frame_number) {
+    int first_frame = (frame_number / this->frame_range_size) * this->frame_range_size;
+    return "frames_" + step_name + "_" + to_string(first_frame) + "-" + to_string(first_frame + this->frame_range_size - 1);
+}
+
+string SpadeObject::partition_root (const string &group_name, string &partition) {
+    vector<string> names;
+    stringstream group_stream(group_name);
+    string name;
+    while (std::getline(group_stream, name, '/')) {
+        if (!name.empty()) { names.push_back(name); }
+    }
+    auto is_number = [] (const string &value) { return (!value.empty()) && (std::all_of(value.begin(), value.end(), ::isdigit)); };
+    size_t depth = 0;
+    if ((this->command_line_arguments->get("format") == "odb") && (names.size() >= 5) && (names[0] == "odb") && (names[1] == "steps") && (names[3] == "frames") && (is_number(names[4]))) {
+        // odb format: /odb/steps/<step>/frames/<frame>/fieldOutputs/<field output>/<instance>
+        if (this->split_by == "step") {
+            depth = 5;
+            partition = "step_" + names[2];
+        } else if (this->split_by == "frame-range") {
+            depth = 5;
+            partition = frame_range_partition(names[2], std::stoi(names[4]));
+        } else if ((this->split_by == "field") && (names.size() >= 7) && (names[5] == "fieldOutputs")) {
+            depth = 7;
+            partition = "field_" + names[6];
+        } else if ((this->split_by == "instance") && (names.size() >= 8) && (names[5] == "fieldOutputs") && (names[7] != "locations")) {
+            depth = 8;
+            partition = "instance_" + names[7];
+        }
+    } else if ((this->command_line_arguments->get("format") == "extract") && (names.size() >= 3) && ((names[0] == "instances") || (names[0] == "assemblies")) && (names[2] == "FieldOutputs")) {
+        // extract format: /instances/<instance>/FieldOutputs/<field output>/<step>/<frame>
+        if (this->split_by == "instance") {
+            depth = 3;
+            partition = "instance_" + names[1];
+        } else if ((this->split_by == "field") && (names.size() >= 4)) {
+            depth = 4;
+            partition = "field_" + names[3];
+        } else if ((this->split_by == "step") && (names.size() >= 5)) {
+            depth = 5;
+            partition = "step_" + names[4];
+        } else if ((this->split_by == "frame-range") && (names.size() >= 6) && (is_number(names[5]))) {
+            depth = 6;
+            partition = frame_range_partition(names[4], std::stoi(names[5]));
+        }
+    }
+    string root_name;
+    for (size_t i=0; i<depth; i++) { root_name += "/" + names[i]; }
+    return root_name;
+}
+
+string SpadeObject::partition_file_name (const string &partition) {
+    string safe_partition = partition;
+    std::replace_if(safe_partition.begin(), safe_partition.end(), [] (const char &character) {
+        return (!std::isalnum(static_cast<unsigned char>(character))) && (character != '.') && (character != '-') && (character != '_');
+    }, '_');
+    return this->command_line_arguments->get("partition-prefix") + "_" + safe_partition + ".h5";
+}
+
+void SpadeObject::open_partition (H5::H5File &h5_file, const string &group_name) {
+    string partition;
+    string root_name = partition_root(group_name, partition);
+    if (root_name.empty()) { return; }
+    auto [partition_link, created] = this->partition_links.try_emplace(partition);
+    if (partition_link->second.count(root_name)) { return; }
+    string file_name = partition_file_name(partition) + ".partial";
+    try {
+        H5::H5File partition_file;
+        if (created) {
+            this->log_file->log("Creating partition file: " + file_name);
+            partition_file = H5::H5File(file_name, H5F_ACC_TRUNC, this->file_profile->creation_properties(), this->file_profile->access_properties());
+            write_string_attribute(partition_file.openGroup("/"), "manifest", this->partition_manifest);
+        } else {
+            partition_file = H5::H5File(file_name, H5F_ACC_RDWR, H5::FileCreatPropList::DEFAULT, this->file_profile->access_properties());
+        }
+        partition_file.createGroup(root_name, this->intermediate_group_properties);
+        partition_file.close();
+    } catch(H5::Exception& e) {
+        this->log_file->logErrorAndExit("Unable to create group " + root_name + " in partition file " + file_name + ". " + e.getDetailMsg());
+    }
+    // Until the partition is finished the link leads to the temporary file, which may be in another directory than the extracted file of a shard
+    std::filesystem::path extracted_directory = std::filesystem::absolute(h5_file.getFileName()).parent_path();
+    link_partition(h5_file, root_name, std::filesystem::absolute(file_name).lexically_relative(extracted_directory).string());
+    partition_link->second.insert(root_name);
+}
+
+void SpadeObject::link_partition (H5::H5File &h5_file, const string &root_name, const string &file_name) {
+    if ((group_exists(h5_file, root_name)) && (H5Ldelete(h5_file.getId(), root_name.c_str(), H5P_DEFAULT) < 0)) {
+        this->log_file->logWarning("Unable to remove link " + root_name + ".");
+    }
+    if (H5Lcreate_external(file_name.c_str(), root_name.c_str(), h5_file.getId(), root_name.c_str(), this->intermediate_group_properties.getId(), H5P_DEFAULT) < 0) {
+        this->log_file->logWarning("Unable to link " + root_name + " to partition file " + file_name + ".");
+    }
+}
+
+void SpadeObject::link_partition_groups (H5::H5File &h5_file, H5::H5File &partition_file, const string &group_name, const string &file_name) {
+    try {
+        H5::Group group = partition_file.openGroup(group_name);
+        string prefix = (group_name == "/") ? group_name : group_name + "/";
+        for (hsize_t i=0; i<group.getNumObjs(); i++) {
+            string member_name = group.getObjnameByIdx(i);
+            if (group.childObjType(member_name) != H5O_TYPE_GROUP) { continue; }
+            string member_group_name = prefix + member_name;
+            string partition;
+            if (partition_root(member_group_name, partition) == member_group_name) {
+                link_partition(h5_file, member_group_name, file_name);
+            } else {
+                link_partition_groups(h5_file, partition_file, member_group_name, file_name);
+            }
+        }
+    } catch(H5::Exception& e) {
+        this->log_file->logWarning("Unable to read group " + group_name + " of partition file " + file_name + ". " + e.getDetailMsg());
+    }
+}
+
+void SpadeObject::finish_partitions (H5::H5File &h5_file) {
+    if (this->split_by.empty()) { return; }
+    for (const auto& [partition, root_names] : this->partition_links) {
+        string file_name = partition_file_name(partition);
+        std::error_code rename_error;
+        std::filesystem::rename(file_name + ".partial", file_name, rename_error);
+        if (rename_error) {
+            this->log_file->logWarning("Unable to rename partition file " + file_name + ".partial. " + rename_error.message());
+            continue;
+        }
+        string linked_file_name = std::filesystem::path(file_name).filename().string();  // Partition files stay next to the extracted file
+        for (const string &root_name : root_names) { link_partition(h5_file, root_name, linked_file_name); }
+    }
+    for (const string &partition : this->reused_partitions) {
+        string file_name = partition_file_name(partition);
+        try {
+            H5::H5File partition_file(file_name, H5F_ACC_RDONLY);
+            link_partition_groups(h5_file, partition_file, "/", std::filesystem::path(file_name).filename().string());
+            partition_file.close();
+        } catch(const H5::FileIException&) {
+            this->log_file->logWarning("Unable to open partition file " + file_name + ".");
+        }
+    }
+    this->log_file->log("Linked " + to_string(this->partition_links.size()) + " partition files written by this run and " + to_string(this->reused_partitions.size()) + " kept from earlier runs.");
+}
+
+void SpadeObject::read_manifest (H5::H5File &h5_file) {
+    string extracted_file = this->command_line_arguments->get("extracted-file");
+    if (!h5_file.nameExists("manifest")) {
+        throw std::runtime_error(extracted_file + " has no manifest. Only files extracted with the append option can be appended to");
+    }
+    int frame_count = 0;
+    try {
+        H5::Group manifest_group = h5_file.openGroup("manifest");
+        for (const string &option : {"format", "layout", "metadata-layout"}) {
+            H5::Attribute attribute = manifest_group.openAttribute(option);
+            string value;
+            attribute.read(attribute.getStrType(), value);
+            if (value != this->command_line_arguments->get(option)) {
+                throw std::runtime_error(extracted_file + " was extracted with the " + value + " " + option + ", which has to be used to append to it");
+            }
+        }
+        if (!manifest_group.nameExists("steps")) { return; }
+        H5::Group steps_group = manifest_group.openGroup("steps");
+        for (hsize_t i=0; i<steps_group.getNumObjs(); i++) {
+            string step_name = steps_group.getObjnameByIdx(i);
+            H5::Group step_group = steps_group.openGroup(step_name);
+            manifest_step_type &step_manifest = this->manifest[step_name];
+            if (step_group.nameExists("frames")) {
+                H5::DataSet dataset_frames = step_group.openDataSet("frames");
+                hsize_t frames_dimensions[1];
+                dataset_frames.getSpace().getSimpleExtentDims(frames_dimensions);
+                vector<int> frames(frames_dimensions[0]);
+                dataset_frames.read(frames.data(), H5::PredType::NATIVE_INT);
+                step_manifest.frames.insert(frames.begin(), frames.end());
+                frame_count += frames.size();
+            }
+            if (!step_group.nameExists("historyRegions")) { continue; }
+            H5::Group history_regions_group = step_group.openGroup("historyRegions");
+            for (hsize_t j=0; j<history_regions_group.getNumObjs(); j++) {
+                string history_region_name = history_regions_group.getObjnameByIdx(j);
+                H5::Group history_region_group = history_regions_group.openGroup(history_region_name);
+                for (int k=0; k<history_region_group.getNumAttrs(); k++) {
+                    H5::Attribute attribute = history_region_group.openAttribute(k);
+                    attribute.read(H5::PredType::NATIVE_INT, &step_manifest.history_samples[history_region_name][attribute.getName()]);
+                }
+            }
         }
-        write_string_attribute(frame_group, "max_width", to_string(new_frame.max_width));
-        write_string_attribute(frame_group, "max_length", to_string(new_frame.max_length));
+    } catch(H5::Exception& e) {
+        throw std::runtime_error("Unable to read the manifest of " + extracted_file + ". " + e.getDetailMsg());
     }
+    this->log_file->log("Appending to " + extracted_file + ", which holds " + to_string(frame_count) + " frames of " + to_string(this->manifest.size()) + " steps.");
+}
 
+void SpadeObject::write_manifest_step (H5::H5File &h5_file, const string &step_name) {
+    manifest_step_type &step_manifest = this->manifest[step_name];
+    string step_group_name = "/manifest/steps/" + step_name;
+    try {
+        H5::Group step_group = create_group(h5_file, step_group_name);
+        if (!step_manifest.new_frames.empty()) {
+            append_rows(step_group, "frames", step_manifest.new_frames.size(), 0, H5::PredType::NATIVE_INT, H5::PredType::NATIVE_INT, step_manifest.new_frames.data());
+            step_manifest.new_frames.clear();
+        }
+        for (const auto& [history_region_name, history_samples] : step_manifest.history_samples) {
+            H5::Group history_region_group = create_group(h5_file, step_group_name + "/historyRegions/" + history_region_name);
+            for (const auto& [history_output_name, samples] : history_samples) {  // One attribute per history output, updated in place by later runs
+                H5::Attribute attribute;
+                if (history_region_group.attrExists(history_output_name)) {
+                    attribute = history_region_group.openAttribute(history_output_name);
+                } else {
+                    attribute = history_region_group.createAttribute(history_output_name, H5::PredType::NATIVE_INT, H5::DataSpace(H5S_SCALAR));
+                }
+                attribute.write(H5::PredType::NATIVE_INT, &samples);
+            }
+        }
+    } catch(H5::Exception& e) {
+        this->log_file->logWarning("Unable to write the manifest of step " + step_name + ". " + e.getDetailMsg());
+    }
 }
 
 void SpadeObject::write_h5_without_steps (H5::H5File &h5_file) {
@@ -1467,10 +2083,10 @@ void SpadeObject::write_h5_without_steps (H5::H5File &h5_file) {
     write_assembly(h5_file, "odb/rootAssembly");
 }
 
-void SpadeObject::write_vtk_data (H5::H5File &h5_file) {
+void SpadeObject::write_vtk_data (ModelSource &model_source, H5::H5File &h5_file) {
 
     // Specification at: https://docs.vtk.org/en/latest/design_documents/VTKFileFormats.html#vtkhdf-file-format
-    this->log_file->logVerbose("Writing top level data to odb group.");
+    this->log_file->logVerbose("Writing top level data to VTKHDF group.");
     H5::Group vtkhdf_group = create_group(h5_file, "/VTKHDF");
     write_string_attribute(vtkhdf_group, "Type", "UnstructuredGrid");  // Type can be: ImageData, PolyData, UnstructuredGrid, OverlappingAMR, PartitionedDataSetCollection or MultiBlockDataSet
     int version[2] = {2, 2};
@@ -1480,33 +2096,355 @@ void SpadeObject::write_vtk_data (H5::H5File &h5_file) {
     H5::Group point_data_group = create_group(h5_file, "/VTKHDF/PointData");
     H5::Group cell_data_group = create_group(h5_file, "/VTKHDF/CellData");
     H5::Group field_data_group = create_group(h5_file, "/VTKHDF/FieldData");
+    write_vtk_mesh(h5_file);
+
+    // Each selected frame becomes a step of the vtk file at the total time of the frame, so the steps of the odb follow each other
+    vector<double> step_values;
+    H5Writer h5_writer(*this->log_file, write_buffer_bytes());
+    auto read_instance = [this] (const string &instance_name) { return selected_instance(instance_name); };
+    auto add_block = [this] (field_output_type &field_output) { add_field_bulk(field_output, nullptr); };
+    for (const string &step_name : model_source.step_names()) {
+        if ((this->command_line_arguments->get("step") != "all") && (!this->step_set.count(step_name))) {
+            continue;
+        }
+        double step_total_time = model_source.step_total_time(step_name);
+        for (int f : select_frames(model_source, step_name)) {
+            int step_index = step_values.size();
+            step_values.push_back(step_total_time + model_source.read_frame(step_name, f).frameValue);
+            this->log_file->logVerbose("Reading field outputs for frame " + to_string(f) + " of step " + step_name + ".");
+
+            for (const string &field_output_name : model_source.field_output_names(step_name, f)) {
+                if ((this->command_line_arguments->get("field") != "all") && (!this->field_set.count(field_output_name))) {
+                    continue;
+                }
+                this->log_file->logVerbose("Reading field output data for " + field_output_name);
+                field_output_type new_field_output = model_source.read_field_output(step_name, f, field_output_name, read_instance, add_block);
+                size_t field_output_bytes = field_output_size(new_field_output);
+                h5_writer.enqueue([this, &h5_file, step_index, field_output = std::move(new_field_output)] () mutable {
+                    write_vtk_field_output(h5_file, step_index, field_output);
+                }, field_output_bytes);
+            }
+        }
+    }
+    h5_writer.finish();
+    write_vtk_steps(h5_file, step_values);
 }
 
-H5::Group SpadeObject::open_subgroup(H5::H5File &h5_file, const string &sub_group_name, bool &exists) {
-    // Recursively call open_subgroup until all subgroups exist
+void SpadeObject::write_vtk_mesh (H5::H5File &h5_file) {
+    this->log_file->logVerbose("Writing vtk points and cells.");
+    vector<float> points;
+    vector<long long> connectivity;
+    vector<long long> offsets = {0};
+    vector<unsigned char> types;
+    for (const auto& [instance_name, instance] : this->instance_mesh) {
+        add_vtk_mesh(instance_name, instance.nodes, instance.elements, points, connectivity, offsets, types);
+    }
+    if ((this->root_assembly.nodes) && (this->root_assembly.elements)) {  // Field output of the root assembly is stored with the default instance name
+        add_vtk_mesh(this->default_instance_name, *this->root_assembly.nodes, *this->root_assembly.elements, points, connectivity, offsets, types);
+    }
+    this->log_file->logDebug("Writing " + to_string(this->vtk_point_count) + " points and " + to_string(this->vtk_cell_count) + " cells to the vtk file");
+
+    H5::Group vtkhdf_group = create_group(h5_file, "/VTKHDF");
+    write_long_vector_dataset(vtkhdf_group, "NumberOfPoints", {static_cast<long long>(this->vtk_point_count)});
+    write_long_vector_dataset(vtkhdf_group, "NumberOfCells", {static_cast<long long>(this->vtk_cell_count)});
+    write_long_vector_dataset(vtkhdf_group, "NumberOfConnectivityIds", {static_cast<long long>(connectivity.size())});
+    write_float_2D_array(vtkhdf_group, "Points", this->vtk_point_count, 3, points.data());
+    write_long_vector_dataset(vtkhdf_group, "Connectivity", connectivity);
+    write_long_vector_dataset(vtkhdf_group, "Offsets", offsets);
+    if (types.empty()) { return; }
+    hsize_t dimensions[] = {types.size()};
+    H5::DataSpace dataspace(1, dimensions);
     try {
-        exists = true;
-        return h5_file.openGroup(sub_group_name.c_str());
+        H5::DataSet dataset = vtkhdf_group.createDataSet("Types", H5::PredType::NATIVE_UCHAR, dataspace, dataset_properties(1, dimensions, sizeof(unsigned char), false));
+        dataset.write(types.data(), H5::PredType::NATIVE_UCHAR);
+        dataset.close();
     } catch(H5::Exception& e) {
-        std::filesystem::path sub_group_path(sub_group_name);
-        string parent_path = sub_group_path.parent_path().string();
-        H5::Group parent_group = open_subgroup(h5_file, parent_path, exists);
+        this->log_file->logWarning("Unable to create dataset Types. " + e.getDetailMsg());
     }
-    exists = false;
-    return create_group(h5_file, sub_group_name);
+    dataspace.close();
 }
 
-
-void SpadeObject::write_mesh(H5::H5File &h5_file) {
-    this->log_file->logDebug("\tCalled write_mesh at time: " + this->command_line_arguments->getTimeStamp(true));
-    string embedded_space;
-    for (auto [part_name, part] : this->part_mesh) {
+void SpadeObject::add_vtk_mesh (const string &instance_name, const mesh_nodes_type &nodes, const map<string, mesh_elements_type> &elements, vector<float> &points, vector<long long> &connectivity, vector<long long> &offsets, vector<unsigned char> &types) {
+    vtk_mesh_index_type &mesh_index = this->vtk_mesh_index[instance_name];
+    mesh_index.point_offset = this->vtk_point_count;
+    mesh_index.nodes = &nodes;
+    points.reserve(points.size() + nodes.labels.size() * 3);
+    for (size_t i=0; i<nodes.labels.size(); i++) {
+        auto coordinates = nodes.coordinates.begin() + i * nodes.coordinate_size;
+        points.insert(points.end(), coordinates, coordinates + nodes.coordinate_size);
+        points.insert(points.end(), 3 - nodes.coordinate_size, 0.0f);  // Two dimensional nodes are put in the z=0 plane
+    }
+    this->vtk_point_count += nodes.labels.size();
+
+    auto find_point = [this] (const string &node_instance_name, const int &node_label) -> long long {
+        auto node_mesh = this->vtk_mesh_index.find(node_instance_name);
+        if ((node_mesh == this->vtk_mesh_index.end()) || (!node_mesh->second.nodes)) { return -1; }
+        auto node = node_mesh->second.nodes->label_index.find(node_label);
+        if (node == node_mesh->second.nodes->label_index.end()) { return -1; }
+        return node_mesh->second.point_offset + node->second;
+    };
+
+    set<string> unsupported_types;
+    int missing_node_count = 0;
+    vector<long long> cell_points;
+    for (const auto& [element_type, type_elements] : elements) {
+        for (size_t i=0; i<type_elements.labels.size(); i++) {
+            size_t connectivity_start = type_elements.connectivity_offsets[i];
+            int node_count = type_elements.connectivity_offsets[i + 1] - connectivity_start;
+            int cell_type = vtk_cell_type(element_type, node_count);
+            if (cell_type == 0) {
+                unsupported_types.insert(element_type);
+                continue;
+            }
+            size_t instance_name_start = type_elements.instance_name_offsets[i];
+            bool node_instances = ((type_elements.instance_name_offsets[i + 1] - instance_name_start) == node_count);  // Assembly level elements name the instance of each node
+            cell_points.clear();
+            for (int j=0; j<node_count; j++) {
+                string node_instance_name = (node_instances) ? this->mesh_instance_names[type_elements.instance_name_ids[instance_name_start + j]] : instance_name;
+                if (node_instance_name.empty()) { node_instance_name = instance_name; }
+                long long point = find_point(node_instance_name, type_elements.connectivity[connectivity_start + j]);
+                if (point < 0) { break; }
+                cell_points.push_back(point);
+            }
+            if (cell_points.size() != node_count) {
+                missing_node_count++;
+                continue;
+            }
+            if (cell_type == 21) { std::swap(cell_points[1], cell_points[2]); }  // Abaqus numbers the middle node of a quadratic line second and vtk numbers it last
+            connectivity.insert(connectivity.end(), cell_points.begin(), cell_points.end());
+            offsets.push_back(connectivity.size());
+            types.push_back(cell_type);
+            mesh_index.cell_index[type_elements.labels[i]] = this->vtk_cell_count++;
+        }
+    }
+    for (const string &element_type : unsupported_types) {
+        this->log_file->logWarning("Elements of type " + element_type + " in " + instance_name + " have no matching vtk cell type and are left out of the vtk file.");
+    }
+    if (missing_node_count > 0) {
+        this->log_file->logWarning(to_string(missing_node_count) + " elements in " + instance_name + " use nodes that weren't found and are left out of the vtk file.");
+    }
+}
+
+int SpadeObject::vtk_cell_type (const string &element_type, const int &node_count) {
+    if (node_count == 1) { return 1; }  // VTK_VERTEX, e.g. for MASS, ROTARYI, or SPRING1 elements
+    // Dimension of the shape of each family of elements, the family is the longest name matching the start of the element type
+    static const map<string, int> family_dimensions = {
+        {"AC1D", 1}, {"B2", 1}, {"B3", 1}, {"CONN", 1}, {"DASHPOT", 1}, {"DC1D", 1}, {"DCC1D", 1}, {"DSAX", 1}, {"ELBOW", 1},
+        {"FRAME", 1}, {"GAP", 1}, {"ITS", 1}, {"JOINT", 1}, {"MAX", 1}, {"MGAX", 1}, {"PIPE", 1}, {"R2D", 1}, {"RAX", 1},
+        {"RB2D", 1}, {"RB3D", 1}, {"SAX", 1}, {"SFMAX", 1}, {"SFMGAX", 1}, {"SPRING", 1}, {"T2D", 1}, {"T3D", 1},
+        {"AC2D", 2}, {"ACAX", 2}, {"CAX", 2}, {"CGAX", 2}, {"COH2D", 2}, {"COHAX", 2}, {"CPE", 2}, {"CPEG", 2}, {"CPS", 2},
+        {"DC2D", 2}, {"DCAX", 2}, {"DCC2D", 2}, {"DCCAX", 2}, {"DS3", 2}, {"DS4", 2}, {"DS6", 2}, {"DS8", 2}, {"M3D", 2},
+        {"R3D", 2}, {"S3", 2}, {"S4", 2}, {"S8", 2}, {"S9", 2}, {"SFM3D", 2}, {"STRI", 2},
+        {"AC3D", 3}, {"C3D", 3}, {"COH3D", 3}, {"DC3D", 3}, {"DCC3D", 3}, {"GK3D", 3}, {"SC6", 3}, {"SC8", 3},
+    };
+    int dimension = 0;
+    size_t family_length = 0;
+    for (const auto& [family, family_dimension] : family_dimensions) {
+        if ((family.size() > family_length) && (element_type.compare(0, family.size(), family) == 0)) {
+            dimension = family_dimension;
+            family_length = family.size();
+        }
+    }
+    // Values from vtkCellType.h, the nodes of these Abaqus elements are in the same order as the vtk cells except for quadratic lines
+    static const map<pair<int, int>, int> cell_types = {
+        {{1, 2}, 3},  // VTK_LINE
+        {{1, 3}, 21},  // VTK_QUADRATIC_EDGE
+        {{2, 3}, 5},  // VTK_TRIANGLE
+        {{2, 4}, 9},  // VTK_QUAD
+        {{2, 6}, 22},  // VTK_QUADRATIC_TRIANGLE
+        {{2, 8}, 23},  // VTK_QUADRATIC_QUAD
+        {{2, 9}, 28},  // VTK_BIQUADRATIC_QUAD
+        {{3, 4}, 10},  // VTK_TETRA
+        {{3, 5}, 14},  // VTK_PYRAMID
+        {{3, 6}, 13},  // VTK_WEDGE
+        {{3, 8}, 12},  // VTK_HEXAHEDRON
+        {{3, 10}, 24},  // VTK_QUADRATIC_TETRA
+        {{3, 15}, 26},  // VTK_QUADRATIC_WEDGE
+        {{3, 20}, 25},  // VTK_QUADRATIC_HEXAHEDRON
+    };
+    auto cell_type = cell_types.find({dimension, node_count});
+    return (cell_type != cell_types.end()) ? cell_type->second : 0;
+}
+
+void SpadeObject::write_vtk_field_output (H5::H5File &h5_file, const int &step_index, field_output_type &field_output) {
+    string array_name = replace_slashes(field_output.name);
+    this->log_file->logVerbose("Writing vtk field output data for " + field_output.name);
+    int width = field_output.componentLabels.size();
+    if (width == 0) {
+        for (const field_bulk_type &field_bulk_value : field_output.bulkValues) { width = max(width, field_bulk_value.width); }
+    }
+    width = max(width, 1);
+
+    vector<double> point_values;
+    vector<double> cell_values;
+    vector<int> cell_counts;  // Number of values summed for each cell, e.g. one per integration point
+    bool double_precision = false;
+    for (const field_bulk_type &field_bulk_value : field_output.bulkValues) {
+        auto mesh_index = this->vtk_mesh_index.find(field_bulk_value.instanceName);
+        if (mesh_index == this->vtk_mesh_index.end()) { continue; }
+        const vtk_mesh_index_type &mesh = mesh_index->second;
+        bool single_precision = !field_bulk_value.data.empty();
+        if ((!single_precision) && (field_bulk_value.dataDouble.empty())) { continue; }
+        double_precision = (double_precision) || (!single_precision);
+
+        // Components are matched by label, since blocks of some element types hold fewer components than the field output
+        vector<int> columns(field_bulk_value.width, -1);
+        for (int j=0; j<field_bulk_value.width; j++) {
+            if ((field_output.componentLabels.empty()) || (j >= field_bulk_value.componentLabels.size())) {
+                columns[j] = (j < width) ? j : -1;
+                continue;
+            }
+            auto component = find(field_output.componentLabels.begin(), field_output.componentLabels.end(), field_bulk_value.componentLabels[j]);
+            columns[j] = (component != field_output.componentLabels.end()) ? distance(field_output.componentLabels.begin(), component) : -1;
+        }
+        auto value = [&field_bulk_value, single_precision] (const int &row, const int &column) -> double {
+            size_t index = static_cast<size_t>(row) * field_bulk_value.width + column;
+            return (single_precision) ? field_bulk_value.data[index] : field_bulk_value.dataDouble[index];
+        };
+
+        if (!field_bulk_value.nodeLabels.empty()) {
+            if (point_values.empty()) { point_values.assign(this->vtk_point_count * width, NAN); }
+            for (int i=0; i<field_bulk_value.length; i++) {
+                auto node = mesh.nodes->label_index.find(field_bulk_value.nodeLabels[i]);
+                if (node == mesh.nodes->label_index.end()) { continue; }
+                size_t row = mesh.point_offset + node->second;
+                for (int j=0; j<field_bulk_value.width; j++) {
+                    if (columns[j] >= 0) { point_values[row * width + columns[j]] = value(i, j); }
+                }
+            }
+        } else if (!field_bulk_value.elementLabels.empty()) {
+            if (cell_values.empty()) {
+                cell_values.assign(this->vtk_cell_count * width, 0.0);
+                cell_counts.assign(this->vtk_cell_count, 0);
+            }
+            for (int i=0; i<field_bulk_value.length; i++) {
+                auto cell = mesh.cell_index.find(field_bulk_value.elementLabels[i]);
+                if (cell == mesh.cell_index.end()) { continue; }
+                cell_counts[cell->second]++;
+                for (int j=0; j<field_bulk_value.width; j++) {
+                    if (columns[j] >= 0) { cell_values[cell->second * width + columns[j]] += value(i, j); }
+                }
+            }
+        }
+    }
+    for (size_t cell=0; cell<cell_counts.size(); cell++) {
+        for (int j=0; j<width; j++) {
+            double &cell_value = cell_values[cell * width + j];
+            cell_value = (cell_counts[cell] > 0) ? cell_value / cell_counts[cell] : NAN;
+        }
+    }
+
+    if (!point_values.empty()) {
+        H5::Group point_data_group = create_group(h5_file, "/VTKHDF/PointData");
+        write_vtk_array(point_data_group, this->vtk_point_arrays, array_name, step_index, this->vtk_point_count, width, double_precision, point_values);
+    }
+    if (!cell_values.empty()) {
+        H5::Group cell_data_group = create_group(h5_file, "/VTKHDF/CellData");
+        write_vtk_array(cell_data_group, this->vtk_cell_arrays, array_name, step_index, this->vtk_cell_count, width, double_precision, cell_values);
+    }
+}
+
+void SpadeObject::write_vtk_array (const H5::Group &group, map<string, vtk_array_type> &arrays, const string &array_name, const int &step_index, const size_t &row_size, const int &width, const bool &double_precision, const vector<double> &values) {
+    vtk_array_type &array = arrays[array_name];
+    if (array.offsets.empty()) {
+        array.width = width;
+        array.double_precision = double_precision;
+    } else if (array.width != width) {
+        this->log_file->logWarning("Unable to write step " + to_string(step_index) + " of vtk array " + array_name + ". The number of components changed.");
+        return;
+    }
+    const H5::PredType &data_type = (array.double_precision) ? H5::PredType::NATIVE_DOUBLE : H5::PredType::NATIVE_FLOAT;
+    long long offset = append_rows(group, array_name, row_size, (width > 1) ? width : 0, data_type, H5::PredType::NATIVE_DOUBLE, values.data());
+    if (array.offsets.size() <= step_index) { array.offsets.resize(step_index + 1, -1); }
+    array.offsets[step_index] = offset;
+}
+
+void SpadeObject::write_vtk_steps (H5::H5File &h5_file, const vector<double> &step_values) {
+    if (step_values.empty()) { return; }  // Without a Steps group the file is read as a single static data set
+    this->log_file->logVerbose("Writing " + to_string(step_values.size()) + " vtk steps.");
+    int step_count = step_values.size();
+    H5::Group steps_group = create_group(h5_file, "/VTKHDF/Steps");
+    write_integer_array_attribute(steps_group, "NSteps", 1, &step_count);
+    write_double_vector_dataset(steps_group, "Values", step_values);
+
+    // The mesh doesn't change, so every step uses the one partition at the start of the mesh datasets
+    vector<long long> zero_offsets(step_count, 0);
+    write_long_vector_dataset(steps_group, "PartOffsets", zero_offsets);
+    write_long_vector_dataset(steps_group, "NumberOfParts", vector<long long>(step_count, 1));
+    write_long_vector_dataset(steps_group, "PointOffsets", zero_offsets);
+    append_rows(steps_group, "CellOffsets", step_count, 1, H5::PredType::NATIVE_LLONG, H5::PredType::NATIVE_LLONG, zero_offsets.data());  // One column per cell topology, an UnstructuredGrid has one
+    append_rows(steps_group, "ConnectivityIdOffsets", step_count, 1, H5::PredType::NATIVE_LLONG, H5::PredType::NATIVE_LLONG, zero_offsets.data());
+    create_group(h5_file, "/VTKHDF/Steps/FieldDataOffsets");
+
+    vector<tuple<string, map<string, vtk_array_type>*, size_t>> data_groups = {
+        {"PointData", &this->vtk_point_arrays, this->vtk_point_count},
+        {"CellData", &this->vtk_cell_arrays, this->vtk_cell_count},
+    };
+    for (auto& [data_group_name, arrays, row_size] : data_groups) {
+        H5::Group data_group = create_group(h5_file, "/VTKHDF/" + data_group_name);
+        H5::Group offsets_group = create_group(h5_file, "/VTKHDF/Steps/" + data_group_name + "Offsets");
+        for (auto& [array_name, array] : *arrays) {
+            array.offsets.resize(step_count, -1);
+            if (find(array.offsets.begin(), array.offsets.end(), -1) != array.offsets.end()) {  // Steps without data all use one block of NaN values
+                vector<double> missing_values(row_size * array.width, NAN);
+                const H5::PredType &data_type = (array.double_precision) ? H5::PredType::NATIVE_DOUBLE : H5::PredType::NATIVE_FLOAT;
+                long long missing_offset = append_rows(data_group, array_name, row_size, (array.width > 1) ? array.width : 0, data_type, H5::PredType::NATIVE_DOUBLE, missing_values.data());
+                replace(array.offsets.begin(), array.offsets.end(), -1LL, missing_offset);
+            }
+            write_long_vector_dataset(offsets_group, array_name, array.offsets);
+        }
+    }
+}
+
+H5::Group SpadeObject::open_subgroup(H5::H5File &h5_file, const string &sub_group_name, bool &exists) {
+    auto cached_group = this->group_cache.find(sub_group_name);
+    if (cached_group != this->group_cache.end()) {
+        exists = true;
+        return cached_group->second;
+    }
+    try {
+        if (!this->split_by.empty()) { open_partition(h5_file, sub_group_name); }
+        exists = group_exists(h5_file, sub_group_name);
+        H5::Group group;
+        if (exists) {
+            group = h5_file.openGroup(sub_group_name);
+        } else {
+            group = h5_file.createGroup(sub_group_name, this->intermediate_group_properties);  // Creates missing parent groups too
+        }
+        this->group_cache.emplace(sub_group_name, group);
+        return group;
+    } catch(H5::Exception& e) {
+        this->log_file->logErrorAndExit("Unable to create or open group " + sub_group_name + ". " + e.getDetailMsg());
+    }
+    return H5::Group();
+}
+
+bool SpadeObject::group_exists(H5::H5File &h5_file, const string &group_name) {
+    size_t separator = 0;
+    while (separator != string::npos) {
+        separator = group_name.find('/', separator + 1);
+        string path = group_name.substr(0, separator);
+        if (this->group_cache.find(path) != this->group_cache.end()) { continue; }
+        if (!h5_file.nameExists(path)) { return false; }
+    }
+    return true;
+}
+
+void SpadeObject::close_groups() {
+    this->group_cache.clear();  // The groups close when the last handle to them is destroyed
+}
+
+
+void SpadeObject::write_mesh(H5::H5File &h5_file) {
+    Logging::Span span(*this->log_file, "write_mesh");
+    string embedded_space;
+    for (const auto& [part_name, part] : this->part_mesh) {
         embedded_space = "";
         string part_group_name = "/parts/" + replace_slashes(part_name);
         bool sub_group_exists = false;
         H5::Group extract_part_group = open_subgroup(h5_file, part_group_name, sub_group_exists);
         write_string_attribute(extract_part_group, "name", part_name);
-        if (!part.nodes.empty() || !part.elements.empty()) {
+        if (!part.nodes.labels.empty() || !part.elements.empty()) {
             if (part.part_index >= 0) {
                 if (!this->parts[part.part_index].embeddedSpace.empty()) {
                     embedded_space = this->parts[part.part_index].embeddedSpace;
@@ -1515,122 +2453,87 @@ void SpadeObject::write_mesh(H5::H5File &h5_file) {
             }
             string part_mesh_group_name = part_group_name + "/Mesh";
             H5::Group part_mesh_group = create_group(h5_file, part_mesh_group_name);
-            if (!part.nodes.empty()) {
+            if (!part.nodes.labels.empty()) {
                 write_mesh_nodes(h5_file, part_mesh_group, part_mesh_group_name, part.nodes, embedded_space);
             }
             if (!part.elements.empty()) {
                 write_mesh_elements(h5_file, part_mesh_group, part_mesh_group_name, part.elements);
             }
         }
-        if (!part.element_sets.empty()) {
-            H5::Group element_sets = create_group(h5_file, part_group_name + "/element_sets");
-            std::regex elements_pattern("\\s*ALL\\s*ELEMENTS\\s*");
-            for (auto [set_name, element_set] : part.element_sets) {
-                if ((!element_set.empty()) && (!regex_match(set_name, elements_pattern))) {
-                    vector<int> element_labels(element_set.begin(), element_set.end());
-                    write_integer_vector_dataset(element_sets, set_name, element_labels);
-                }
-            }
-        }
-        if (!part.node_sets.empty()) {
-            H5::Group node_sets = create_group(h5_file, part_group_name + "/node_sets");
-            std::regex nodes_pattern("\\s*ALL\\s*NODES\\s*");
-            for (auto [set_name, node_set] : part.node_sets) {
-                if ((!node_set.empty()) && (!regex_match(set_name, nodes_pattern))) {
-                    vector<int> node_labels(node_set.begin(), node_set.end());
-                    write_integer_vector_dataset(node_sets, set_name, node_labels);
-                }
-            }
-        }
+        write_mesh_sets(h5_file, part_group_name, part);
     }
     string assembly_group_name = "/assemblies/" + replace_slashes(this->root_assembly.name);
     bool sub_group_exists = false;
     H5::Group extract_assembly_group = open_subgroup(h5_file, assembly_group_name, sub_group_exists);
     write_string_attribute(extract_assembly_group, "name", this->root_assembly.name);
-    if (!this->root_assembly.nodes->empty() || !this->root_assembly.elements->empty()) {
+    if (!this->root_assembly.nodes->labels.empty() || !this->root_assembly.elements->empty()) {
         if (!this->root_assembly.embeddedSpace.empty()) {
             write_string_dataset(extract_assembly_group, "embeddedSpace", this->root_assembly.embeddedSpace);
         }
         string assembly_mesh_group_name = assembly_group_name + "/Mesh";
         H5::Group assembly_mesh_group = create_group(h5_file, assembly_mesh_group_name);
-        if (!this->root_assembly.nodes->empty()) {
+        if (!this->root_assembly.nodes->labels.empty()) {
             write_mesh_nodes(h5_file, assembly_mesh_group, assembly_mesh_group_name, *this->root_assembly.nodes, this->root_assembly.embeddedSpace);
         }
         if (!this->root_assembly.elements->empty()) {
             write_mesh_elements(h5_file, assembly_mesh_group, assembly_mesh_group_name, *this->root_assembly.elements);
         }
     }
-    for (auto [assembly_name, assembly] : this->assembly_mesh) {
+    for (const auto& [assembly_name, assembly] : this->assembly_mesh) {
         string assembly_group_name = "/assemblies/" + replace_slashes(assembly_name);
         bool sub_group_exists = false;
         H5::Group extract_assembly_group = open_subgroup(h5_file, assembly_group_name, sub_group_exists);
-        write_string_attribute(extract_assembly_group, "name", assembly_name);
-        if (!assembly.element_sets.empty()) {
-            H5::Group element_sets = create_group(h5_file, assembly_group_name + "/element_sets");
-            std::regex elements_pattern("\\s*ALL\\s*ELEMENTS\\s*");
-            for (auto [set_name, element_set] : assembly.element_sets) {
-                if ((!element_set.empty()) && (!regex_match(set_name, elements_pattern))) {
-                    vector<int> element_labels(element_set.begin(), element_set.end());
-                    write_integer_vector_dataset(element_sets, set_name, element_labels);
-                }
-            }
-        }
-        if (!assembly.node_sets.empty()) {
-            H5::Group node_sets = create_group(h5_file, assembly_group_name + "/node_sets");
-            std::regex nodes_pattern("\\s*ALL\\s*NODES\\s*");
-            for (auto [set_name, node_set] : assembly.node_sets) {
-                if ((!node_set.empty()) && (!regex_match(set_name, nodes_pattern))) {
-                    vector<int> node_labels(node_set.begin(), node_set.end());
-                    write_integer_vector_dataset(node_sets, set_name, node_labels);
-                }
-            }
-        }
+        if (!extract_assembly_group.attrExists("name")) { write_string_attribute(extract_assembly_group, "name", assembly_name); }  // The root assembly was written above
+        write_mesh_sets(h5_file, assembly_group_name, assembly);
     }
-    for (auto [instance_name, instance] : this->instance_mesh) {
+    for (const auto& [instance_name, instance] : this->instance_mesh) {
         embedded_space = "";
         string instance_group_name = "/instances/" + replace_slashes(instance_name);
         bool sub_group_exists = false;
         H5::Group extract_instance_group = open_subgroup(h5_file, instance_group_name, sub_group_exists);
         write_string_attribute(extract_instance_group, "name", instance_name);
-        if (!instance.nodes.empty() || !instance.elements.empty()) {
+        if (!instance.nodes.labels.empty() || !instance.elements.empty()) {
             if (instance.instance_index >= 0) {
                 if (!this->root_assembly.instances[instance.instance_index].embeddedSpace.empty()) { embedded_space = this->root_assembly.instances[instance.instance_index].embeddedSpace; }
             }
             string instance_mesh_group_name = instance_group_name + "/Mesh";
             H5::Group instance_mesh_group = create_group(h5_file, instance_mesh_group_name);
-            if (!instance.nodes.empty()) {
+            if (!instance.nodes.labels.empty()) {
                 write_mesh_nodes(h5_file, instance_mesh_group, instance_mesh_group_name, instance.nodes, embedded_space);
             }
             if (!instance.elements.empty()) {
                 write_mesh_elements(h5_file, instance_mesh_group, instance_mesh_group_name, instance.elements);
             }
         }
-        if (!instance.element_sets.empty()) {
-            H5::Group element_sets = create_group(h5_file, instance_group_name + "/element_sets");
-            std::regex elements_pattern("\\s*ALL\\s*ELEMENTS\\s*");
-            for (auto [set_name, element_set] : instance.element_sets) {
-                if ((!element_set.empty()) && (!regex_match(set_name, elements_pattern))) {
-                    vector<int> element_labels(element_set.begin(), element_set.end());
-                    write_integer_vector_dataset(element_sets, set_name, element_labels);
-                }
+        write_mesh_sets(h5_file, instance_group_name, instance);
+    }
+}
+
+void SpadeObject::write_mesh_sets(H5::H5File &h5_file, const string &group_name, const mesh_type &mesh) {
+    if (!mesh.element_sets.empty()) {
+        H5::Group element_sets = create_group(h5_file, group_name + "/element_sets");
+        std::regex elements_pattern("\\s*ALL\\s*ELEMENTS\\s*");
+        for (const auto& [set_id, element_set] : mesh.element_sets) {
+            const string &set_name = this->mesh_set_names[set_id];
+            if ((!element_set.labels.empty()) && (!regex_match(set_name, elements_pattern))) {
+                write_integer_vector_dataset(element_sets, set_name, element_set.labels);
             }
         }
-        if (!instance.node_sets.empty()) {
-            H5::Group node_sets = create_group(h5_file, instance_group_name + "/node_sets");
-            std::regex nodes_pattern("\\s*ALL\\s*NODES\\s*");
-            for (auto [set_name, node_set] : instance.node_sets) {
-                if ((!node_set.empty()) && (!regex_match(set_name, nodes_pattern))) {
-                    vector<int> node_labels(node_set.begin(), node_set.end());
-                    write_integer_vector_dataset(node_sets, set_name, node_labels);
-                }
+    }
+    if (!mesh.node_sets.empty()) {
+        H5::Group node_sets = create_group(h5_file, group_name + "/node_sets");
+        std::regex nodes_pattern("\\s*ALL\\s*NODES\\s*");
+        for (const auto& [set_id, node_set] : mesh.node_sets) {
+            const string &set_name = this->mesh_set_names[set_id];
+            if ((!node_set.labels.empty()) && (!regex_match(set_name, nodes_pattern))) {
+                write_integer_vector_dataset(node_sets, set_name, node_set.labels);
             }
         }
     }
-    this->log_file->logDebug("\tFinished write_mesh at time: " + this->command_line_arguments->getTimeStamp(true));
 }
 
-void SpadeObject::write_mesh_nodes(H5::H5File &h5_file, H5::Group &group, string &group_name, map<int, node_type> nodes, const string embedded_space) {
-    this->log_file->logDebug("\t\tCalled write_mesh_nodes at time: " + this->command_line_arguments->getTimeStamp(true));
+void SpadeObject::write_mesh_nodes(H5::H5File &h5_file, H5::Group &group, const string &group_name, const mesh_nodes_type &nodes, const string &embedded_space) {
+    Logging::Span span(*this->log_file, "write_mesh_nodes");
     vector<const char*> coordinates;
     if (embedded_space == "Two Dimensional Planar") {
         coordinates.push_back("x");
@@ -1643,26 +2546,13 @@ void SpadeObject::write_mesh_nodes(H5::H5File &h5_file, H5::Group &group, string
         coordinates.push_back("y");
         coordinates.push_back("z");
     }
-    int true_coord_size = nodes.begin()->second.coordinates.size();
-    vector<int> node_labels;
-    vector<float> node_coords;
-    hsize_t dimension(nodes.size());
-    int node_count = 0;
-    for (auto [node_id, node] : nodes) {
-        node_labels.push_back(node_id);
-        for (const float& coord : node.coordinates) {
-            node_coords.push_back(coord);
-        }
-        node_count++;
-    }
-
-    hsize_t dims[2] = {nodes.size(), true_coord_size};
+    hsize_t dims[2] = {nodes.labels.size(), static_cast<hsize_t>(nodes.coordinate_size)};
     H5::DataSpace dataspace_coord(2, dims);
     H5::DataType datatype_coord(H5::PredType::NATIVE_FLOAT);
     H5::DataSet dataset_coord;
     try {
-        dataset_coord = group.createDataSet("coordinates", datatype_coord, dataspace_coord);
-        dataset_coord.write(node_coords.data(), datatype_coord);
+        dataset_coord = group.createDataSet("coordinates", datatype_coord, dataspace_coord, dataset_properties(2, dims, sizeof(float), false));
+        dataset_coord.write(nodes.coordinates.data(), datatype_coord);
     } catch(H5::Exception& e) {
         this->log_file->logWarning("Unable to create dataset coordinates. " + e.getDetailMsg());
     }
@@ -1686,13 +2576,13 @@ void SpadeObject::write_mesh_nodes(H5::H5File &h5_file, H5::Group &group, string
     label_dataset.close();
     label_dataspace.close();
 
-    hsize_t node_dimensions[] = {node_labels.size()};
+    hsize_t node_dimensions[] = {nodes.labels.size()};
     H5::DataSpace node_dataspace(1, node_dimensions);
     H5::DataSet node_dataset;
     data_name = "node";
     try {
-        node_dataset = group.createDataSet("node", H5::PredType::NATIVE_INT, node_dataspace);
-        node_dataset.write(node_labels.data(), H5::PredType::NATIVE_INT);
+        node_dataset = group.createDataSet("node", H5::PredType::NATIVE_INT, node_dataspace, dataset_properties(1, node_dimensions, sizeof(int), false));
+        node_dataset.write(nodes.labels.data(), H5::PredType::NATIVE_INT);
         // Associate the coordinate datasets with the main dataset using dimension scales
         H5DSset_scale(node_dataset.getId(), data_name.c_str());
         H5DSattach_scale(dataset_coord.getId(), node_dataset.getId(), 0);
@@ -1705,81 +2595,60 @@ void SpadeObject::write_mesh_nodes(H5::H5File &h5_file, H5::Group &group, string
     dataspace_coord.close();
     dataset_coord.close();
 
-    this->log_file->logDebug("\t\tFinished write_mesh_nodes at time: " + this->command_line_arguments->getTimeStamp(true));
 }
 
-void SpadeObject::write_mesh_elements(H5::H5File &h5_file, H5::Group &group, string &group_name, map<string, map<int, element_type>> elements) {
-    this->log_file->logDebug("\t\tCalled write_mesh_elements at time: " + this->command_line_arguments->getTimeStamp(true));
-    for (auto [type, element_members] : elements) {
-
-        vector<int> element_labels;
-        vector<const char*> section_categories_names;
-        vector<const char*> section_categories_descriptions;
-        vector<string> section_categories_names_strings;
-        vector<string> section_categories_descriptions_strings;
-        vector<int> element_connectivity;
-        int connectivity_size = element_members.begin()->second.connectivity.size();
-        vector<int> node_indices;
-        for (int i=0; i<connectivity_size; i++) { node_indices.push_back(i); }
-        bool instances_empty = true;
-
+void SpadeObject::write_mesh_elements(H5::H5File &h5_file, H5::Group &group, const string &group_name, const map<string, mesh_elements_type> &elements) {
+    Logging::Span span(*this->log_file, "write_mesh_elements");
+    // Pointers to the interned strings, shared by every element referencing them
+    vector<const char*> instance_names;
+    for (const string &instance_name : this->mesh_instance_names) { instance_names.push_back(instance_name.c_str()); }
+    vector<vector<const char*>> section_point_numbers(this->mesh_section_categories.size());
+    vector<vector<const char*>> section_point_descriptions(this->mesh_section_categories.size());
+    for (int i=0; i<this->mesh_section_categories.size(); i++) {
+        for (const string &number : this->mesh_section_categories[i].section_point_numbers) { section_point_numbers[i].push_back(number.c_str()); }
+        for (const string &description : this->mesh_section_categories[i].section_point_descriptions) { section_point_descriptions[i].push_back(description.c_str()); }
+    }
+    for (const auto& [type, element_members] : elements) {
+        hsize_t dimension(element_members.labels.size());
+        int connectivity_size = element_members.connectivity_offsets[1] - element_members.connectivity_offsets[0];
+        if (element_members.connectivity.size() != dimension * connectivity_size) {
+            this->log_file->logWarning("Elements of type " + type + " do not all have the same number of nodes. Unable to write mesh data for them.");
+            continue;
+        }
+        vector<int> node_indices(connectivity_size);
+        iota(node_indices.begin(), node_indices.end(), 0);
 
-        hsize_t dimension(element_members.size());
+        vector<const char*> section_categories_names(dimension);
+        vector<const char*> section_categories_descriptions(dimension);
+        vector<const char*> element_instance_names(element_members.instance_name_ids.size());
         vector<hvl_t> variable_length_instances(dimension);
         vector<hvl_t> variable_length_section_point_numbers(dimension);
         vector<hvl_t> variable_length_section_point_descriptions(dimension);
-        int element_count = 0;
+        bool instances_empty = element_members.instance_name_ids.empty();
         bool section_point_empty = true;
-        for (auto [element_id, element] : element_members) {
-            element_labels.push_back(element_id);
-            section_categories_names_strings.push_back(element.sectionCategory.name);
-            section_categories_descriptions_strings.push_back(element.sectionCategory.description);
-            section_categories_names.push_back(section_categories_names_strings[section_categories_names_strings.size() - 1].c_str());
-            section_categories_descriptions.push_back(section_categories_descriptions_strings[section_categories_descriptions_strings.size() - 1].c_str());
-            for (const float& connectivity : element.connectivity) {
-                element_connectivity.push_back(connectivity);
-            }
-            if (element.instanceNames.size() > 0) {
-                instances_empty = false;
-                variable_length_instances[element_count].len = element.instanceNames.size();
-                variable_length_instances[element_count].p = new char*[element.instanceNames.size()];
-                size_t instance_count = 0;
-                for (const std::string& str : element.instanceNames) {
-                    char* c_str = new char[str.size() + 1];  // Plus 1 for null terminator
-                    std::strcpy(c_str, str.c_str());
-                    static_cast<char**>(variable_length_instances[element_count].p)[instance_count] = c_str;
-                    ++instance_count;
-                }
-            }
-            if (element.sectionCategory.section_point_numbers.size()) {
+        for (size_t i=0; i<element_instance_names.size(); i++) { element_instance_names[i] = instance_names[element_members.instance_name_ids[i]]; }
+        for (hsize_t i=0; i<dimension; i++) {
+            const int &category_id = element_members.section_category_ids[i];
+            section_categories_names[i] = this->mesh_section_categories[category_id].name.c_str();
+            section_categories_descriptions[i] = this->mesh_section_categories[category_id].description.c_str();
+            variable_length_instances[i].len = element_members.instance_name_offsets[i + 1] - element_members.instance_name_offsets[i];
+            variable_length_instances[i].p = element_instance_names.data() + element_members.instance_name_offsets[i];
+            if (!section_point_numbers[category_id].empty()) {
                 section_point_empty = false;
-                variable_length_section_point_numbers[element_count].len = element.sectionCategory.section_point_numbers.size();
-                variable_length_section_point_numbers[element_count].p = new char*[element.sectionCategory.section_point_numbers.size()];
-                variable_length_section_point_descriptions[element_count].len = element.sectionCategory.section_point_descriptions.size();
-                variable_length_section_point_descriptions[element_count].p = new char*[element.sectionCategory.section_point_descriptions.size()];
-                size_t section_point_count = 0;
-                for (int i=0; i<element.sectionCategory.section_point_numbers.size(); i++) {
-                    string str_number = element.sectionCategory.section_point_numbers[i];
-                    string str_description = element.sectionCategory.section_point_descriptions[i];
-                    char* c_str_number = new char[str_number.size() + 1];  // Plus 1 for null terminator
-                    char* c_str_description = new char[str_description.size() + 1];  // Plus 1 for null terminator
-                    std::strcpy(c_str_number, str_number.c_str());
-                    std::strcpy(c_str_description, str_description.c_str());
-                    static_cast<char**>(variable_length_section_point_numbers[element_count].p)[section_point_count] = c_str_number;
-                    static_cast<char**>(variable_length_section_point_descriptions[element_count].p)[section_point_count] = c_str_description;
-                    ++section_point_count;
-                }
+                variable_length_section_point_numbers[i].len = section_point_numbers[category_id].size();
+                variable_length_section_point_numbers[i].p = section_point_numbers[category_id].data();
+                variable_length_section_point_descriptions[i].len = section_point_descriptions[category_id].size();
+                variable_length_section_point_descriptions[i].p = section_point_descriptions[category_id].data();
             }
-            element_count++;
         }
 
-        hsize_t dims[2] = {element_members.size(), connectivity_size};
+        hsize_t dims[2] = {dimension, static_cast<hsize_t>(connectivity_size)};
         H5::DataSpace dataspace_connectivity(2, dims);
         H5::DataType datatype_connectivity(H5::PredType::NATIVE_INT);
         H5::DataSet dataset_connectivity;
         try {
-            dataset_connectivity = group.createDataSet(type + "_mesh", datatype_connectivity, dataspace_connectivity);
-            dataset_connectivity.write(element_connectivity.data(), datatype_connectivity);
+            dataset_connectivity = group.createDataSet(type + "_mesh", datatype_connectivity, dataspace_connectivity, dataset_properties(2, dims, sizeof(int), false));
+            dataset_connectivity.write(element_members.connectivity.data(), datatype_connectivity);
             H5DSset_label(dataset_connectivity.getId(), 0, type.c_str());
             H5DSset_label(dataset_connectivity.getId(), 1, (type + "_node").c_str());
         } catch(H5::Exception& e) {
@@ -1787,12 +2656,12 @@ void SpadeObject::write_mesh_elements(H5::H5File &h5_file, H5::Group &group, str
         }
         datatype_connectivity.close();
 
-        hsize_t type_dimensions[] = {element_labels.size()};
+        hsize_t type_dimensions[] = {dimension};
         H5::DataSpace dataspace_type(1, type_dimensions);
         H5::DataSet dataset_type;
         try {
-            dataset_type = group.createDataSet(type, H5::PredType::NATIVE_INT, dataspace_type);
-            dataset_type.write(element_labels.data(), H5::PredType::NATIVE_INT);
+            dataset_type = group.createDataSet(type, H5::PredType::NATIVE_INT, dataspace_type, dataset_properties(1, type_dimensions, sizeof(int), false));
+            dataset_type.write(element_members.labels.data(), H5::PredType::NATIVE_INT);
             // Associate the coordinate datasets with the main dataset using dimension scales
             H5DSset_scale(dataset_type.getId(), type.c_str());
             H5DSattach_scale(dataset_connectivity.getId(), dataset_type.getId(), 0);
@@ -1859,7 +2728,6 @@ void SpadeObject::write_mesh_elements(H5::H5File &h5_file, H5::Group &group, str
                 H5::DataSet dataset_instances(group.createDataSet(type + "_element_instances", datatype_instances, dataspace_instances));
                 dataset_instances.write(variable_length_instances.data(), datatype_instances);
                 dataset_instances.close();
-                H5Treclaim(datatype_instances.getId(), dataspace_instances.getId(), H5P_DEFAULT, variable_length_instances.data());  // Clearing the memory
             } catch(H5::Exception& e) {
                 this->log_file->logWarning("Unable to create dataset element_instances. " + e.getDetailMsg());
             }
@@ -1874,7 +2742,6 @@ void SpadeObject::write_mesh_elements(H5::H5File &h5_file, H5::Group &group, str
                 H5::DataSet dataset_section_point_numbers(group.createDataSet(type + "_section_point_numbers", datatype_section_point_numbers, dataspace_section_point_numbers));
                 dataset_section_point_numbers.write(variable_length_section_point_numbers.data(), datatype_section_point_numbers);
                 dataset_section_point_numbers.close();
-                H5Treclaim(datatype_section_point_numbers.getId(), dataspace_section_point_numbers.getId(), H5P_DEFAULT, variable_length_section_point_numbers.data());  // Clearing the memory
             } catch(H5::Exception& e) {
                 this->log_file->logWarning("Unable to create dataset section_point_numbers. " + e.getDetailMsg());
             }
@@ -1887,7 +2754,6 @@ void SpadeObject::write_mesh_elements(H5::H5File &h5_file, H5::Group &group, str
                 H5::DataSet dataset_section_point_descriptions(group.createDataSet(type + "_section_point_descriptions", datatype_section_point_descriptions, dataspace_section_point_descriptions));
                 dataset_section_point_descriptions.write(variable_length_section_point_descriptions.data(), datatype_section_point_descriptions);
                 dataset_section_point_descriptions.close();
-                H5Treclaim(datatype_section_point_descriptions.getId(), dataspace_section_point_descriptions.getId(), H5P_DEFAULT, variable_length_section_point_descriptions.data());  // Clearing the memory
             } catch(H5::Exception& e) {
                 this->log_file->logWarning("Unable to create dataset section_point_descriptions. " + e.getDetailMsg());
             }
@@ -1908,7 +2774,6 @@ void SpadeObject::write_mesh_elements(H5::H5File &h5_file, H5::Group &group, str
         dataspace_connectivity.close();
         dataset_connectivity.close();
     }
-    this->log_file->logDebug("\t\tFinished write_mesh_elements at time: " + this->command_line_arguments->getTimeStamp(true));
 }
 
 void SpadeObject::create_extract_history_group(H5::H5File &h5_file, history_region_type &history_region, string &step_group_name) {
@@ -1928,7 +2793,7 @@ void SpadeObject::create_extract_history_group(H5::H5File &h5_file, history_regi
 }
 
 void SpadeObject::write_parts(H5::H5File &h5_file, const string &group_name) {
-    for (auto part : this->parts) {
+    for (const auto& part : this->parts) {
         string part_group_name = group_name + "/" + replace_slashes(part.name);
         H5::Group part_group = create_group(h5_file, part_group_name);
         write_string_attribute(part_group, "name", part.name);
@@ -1944,10 +2809,11 @@ void SpadeObject::write_parts(H5::H5File &h5_file, const string &group_name) {
 }
 
 void SpadeObject::write_assembly(H5::H5File &h5_file, const string &group_name) {
+    Logging::Span span(*this->log_file, "write_assembly");
     string root_assembly_group_name = "/odb/rootAssembly " + replace_slashes(this->root_assembly.name);
     H5::Group root_assembly_group = create_group(h5_file, root_assembly_group_name);
     write_string_attribute(root_assembly_group, "name", this->root_assembly.name);
-    this->log_file->logDebug("\tWriting instances in write_assembly at time: " + this->command_line_arguments->getTimeStamp(true));
+    this->log_file->logDebug([&] { return "\tWriting instances in write_assembly at time: " + this->command_line_arguments->getTimeStamp(true); });
     write_instances(h5_file, root_assembly_group_name);
     write_string_dataset(root_assembly_group, "embeddedSpace", this->root_assembly.embeddedSpace);
     if (this->command_line_arguments->get("format") == "odb") {
@@ -1956,15 +2822,15 @@ void SpadeObject::write_assembly(H5::H5File &h5_file, const string &group_name)
         write_sets(h5_file, root_assembly_group_name + "/nodeSets", this->root_assembly.nodeSets, this->assembly_mesh[this->root_assembly.name].element_sets, this->assembly_mesh[this->root_assembly.name].node_sets);
         write_sets(h5_file, root_assembly_group_name + "/elementSets", this->root_assembly.elementSets, this->assembly_mesh[this->root_assembly.name].element_sets, this->assembly_mesh[this->root_assembly.name].node_sets);
     }
-    this->log_file->logDebug("\tWriting surface sets in write_assembly at time: " + this->command_line_arguments->getTimeStamp(true));
+    this->log_file->logDebug([&] { return "\tWriting surface sets in write_assembly at time: " + this->command_line_arguments->getTimeStamp(true); });
     write_sets(h5_file, root_assembly_group_name + "/surfaces", this->root_assembly.surfaces, this->assembly_mesh[this->root_assembly.name].element_sets, this->assembly_mesh[this->root_assembly.name].node_sets);
     if (this->root_assembly.connectorOrientations.size() > 0) {
-        this->log_file->logDebug("\tWriting connector orientations in write_assembly at time: " + this->command_line_arguments->getTimeStamp(true));
+        this->log_file->logDebug([&] { return "\tWriting connector orientations in write_assembly at time: " + this->command_line_arguments->getTimeStamp(true); });
         H5::Group connector_orientations_group = create_group(h5_file, root_assembly_group_name + "/connectorOrientations");
         for (int i=0; i<this->root_assembly.connectorOrientations.size(); i++) {
             string connector_orientation_group_name = root_assembly_group_name + "/connectorOrientations/" + to_string(i);
             H5::Group connector_orientation_group = create_group(h5_file, connector_orientation_group_name);
-            write_set(h5_file, connector_orientation_group_name, this->root_assembly.connectorOrientations[i].region, nullopt, nullopt);
+            write_set(h5_file, connector_orientation_group_name, this->root_assembly.connectorOrientations[i].region, nullptr, nullptr);
             write_string_dataset(connector_orientation_group, "orient2sameAs1", this->root_assembly.connectorOrientations[i].orient2sameAs1);
             write_float_dataset(connector_orientation_group, "angle1", this->root_assembly.connectorOrientations[i].angle1);
             write_float_dataset(connector_orientation_group, "angle2", this->root_assembly.connectorOrientations[i].angle2);
@@ -1974,7 +2840,6 @@ void SpadeObject::write_assembly(H5::H5File &h5_file, const string &group_name)
             write_string_dataset(connector_orientation_group, "axis2", this->root_assembly.connectorOrientations[i].axis2);
         }
     }
-    this->log_file->logDebug("\tFinished write_assembly at time: " + this->command_line_arguments->getTimeStamp(true));
 }
 
 void SpadeObject::write_field_values(H5::H5File &h5_file, const string &group_name, H5::Group &group, field_value_type &values) {
@@ -1982,7 +2847,10 @@ void SpadeObject::write_field_values(H5::H5File &h5_file, const string &group_na
     if (values.elementEmpty == false) { write_integer_vector_dataset(group, "elementLabel", values.elementLabel); }
     if (values.nodeEmpty == false) { write_integer_vector_dataset(group, "nodeLabel", values.nodeLabel); }
     if (values.integrationPointEmpty == false) { write_integer_vector_dataset(group, "integrationPoint", values.integrationPoint); }
-    if (values.typeEmpty == false) { write_string_vector_dataset(group, "type", values.type); }
+    if (values.typeEmpty == false) {
+        hsize_t dimensions[] = {values.type.size()};
+        write_enum_dataset(group, "type", this->data_type_enum_type, 1, dimensions, values.type.data());
+    }
     if (values.magnitudeEmpty == false) { write_float_vector_dataset(group, "magnitude", values.magnitude); }
     if (values.trescaEmpty == false) { write_float_vector_dataset(group, "tresca", values.tresca); }
     if (values.pressEmpty == false) { write_float_vector_dataset(group, "press", values.press); }
@@ -2004,159 +2872,156 @@ void SpadeObject::write_field_values(H5::H5File &h5_file, const string &group_na
     }
 }
 
-void SpadeObject::write_field_bulk_data(H5::H5File &h5_file, const string &group_name, const odb_FieldBulkData &field_bulk_data, bool complex_data, bool write_mises) {
+void SpadeObject::write_field_bulk_data(H5::H5File &h5_file, const string &group_name, field_bulk_type &field_bulk_data) {
+    Logging::Span span(*this->log_file, "write bulk block");
+    span.add("group", group_name);
+    span.add("elements", field_bulk_data.numberOfElements);
+    span.add("values", field_bulk_data.length);
+    if (span.active()) { span.add("bytes", static_cast<long long>(field_bulk_size(field_bulk_data))); }
     bool sub_group_exists = false;
     H5::Group bulk_group = open_subgroup(h5_file, group_name, sub_group_exists);
 
-    int coord_length = 0;
-
-    write_string_dataset(bulk_group, "position", get_position_enum(field_bulk_data.position()));
-    if(field_bulk_data.numberOfElements() && field_bulk_data.elementLabels()) { // If elements
+    bool single_precision = (field_bulk_data.precision == "Single Precision");
+    write_string_dataset(bulk_group, "position", field_bulk_data.position);
+    if(field_bulk_data.numberOfElements && !field_bulk_data.elementLabels.empty()) { // If elements
 
-        int number_of_integration_points = field_bulk_data.length()/field_bulk_data.numberOfElements();
-        coord_length = field_bulk_data.length() * field_bulk_data.orientationWidth();
+        int number_of_integration_points = field_bulk_data.length/field_bulk_data.numberOfElements;
 
-        if (field_bulk_data.baseElementType().CStr() != "") {
-            write_string_dataset(bulk_group, "baseElementType", field_bulk_data.baseElementType().CStr());
+        if (!field_bulk_data.baseElementType.empty()) {
+            write_string_dataset(bulk_group, "baseElementType", field_bulk_data.baseElementType);
         }
-        write_integer_dataset(bulk_group, "orientationWidth", field_bulk_data.orientationWidth());
-        if (field_bulk_data.numberOfElements() != 0) {
-            write_integer_dataset(bulk_group, "numberOfElements", field_bulk_data.numberOfElements());
+        write_integer_dataset(bulk_group, "orientationWidth", field_bulk_data.orientationWidth);
+        if (field_bulk_data.numberOfElements != 0) {
+            write_integer_dataset(bulk_group, "numberOfElements", field_bulk_data.numberOfElements);
         }
-        if (field_bulk_data.valuesPerElement() != 0) {
-            write_integer_dataset(bulk_group, "valuesPerElement", field_bulk_data.valuesPerElement());
+        if (field_bulk_data.valuesPerElement != 0) {
+            write_integer_dataset(bulk_group, "valuesPerElement", field_bulk_data.valuesPerElement);
         }
 
-        vector<const char*> field_component_labels;
-        odb_SequenceString component_labels = field_bulk_data.componentLabels();
-        for (int i=0; i<field_bulk_data.componentLabels().size(); i++) {  // Usually just around 3 labels or less
-            field_component_labels.push_back(component_labels[i].CStr());
-        }
-        write_c_string_vector_dataset(bulk_group, "componentLabels", field_component_labels);
+        write_string_vector_dataset(bulk_group, "componentLabels", field_bulk_data.componentLabels);
 
-
-        odb_Enum::odb_ElementFaceEnum* faces = field_bulk_data.faces();
-        if (faces) {
-            vector<const char*> faces_vector;
-            int current_position = 0;
-            for (int element=0; element<field_bulk_data.numberOfElements(); ++element) {
-                for (int integration_point=0; integration_point<number_of_integration_points; integration_point++, current_position++) {
-                    string face_name;
-                    int index = faces[current_position];
-                    try {
-                        face_name = this->faces_enum_strings.at(index);
-                    } catch (const std::out_of_range& e) {
-                        face_name = this->faces_enum_strings[0];
-                    }
-                    faces_vector.push_back(face_name.c_str());
-                }
-            }
-            write_c_string_2D_vector(bulk_group, "faces", number_of_integration_points, faces_vector);
+        if (!field_bulk_data.emptyFaces) {
+            hsize_t dimensions_faces[] = {field_bulk_data.numberOfElements, number_of_integration_points};
+            write_enum_dataset(bulk_group, "faces", this->face_enum_type, 2, dimensions_faces, field_bulk_data.faces.data());
         }
 
-        if (write_mises) {
-            write_float_2D_array(bulk_group, "mises", field_bulk_data.numberOfElements(), number_of_integration_points, field_bulk_data.mises());
+        if (!field_bulk_data.mises.empty()) {
+            write_float_2D_array(bulk_group, "mises", field_bulk_data.numberOfElements, number_of_integration_points, field_bulk_data.mises.data());
+        }
+        for (auto& [invariant_name, invariant_values] : field_bulk_data.invariants) {
+            write_float_2D_array(bulk_group, invariant_name, field_bulk_data.numberOfElements, number_of_integration_points, invariant_values.data());
         }
-        write_integer_2D_array(bulk_group, "elementLabels", field_bulk_data.numberOfElements(), number_of_integration_points, field_bulk_data.elementLabels());
-        if (field_bulk_data.integrationPoints()) {
-            write_integer_2D_array(bulk_group, "integrationPoints", field_bulk_data.numberOfElements(), number_of_integration_points, field_bulk_data.integrationPoints());
+        write_integer_2D_array(bulk_group, "elementLabels", field_bulk_data.numberOfElements, number_of_integration_points, field_bulk_data.elementLabels.data());
+        if (!field_bulk_data.integrationPoints.empty()) {
+            write_integer_2D_array(bulk_group, "integrationPoints", field_bulk_data.numberOfElements, number_of_integration_points, field_bulk_data.integrationPoints.data());
         }
 
-        if(field_bulk_data.precision() == odb_Enum::SINGLE_PRECISION) {
-            write_float_3D_array(bulk_group, "data", field_bulk_data.numberOfElements(), number_of_integration_points, field_bulk_data.width(), field_bulk_data.data());
-            if (complex_data) {
-                write_float_3D_array(bulk_group, "conjugateData", field_bulk_data.numberOfElements(), number_of_integration_points, field_bulk_data.width(), field_bulk_data.conjugateData());
+        if (single_precision) {
+            write_float_3D_array(bulk_group, "data", field_bulk_data.numberOfElements, number_of_integration_points, field_bulk_data.width, field_bulk_data.data.data());
+            if (!field_bulk_data.conjugateData.empty()) {
+                write_float_3D_array(bulk_group, "conjugateData", field_bulk_data.numberOfElements, number_of_integration_points, field_bulk_data.width, field_bulk_data.conjugateData.data());
             }
-            if ((field_bulk_data.localCoordSystem()) && (coord_length)) {
-                write_float_3D_array(bulk_group, "localCoordSystem", field_bulk_data.numberOfElements(), number_of_integration_points, field_bulk_data.orientationWidth(), field_bulk_data.localCoordSystem());
+            if (!field_bulk_data.localCoordSystem.empty()) {
+                write_float_3D_array(bulk_group, "localCoordSystem", field_bulk_data.numberOfElements, number_of_integration_points, field_bulk_data.orientationWidth, field_bulk_data.localCoordSystem.data());
             }
         } else {  // Double precision
-            write_double_3D_array(bulk_group, "data", field_bulk_data.numberOfElements(), number_of_integration_points, field_bulk_data.width(), field_bulk_data.dataDouble());
-            if (complex_data) {
-                write_double_3D_array(bulk_group, "conjugateData", field_bulk_data.numberOfElements(), number_of_integration_points, field_bulk_data.width(), field_bulk_data.conjugateDataDouble());
+            write_double_3D_array(bulk_group, "data", field_bulk_data.numberOfElements, number_of_integration_points, field_bulk_data.width, field_bulk_data.dataDouble.data());
+            if (!field_bulk_data.conjugateDataDouble.empty()) {
+                write_double_3D_array(bulk_group, "conjugateData", field_bulk_data.numberOfElements, number_of_integration_points, field_bulk_data.width, field_bulk_data.conjugateDataDouble.data());
             }
-            if ((field_bulk_data.localCoordSystemDouble()) && (coord_length)) {
-                write_double_3D_array(bulk_group, "localCoordSystem", field_bulk_data.numberOfElements(), number_of_integration_points, field_bulk_data.orientationWidth(), field_bulk_data.localCoordSystemDouble());
+            if (!field_bulk_data.localCoordSystemDouble.empty()) {
+                write_double_3D_array(bulk_group, "localCoordSystem", field_bulk_data.numberOfElements, number_of_integration_points, field_bulk_data.orientationWidth, field_bulk_data.localCoordSystemDouble.data());
             }
         }
     } else {  // Nodes
-        if(field_bulk_data.precision() == odb_Enum::SINGLE_PRECISION) {
-            write_float_2D_array(bulk_group, "data", field_bulk_data.length(), field_bulk_data.width(), field_bulk_data.data());
-            if (complex_data) {
-                write_float_2D_array(bulk_group, "conjugateData", field_bulk_data.length(), field_bulk_data.width(), field_bulk_data.conjugateData());
+        if (single_precision) {
+            write_float_2D_array(bulk_group, "data", field_bulk_data.length, field_bulk_data.width, field_bulk_data.data.data());
+            if (!field_bulk_data.conjugateData.empty()) {
+                write_float_2D_array(bulk_group, "conjugateData", field_bulk_data.length, field_bulk_data.width, field_bulk_data.conjugateData.data());
             }
         } else {  // Double precision
-            write_double_2D_array(bulk_group, "data", field_bulk_data.length(), field_bulk_data.width(), field_bulk_data.dataDouble());
-            if (complex_data) {
-                write_double_2D_array(bulk_group, "conjugateData", field_bulk_data.length(), field_bulk_data.width(), field_bulk_data.conjugateDataDouble());
+            write_double_2D_array(bulk_group, "data", field_bulk_data.length, field_bulk_data.width, field_bulk_data.dataDouble.data());
+            if (!field_bulk_data.conjugateDataDouble.empty()) {
+                write_double_2D_array(bulk_group, "conjugateData", field_bulk_data.length, field_bulk_data.width, field_bulk_data.conjugateDataDouble.data());
             }
         }
+        for (const auto& [invariant_name, invariant_values] : field_bulk_data.invariants) {
+            write_float_vector_dataset(bulk_group, invariant_name, invariant_values);
+        }
 
-        write_integer_array_dataset(bulk_group, "nodeLabels", field_bulk_data.length(), field_bulk_data.nodeLabels());
+        write_integer_array_dataset(bulk_group, "nodeLabels", field_bulk_data.length, field_bulk_data.nodeLabels.data());
     }
 }
 
-void SpadeObject::write_extract_field_bulk_data(H5::H5File &h5_file, const string &group_name, const odb_FieldBulkData &field_bulk_data, bool complex_data, bool write_mises, string field_output_safe_name) {
+void SpadeObject::write_extract_field_bulk_data(H5::H5File &h5_file, const string &group_name, field_bulk_type &field_bulk_data, const string &field_output_safe_name, const string &frame_key) {
+    Logging::Span span(*this->log_file, "write bulk block");
+    span.add("group", group_name);
+    span.add("elements", field_bulk_data.numberOfElements);
+    span.add("values", field_bulk_data.length);
+    if (span.active()) { span.add("bytes", static_cast<long long>(field_bulk_size(field_bulk_data))); }
     bool sub_group_exists = false;
     H5::Group bulk_group = open_subgroup(h5_file, group_name, sub_group_exists);
 
     vector<const char*> field_component_labels;
-    odb_SequenceString component_labels = field_bulk_data.componentLabels();
-    for (int i=0; i<field_bulk_data.componentLabels().size(); i++) {  // Usually just around 4 labels or less
-        field_component_labels.push_back(component_labels[i].CStr());
+    for (const string &component_label : field_bulk_data.componentLabels) {  // Usually just around 4 labels or less
+        field_component_labels.push_back(component_label.c_str());
     }
     if (field_component_labels.empty()) {
         field_component_labels.push_back(field_output_safe_name.c_str());
     }
 
-    int coord_length = 0;
+    bool single_precision = (field_bulk_data.precision == "Single Precision");
+    bool write_mises = !field_bulk_data.mises.empty();
+    bool write_integration_points = !field_bulk_data.integrationPoints.empty();
     string component_labels_name = "componentLabels";
     string element_labels_name = "elementLabels";
     string elements_name = "elements";
     string nodes_name = "nodes";
     string local_coordinate_name = "localCoordSystem";
-    string position = get_position_enum(field_bulk_data.position());
+    string position = field_bulk_data.position;
     write_string_attribute(bulk_group, "position", position);
-    if(field_bulk_data.numberOfElements() && field_bulk_data.elementLabels()) { // If elements
+    if(field_bulk_data.numberOfElements && !field_bulk_data.elementLabels.empty()) { // If elements
 
-        int number_of_integration_points = field_bulk_data.length()/field_bulk_data.numberOfElements();
-        coord_length = field_bulk_data.length() * field_bulk_data.orientationWidth();
+        int number_of_integration_points = field_bulk_data.length/field_bulk_data.numberOfElements;
 
-        if (field_bulk_data.baseElementType().CStr() != "") {
-            write_string_attribute(bulk_group, "baseElementType", field_bulk_data.baseElementType().CStr());
+        if (!field_bulk_data.baseElementType.empty()) {
+            write_string_attribute(bulk_group, "baseElementType", field_bulk_data.baseElementType);
         }
-        write_integer_dataset(bulk_group, "orientationWidth", field_bulk_data.orientationWidth());
-        if (field_bulk_data.numberOfElements() != 0) {
-            write_string_attribute(bulk_group, "numberOfElements", to_string(field_bulk_data.numberOfElements()));
+        write_integer_dataset(bulk_group, "orientationWidth", field_bulk_data.orientationWidth);
+        if (field_bulk_data.numberOfElements != 0) {
+            write_string_attribute(bulk_group, "numberOfElements", to_string(field_bulk_data.numberOfElements));
         }
-        if (field_bulk_data.valuesPerElement() != 0) {
-            write_string_attribute(bulk_group, "valuesPerElement", to_string(field_bulk_data.valuesPerElement()));
+        if (field_bulk_data.valuesPerElement != 0) {
+            write_string_attribute(bulk_group, "valuesPerElement", to_string(field_bulk_data.valuesPerElement));
         }
 
         bool conjugate_data_exists = false;
         bool coord_data_exists = false;
-        hsize_t dimensions[] = {field_bulk_data.numberOfElements(), number_of_integration_points, field_bulk_data.width()};
+        hsize_t dimensions[] = {field_bulk_data.numberOfElements, number_of_integration_points, field_bulk_data.width};
         H5::DataSpace dataspace_data(3, dimensions);
         H5::DataSet dataset_data;
         H5::DataSpace dataspace_conjugate_data(3, dimensions);
         H5::DataSet dataset_conjugate_data;
-        hsize_t dimensions_coords[] = {field_bulk_data.numberOfElements(), number_of_integration_points, field_bulk_data.orientationWidth()};
+        hsize_t dimensions_coords[] = {field_bulk_data.numberOfElements, number_of_integration_points, field_bulk_data.orientationWidth};
         H5::DataSpace dataspace_coords(3, dimensions_coords);
         H5::DataSet dataset_coords;
-        if(field_bulk_data.precision() == odb_Enum::SINGLE_PRECISION) {
+        size_t value_size = (single_precision) ? sizeof(float) : sizeof(double);
+        H5::DSetCreatPropList properties_data = dataset_properties(3, dimensions, value_size, true);
+        H5::DSetCreatPropList properties_coords = dataset_properties(3, dimensions_coords, value_size, true);
+        if (single_precision) {
             try {
-                dataset_data = bulk_group.createDataSet("data", H5::PredType::NATIVE_FLOAT, dataspace_data);
-                dataset_data.write(field_bulk_data.data(), H5::PredType::NATIVE_FLOAT);
+                dataset_data = bulk_group.createDataSet("data", H5::PredType::NATIVE_FLOAT, dataspace_data, properties_data);
+                dataset_data.write(field_bulk_data.data.data(), H5::PredType::NATIVE_FLOAT);
                 H5DSset_label(dataset_data.getId(), 0, elements_name.c_str());
                 H5DSset_label(dataset_data.getId(), 1, position.c_str());
                 H5DSset_label(dataset_data.getId(), 2, component_labels_name.c_str());
             } catch(H5::Exception& e) {
                 this->log_file->logWarning("Unable to create dataset data. " + e.getDetailMsg());
             }
-            if (complex_data) {
+            if (!field_bulk_data.conjugateData.empty()) {
                 try {
-                    dataset_conjugate_data = bulk_group.createDataSet("conjugateData", H5::PredType::NATIVE_FLOAT, dataspace_conjugate_data);
-                    dataset_conjugate_data.write(field_bulk_data.conjugateData(), H5::PredType::NATIVE_FLOAT);
+                    dataset_conjugate_data = bulk_group.createDataSet("conjugateData", H5::PredType::NATIVE_FLOAT, dataspace_conjugate_data, properties_data);
+                    dataset_conjugate_data.write(field_bulk_data.conjugateData.data(), H5::PredType::NATIVE_FLOAT);
                     H5DSset_label(dataset_conjugate_data.getId(), 0, elements_name.c_str());
                     H5DSset_label(dataset_conjugate_data.getId(), 1, position.c_str());
                     H5DSset_label(dataset_conjugate_data.getId(), 2, component_labels_name.c_str());
@@ -2165,10 +3030,10 @@ void SpadeObject::write_extract_field_bulk_data(H5::H5File &h5_file, const strin
                     this->log_file->logWarning("Unable to create dataset conjugateData. " + e.getDetailMsg());
                 }
             }
-            if ((field_bulk_data.localCoordSystem()) && (coord_length)) {
+            if (!field_bulk_data.localCoordSystem.empty()) {
                 try {
-                    dataset_coords = bulk_group.createDataSet(local_coordinate_name, H5::PredType::NATIVE_FLOAT, dataspace_coords);
-                    dataset_coords.write(field_bulk_data.localCoordSystemDouble(), H5::PredType::NATIVE_FLOAT);
+                    dataset_coords = bulk_group.createDataSet(local_coordinate_name, H5::PredType::NATIVE_FLOAT, dataspace_coords, properties_coords);
+                    dataset_coords.write(field_bulk_data.localCoordSystem.data(), H5::PredType::NATIVE_FLOAT);
                     H5DSset_label(dataset_coords.getId(), 0, elements_name.c_str());
                     H5DSset_label(dataset_coords.getId(), 1, position.c_str());
                     H5DSset_label(dataset_coords.getId(), 2, component_labels_name.c_str());
@@ -2176,22 +3041,21 @@ void SpadeObject::write_extract_field_bulk_data(H5::H5File &h5_file, const strin
                 } catch(H5::Exception& e) {
                     this->log_file->logWarning("Unable to create dataset " + local_coordinate_name + ". " + e.getDetailMsg());
                 }
-                write_float_3D_array(bulk_group, "localCoordSystem", field_bulk_data.numberOfElements(), number_of_integration_points, field_bulk_data.orientationWidth(), field_bulk_data.localCoordSystem());
             }
         } else {  // Double precision
             try {
-                dataset_data = bulk_group.createDataSet("data", H5::PredType::NATIVE_DOUBLE, dataspace_data);
-                dataset_data.write(field_bulk_data.data(), H5::PredType::NATIVE_DOUBLE);
+                dataset_data = bulk_group.createDataSet("data", H5::PredType::NATIVE_DOUBLE, dataspace_data, properties_data);
+                dataset_data.write(field_bulk_data.dataDouble.data(), H5::PredType::NATIVE_DOUBLE);
                 H5DSset_label(dataset_data.getId(), 0, elements_name.c_str());
                 H5DSset_label(dataset_data.getId(), 1, position.c_str());
                 H5DSset_label(dataset_data.getId(), 2, component_labels_name.c_str());
             } catch(H5::Exception& e) {
                 this->log_file->logWarning("Unable to create dataset data. " + e.getDetailMsg());
             }
-            if (complex_data) {
+            if (!field_bulk_data.conjugateDataDouble.empty()) {
                 try {
-                    dataset_conjugate_data = bulk_group.createDataSet("conjugateData", H5::PredType::NATIVE_DOUBLE, dataspace_conjugate_data);
-                    dataset_conjugate_data.write(field_bulk_data.conjugateData(), H5::PredType::NATIVE_DOUBLE);
+                    dataset_conjugate_data = bulk_group.createDataSet("conjugateData", H5::PredType::NATIVE_DOUBLE, dataspace_conjugate_data, properties_data);
+                    dataset_conjugate_data.write(field_bulk_data.conjugateDataDouble.data(), H5::PredType::NATIVE_DOUBLE);
                     H5DSset_label(dataset_conjugate_data.getId(), 0, elements_name.c_str());
                     H5DSset_label(dataset_conjugate_data.getId(), 1, position.c_str());
                     H5DSset_label(dataset_conjugate_data.getId(), 2, component_labels_name.c_str());
@@ -2200,10 +3064,10 @@ void SpadeObject::write_extract_field_bulk_data(H5::H5File &h5_file, const strin
                     this->log_file->logWarning("Unable to create dataset conjugateData. " + e.getDetailMsg());
                 }
             }
-            if ((field_bulk_data.localCoordSystemDouble()) && (coord_length)) {
+            if (!field_bulk_data.localCoordSystemDouble.empty()) {
                 try {
-                    dataset_coords = bulk_group.createDataSet(local_coordinate_name, H5::PredType::NATIVE_DOUBLE, dataspace_coords);
-                    dataset_coords.write(field_bulk_data.localCoordSystemDouble(), H5::PredType::NATIVE_DOUBLE);
+                    dataset_coords = bulk_group.createDataSet(local_coordinate_name, H5::PredType::NATIVE_DOUBLE, dataspace_coords, properties_coords);
+                    dataset_coords.write(field_bulk_data.localCoordSystemDouble.data(), H5::PredType::NATIVE_DOUBLE);
                     H5DSset_label(dataset_coords.getId(), 0, elements_name.c_str());
                     H5DSset_label(dataset_coords.getId(), 1, position.c_str());
                     H5DSset_label(dataset_coords.getId(), 2, component_labels_name.c_str());
@@ -2233,73 +3097,89 @@ void SpadeObject::write_extract_field_bulk_data(H5::H5File &h5_file, const strin
         dataset_label.close();
         dataspace_label.close();
 
-        hsize_t dimensions_element_labels[] = {field_bulk_data.numberOfElements(), number_of_integration_points};
+        hsize_t dimensions_element_labels[] = {field_bulk_data.numberOfElements, number_of_integration_points};
         H5::DataSpace dataspace_element_labels(2, dimensions_element_labels);  // two dimensional data
         H5::DataSet dataset_element_labels;
-        try {
-            dataset_element_labels = bulk_group.createDataSet(element_labels_name, H5::PredType::NATIVE_INT, dataspace_element_labels);
-            dataset_element_labels.write(field_bulk_data.elementLabels(), H5::PredType::NATIVE_INT);
-            H5DSset_label(dataset_element_labels.getId(), 0, elements_name.c_str());
-            H5DSset_label(dataset_element_labels.getId(), 1, position.c_str());
-        } catch(H5::Exception& e) {
-            this->log_file->logWarning("Error creating dataset " + element_labels_name + ". " + e.getDetailMsg());
+        H5::DSetCreatPropList properties_element_points = dataset_properties(2, dimensions_element_labels, sizeof(int), false);  // Shared by all datasets with element and integration point dimensions
+        // Datasets linked from an earlier frame keep the dimension scales of that frame, which hold the same labels
+        string labels_content;
+        append_strings(labels_content, {position});
+        append_bytes(labels_content, dimensions_element_labels, sizeof(dimensions_element_labels));
+        append_bytes(labels_content, field_bulk_data.elementLabels.data(), field_bulk_data.elementLabels.size() * sizeof(int));
+        bool element_labels_linked = link_frame_datasets(h5_file, bulk_group, group_name, frame_key + "/" + element_labels_name, {element_labels_name}, labels_content);
+        if (!element_labels_linked) {
+            try {
+                dataset_element_labels = bulk_group.createDataSet(element_labels_name, H5::PredType::NATIVE_INT, dataspace_element_labels, properties_element_points);
+                dataset_element_labels.write(field_bulk_data.elementLabels.data(), H5::PredType::NATIVE_INT);
+                H5DSset_label(dataset_element_labels.getId(), 0, elements_name.c_str());
+                H5DSset_label(dataset_element_labels.getId(), 1, position.c_str());
+            } catch(H5::Exception& e) {
+                this->log_file->logWarning("Error creating dataset " + element_labels_name + ". " + e.getDetailMsg());
+            }
         }
 
-        odb_Enum::odb_ElementFaceEnum* faces = field_bulk_data.faces();
-        hsize_t dimensions_faces[] {field_bulk_data.length(), number_of_integration_points};
+        bool faces = !field_bulk_data.emptyFaces;
+        hsize_t dimensions_faces[] {field_bulk_data.numberOfElements, number_of_integration_points};
         H5::DataSpace  dataspace_faces(2, dimensions_faces);
         H5::DataSet dataset_faces;
         if (faces) {
             string faces_name = "faces";
-            vector<const char*> faces_vector;
-            int current_position = 0;
-            for (int element=0; element<field_bulk_data.numberOfElements(); ++element) {
-                for (int integration_point=0; integration_point<number_of_integration_points; integration_point++, current_position++) {
-                    string face_name;
-                    int index = faces[current_position];
-                    try {
-                        face_name = this->faces_enum_strings.at(index);
-                    } catch (const std::out_of_range& e) {
-                        face_name = this->faces_enum_strings[0];
-                    }
-                    faces_vector.push_back(face_name.c_str());
-                }
-            }
-            H5::StrType string_type_faces(H5::PredType::C_S1, H5T_VARIABLE); // Variable length string
+            string faces_content = labels_content;  // Linked datasets keep the element label scales of the frame they were written in
+            append_bytes(faces_content, field_bulk_data.faces.data(), field_bulk_data.faces.size() * sizeof(short));
+            faces = !link_frame_datasets(h5_file, bulk_group, group_name, frame_key + "/" + faces_name, {faces_name}, faces_content);
+        }
+        if (faces) {
+            string faces_name = "faces";
             try {
-                dataset_faces = bulk_group.createDataSet(faces_name, string_type_faces, dataspace_faces);
-                dataset_faces.write(faces_vector.data(), string_type_faces);
+                dataset_faces = bulk_group.createDataSet(faces_name, this->face_enum_type, dataspace_faces, dataset_properties(2, dimensions_faces, sizeof(short), false));
+                dataset_faces.write(field_bulk_data.faces.data(), this->face_enum_type);
                 H5DSset_label(dataset_faces.getId(), 0, elements_name.c_str());
                 H5DSset_label(dataset_faces.getId(), 1, position.c_str());
             } catch(H5::Exception& e) {
                 this->log_file->logWarning("Unable to create dataset " + faces_name + ". " + e.getDetailMsg());
             }
-            string_type_faces.close();
         }
 
-        hsize_t dimensions_mises[] = {field_bulk_data.numberOfElements(), number_of_integration_points};
+        hsize_t dimensions_mises[] = {field_bulk_data.numberOfElements, number_of_integration_points};
         H5::DataSpace dataspace_mises(2, dimensions_mises);
         H5::DataSet dataset_mises;
         string mises_name = "mises";
         if (write_mises) {
             try {
-                dataset_mises = bulk_group.createDataSet(mises_name, H5::PredType::NATIVE_FLOAT, dataspace_mises);
-                dataset_mises.write(field_bulk_data.mises(), H5::PredType::NATIVE_FLOAT);
+                dataset_mises = bulk_group.createDataSet(mises_name, H5::PredType::NATIVE_FLOAT, dataspace_mises, properties_element_points);
+                dataset_mises.write(field_bulk_data.mises.data(), H5::PredType::NATIVE_FLOAT);
                 H5DSset_label(dataset_mises.getId(), 0, elements_name.c_str());
                 H5DSset_label(dataset_mises.getId(), 1, position.c_str());
             } catch(H5::Exception& e) {
                 this->log_file->logWarning("Unable to create dataset " + mises_name + ". " + e.getDetailMsg());
             }
         }
+        vector<H5::DataSet> dataset_invariants;  // Invariants computed from the bulk data share the mises dimensions
+        for (const auto& [invariant_name, invariant_values] : field_bulk_data.invariants) {
+            try {
+                H5::DataSet dataset_invariant = bulk_group.createDataSet(invariant_name, H5::PredType::NATIVE_FLOAT, dataspace_mises, properties_element_points);
+                dataset_invariant.write(invariant_values.data(), H5::PredType::NATIVE_FLOAT);
+                H5DSset_label(dataset_invariant.getId(), 0, elements_name.c_str());
+                H5DSset_label(dataset_invariant.getId(), 1, position.c_str());
+                dataset_invariants.push_back(dataset_invariant);
+            } catch(H5::Exception& e) {
+                this->log_file->logWarning("Unable to create dataset " + invariant_name + ". " + e.getDetailMsg());
+            }
+        }
 
-        hsize_t dimensions_integration_points[] = {field_bulk_data.numberOfElements(), number_of_integration_points};
+        hsize_t dimensions_integration_points[] = {field_bulk_data.numberOfElements, number_of_integration_points};
         H5::DataSpace dataspace_integration_points(2, dimensions_integration_points);
         H5::DataSet dataset_integration_points;
         string integration_points_name = "integrationPoints";
-        if (field_bulk_data.integrationPoints()) {
+        if (write_integration_points) {
+            string integration_points_content = labels_content;
+            append_bytes(integration_points_content, field_bulk_data.integrationPoints.data(), field_bulk_data.integrationPoints.size() * sizeof(int));
+            write_integration_points = !link_frame_datasets(h5_file, bulk_group, group_name, frame_key + "/" + integration_points_name, {integration_points_name}, integration_points_content);
+        }
+        if (write_integration_points) {
             try {
-                dataset_integration_points = bulk_group.createDataSet(integration_points_name, H5::PredType::NATIVE_INT, dataspace_integration_points);
-                dataset_integration_points.write(field_bulk_data.integrationPoints(), H5::PredType::NATIVE_INT);
+                dataset_integration_points = bulk_group.createDataSet(integration_points_name, H5::PredType::NATIVE_INT, dataspace_integration_points, properties_element_points);
+                dataset_integration_points.write(field_bulk_data.integrationPoints.data(), H5::PredType::NATIVE_INT);
                 H5DSset_label(dataset_integration_points.getId(), 0, elements_name.c_str());
                 H5DSset_label(dataset_integration_points.getId(), 1, position.c_str());
             } catch(H5::Exception& e) {
@@ -2309,21 +3189,22 @@ void SpadeObject::write_extract_field_bulk_data(H5::H5File &h5_file, const strin
 
         // Creating blank dataset to use as dimension scale
         hsize_t dimensions_position[] = {number_of_integration_points};
-        double* zeroes = new double[number_of_integration_points];
+        vector<float> zeroes(number_of_integration_points, 0.0);
         H5::DataSpace dataspace_position(1, dimensions_position);
         H5::DataSet dataset_position;
         try {
             dataset_position = bulk_group.createDataSet(position, H5::PredType::NATIVE_FLOAT, dataspace_position);
-            dataset_position.write(zeroes, H5::PredType::NATIVE_FLOAT);
+            dataset_position.write(zeroes.data(), H5::PredType::NATIVE_FLOAT);
             // Associate the coordinate datasets with the main dataset using dimension scales
             H5DSset_scale(dataset_position.getId(), position.c_str());
-            H5DSattach_scale(dataset_element_labels.getId(), dataset_position.getId(), 1);
+            if (!element_labels_linked) { H5DSattach_scale(dataset_element_labels.getId(), dataset_position.getId(), 1); }
             H5DSattach_scale(dataset_data.getId(), dataset_position.getId(), 1);
             if(conjugate_data_exists) { H5DSattach_scale(dataset_conjugate_data.getId(), dataset_position.getId(), 1); }
             if (coord_data_exists) { H5DSattach_scale(dataset_coords.getId(), dataset_position.getId(), 1); }
             if (faces) { H5DSattach_scale(dataset_faces.getId(), dataset_position.getId(), 1); }
             if (write_mises) { H5DSattach_scale(dataset_mises.getId(), dataset_position.getId(), 1); }
-            if (field_bulk_data.integrationPoints()) { H5DSattach_scale(dataset_integration_points.getId(), dataset_position.getId(), 1); }
+            for (const H5::DataSet &dataset_invariant : dataset_invariants) { H5DSattach_scale(dataset_invariant.getId(), dataset_position.getId(), 1); }
+            if (write_integration_points) { H5DSattach_scale(dataset_integration_points.getId(), dataset_position.getId(), 1); }
         } catch(H5::Exception& e) {
             this->log_file->logWarning("Error creating dataset " + position + ". " + e.getDetailMsg());
         }
@@ -2331,34 +3212,27 @@ void SpadeObject::write_extract_field_bulk_data(H5::H5File &h5_file, const strin
         dataspace_position.close();
 
         // Creating 1D dataset of element labels.
-        hsize_t dimensions_number_of_elements[] = {field_bulk_data.numberOfElements()};
-        H5::DataSpace dataspace_memory(1, dimensions_number_of_elements);
+        hsize_t dimensions_number_of_elements[] = {field_bulk_data.numberOfElements};
         H5::DataSpace dataspace_first_element(1, dimensions_number_of_elements);
         H5::DataSet dataset_element;
-        hsize_t start[] = {0, 0};
-        hsize_t count[] = {field_bulk_data.numberOfElements(), 1}; // Number of elements to select
         try {
-            H5::DataSpace dataspace_first_element_label = dataset_element_labels.getSpace();
-            dataspace_first_element_label.selectHyperslab(H5S_SELECT_SET, count, start);
-            vector<int> first_elements(field_bulk_data.numberOfElements());
-            dataset_element_labels.read(first_elements.data(), H5::PredType::NATIVE_INT, dataspace_memory, dataspace_first_element_label);
-            dataset_element = bulk_group.createDataSet(elements_name, H5::PredType::NATIVE_INT, dataspace_first_element);
+            vector<int> first_elements = first_element_labels(field_bulk_data, number_of_integration_points);
+            dataset_element = bulk_group.createDataSet(elements_name, H5::PredType::NATIVE_INT, dataspace_first_element, dataset_properties(1, dimensions_number_of_elements, sizeof(int), false));
             dataset_element.write(first_elements.data(), H5::PredType::NATIVE_INT);
             // Associate the coordinate datasets with the main dataset using dimension scales
             H5DSset_scale(dataset_element.getId(), elements_name.c_str());
-            H5DSattach_scale(dataset_element_labels.getId(), dataset_element.getId(), 0);
+            if (!element_labels_linked) { H5DSattach_scale(dataset_element_labels.getId(), dataset_element.getId(), 0); }
             H5DSattach_scale(dataset_data.getId(), dataset_element.getId(), 0);
             if(conjugate_data_exists) { H5DSattach_scale(dataset_conjugate_data.getId(), dataset_element.getId(), 0); }
             if (coord_data_exists) { H5DSattach_scale(dataset_coords.getId(), dataset_element.getId(), 0); }
             if (faces) { H5DSattach_scale(dataset_faces.getId(), dataset_element.getId(), 0); }
             if (write_mises) { H5DSattach_scale(dataset_mises.getId(), dataset_element.getId(), 0); }
-            if (field_bulk_data.integrationPoints()) { H5DSattach_scale(dataset_integration_points.getId(), dataset_element.getId(), 0); }
-            dataspace_first_element_label.close();
+            for (const H5::DataSet &dataset_invariant : dataset_invariants) { H5DSattach_scale(dataset_invariant.getId(), dataset_element.getId(), 0); }
+            if (write_integration_points) { H5DSattach_scale(dataset_integration_points.getId(), dataset_element.getId(), 0); }
         } catch(H5::Exception& e) {
             this->log_file->logWarning("Error creating dataset " + elements_name + ". " + e.getDetailMsg());
         }
         dataset_element.close();
-        dataspace_memory.close();
         dataspace_first_element.close();
 
 
@@ -2372,6 +3246,7 @@ void SpadeObject::write_extract_field_bulk_data(H5::H5File &h5_file, const strin
         dataspace_faces.close();
         dataset_mises.close();
         dataspace_mises.close();
+        for (H5::DataSet &dataset_invariant : dataset_invariants) { dataset_invariant.close(); }
         dataset_integration_points.close();
         dataspace_integration_points.close();
         dataspace_element_labels.close();
@@ -2379,28 +3254,30 @@ void SpadeObject::write_extract_field_bulk_data(H5::H5File &h5_file, const strin
 
     } else {  // Nodes
         bool conjugate_data_exists = false;
-        hsize_t dimensions[] = {field_bulk_data.length(), field_bulk_data.width()};
+        hsize_t dimensions[] = {field_bulk_data.length, field_bulk_data.width};
         H5::DataSpace dataspace_data(2, dimensions);
         H5::DataSet dataset_data;
         H5::DataSpace dataspace_conjugate_data(2, dimensions);
         H5::DataSet dataset_conjugate_data;
-        hsize_t dimensions_node_labels[] = {field_bulk_data.length()};
+        hsize_t dimensions_node_labels[] = {field_bulk_data.length};
         H5::DataSpace dataspace_node_labels(1, dimensions_node_labels);
         H5::DataSet dataset_node_labels;
+        size_t value_size = (single_precision) ? sizeof(float) : sizeof(double);
+        H5::DSetCreatPropList properties_data = dataset_properties(2, dimensions, value_size, true);
 
-        if(field_bulk_data.precision() == odb_Enum::SINGLE_PRECISION) {
+        if (single_precision) {
             try {
-                dataset_data = bulk_group.createDataSet("data", H5::PredType::NATIVE_FLOAT, dataspace_data);
-                dataset_data.write(field_bulk_data.data(), H5::PredType::NATIVE_FLOAT);
+                dataset_data = bulk_group.createDataSet("data", H5::PredType::NATIVE_FLOAT, dataspace_data, properties_data);
+                dataset_data.write(field_bulk_data.data.data(), H5::PredType::NATIVE_FLOAT);
                 H5DSset_label(dataset_data.getId(), 0, nodes_name.c_str());
                 H5DSset_label(dataset_data.getId(), 1, component_labels_name.c_str());
             } catch(H5::Exception& e) {
                 this->log_file->logWarning("Unable to create dataset data. " + e.getDetailMsg());
             }
-            if (complex_data) {
+            if (!field_bulk_data.conjugateData.empty()) {
                 try {
-                    dataset_conjugate_data = bulk_group.createDataSet("conjugateData", H5::PredType::NATIVE_FLOAT, dataspace_conjugate_data);
-                    dataset_conjugate_data.write(field_bulk_data.conjugateData(), H5::PredType::NATIVE_FLOAT);
+                    dataset_conjugate_data = bulk_group.createDataSet("conjugateData", H5::PredType::NATIVE_FLOAT, dataspace_conjugate_data, properties_data);
+                    dataset_conjugate_data.write(field_bulk_data.conjugateData.data(), H5::PredType::NATIVE_FLOAT);
                     H5DSset_label(dataset_conjugate_data.getId(), 0, nodes_name.c_str());
                     H5DSset_label(dataset_conjugate_data.getId(), 1, component_labels_name.c_str());
                     conjugate_data_exists = true;
@@ -2410,17 +3287,17 @@ void SpadeObject::write_extract_field_bulk_data(H5::H5File &h5_file, const strin
             }
         } else {  // Double precision
             try {
-                dataset_data = bulk_group.createDataSet("data", H5::PredType::NATIVE_DOUBLE, dataspace_data);
-                dataset_data.write(field_bulk_data.data(), H5::PredType::NATIVE_DOUBLE);
+                dataset_data = bulk_group.createDataSet("data", H5::PredType::NATIVE_DOUBLE, dataspace_data, properties_data);
+                dataset_data.write(field_bulk_data.dataDouble.data(), H5::PredType::NATIVE_DOUBLE);
                 H5DSset_label(dataset_data.getId(), 0, nodes_name.c_str());
                 H5DSset_label(dataset_data.getId(), 1, component_labels_name.c_str());
             } catch(H5::Exception& e) {
                 this->log_file->logWarning("Unable to create dataset data. " + e.getDetailMsg());
             }
-            if (complex_data) {
+            if (!field_bulk_data.conjugateDataDouble.empty()) {
                 try {
-                    dataset_conjugate_data = bulk_group.createDataSet("conjugateData", H5::PredType::NATIVE_DOUBLE, dataspace_conjugate_data);
-                    dataset_conjugate_data.write(field_bulk_data.conjugateData(), H5::PredType::NATIVE_DOUBLE);
+                    dataset_conjugate_data = bulk_group.createDataSet("conjugateData", H5::PredType::NATIVE_DOUBLE, dataspace_conjugate_data, properties_data);
+                    dataset_conjugate_data.write(field_bulk_data.conjugateDataDouble.data(), H5::PredType::NATIVE_DOUBLE);
                     H5DSset_label(dataset_conjugate_data.getId(), 0, nodes_name.c_str());
                     H5DSset_label(dataset_conjugate_data.getId(), 1, component_labels_name.c_str());
                     conjugate_data_exists = true;
@@ -2447,17 +3324,29 @@ void SpadeObject::write_extract_field_bulk_data(H5::H5File &h5_file, const strin
         dataset_label.close();
         dataspace_label.close();
 
+        vector<H5::DataSet> dataset_invariants;
+        for (const auto& [invariant_name, invariant_values] : field_bulk_data.invariants) {
+            try {
+                H5::DataSet dataset_invariant = bulk_group.createDataSet(invariant_name, H5::PredType::NATIVE_FLOAT, dataspace_node_labels, dataset_properties(1, dimensions_node_labels, sizeof(float), true));
+                dataset_invariant.write(invariant_values.data(), H5::PredType::NATIVE_FLOAT);
+                dataset_invariants.push_back(dataset_invariant);
+            } catch(H5::Exception& e) {
+                this->log_file->logWarning("Unable to create dataset " + invariant_name + ". " + e.getDetailMsg());
+            }
+        }
 
         string labels_name = "nodeLabels";
         try {
-            H5::DataSet dataset_node_labels = bulk_group.createDataSet(labels_name, H5::PredType::NATIVE_INT, dataspace_node_labels);
-            dataset_node_labels.write(field_bulk_data.nodeLabels(), H5::PredType::NATIVE_INT);
+            H5::DataSet dataset_node_labels = bulk_group.createDataSet(labels_name, H5::PredType::NATIVE_INT, dataspace_node_labels, dataset_properties(1, dimensions_node_labels, sizeof(int), false));
+            dataset_node_labels.write(field_bulk_data.nodeLabels.data(), H5::PredType::NATIVE_INT);
             H5DSset_scale(dataset_node_labels.getId(), labels_name.c_str());
             H5DSattach_scale(dataset_data.getId(), dataset_node_labels.getId(), 0);
             if(conjugate_data_exists) { H5DSattach_scale(dataset_conjugate_data.getId(), dataset_node_labels.getId(), 0); }
+            for (const H5::DataSet &dataset_invariant : dataset_invariants) { H5DSattach_scale(dataset_invariant.getId(), dataset_node_labels.getId(), 0); }
         } catch(H5::Exception& e) {
             this->log_file->logWarning("Unable to create dataset " + labels_name + ". " + e.getDetailMsg());
         }
+        for (H5::DataSet &dataset_invariant : dataset_invariants) { dataset_invariant.close(); }
 
         dataspace_data.close();
         dataset_data.close();
@@ -2468,366 +3357,453 @@ void SpadeObject::write_extract_field_bulk_data(H5::H5File &h5_file, const strin
     }
 }
 
-void SpadeObject::write_field_outputs(H5::H5File &h5_file, const odb_Frame &frame, const string &group_name, int &max_width, int &max_length) {
-    string field_outputs_group_name = group_name + "/fieldOutputs";
-    H5::Group field_outputs_group = create_group(h5_file, field_outputs_group_name);
-
-    const odb_FieldOutputRepository& field_outputs = frame.fieldOutputs();
-    odb_FieldOutputRepositoryIT field_outputs_iterator(field_outputs);
-    for (field_outputs_iterator.first(); !field_outputs_iterator.isDone(); field_outputs_iterator.next()) {
-        const odb_FieldOutput& field_output = field_outputs[field_outputs_iterator.currentKey()];
+function<void(field_output_type&)> SpadeObject::field_output_writer(H5Writer &h5_writer, H5::H5File &h5_file, const string &frame_group_name, const string &frame_number, const int &frame_index, const string &step_name, const float &frame_value) {
+    if (this->command_line_arguments->get("format") == "odb") {
+        string field_outputs_group_name = frame_group_name + "/fieldOutputs";
+        h5_writer.enqueue([this, &h5_file, field_outputs_group_name] { create_group(h5_file, field_outputs_group_name); }, 0);
+        return [this, &h5_writer, &h5_file, field_outputs_group_name] (field_output_type &field_output) {
+            field_output_type part = split_field_output(field_output);
+            size_t part_bytes = field_output_size(part);
+            h5_writer.enqueue([this, &h5_file, field_outputs_group_name, field_output = std::move(part)] () mutable {
+                write_field_output(h5_file, field_outputs_group_name, field_output);
+            }, part_bytes);
+        };
+    }
+    bool stacked_layout = (this->command_line_arguments->get("layout") == "stacked");
+    int frame_number_value = std::stoi(frame_number);
+    return [this, &h5_writer, &h5_file, stacked_layout, frame_number, frame_index, frame_number_value, frame_value, step_name] (field_output_type &field_output) {
+        field_output_type part = split_field_output(field_output);
+        size_t part_bytes = field_output_size(part);
+        if (stacked_layout) {
+            h5_writer.enqueue([this, &h5_file, frame_index, frame_number_value, frame_value, step_name, field_output = std::move(part)] () mutable {
+                write_stacked_field_output(h5_file, frame_index, frame_number_value, frame_value, step_name, field_output);
+            }, part_bytes);
+        } else {
+            h5_writer.enqueue([this, &h5_file, frame_number, step_name, field_output = std::move(part)] () mutable {
+                write_extract_field_output(h5_file, frame_number, step_name, field_output);
+            }, part_bytes);
+        }
+    };
+}
 
-        string field_output_name = field_output.name().CStr();
-        if ((this->command_line_arguments->get("field") != "all") && (!this->field_set.count(field_output_name))) {
-            continue;
+void SpadeObject::write_field_output(H5::H5File &h5_file, const string &group_name, field_output_type &field_output) {
+    Logging::Span span(*this->log_file, "write field output");
+    span.add("field output", field_output.name);
+    if (span.active()) { span.add("bytes", static_cast<long long>(field_output_size(field_output))); }
+    string field_output_group_name = group_name + "/" + replace_slashes(field_output.name);
+    H5::Group field_output_group = create_group(h5_file, field_output_group_name);
+    this->log_file->logVerbose("Writing field output data for " + field_output.name);
+    if (field_output.writeMetadata) {
+        write_string_attribute(field_output_group, "name", field_output.name);
+        write_field_output_metadata(h5_file, field_output_group_name, field_output_group, field_output);
+    }
+
+    this->log_file->logDebug("Writing " + to_string(field_output.bulkValues.size()) + " blocks of bulk field output data for " + field_output.name);
+    for (field_bulk_type &field_bulk_value : field_output.bulkValues) {
+        if (field_bulk_value.writeFieldValues) {
+            string instance_group_name = field_output_group_name + "/" + field_bulk_value.instanceName;
+            H5::Group instance_group = create_group(h5_file, instance_group_name);
+            write_field_values(h5_file, instance_group_name, instance_group, field_output.values[field_bulk_value.instanceName]);
         }
-        string field_output_group_name = field_outputs_group_name + "/" + replace_slashes(field_output_name);
-        H5::Group field_output_group = create_group(h5_file, field_output_group_name);
-        write_string_attribute(field_output_group, "name", field_output_name);
-        this->log_file->logVerbose("Writing field output data for " + field_output_name);
-        write_string_dataset(field_output_group, "description", field_output.description().CStr());
-        write_string_dataset(field_output_group, "type", get_field_type_enum(field_output.type()));
-        write_integer_dataset(field_output_group, "dim", field_output.dim());
-        write_integer_dataset(field_output_group, "dim2", field_output.dim2());
-        // TODO: Maybe reach out to 3DS to determine if they plan to implement isEngineeringTensor() function
-        // string isEngineeringTensor = (field_output.isEngineeringTensor()) ? "true" : "false";
-        // write_string_dataset(field_output_group, "isEngineeringTensor", isEngineeringTensor);
-
-        vector<const char*> component_labels;
-        odb_SequenceString available_components = field_output.componentLabels();
-        for (int i=0; i<available_components.size(); i++) {
-            component_labels.push_back(available_components[i].CStr());
-        }
-        write_c_string_vector_dataset(field_output_group, "componentLabels", component_labels);
-
-        vector<string> valid_invariants;
-        for (int i=0; i<field_output.validInvariants().size(); i++) {
-            valid_invariants.push_back(get_valid_invariant_enum(field_output.validInvariants().constGet(i)));
-        }
-        write_string_vector_dataset(field_output_group, "validInvariants", valid_invariants);
-
-        odb_SequenceFieldLocation field_locations = field_output.locations();
-        if (field_locations.size() > 0) {
-            this->log_file->logVerbose("Writing field location data for " + field_output_name);
-            H5::Group locations_group = create_group(h5_file, field_output_group_name + "/locations");
-            for (int i=0; i<field_locations.size(); i++) {
-                odb_FieldLocation field_location = field_locations.constGet(i);
-                string location_group_name = field_output_group_name + "/locations/" + to_string(i);
-                H5::Group location_group = create_group(h5_file, location_group_name);
-
-                string position = get_position_enum(field_location.position());
-                write_string_dataset(location_group, "position", position);
-                if (field_location.sectionPoint().size() > 0) {
-                    H5::Group section_points_group = create_group(h5_file, location_group_name + "/sectionPoint");
-                    for (int j=0; j<field_location.sectionPoint().size(); j++) {
-                        H5::Group section_point_group = create_group(h5_file, location_group_name + "/sectionPoint/" + to_string(field_location.sectionPoint(j).number()));
-                        write_string_dataset(section_point_group, "description", field_location.sectionPoint(j).description().CStr());
-                    }
-                }
-            }
+        string value_group_name = field_output_group_name + "/" + field_bulk_value.instanceName + "/" + field_bulk_value.dataName;
+        this->log_file->logDebug([&] { return "Write field bulk data " + field_bulk_value.dataName; });
+        write_field_bulk_data(h5_file, value_group_name, field_bulk_value);
+    }
+
+    for (const string& instance_name : field_output.remainingInstances) {
+        string instance_group_name = field_output_group_name + "/" + instance_name;
+        H5::Group instance_group = create_group(h5_file, instance_group_name);
+        write_field_values(h5_file, instance_group_name, instance_group, field_output.values[instance_name]);
+    }
+}
+
+void SpadeObject::write_extract_field_output(H5::H5File &h5_file, const string &frame_number, const string &step_name, field_output_type &field_output) {
+    Logging::Span span(*this->log_file, "write field output");
+    span.add("field output", field_output.name);
+    span.add("frame", frame_number);
+    if (span.active()) { span.add("bytes", static_cast<long long>(field_output_size(field_output))); }
+    string field_output_safe_name = replace_slashes(field_output.name);
+    this->log_file->logVerbose("Writing field output data for " + field_output.name);
+
+    this->log_file->logDebug("Writing " + to_string(field_output.bulkValues.size()) + " blocks of bulk field output data for " + field_output.name);
+    for (field_bulk_type &field_bulk_value : field_output.bulkValues) {
+        string prefix = (field_bulk_value.assemblyData) ? "/assemblies/" : "/instances/";
+        string field_output_group_name = prefix + field_bulk_value.instanceName + "/FieldOutputs/" + field_output_safe_name + "/" + step_name + "/" + frame_number;
+        bool sub_group_exists = false;
+        H5::Group field_output_group = open_subgroup(h5_file, field_output_group_name, sub_group_exists);
+        if (field_bulk_value.writeFieldValues) {
+            write_field_values(h5_file, field_output_group_name, field_output_group, field_output.values[field_bulk_value.instanceName]);
         }
+        write_field_output_name(h5_file, prefix + field_bulk_value.instanceName + "/FieldOutputs/" + field_output_safe_name, field_output.name);
+        string step_group_name = prefix + field_bulk_value.instanceName + "/FieldOutputs/" + field_output_safe_name + "/" + step_name;
+        write_frame_field_output_metadata(h5_file, field_output_group_name, field_output_group, step_group_name, field_output);
 
+        string value_group_name = field_output_group_name + "/" + field_bulk_value.dataName;
+        this->log_file->logDebug([&] { return "Write field bulk data " + field_bulk_value.dataName; });
+        write_extract_field_bulk_data(h5_file, value_group_name, field_bulk_value, field_output_safe_name, step_group_name + "/" + field_bulk_value.dataName);
+    }
 
-        map<string, field_value_type> values_map;  // String index is the name of the instance
-        odb_SequenceFieldValue field_values = field_output.values();
-        set<string> instance_names;
-        bool write_mises = false;
-        if (field_output.validInvariants().size() > 0) {
-            field_value_type new_field_value;
-            for (int i=0; i<field_values.size(); i++) {
-                odb_FieldValue field_value  = field_values.constGet(i);
-                string instance_name = field_value.instance().name().CStr();
-                if (instance_name.empty()) { instance_name = this->default_instance_name; }
-                if (instance_names.find(instance_name) == instance_names.end()) {
-                    values_map[instance_name].magnitudeEmpty = true;
-                    values_map[instance_name].trescaEmpty = true;
-                    values_map[instance_name].pressEmpty = true;
-                    values_map[instance_name].inv3Empty = true;
-                    values_map[instance_name].maxPrincipalEmpty = true;
-                    values_map[instance_name].midPrincipalEmpty = true;
-                    values_map[instance_name].minPrincipalEmpty = true;
-                    values_map[instance_name].maxInPlanePrincipalEmpty = true;
-                    values_map[instance_name].minInPlanePrincipalEmpty = true;
-                    values_map[instance_name].outOfPlanePrincipalEmpty = true;
-                    values_map[instance_name].elementEmpty = true;
-                    values_map[instance_name].nodeEmpty = true;
-                    values_map[instance_name].integrationPointEmpty = true;
-                    values_map[instance_name].typeEmpty = true;
-                    values_map[instance_name].sectionPointNumberEmpty = true;
-                    values_map[instance_name].sectionPointDescriptionEmpty = true;
-                    instance_names.insert(instance_name);
-                }
-                process_field_values(field_value, field_output.validInvariants(), values_map[instance_name]);
-            }
-            if (field_output.validInvariants().isMember(odb_Enum::MISES)) {
-                write_mises = true;
-            }
+    // If there is an instance with field output data (not bulk data) that didn't get written, then write it here
+    for (const string& instance_name : field_output.remainingInstances) {
+        string prefix = "/instances/";
+        if (instance_name == this->default_instance_name) {
+            prefix = "/assemblies/";
         }
+        string field_output_group_name = prefix + instance_name + "/FieldOutputs/" + field_output_safe_name + "/" + step_name + "/" + frame_number;
+        bool sub_group_exists = false;
+        H5::Group field_output_group = open_subgroup(h5_file, field_output_group_name, sub_group_exists);
+        write_field_values(h5_file, field_output_group_name, field_output_group, field_output.values[instance_name]);
+        write_field_output_name(h5_file, prefix + instance_name + "/FieldOutputs/" + field_output_safe_name, field_output.name);
+        string step_group_name = prefix + instance_name + "/FieldOutputs/" + field_output_safe_name + "/" + step_name;
+        write_frame_field_output_metadata(h5_file, field_output_group_name, field_output_group, step_group_name, field_output);
+    }
+}
 
-        int field_output_max_length = 0;
-        int field_output_max_width = 0;
-        set<string> field_data_names;
-        const odb_SequenceFieldBulkData& field_bulk_values = field_output.bulkDataBlocks();
-        this->log_file->logDebug("Writing " + to_string(field_bulk_values.size()) + " blocks of bulk field output data for " + field_output_name);
-        for (int i=0; i<field_bulk_values.size(); i++) {  // There seems to be a "block" per element type and if the element type is the same per section point
-                                                        // e.g. In one odb the "E" field values had three "blocks" One for element type B23 (section point 1)
-                                                        // one for element type B23 (section point 5), and one for element type GAPUNI
-            const odb_FieldBulkData& field_bulk_value = field_bulk_values[i];
+void SpadeObject::write_frame_field_output_metadata(H5::H5File &h5_file, const string &group_name, const H5::Group &group, const string &step_group_name, const field_output_type &field_output) {
+    // Only link the datasets write_field_output_metadata() would write
+    vector<string> dataset_names;
+    if (!this->scalar_attributes) {
+        if (!field_output.description.empty()) { dataset_names.push_back("description"); }
+        if (!field_output.type.empty()) { dataset_names.push_back("type"); }
+        if (field_output.dim) { dataset_names.push_back("dim"); }
+        if (field_output.dim2) { dataset_names.push_back("dim2"); }
+    }
+    if (!field_output.componentLabels.empty()) { dataset_names.push_back("componentLabels"); }
+    if (!field_output.validInvariants.empty()) { dataset_names.push_back("validInvariants"); }
+    if (!field_output.locations.empty()) { dataset_names.push_back("locations"); }
+
+    int dimensions[] = {field_output.dim, field_output.dim2};
+    string metadata_content;
+    append_bytes(metadata_content, dimensions, sizeof(dimensions));
+    append_strings(metadata_content, {field_output.description, field_output.type});
+    append_strings(metadata_content, field_output.componentLabels);
+    append_strings(metadata_content, field_output.validInvariants);
+    for (const field_location_type &field_location : field_output.locations) {
+        append_strings(metadata_content, {field_location.position, to_string(field_location.sectionPoint.size())});
+        for (const section_point_type &section_point : field_location.sectionPoint) {
+            append_strings(metadata_content, {section_point.number, section_point.description});
+        }
+    }
+    if (!link_frame_datasets(h5_file, group, group_name, step_group_name, dataset_names, metadata_content)) {
+        write_field_output_metadata(h5_file, group_name, group, field_output);
+    } else if (this->scalar_attributes) {
+        write_field_output_scalars(group, field_output);
+    }
+}
 
-            // Skip instance if 'all' not specified and instance doesn't match user input
-            string instance_name = field_bulk_value.instance().name().CStr();
-            bool instance_value_exists = false;
-            if (instance_names.find(instance_name) != instance_names.end()) {
-                instance_names.erase(instance_name);  // Remove from set to indicate it has already been processed
-                instance_value_exists = true;
-            }
-            if (instance_name.empty()) { instance_name = this->default_instance_name; }
-            if ((this->command_line_arguments->get("instance") != "all") && (!this->instance_set.count(instance_name))) {
-                continue;
-            }
-            if (instance_value_exists) {
-                string instance_group_name = field_output_group_name + "/" + instance_name;
-                H5::Group instance_group = create_group(h5_file, instance_group_name);
-                write_field_values(h5_file, instance_group_name, instance_group, values_map[instance_name]);
-            }
+bool SpadeObject::link_frame_datasets(H5::H5File &h5_file, const H5::Group &group, const string &group_name, const string &frame_key, const vector<string> &dataset_names, const string &content) {
+    string partition;
+    if (!this->split_by.empty()) { partition_root(group_name, partition); }  // Hard links can't reach into another partition file
+    const string* shared_content = &*this->frame_dataset_contents.insert(content).first;  // Found by comparing the bytes of contents with the same hash
+    auto [frame_dataset, inserted] = this->frame_datasets.try_emplace(partition + frame_key, shared_content, group_name, group_name);
+    if (inserted) { return false; }
+    auto &[linked_content, linked_group_name, last_group_name] = frame_dataset->second;
+    if (last_group_name == group_name) { return true; }  // Already written or linked to this group, e.g. for another block of the same instance
+    last_group_name = group_name;
+    if (linked_content != shared_content) {
+        linked_content = shared_content;
+        linked_group_name = group_name;
+        return false;
+    }
+    for (const string &dataset_name : dataset_names) {
+        string linked_name = linked_group_name + "/" + dataset_name;
+        if (H5Lcreate_hard(group.getId(), linked_name.c_str(), group.getId(), dataset_name.c_str(), H5P_DEFAULT, H5P_DEFAULT) < 0) {  // The full path is found in the file of the group, which is a partition file when split
+            this->log_file->logWarning("Unable to link " + group_name + "/" + dataset_name + " to " + linked_name + ".");
+        }
+    }
+    return true;
+}
 
-            // Get name of group where to write data
-            string position = get_position_enum(field_bulk_value.position());
-            string data_name;
-            string base_element_type = "";
-            base_element_type = field_bulk_value.baseElementType().CStr();
-            if (!base_element_type.empty()) {
-                data_name = field_bulk_value.baseElementType().CStr();
-            } else {
-                data_name = position;
-            }
-            if (field_data_names.find(data_name) != field_data_names.end()) {  // If this name already exists, append the index to it
-                data_name = data_name + "_" + to_string(i);   // It would be nice to append the section point number to it, but I'm not sure how to do that reliably
-            }
-            field_data_names.insert(data_name);
+void SpadeObject::write_field_output_name(H5::H5File &h5_file, const string &group_name, const string &field_output_name) {
+    H5::Group group = h5_file.openGroup(group_name);
+    if (group.attrExists("name")) { return; }  // Written for an earlier frame or another block of the instance
+    write_string_attribute(group, "name", field_output_name);
+}
 
-            if (field_bulk_value.width() > field_output_max_width) {  field_output_max_width = field_bulk_value.width(); }
-            if (field_bulk_value.length() > field_output_max_length) {  field_output_max_length = field_bulk_value.length(); }
+void SpadeObject::write_field_output_scalars(const H5::Group &group, const field_output_type &field_output) {
+    write_string_dataset(group, "description", field_output.description);
+    write_string_dataset(group, "type", field_output.type);
+    write_integer_dataset(group, "dim", field_output.dim);
+    write_integer_dataset(group, "dim2", field_output.dim2);
+}
 
-            string value_group_name = field_output_group_name + "/" + instance_name + "/" + data_name;
-            this->log_file->logDebug("Write field bulk data " + data_name);
-            write_field_bulk_data(h5_file, value_group_name, field_bulk_value, field_output.isComplex(), write_mises);
-        }
+void SpadeObject::append_bytes(string &content, const void* data, const size_t &bytes) {
+    content.append(static_cast<const char*>(data), bytes);
+}
 
-        if (field_output_max_width > max_width) {  max_width = field_output_max_width; }
-        if (field_output_max_length > max_length) {  max_length = field_output_max_length; }
+void SpadeObject::append_strings(string &content, const vector<string> &strings) {
+    for (const string &string_value : strings) {
+        size_t string_size = string_value.size();
+        append_bytes(content, &string_size, sizeof(string_size));  // The size keeps the strings apart
+        content.append(string_value);
+    }
+}
 
-        for (const string& instance_name : instance_names) {
-            if ((this->command_line_arguments->get("instance") != "all") && (!this->instance_set.count(instance_name))) {
-                continue;
+void SpadeObject::write_field_output_metadata(H5::H5File &h5_file, const string &group_name, const H5::Group &group, const field_output_type &field_output) {
+    write_field_output_scalars(group, field_output);
+    // TODO: Maybe reach out to 3DS to determine if they plan to implement isEngineeringTensor() function
+    // string isEngineeringTensor = (field_output.isEngineeringTensor()) ? "true" : "false";
+    // write_string_dataset(group, "isEngineeringTensor", isEngineeringTensor);
+
+    write_string_vector_dataset(group, "componentLabels", field_output.componentLabels);
+    write_string_vector_dataset(group, "validInvariants", field_output.validInvariants);
+
+    if (field_output.locations.size() > 0) {
+        this->log_file->logDebug("Write field location data");
+        H5::Group locations_group = create_group(h5_file, group_name + "/locations");
+        for (int i=0; i<field_output.locations.size(); i++) {
+            const field_location_type &field_location = field_output.locations[i];
+            string location_group_name = group_name + "/locations/" + to_string(i);
+            H5::Group location_group = create_group(h5_file, location_group_name);
+
+            write_string_dataset(location_group, "position", field_location.position);
+            if (field_location.sectionPoint.size() > 0) {
+                this->log_file->logDebug([&] { return "Write section point data for location " + to_string(i); });
+                H5::Group section_points_group = create_group(h5_file, location_group_name + "/sectionPoint");
+                for (const section_point_type &section_point : field_location.sectionPoint) {
+                    H5::Group section_point_group = create_group(h5_file, location_group_name + "/sectionPoint/" + section_point.number);
+                    write_string_dataset(section_point_group, "description", section_point.description);
+                }
             }
-            string instance_group_name = field_output_group_name + "/" + instance_name;
-            H5::Group instance_group = create_group(h5_file, instance_group_name);
-            write_field_values(h5_file, instance_group_name, instance_group, values_map[instance_name]);
         }
     }
 }
 
-void SpadeObject::write_extract_field_outputs(H5::H5File &h5_file, const odb_Frame &frame, const string &frame_number, const string &step_name, int &max_width, int &max_length) {
+void SpadeObject::write_stacked_field_output(H5::H5File &h5_file, const int &frame_index, const int &frame_number, const float &frame_value, const string &step_name, field_output_type &field_output) {
+    Logging::Span span(*this->log_file, "write field output");
+    span.add("field output", field_output.name);
+    span.add("frame", frame_number);
+    if (span.active()) { span.add("bytes", static_cast<long long>(field_output_size(field_output))); }
+    string field_output_safe_name = replace_slashes(field_output.name);
+    this->log_file->logVerbose("Writing stacked field output data for " + field_output.name);
+
+    set<string> stepped_groups;  // Step groups that already have this frame in their frame scales
+    auto open_step_group = [&] (const string &prefix, const string &instance_name) {
+        string field_output_name = prefix + instance_name + "/FieldOutputs/" + field_output_safe_name;
+        string step_group_name = field_output_name + "/" + step_name;
+        bool sub_group_exists = false;
+        H5::Group step_group = open_subgroup(h5_file, step_group_name, sub_group_exists);
+        if (!sub_group_exists) {
+            H5::Group field_output_group = create_group(h5_file, field_output_name);
+            if (!field_output_group.attrExists("name")) { write_string_attribute(field_output_group, "name", field_output.name); }
+            write_field_output_metadata(h5_file, step_group_name, step_group, field_output);
+        }
+        if (stepped_groups.insert(step_group_name).second) {
+            write_frame_scales(step_group, frame_index, frame_number, frame_value);
+        }
+        return step_group;
+    };
+
+    this->log_file->logDebug("Writing " + to_string(field_output.bulkValues.size()) + " blocks of bulk field output data for " + field_output.name);
+    for (field_bulk_type &field_bulk_value : field_output.bulkValues) {
+        string prefix = (field_bulk_value.assemblyData) ? "/assemblies/" : "/instances/";
+        H5::Group step_group = open_step_group(prefix, field_bulk_value.instanceName);
+        if (field_bulk_value.writeFieldValues) {
+            write_stacked_field_values(step_group, frame_index, field_output.values[field_bulk_value.instanceName]);
+        }
+        this->log_file->logDebug([&] { return "Write stacked field bulk data " + field_bulk_value.dataName; });
+        write_stacked_field_bulk_data(step_group, field_bulk_value.dataName, frame_index, field_bulk_value, field_output_safe_name);
+    }
+
+    for (const string& instance_name : field_output.remainingInstances) {
+        string prefix = (instance_name == this->default_instance_name) ? "/assemblies/" : "/instances/";
+        H5::Group step_group = open_step_group(prefix, instance_name);
+        write_stacked_field_values(step_group, frame_index, field_output.values[instance_name]);
+    }
+}
 
-    const odb_FieldOutputRepository& field_outputs = frame.fieldOutputs();
-    odb_FieldOutputRepositoryIT field_outputs_iterator(field_outputs);
-    for (field_outputs_iterator.first(); !field_outputs_iterator.isDone(); field_outputs_iterator.next()) {
-        const odb_FieldOutput& field_output = field_outputs[field_outputs_iterator.currentKey()];
+void SpadeObject::write_frame_scales(const H5::Group &step_group, const int &frame_index, const int &frame_number, const float &frame_value) {
+    bool created = false;
+    H5::DataSet dataset_frame_values = write_stacked_array(step_group, "frame_values", frame_index, 0, nullptr, H5::PredType::NATIVE_FLOAT, &frame_value, created);
+    if (created) { H5DSset_scale(dataset_frame_values.getId(), "frame_values"); }
+    H5::DataSet dataset_frame_numbers = write_stacked_array(step_group, "frame_numbers", frame_index, 0, nullptr, H5::PredType::NATIVE_INT, &frame_number, created);
+    if (created) { H5DSset_scale(dataset_frame_numbers.getId(), "frame_numbers"); }
+}
 
-        string field_output_name = field_output.name().CStr();
-        if ((this->command_line_arguments->get("field") != "all") && (!this->field_set.count(field_output_name))) {
-            continue;
+void SpadeObject::attach_stacked_scales(const H5::Group &step_group, const H5::Group &group, const H5::DataSet &dataset, const vector<pair<string, string>> &dimension_scales) {
+    try {
+        H5DSset_label(dataset.getId(), 0, "frames");
+        for (const string scale_name : {"frame_values", "frame_numbers"}) {
+            H5::DataSet frame_scale = step_group.openDataSet(scale_name);
+            H5DSattach_scale(dataset.getId(), frame_scale.getId(), 0);
         }
-        string field_output_safe_name = replace_slashes(field_output_name);
-        this->log_file->logVerbose("Writing field output data for " + field_output_name);
-
-        vector<const char*> component_labels;
-        odb_SequenceString available_components = field_output.componentLabels();
-        for (int i=0; i<available_components.size(); i++) {
-            component_labels.push_back(available_components[i].CStr());
-        }
-
-        vector<string> valid_invariants;
-        for (int i=0; i<field_output.validInvariants().size(); i++) {
-            valid_invariants.push_back(get_valid_invariant_enum(field_output.validInvariants().constGet(i)));
-        }
-
-        odb_SequenceFieldLocation field_locations = field_output.locations();
-
-        map<string, field_value_type> values_map;  // String index is the name of the instance
-        odb_SequenceFieldValue field_values = field_output.values();
-        set<string> instance_names;
-        bool write_mises = false;
-        if (field_output.validInvariants().size() > 0) {
-            field_value_type new_field_value;
-            for (int i=0; i<field_values.size(); i++) {
-                odb_FieldValue field_value  = field_values.constGet(i);
-                string instance_name = field_value.instance().name().CStr();
-                if (instance_name.empty()) { instance_name = this->default_instance_name; }
-                if (instance_names.find(instance_name) == instance_names.end()) {
-                    values_map[instance_name].magnitudeEmpty = true;
-                    values_map[instance_name].trescaEmpty = true;
-                    values_map[instance_name].pressEmpty = true;
-                    values_map[instance_name].inv3Empty = true;
-                    values_map[instance_name].maxPrincipalEmpty = true;
-                    values_map[instance_name].midPrincipalEmpty = true;
-                    values_map[instance_name].minPrincipalEmpty = true;
-                    values_map[instance_name].maxInPlanePrincipalEmpty = true;
-                    values_map[instance_name].minInPlanePrincipalEmpty = true;
-                    values_map[instance_name].outOfPlanePrincipalEmpty = true;
-                    values_map[instance_name].elementEmpty = true;
-                    values_map[instance_name].nodeEmpty = true;
-                    values_map[instance_name].integrationPointEmpty = true;
-                    values_map[instance_name].typeEmpty = true;
-                    values_map[instance_name].sectionPointNumberEmpty = true;
-                    values_map[instance_name].sectionPointDescriptionEmpty = true;
-                    instance_names.insert(instance_name);
-                }
-                process_field_values(field_value, field_output.validInvariants(), values_map[instance_name]);
-            }
-            if (field_output.validInvariants().isMember(odb_Enum::MISES)) {
-                write_mises = true;
+        for (int i=0; i<dimension_scales.size(); i++) {
+            const auto& [dimension_label, scale_name] = dimension_scales[i];
+            H5DSset_label(dataset.getId(), i + 1, dimension_label.c_str());
+            if ((!scale_name.empty()) && (group.nameExists(scale_name))) {
+                H5::DataSet scale = group.openDataSet(scale_name);
+                H5DSattach_scale(dataset.getId(), scale.getId(), i + 1);
             }
         }
+    } catch(H5::Exception& e) {
+        this->log_file->logWarning("Unable to attach dimension scales. " + e.getDetailMsg());
+    }
+}
 
-        int field_output_max_length = 0;
-        int field_output_max_width = 0;
-        set<string> field_data_names;
-        const odb_SequenceFieldBulkData& field_bulk_values = field_output.bulkDataBlocks();
-        this->log_file->logDebug("Writing " + to_string(field_bulk_values.size()) + " blocks of bulk field output data for " + field_output_name);
-        for (int i=0; i<field_bulk_values.size(); i++) {  // There seems to be a "block" per element type and if the element type is the same per section point
-                                                        // e.g. In one odb the "E" field values had three "blocks" One for element type B23 (section point 1)
-                                                        // one for element type B23 (section point 5), and one for element type GAPUNI
-            const odb_FieldBulkData& field_bulk_value = field_bulk_values[i];
+void SpadeObject::write_stacked_field_values(const H5::Group &group, const int &frame_index, field_value_type &values) {
+    // Labels are written with the first frame, invariants get a row per frame
+    if ((values.elementEmpty == false) && (!group.nameExists("elementLabel"))) { write_integer_vector_dataset(group, "elementLabel", values.elementLabel); }
+    if ((values.nodeEmpty == false) && (!group.nameExists("nodeLabel"))) { write_integer_vector_dataset(group, "nodeLabel", values.nodeLabel); }
+    if ((values.integrationPointEmpty == false) && (!group.nameExists("integrationPoint"))) { write_integer_vector_dataset(group, "integrationPoint", values.integrationPoint); }
+    if ((values.typeEmpty == false) && (!group.nameExists("type"))) {
+        hsize_t dimensions[] = {values.type.size()};
+        write_enum_dataset(group, "type", this->data_type_enum_type, 1, dimensions, values.type.data());
+    }
+    if (((values.sectionPointNumberEmpty == false) || (values.sectionPointDescriptionEmpty == false)) && (!group.nameExists("sectionPoint"))) {
+        H5::Group section_point_group = group.createGroup("sectionPoint");
+        if (values.sectionPointNumberEmpty == false) {
+            write_string_vector_dataset(section_point_group, "number", values.sectionPointNumber);
+        }
+        if (values.sectionPointDescriptionEmpty == false) {
+            write_string_vector_dataset(section_point_group, "description", values.sectionPointDescription);
+        }
+    }
 
-            // Skip instance if 'all' not specified and instance doesn't match user input
-            string instance_name = field_bulk_value.instance().name().CStr();
-            bool instance_value_exists = false;
-            if (instance_names.find(instance_name) != instance_names.end()) {
-                instance_names.erase(instance_name);  // Remove from set to indicate it has already been processed
-                instance_value_exists = true;
+    vector<tuple<string, bool, vector<float>*>> invariants = {
+        {"magnitude", values.magnitudeEmpty, &values.magnitude},
+        {"tresca", values.trescaEmpty, &values.tresca},
+        {"press", values.pressEmpty, &values.press},
+        {"inv3", values.inv3Empty, &values.inv3},
+        {"maxPrincipal", values.maxPrincipalEmpty, &values.maxPrincipal},
+        {"midPrincipal", values.midPrincipalEmpty, &values.midPrincipal},
+        {"minPrincipal", values.minPrincipalEmpty, &values.minPrincipal},
+        {"maxInPlanePrincipal", values.maxInPlanePrincipalEmpty, &values.maxInPlanePrincipal},
+        {"minInPlanePrincipal", values.minInPlanePrincipalEmpty, &values.minInPlanePrincipal},
+        {"outOfPlanePrincipal", values.outOfPlanePrincipalEmpty, &values.outOfPlanePrincipal},
+    };
+    for (auto& [invariant_name, invariant_empty, invariant_values] : invariants) {
+        if (invariant_empty) { continue; }
+        hsize_t dimensions[] = {invariant_values->size()};
+        bool created = false;
+        H5::DataSet dataset = write_stacked_array(group, invariant_name, frame_index, 1, dimensions, H5::PredType::NATIVE_FLOAT, invariant_values->data(), created);
+        if (created) { attach_stacked_scales(group, group, dataset, {{"values", ""}}); }
+    }
+}
+
+void SpadeObject::write_stacked_field_bulk_data(const H5::Group &step_group, const string &group_name, const int &frame_index, field_bulk_type &field_bulk_data, const string &field_output_safe_name) {
+    Logging::Span span(*this->log_file, "write bulk block");
+    span.add("group", group_name);
+    span.add("elements", field_bulk_data.numberOfElements);
+    span.add("values", field_bulk_data.length);
+    if (span.active()) { span.add("bytes", static_cast<long long>(field_bulk_size(field_bulk_data))); }
+    H5::Group bulk_group;
+    bool new_group = !step_group.nameExists(group_name);
+    try {
+        bulk_group = (new_group) ? step_group.createGroup(group_name) : step_group.openGroup(group_name);
+    } catch(H5::Exception& e) {
+        this->log_file->logWarning("Unable to create or open group " + group_name + ". " + e.getDetailMsg());
+        return;
+    }
+
+    bool single_precision = (field_bulk_data.precision == "Single Precision");
+    const H5::PredType &value_type = (single_precision) ? H5::PredType::NATIVE_FLOAT : H5::PredType::NATIVE_DOUBLE;
+    auto buffer = [] (const auto &values) -> const void* { return (values.empty()) ? nullptr : values.data(); };  // write_stacked_array skips null buffers
+    const void* data_buffer = (single_precision) ? buffer(field_bulk_data.data) : buffer(field_bulk_data.dataDouble);
+    const void* conjugate_data_buffer = (single_precision) ? buffer(field_bulk_data.conjugateData) : buffer(field_bulk_data.conjugateDataDouble);
+    const void* coords_buffer = (single_precision) ? buffer(field_bulk_data.localCoordSystem) : buffer(field_bulk_data.localCoordSystemDouble);
+    string component_labels_name = "componentLabels";
+    string elements_name = "elements";
+    string position = field_bulk_data.position;
+
+    if (new_group) {  // Everything but the data stays the same from frame to frame, so it is written once
+        write_string_attribute(bulk_group, "position", position);
+        vector<string> component_labels = field_bulk_data.componentLabels;
+        if (component_labels.empty()) { component_labels.push_back(field_output_safe_name); }
+        write_string_vector_dataset(bulk_group, component_labels_name, component_labels);
+        try {
+            H5::DataSet dataset_label = bulk_group.openDataSet(component_labels_name);
+            H5DSset_scale(dataset_label.getId(), component_labels_name.c_str());
+        } catch(H5::Exception& e) {
+            this->log_file->logWarning("Error creating dimension scale " + component_labels_name + ". " + e.getDetailMsg());
+        }
+    }
+
+    if(field_bulk_data.numberOfElements && !field_bulk_data.elementLabels.empty()) { // If elements
+        int number_of_integration_points = field_bulk_data.length/field_bulk_data.numberOfElements;
+        if (new_group) {
+            if (!field_bulk_data.baseElementType.empty()) {
+                write_string_attribute(bulk_group, "baseElementType", field_bulk_data.baseElementType);
             }
-            string prefix = "/instances/";
-            if (instance_name.empty()) { instance_name = this->default_instance_name; prefix = "/assemblies/"; }
-            if ((this->command_line_arguments->get("instance") != "all") && (!this->instance_set.count(instance_name))) {
-                continue;
+            write_integer_dataset(bulk_group, "orientationWidth", field_bulk_data.orientationWidth);
+            write_string_attribute(bulk_group, "numberOfElements", to_string(field_bulk_data.numberOfElements));
+            if (field_bulk_data.valuesPerElement != 0) {
+                write_string_attribute(bulk_group, "valuesPerElement", to_string(field_bulk_data.valuesPerElement));
             }
 
-            string field_output_group_name = prefix + instance_name + "/FieldOutputs/" + field_output_safe_name + "/" + step_name + "/" + frame_number;
-            bool sub_group_exists = false;
-            H5::Group field_output_group = open_subgroup(h5_file, field_output_group_name, sub_group_exists);
-            if (instance_value_exists) {
-                write_field_values(h5_file, field_output_group_name, field_output_group, values_map[instance_name]);
-            }
-            write_string_attribute(h5_file, prefix + instance_name + "/FieldOutputs/" + field_output_safe_name, "name", field_output_name);
-
-            write_string_dataset(field_output_group, "description", field_output.description().CStr());
-            write_string_dataset(field_output_group, "type", get_field_type_enum(field_output.type()));
-            write_integer_dataset(field_output_group, "dim", field_output.dim());
-            write_integer_dataset(field_output_group, "dim2", field_output.dim2());
-            // TODO: Maybe reach out to 3DS to determine if they plan to implement isEngineeringTensor() function
-            // string isEngineeringTensor = (field_output.isEngineeringTensor()) ? "true" : "false";
-            // write_string_dataset(field_output_group, "isEngineeringTensor", isEngineeringTensor);
-
-            write_c_string_vector_dataset(field_output_group, "componentLabels", component_labels);
-            write_string_vector_dataset(field_output_group, "validInvariants", valid_invariants);
-
-            if (field_locations.size() > 0) {
-                this->log_file->logDebug("Write field location data");
-                H5::Group locations_group = create_group(h5_file, field_output_group_name + "/locations");
-                for (int j=0; j<field_locations.size(); j++) {
-                    odb_FieldLocation field_location = field_locations.constGet(j);
-                    string location_group_name = field_output_group_name + "/locations/" + to_string(j);
-                    H5::Group location_group = create_group(h5_file, location_group_name);
-
-                    string position = get_position_enum(field_location.position());
-                    write_string_dataset(location_group, "position", position);
-                    if (field_location.sectionPoint().size() > 0) {
-                        this->log_file->logDebug("Write section point data for location " + to_string(j));
-                        H5::Group section_points_group = create_group(h5_file, location_group_name + "/sectionPoint");
-                        for (int k=0; k<field_location.sectionPoint().size(); k++) {
-                            H5::Group section_point_group = create_group(h5_file, location_group_name + "/sectionPoint/" + to_string(field_location.sectionPoint(k).number()));
-                            write_string_dataset(section_point_group, "description", field_location.sectionPoint(k).description().CStr());
-                        }
-                    }
-                }
+            vector<int> first_elements = first_element_labels(field_bulk_data, number_of_integration_points);
+            vector<float> zeroes(number_of_integration_points, 0.0);
+            write_integer_vector_dataset(bulk_group, elements_name, first_elements);
+            write_float_vector_dataset(bulk_group, position, zeroes);
+            write_integer_2D_array(bulk_group, "elementLabels", field_bulk_data.numberOfElements, number_of_integration_points, field_bulk_data.elementLabels.data());
+            if (!field_bulk_data.integrationPoints.empty()) {
+                write_integer_2D_array(bulk_group, "integrationPoints", field_bulk_data.numberOfElements, number_of_integration_points, field_bulk_data.integrationPoints.data());
             }
-
-            // Get name of group where to write data
-            string position = get_position_enum(field_bulk_value.position());
-            string data_name;
-            string base_element_type = "";
-            base_element_type = field_bulk_value.baseElementType().CStr();
-            if (!base_element_type.empty()) {
-                data_name = field_bulk_value.baseElementType().CStr();
-            } else {
-                data_name = position;
+            if (!field_bulk_data.emptyFaces) {
+                hsize_t dimensions_faces[] = {field_bulk_data.numberOfElements, number_of_integration_points};
+                write_enum_dataset(bulk_group, "faces", this->face_enum_type, 2, dimensions_faces, field_bulk_data.faces.data());
             }
-            if (field_data_names.find(data_name) != field_data_names.end()) {  // If this name already exists, append the index to it
-                data_name = data_name + "_" + to_string(i);   // It would be nice to append the section point number to it, but I'm not sure how to do that reliably
+            try {
+                H5::DataSet dataset_element = bulk_group.openDataSet(elements_name);
+                H5DSset_scale(dataset_element.getId(), elements_name.c_str());
+                H5::DataSet dataset_position = bulk_group.openDataSet(position);
+                H5DSset_scale(dataset_position.getId(), position.c_str());
+            } catch(H5::Exception& e) {
+                this->log_file->logWarning("Error creating dimension scales " + elements_name + " and " + position + ". " + e.getDetailMsg());
             }
-            field_data_names.insert(data_name);
-
-            if (field_bulk_value.width() > field_output_max_width) {  field_output_max_width = field_bulk_value.width(); }
-            if (field_bulk_value.length() > field_output_max_length) {  field_output_max_length = field_bulk_value.length(); }
-
-            string value_group_name = field_output_group_name + "/" + data_name;
-            this->log_file->logDebug("Write field bulk data " + data_name);
-            write_extract_field_bulk_data(h5_file, value_group_name, field_bulk_value, field_output.isComplex(), write_mises, field_output_safe_name);
         }
 
-        if (field_output_max_width > max_width) {  max_width = field_output_max_width; }
-        if (field_output_max_length > max_length) {  max_length = field_output_max_length; }
+        vector<pair<string, string>> data_scales = {{elements_name, elements_name}, {position, position}, {component_labels_name, component_labels_name}};
+        vector<pair<string, string>> point_scales = {{elements_name, elements_name}, {position, position}};
+        hsize_t dimensions[] = {field_bulk_data.numberOfElements, number_of_integration_points, field_bulk_data.width};
+        hsize_t dimensions_coords[] = {field_bulk_data.numberOfElements, number_of_integration_points, field_bulk_data.orientationWidth};
+        bool created = false;
+        H5::DataSet dataset = write_stacked_array(bulk_group, "data", frame_index, 3, dimensions, value_type, data_buffer, created);
+        if (created) { attach_stacked_scales(step_group, bulk_group, dataset, data_scales); }
+        dataset = write_stacked_array(bulk_group, "conjugateData", frame_index, 3, dimensions, value_type, conjugate_data_buffer, created);
+        if (created) { attach_stacked_scales(step_group, bulk_group, dataset, data_scales); }
+        dataset = write_stacked_array(bulk_group, "localCoordSystem", frame_index, 3, dimensions_coords, value_type, coords_buffer, created);
+        if (created) { attach_stacked_scales(step_group, bulk_group, dataset, data_scales); }
+        dataset = write_stacked_array(bulk_group, "mises", frame_index, 2, dimensions, H5::PredType::NATIVE_FLOAT, buffer(field_bulk_data.mises), created);
+        if (created) { attach_stacked_scales(step_group, bulk_group, dataset, point_scales); }
+        for (const auto& [invariant_name, invariant_values] : field_bulk_data.invariants) {
+            dataset = write_stacked_array(bulk_group, invariant_name, frame_index, 2, dimensions, H5::PredType::NATIVE_FLOAT, buffer(invariant_values), created);
+            if (created) { attach_stacked_scales(step_group, bulk_group, dataset, point_scales); }
+        }
 
-        // If there is an instance with field output data (not bulk data) that didn't get written, then write it here
-        for (const string& instance_name : instance_names) {
-            if ((this->command_line_arguments->get("instance") != "all") && (!this->instance_set.count(instance_name))) {
-                continue;
-            }
-            string prefix = "/instances/";
-            if (instance_name == this->default_instance_name) {
-                prefix = "/assemblies/";
-            }
-            string field_output_group_name = prefix + instance_name + "/FieldOutputs/" + field_output_safe_name + "/" + step_name + "/" + frame_number;
-            bool sub_group_exists = false;
-            H5::Group field_output_group = open_subgroup(h5_file, field_output_group_name, sub_group_exists);
-            write_field_values(h5_file, field_output_group_name, field_output_group, values_map[instance_name]);
-            write_string_attribute(h5_file, prefix + instance_name + "/FieldOutputs/" + field_output_safe_name, "name", field_output_name);
-
-            write_string_dataset(field_output_group, "description", field_output.description().CStr());
-            write_string_dataset(field_output_group, "type", get_field_type_enum(field_output.type()));
-            write_integer_dataset(field_output_group, "dim", field_output.dim());
-            write_integer_dataset(field_output_group, "dim2", field_output.dim2());
-            // TODO: Maybe reach out to 3DS to determine if they plan to implement isEngineeringTensor() function
-            // string isEngineeringTensor = (field_output.isEngineeringTensor()) ? "true" : "false";
-            // write_string_dataset(field_output_group, "isEngineeringTensor", isEngineeringTensor);
-
-            write_c_string_vector_dataset(field_output_group, "componentLabels", component_labels);
-            write_string_vector_dataset(field_output_group, "validInvariants", valid_invariants);
-
-            if (field_locations.size() > 0) {
-                H5::Group locations_group = create_group(h5_file, field_output_group_name + "/locations");
-                for (int i=0; i<field_locations.size(); i++) {
-                    odb_FieldLocation field_location = field_locations.constGet(i);
-                    string location_group_name = field_output_group_name + "/locations/" + to_string(i);
-                    H5::Group location_group = create_group(h5_file, location_group_name);
-
-                    string position = get_position_enum(field_location.position());
-                    write_string_dataset(location_group, "position", position);
-                    if (field_location.sectionPoint().size() > 0) {
-                        H5::Group section_points_group = create_group(h5_file, location_group_name + "/sectionPoint");
-                        for (int j=0; j<field_location.sectionPoint().size(); j++) {
-                            H5::Group section_point_group = create_group(h5_file, location_group_name + "/sectionPoint/" + to_string(field_location.sectionPoint(j).number()));
-                            write_string_dataset(section_point_group, "description", field_location.sectionPoint(j).description().CStr());
-                        }
-                    }
-                }
+    } else {  // Nodes
+        string labels_name = "nodeLabels";
+        if (new_group) {
+            write_integer_vector_dataset(bulk_group, labels_name, field_bulk_data.nodeLabels);
+            try {
+                H5::DataSet dataset_node_labels = bulk_group.openDataSet(labels_name);
+                H5DSset_scale(dataset_node_labels.getId(), labels_name.c_str());
+            } catch(H5::Exception& e) {
+                this->log_file->logWarning("Error creating dimension scale " + labels_name + ". " + e.getDetailMsg());
             }
         }
+
+        vector<pair<string, string>> data_scales = {{"nodes", labels_name}, {component_labels_name, component_labels_name}};
+        hsize_t dimensions[] = {field_bulk_data.length, field_bulk_data.width};
+        bool created = false;
+        H5::DataSet dataset = write_stacked_array(bulk_group, "data", frame_index, 2, dimensions, value_type, data_buffer, created);
+        if (created) { attach_stacked_scales(step_group, bulk_group, dataset, data_scales); }
+        dataset = write_stacked_array(bulk_group, "conjugateData", frame_index, 2, dimensions, value_type, conjugate_data_buffer, created);
+        if (created) { attach_stacked_scales(step_group, bulk_group, dataset, data_scales); }
+        vector<pair<string, string>> node_scales = {{"nodes", labels_name}};
+        for (const auto& [invariant_name, invariant_values] : field_bulk_data.invariants) {
+            dataset = write_stacked_array(bulk_group, invariant_name, frame_index, 1, dimensions, H5::PredType::NATIVE_FLOAT, buffer(invariant_values), created);
+            if (created) { attach_stacked_scales(step_group, bulk_group, dataset, node_scales); }
+        }
     }
 }
 
+vector<int> SpadeObject::first_element_labels(const field_bulk_type &field_bulk_data, const int &number_of_integration_points) {
+    vector<int> first_elements(field_bulk_data.numberOfElements);
+    const int* element_labels = field_bulk_data.elementLabels.data();
+    for (size_t i=0; i<first_elements.size(); i++) { first_elements[i] = element_labels[i * number_of_integration_points]; }
+    return first_elements;
+}
+
 void SpadeObject::write_frame(H5::H5File &h5_file, H5::Group &frame_group, frame_type &frame) {
     if (frame.cyclicModeNumber != -1) { write_integer_dataset(frame_group, "cyclicModeNumber", frame.cyclicModeNumber); }
     write_integer_dataset(frame_group, "mode", frame.mode);
@@ -2864,7 +3840,7 @@ void SpadeObject::write_history_point(H5::H5File &h5_file, const string &group_n
             H5::Group node_group = create_group(h5_file, node_group_name);
             write_float_array_dataset(node_group, to_string(history_point.node_label), 3, history_point.node_coordinates);
         }
-        write_set(h5_file, history_point_group_name, history_point.region, nullopt, nullopt);
+        write_set(h5_file, history_point_group_name, history_point.region, nullptr, nullptr);
         H5::Group section_point_group = create_group(h5_file, history_point_group_name + "/sectionPoint");
         write_string_dataset(section_point_group, "number", history_point.sectionPoint.number);
         write_string_dataset(section_point_group, "description", history_point.sectionPoint.description);
@@ -2887,7 +3863,8 @@ void SpadeObject::write_history_point(H5::H5File &h5_file, const string &group_n
             write_string_attribute(set_group, "type", history_point.region.type);
             write_string_vector_dataset(set_group, "instanceNames", history_point.region.instanceNames);
             if (!history_point.region.faces.empty()) {
-                write_string_vector_dataset(set_group, "faces", history_point.region.faces);
+                hsize_t dimensions_faces[] = {history_point.region.faces.size()};
+                write_enum_dataset(set_group, "faces", this->face_enum_type, 1, dimensions_faces, history_point.region.faces.data());
             }
         }
         if (history_point.sectionPoint.number != "-1") {
@@ -2898,124 +3875,111 @@ void SpadeObject::write_history_point(H5::H5File &h5_file, const string &group_n
 
 }
 
-void SpadeObject::write_history_output(H5::H5File &h5_file, const string &group_name, const odb_HistoryOutput &history_output) {
+#ifndef SPADE_WITHOUT_ABAQUS
+void SpadeObject::write_history_output(H5::H5File &h5_file, const string &group_name, const odb_HistoryOutput &history_output, int &samples) {
+    Logging::Span span(*this->log_file, "history output");
+    span.add("history output", group_name);
     // Per Abaqus documentation the conjugate data specifies the imaginary portion of a specified complex variable at each
     // frame value (time, frequency, or mode). Therefore it seems that data and conjugate data can be present at the same time
     // So a group has to be created to handle two possible datasets, despite there usually being only one
     H5::Group history_output_group = create_group(h5_file, group_name);
 
-    write_string_dataset(history_output_group, "description", history_output.description().CStr());
-    write_string_attribute(history_output_group, "name", history_output.name().CStr());
-    string history_output_type_name;
-    switch(history_output.type()) {
-        case odb_Enum::SCALAR: history_output_type_name = "Scalar"; break;
+    if (samples == 0) {
+        write_string_dataset(history_output_group, "description", history_output.description().CStr());
+        write_string_attribute(history_output_group, "name", history_output.name().CStr());
+        string history_output_type_name;
+        switch(history_output.type()) {
+            case odb_Enum::SCALAR: history_output_type_name = "Scalar"; break;
+        }
+        write_string_dataset(history_output_group, "type", history_output_type_name);
     }
-    write_string_dataset(history_output_group, "type", history_output_type_name);
+    // Appended files need extendible datasets, so the samples written to the odb later can be added to them
+    bool append = this->command_line_arguments->append();
 
     vector<float> output_data;
     const odb_SequenceSequenceFloat& data = history_output.data();
-    int row_size = data.size();
-    for (int i=0; i<data.size(); i++) {
+    int row_size = std::max(0, data.size() - samples);
+    for (int i=samples; i<data.size(); i++) {
         odb_SequenceFloat data_dimension1 = data.constGet(i);
         for (int j=0; j<data_dimension1.size(); j++) {
             output_data.push_back(data_dimension1.constGet(j));
         }
     }
     this->log_file->logDebug("Writing " + to_string(row_size) + " rows of history output for " + history_output.name().CStr());
-    write_float_2D_data(history_output_group, "data", row_size, 2, output_data);  // history output data has 2 columns: frameValue and value
+    if (append) {
+        append_rows(history_output_group, "data", row_size, 2, H5::PredType::NATIVE_FLOAT, H5::PredType::NATIVE_FLOAT, output_data.data());
+    } else {
+        write_float_2D_data(history_output_group, "data", row_size, 2, output_data);  // history output data has 2 columns: frameValue and value
+    }
 
     vector<float> output_conjugate_data;
     const odb_SequenceSequenceFloat& conjugate_data = history_output.conjugateData();
-    int row_size_conjugate = conjugate_data.size();
-    for (int i=0; i<conjugate_data.size(); i++) {
+    int row_size_conjugate = std::max(0, conjugate_data.size() - samples);
+    for (int i=samples; i<conjugate_data.size(); i++) {
         odb_SequenceFloat conjugate_data_dimension1 = conjugate_data.constGet(i);
         for (int j=0; j<conjugate_data_dimension1.size(); j++) {
             output_conjugate_data.push_back(conjugate_data_dimension1.constGet(j));
         }
     }
     this->log_file->logDebug("Writing " + to_string(row_size_conjugate) + " rows of history output conjugate data for " + history_output.name().CStr());
-    write_float_2D_data(history_output_group, "conjugateData", row_size_conjugate, 2, output_conjugate_data);
+    if (append) {
+        append_rows(history_output_group, "conjugateData", row_size_conjugate, 2, H5::PredType::NATIVE_FLOAT, H5::PredType::NATIVE_FLOAT, output_conjugate_data.data());
+    } else {
+        write_float_2D_data(history_output_group, "conjugateData", row_size_conjugate, 2, output_conjugate_data);
+    }
+    samples = std::max(samples, data.size());
 }
 
-void SpadeObject::write_extract_history_output(H5::H5File &h5_file, const string &group_name, const odb_HistoryOutputRepository &history_outputs) {
+void SpadeObject::write_extract_history_output(H5::H5File &h5_file, const string &group_name, const odb_HistoryOutputRepository &history_outputs, int &samples, int &conjugate_samples) {
+    Logging::Span span(*this->log_file, "history output");
+    span.add("history region", group_name);
+    history_matrix_type history_matrix = read_history_matrix(history_outputs);
     vector<const char*> names;
     vector<const char*> types;
     vector<const char*> descriptions;
-    vector<float> frame_data;
-    vector<float> conjugate_frame_data;
-    vector<float> all_output_data;
-    vector<float> all_conjugate_data;
-    bool frame_data_written = false;
-    bool conjugate_frame_data_written = false;
-    bool conjugate_data_exists = false;
-    odb_HistoryOutputRepositoryIT history_outputs_iterator (history_outputs);
+    for (size_t i=0; i<history_matrix.names.size(); i++) {
+        names.push_back(history_matrix.names[i].c_str());
+        types.push_back(history_matrix.types[i].c_str());
+        descriptions.push_back(history_matrix.descriptions[i].c_str());
+    }
+    const vector<float> &frame_data = history_matrix.frame_values;
+    const vector<float> &conjugate_frame_data = history_matrix.conjugate_frame_values;
+    const vector<float> &all_output_data = history_matrix.data;
+    const vector<float> &all_conjugate_data = history_matrix.conjugate_data;
+    bool conjugate_data_exists = !all_conjugate_data.empty();
+    hsize_t rows = names.size();
+    hsize_t columns = frame_data.size();
 
-    int rows;
-    if (this->command_line_arguments->get("history") == "all") {
-        rows = history_outputs.size();
-    } else {
-        rows = this->history_set.size();
-    }
-    bool first_output = true;
-    int columns;
-    for (history_outputs_iterator.first(); !history_outputs_iterator.isDone(); history_outputs_iterator.next()) {
-        odb_HistoryOutput history_output = history_outputs_iterator.currentValue();
-        if (first_output) {
-            columns = history_output.data().size();
-            all_output_data.reserve(rows * columns);
-            all_conjugate_data.reserve(rows * columns);
-        }
-        first_output = false;
-        string history_output_name = history_output.name().CStr();
-        this->log_file->logVerbose("Processing data for history output " + history_output_name);
-        if ((this->command_line_arguments->get("history") == "all") || (this->history_set.count(history_output_name))) {
-            names.push_back(history_output.name().CStr());
-            descriptions.push_back(history_output.description().CStr());
-            string history_output_type_name = "";
-            switch(history_output.type()) {
-                case odb_Enum::SCALAR: history_output_type_name = "Scalar"; break;
-            }
-            types.push_back(history_output_type_name.c_str());
-
-            vector<float> output_data;
-            const odb_SequenceSequenceFloat& data = history_output.data();
-            if (!frame_data_written) {
-                for (int i=0; i<data.size(); i++) {
-                    odb_SequenceFloat data_dimension1 = data.constGet(i);
-                    frame_data.push_back(data_dimension1.constGet(0));
-                    output_data.push_back(data_dimension1.constGet(1));
-                }
-            } else {
-                for (int i=0; i<data.size(); i++) {
-                    odb_SequenceFloat data_dimension1 = data.constGet(i);
-                    output_data.push_back(data_dimension1.constGet(1));
-                }
+    H5::Group group = create_group(h5_file, group_name);
+    // Appended files need extendible datasets, so the samples written to the odb later can be added to them
+    bool append = this->command_line_arguments->append();
+    if (samples > 0) {  // The group was written by an earlier extraction, so only the new frame values are added
+        if (names.empty()) { return; }
+        if (columns > samples) {
+            int new_columns = columns - samples;
+            vector<float> new_output_data(rows * new_columns, NAN);
+            for (int i=0; i<names.size(); i++) {
+                std::copy_n(all_output_data.begin() + i * columns + samples, new_columns, new_output_data.begin() + i * new_columns);
             }
-            all_output_data.insert(all_output_data.end(), output_data.begin(), output_data.end());
-            frame_data_written = true;
-            vector<float> output_conjugate_data;
-            const odb_SequenceSequenceFloat& conjugate_data = history_output.conjugateData();
-            if (conjugate_data.size() != 0) {
-                conjugate_data_exists = true;
-                if (!conjugate_frame_data_written) {
-                    for (int i=0; i<conjugate_data.size(); i++) {
-                        odb_SequenceFloat conjugate_data_dimension1 = conjugate_data.constGet(i);
-                        conjugate_frame_data.push_back(conjugate_data_dimension1.constGet(0));
-                        output_conjugate_data.push_back(conjugate_data_dimension1.constGet(1));
-                    }
-                } else {
-                    for (int i=0; i<conjugate_data.size(); i++) {
-                        odb_SequenceFloat conjugate_data_dimension1 = conjugate_data.constGet(i);
-                        output_conjugate_data.push_back(conjugate_data_dimension1.constGet(1));
-                    }
-                }
-                all_conjugate_data.insert(all_conjugate_data.end(), output_conjugate_data.begin(), output_conjugate_data.end());
-                conjugate_frame_data_written = true;
+            this->log_file->logDebug("Appending " + to_string(new_columns) + " frame values of history output data.");
+            append_columns(group, "data", rows, new_columns, H5::PredType::NATIVE_FLOAT, H5::PredType::NATIVE_FLOAT, new_output_data.data());
+            append_rows(group, "frame_values", new_columns, 0, H5::PredType::NATIVE_FLOAT, H5::PredType::NATIVE_FLOAT, frame_data.data() + samples);
+            samples = columns;
+        }
+        int conjugate_columns = conjugate_frame_data.size();  // The conjugate data has a time axis of its own
+        if ((conjugate_data_exists) && (conjugate_columns > conjugate_samples)) {
+            int new_conjugate_columns = conjugate_columns - conjugate_samples;
+            vector<float> new_conjugate_data(rows * new_conjugate_columns, NAN);
+            for (int i=0; i<names.size(); i++) {
+                std::copy_n(all_conjugate_data.begin() + i * conjugate_columns + conjugate_samples, new_conjugate_columns, new_conjugate_data.begin() + i * new_conjugate_columns);
             }
+            this->log_file->logDebug("Appending " + to_string(new_conjugate_columns) + " conjugate frame values of history output data.");
+            append_columns(group, "conjugate_data", rows, new_conjugate_columns, H5::PredType::NATIVE_FLOAT, H5::PredType::NATIVE_FLOAT, new_conjugate_data.data());
+            append_rows(group, "conjugateFrameValues", new_conjugate_columns, 0, H5::PredType::NATIVE_FLOAT, H5::PredType::NATIVE_FLOAT, conjugate_frame_data.data() + conjugate_samples);
+            conjugate_samples = conjugate_columns;
         }
+        return;
     }
-
-    H5::Group group = create_group(h5_file, group_name);
     string coordinate_labels;
     string string_names = "names";
     string string_descriptions = "descriptions";
@@ -3029,8 +3993,13 @@ void SpadeObject::write_extract_history_output(H5::H5File &h5_file, const string
     H5::DataType datatype_data(H5::PredType::NATIVE_FLOAT);
     H5::DataSet dataset_data;
     try {
-        dataset_data = group.createDataSet(string_data, datatype_data, dataspace_data);
-        dataset_data.write(all_output_data.data(), datatype_data);
+        if (append) {
+            append_columns(group, string_data, rows, columns, H5::PredType::NATIVE_FLOAT, H5::PredType::NATIVE_FLOAT, all_output_data.data());
+            dataset_data = group.openDataSet(string_data);
+        } else {
+            dataset_data = group.createDataSet(string_data, datatype_data, dataspace_data, dataset_properties(2, dims, sizeof(float), false));
+            dataset_data.write(all_output_data.data(), datatype_data);
+        }
         H5DSset_label(dataset_data.getId(), 0, string_names.c_str());
         H5DSset_label(dataset_data.getId(), 1, string_frame_values.c_str());
     } catch(H5::Exception& e) {
@@ -3044,8 +4013,13 @@ void SpadeObject::write_extract_history_output(H5::H5File &h5_file, const string
     H5::DataType datatype_frame_data(H5::PredType::NATIVE_FLOAT);
     H5::DataSet dataset_frame_data;
     try {
-        dataset_frame_data = group.createDataSet(string_frame_values, datatype_frame_data, dataspace_frame_data);
-        dataset_frame_data.write(frame_data.data(), datatype_frame_data);
+        if (append) {
+            append_rows(group, string_frame_values, frame_data.size(), 0, H5::PredType::NATIVE_FLOAT, H5::PredType::NATIVE_FLOAT, frame_data.data());
+            dataset_frame_data = group.openDataSet(string_frame_values);
+        } else {
+            dataset_frame_data = group.createDataSet(string_frame_values, datatype_frame_data, dataspace_frame_data, dataset_properties(1, frame_data_dimensions, sizeof(float), false));
+            dataset_frame_data.write(frame_data.data(), datatype_frame_data);
+        }
         // Associate the coordinate datasets with the main dataset using dimension scales
         H5DSset_scale(dataset_frame_data.getId(), string_frame_values.c_str());
         H5DSattach_scale(dataset_data.getId(), dataset_frame_data.getId(), 1);
@@ -3057,14 +4031,19 @@ void SpadeObject::write_extract_history_output(H5::H5File &h5_file, const string
     dataset_frame_data.close();
 
     H5::DataSet dataset_conjugate_data;
-    hsize_t conjugate_dims[2] = {rows, columns};
+    hsize_t conjugate_dims[2] = {rows, conjugate_frame_data.size()};
     H5::DataSpace dataspace_conjugate_data(2, conjugate_dims);
     if (conjugate_data_exists) {
 
         H5::DataType datatype_conjugate_data(H5::PredType::NATIVE_FLOAT);
         try {
-            dataset_conjugate_data = group.createDataSet(string_conjugate_data, datatype_conjugate_data, dataspace_conjugate_data);
-            dataset_conjugate_data.write(all_conjugate_data.data(), datatype_conjugate_data);
+            if (append) {
+                append_columns(group, string_conjugate_data, rows, conjugate_frame_data.size(), H5::PredType::NATIVE_FLOAT, H5::PredType::NATIVE_FLOAT, all_conjugate_data.data());
+                dataset_conjugate_data = group.openDataSet(string_conjugate_data);
+            } else {
+                dataset_conjugate_data = group.createDataSet(string_conjugate_data, datatype_conjugate_data, dataspace_conjugate_data, dataset_properties(2, conjugate_dims, sizeof(float), false));
+                dataset_conjugate_data.write(all_conjugate_data.data(), datatype_conjugate_data);
+            }
             H5DSset_label(dataset_conjugate_data.getId(), 0, string_names.c_str());
             H5DSset_label(dataset_conjugate_data.getId(), 1, string_conjugate_data.c_str());
         } catch(H5::Exception& e) {
@@ -3078,11 +4057,16 @@ void SpadeObject::write_extract_history_output(H5::H5File &h5_file, const string
         H5::DataType datatype_conjugate_frame_data(H5::PredType::NATIVE_FLOAT);
         H5::DataSet dataset_conjugate_frame_data;
         try {
-            dataset_conjugate_frame_data = group.createDataSet("conjugateFrameValues", datatype_conjugate_frame_data, dataspace_conjugate_frame_data);
-            dataset_conjugate_frame_data.write(conjugate_frame_data.data(), datatype_conjugate_frame_data);
+            if (append) {
+                append_rows(group, "conjugateFrameValues", conjugate_frame_data.size(), 0, H5::PredType::NATIVE_FLOAT, H5::PredType::NATIVE_FLOAT, conjugate_frame_data.data());
+                dataset_conjugate_frame_data = group.openDataSet("conjugateFrameValues");
+            } else {
+                dataset_conjugate_frame_data = group.createDataSet("conjugateFrameValues", datatype_conjugate_frame_data, dataspace_conjugate_frame_data, dataset_properties(1, conjugate_frame_data_dimensions, sizeof(float), false));
+                dataset_conjugate_frame_data.write(conjugate_frame_data.data(), datatype_conjugate_frame_data);
+            }
             // Associate the coordinate datasets with the main dataset using dimension scales
             H5DSset_scale(dataset_conjugate_frame_data.getId(), string_conjugate_data.c_str());
-            H5DSattach_scale(dataset_data.getId(), dataset_conjugate_frame_data.getId(), 1);
+            H5DSattach_scale(dataset_conjugate_data.getId(), dataset_conjugate_frame_data.getId(), 1);
         } catch(H5::Exception& e) {
             this->log_file->logWarning("Error creating dataset conjugateFrameValues. " + e.getDetailMsg());
         }
@@ -3172,7 +4156,10 @@ void SpadeObject::write_extract_history_output(H5::H5File &h5_file, const string
 
     dataset_conjugate_data.close();
     dataspace_conjugate_data.close();
+    samples = columns;
+    conjugate_samples = conjugate_frame_data.size();
 }
+#endif
 
 void SpadeObject::write_history_region(H5::H5File &h5_file, const string &group_name, history_region_type &history_region) {
     H5::Group history_region_group = create_group(h5_file, group_name);
@@ -3203,25 +4190,25 @@ void SpadeObject::write_step(H5::H5File &h5_file, H5::Group &step_group, step_ty
 void SpadeObject::write_instances(H5::H5File &h5_file, const string &group_name) {
     string instances_group_name = group_name + "/instances";
     H5::Group instances_group = create_group(h5_file, instances_group_name);
-    for (auto instance : this->root_assembly.instances) {
+    for (const auto& instance : this->root_assembly.instances) {
         string instance_group_name = instances_group_name + "/" + replace_slashes(instance.name);
         H5::Group instance_group = create_group(h5_file, instance_group_name);
         write_string_attribute(instance_group, "name", instance.name);
-        this->log_file->logDebug("\t\tWriting instance: " + instance.name + " at time: " + this->command_line_arguments->getTimeStamp(true));
+        this->log_file->logDebug([&] { return "\t\tWriting instance: " + instance.name + " at time: " + this->command_line_arguments->getTimeStamp(true); });
         write_instance(h5_file, instance_group, instance_group_name, instance);
     }
 }
 
-void SpadeObject::write_instance(H5::H5File &h5_file, H5::Group &group, const string &group_name, instance_type instance) {
+void SpadeObject::write_instance(H5::H5File &h5_file, H5::Group &group, const string &group_name, const instance_type &instance) {
     write_string_dataset(group, "embeddedSpace", instance.embeddedSpace);
     if (this->command_line_arguments->get("format") == "odb") {
-        this->log_file->logDebug("\t\tWriting nodes in instance: " + instance.name + " at time: " + this->command_line_arguments->getTimeStamp(true));
+        this->log_file->logDebug([&] { return "\t\tWriting nodes in instance: " + instance.name + " at time: " + this->command_line_arguments->getTimeStamp(true); });
         write_nodes(h5_file, group, group_name, instance.nodes, "");
-        this->log_file->logDebug("\t\tWriting elements in instance: " + instance.name + " at time: " + this->command_line_arguments->getTimeStamp(true));
+        this->log_file->logDebug([&] { return "\t\tWriting elements in instance: " + instance.name + " at time: " + this->command_line_arguments->getTimeStamp(true); });
         write_elements(h5_file, group, group_name, instance.elements);
-        this->log_file->logDebug("\t\tWriting node sets in instance: " + instance.name + " at time: " + this->command_line_arguments->getTimeStamp(true));
+        this->log_file->logDebug([&] { return "\t\tWriting node sets in instance: " + instance.name + " at time: " + this->command_line_arguments->getTimeStamp(true); });
         write_sets(h5_file, group_name + "/nodeSets", instance.nodeSets, this->instance_mesh[instance.name].element_sets, this->instance_mesh[instance.name].node_sets);
-        this->log_file->logDebug("\t\tWriting element sets in instance: " + instance.name + " at time: " + this->command_line_arguments->getTimeStamp(true));
+        this->log_file->logDebug([&] { return "\t\tWriting element sets in instance: " + instance.name + " at time: " + this->command_line_arguments->getTimeStamp(true); });
         write_sets(h5_file, group_name + "/elementSets", instance.elementSets, this->instance_mesh[instance.name].element_sets, this->instance_mesh[instance.name].node_sets);
     }
     write_sets(h5_file, group_name + "/surfaces", instance.surfaces, this->instance_mesh[instance.name].element_sets, this->instance_mesh[instance.name].node_sets);
@@ -3230,7 +4217,7 @@ void SpadeObject::write_instance(H5::H5File &h5_file, H5::Group &group, const st
         for (int i=0; i<instance.sectionAssignments.size(); i++) {
             string section_assignment_group_name = group_name + "/sectionAssignments/" + instance.sectionAssignments[i].sectionName;
             H5::Group section_assignment_group = create_group(h5_file, section_assignment_group_name);
-            write_set(h5_file, section_assignment_group_name, instance.sectionAssignments[i].region, nullopt, nullopt);
+            write_set(h5_file, section_assignment_group_name, instance.sectionAssignments[i].region, nullptr, nullptr);
         }
     }
     if (instance.rigidBodies.size() > 0) {
@@ -3240,10 +4227,10 @@ void SpadeObject::write_instance(H5::H5File &h5_file, H5::Group &group, const st
             H5::Group rigid_body_group = create_group(h5_file, rigid_body_group_name);
             write_string_dataset(rigid_body_group, "position", instance.rigidBodies[i].position);
             write_string_dataset(rigid_body_group, "isothermal", instance.rigidBodies[i].isothermal);
-            write_set(h5_file, rigid_body_group_name, instance.rigidBodies[i].referenceNode, nullopt, nullopt);
-            write_set(h5_file, rigid_body_group_name, instance.rigidBodies[i].elements, nullopt, nullopt);
-            write_set(h5_file, rigid_body_group_name, instance.rigidBodies[i].tieNodes, nullopt, nullopt);
-            write_set(h5_file, rigid_body_group_name, instance.rigidBodies[i].pinNodes, nullopt, nullopt);
+            write_set(h5_file, rigid_body_group_name, instance.rigidBodies[i].referenceNode, nullptr, nullptr);
+            write_set(h5_file, rigid_body_group_name, instance.rigidBodies[i].elements, nullptr, nullptr);
+            write_set(h5_file, rigid_body_group_name, instance.rigidBodies[i].tieNodes, nullptr, nullptr);
+            write_set(h5_file, rigid_body_group_name, instance.rigidBodies[i].pinNodes, nullptr, nullptr);
             write_analytic_surface(h5_file, rigid_body_group_name, instance.rigidBodies[i].analyticSurface);
         }
     }
@@ -3252,7 +4239,7 @@ void SpadeObject::write_instance(H5::H5File &h5_file, H5::Group &group, const st
         for (int i=0; i<instance.beamOrientations.size(); i++) {
             string beam_orientation_group_name = group_name + "/beamOrientations/" + to_string(i);
             H5::Group beam_orientation_group = create_group(h5_file, beam_orientation_group_name);
-            write_set(h5_file, beam_orientation_group_name, instance.beamOrientations[i].region, nullopt, nullopt);
+            write_set(h5_file, beam_orientation_group_name, instance.beamOrientations[i].region, nullptr, nullptr);
             write_string_dataset(beam_orientation_group, "method", instance.beamOrientations[i].method);
             write_float_vector_dataset(beam_orientation_group, "vector", instance.beamOrientations[i].beam_vector);
         }
@@ -3264,15 +4251,15 @@ void SpadeObject::write_instance(H5::H5File &h5_file, H5::Group &group, const st
             H5::Group rebar_orientation_group = create_group(h5_file, rebar_orientation_group_name);
             write_string_dataset(rebar_orientation_group, "axis", instance.rebarOrientations[i].axis);
             write_float_dataset(rebar_orientation_group, "angle", instance.rebarOrientations[i].angle);
-            write_set(h5_file, rebar_orientation_group_name, instance.rebarOrientations[i].region, nullopt, nullopt);
+            write_set(h5_file, rebar_orientation_group_name, instance.rebarOrientations[i].region, nullptr, nullptr);
             write_datum_csys(h5_file, rebar_orientation_group_name, instance.rebarOrientations[i].csys);
         }
     }
     write_analytic_surface(h5_file, group_name, instance.analyticSurface);
 }
 
-void SpadeObject::write_analytic_surface(H5::H5File &h5_file, const string &group_name, analytic_surface_type &analytic_surface) {
-    this->log_file->logDebug("\t\tCalled write_analytic_surface at time: " + this->command_line_arguments->getTimeStamp(true));
+void SpadeObject::write_analytic_surface(H5::H5File &h5_file, const string &group_name, const analytic_surface_type &analytic_surface) {
+    this->log_file->logDebug([&] { return "\t\tCalled write_analytic_surface at time: " + this->command_line_arguments->getTimeStamp(true); });
     if ((analytic_surface.name.empty()) && (analytic_surface.type.empty()) && (!analytic_surface.filletRadius) && (analytic_surface.segments.size() == 0) && (analytic_surface.localCoordData.size() == 0)) { return; }
     string analytic_surface_group_name = group_name + "/analyticSurface";
     H5::Group surface_group = create_group(h5_file, analytic_surface_group_name);
@@ -3308,8 +4295,8 @@ void SpadeObject::write_constraints(H5::H5File &h5_file, const string &group_nam
         for (int i=0; i<this->constraints.ties.size(); i++) {
             string tie_group_name = group_name + "/tie/" + to_string(i);
             H5::Group tie_group = create_group(h5_file, tie_group_name);
-            write_set(h5_file, tie_group_name, this->constraints.ties[i].main, nullopt, nullopt);
-            write_set(h5_file, tie_group_name, this->constraints.ties[i].secondary, nullopt, nullopt);
+            write_set(h5_file, tie_group_name, this->constraints.ties[i].main, nullptr, nullptr);
+            write_set(h5_file, tie_group_name, this->constraints.ties[i].secondary, nullptr, nullptr);
             write_string_dataset(tie_group, "adjust", this->constraints.ties[i].adjust);
             write_string_dataset(tie_group, "tieRotations", this->constraints.ties[i].tieRotations);
             write_string_dataset(tie_group, "positionToleranceMethod", this->constraints.ties[i].positionToleranceMethod);
@@ -3339,9 +4326,9 @@ void SpadeObject::write_constraints(H5::H5File &h5_file, const string &group_nam
         for (int i=0; i<this->constraints.couplings.size(); i++) {
             string coupling_group_name = group_name + "/coupling/" + to_string(i);
             H5::Group coupling_group = create_group(h5_file, coupling_group_name);
-            write_set(h5_file, coupling_group_name, this->constraints.couplings[i].surface, nullopt, nullopt);
-            write_set(h5_file, coupling_group_name, this->constraints.couplings[i].refPoint, nullopt, nullopt);
-            write_set(h5_file, coupling_group_name, this->constraints.couplings[i].nodes, nullopt, nullopt);
+            write_set(h5_file, coupling_group_name, this->constraints.couplings[i].surface, nullptr, nullptr);
+            write_set(h5_file, coupling_group_name, this->constraints.couplings[i].refPoint, nullptr, nullptr);
+            write_set(h5_file, coupling_group_name, this->constraints.couplings[i].nodes, nullptr, nullptr);
             write_string_dataset(coupling_group, "couplingType", this->constraints.couplings[i].couplingType);
             write_string_dataset(coupling_group, "weightingMethod", this->constraints.couplings[i].weightingMethod);
             write_string_dataset(coupling_group, "influenceRadius", this->constraints.couplings[i].influenceRadius);
@@ -3358,8 +4345,8 @@ void SpadeObject::write_constraints(H5::H5File &h5_file, const string &group_nam
         for (int i=0; i<this->constraints.mpc.size(); i++) {
             string mpc_group_name = group_name + "/mpc/" + to_string(i);
             H5::Group mpc_group = create_group(h5_file, mpc_group_name);
-            write_set(h5_file, mpc_group_name, this->constraints.mpc[i].surface, nullopt, nullopt);
-            write_set(h5_file, mpc_group_name, this->constraints.mpc[i].refPoint, nullopt, nullopt);
+            write_set(h5_file, mpc_group_name, this->constraints.mpc[i].surface, nullptr, nullptr);
+            write_set(h5_file, mpc_group_name, this->constraints.mpc[i].refPoint, nullptr, nullptr);
             write_string_dataset(mpc_group, "mpcType", this->constraints.mpc[i].mpcType);
             write_string_dataset(mpc_group, "userMode", this->constraints.mpc[i].userMode);
             write_string_dataset(mpc_group, "userType", this->constraints.mpc[i].userType);
@@ -3370,8 +4357,8 @@ void SpadeObject::write_constraints(H5::H5File &h5_file, const string &group_nam
         for (int i=0; i<this->constraints.shell_solid_couplings.size(); i++) {
             string shell_solid_coupling_group_name = group_name + "/shellSolidCoupling/" + to_string(i);
             H5::Group shell_solid_coupling_group = create_group(h5_file, shell_solid_coupling_group_name);
-            write_set(h5_file, shell_solid_coupling_group_name, this->constraints.shell_solid_couplings[i].shellEdge, nullopt, nullopt);
-            write_set(h5_file, shell_solid_coupling_group_name, this->constraints.shell_solid_couplings[i].solidFace, nullopt, nullopt);
+            write_set(h5_file, shell_solid_coupling_group_name, this->constraints.shell_solid_couplings[i].shellEdge, nullptr, nullptr);
+            write_set(h5_file, shell_solid_coupling_group_name, this->constraints.shell_solid_couplings[i].solidFace, nullptr, nullptr);
             write_string_dataset(shell_solid_coupling_group, "positionToleranceMethod", this->constraints.shell_solid_couplings[i].positionToleranceMethod);
             write_string_dataset(shell_solid_coupling_group, "positionTolerance", this->constraints.shell_solid_couplings[i].positionTolerance);
             write_string_dataset(shell_solid_coupling_group, "influenceDistanceMethod", this->constraints.shell_solid_couplings[i].influenceDistanceMethod);
@@ -3437,67 +4424,75 @@ void SpadeObject::write_interactions(H5::H5File &h5_file, const string &group_na
             write_string_dataset(explicit_group, "contactControls", this->explicit_interactions[i].contactControls);
             write_double_dataset(explicit_group, "weightingFactor", this->explicit_interactions[i].weightingFactor);
             write_tangential_behavior(h5_file, explicit_group_name, this->explicit_interactions[i].interactionProperty);
-            write_set(h5_file, explicit_group_name, this->explicit_interactions[i].main, nullopt, nullopt);
-            write_set(h5_file, explicit_group_name, this->explicit_interactions[i].secondary, nullopt, nullopt);
+            write_set(h5_file, explicit_group_name, this->explicit_interactions[i].main, nullptr, nullptr);
+            write_set(h5_file, explicit_group_name, this->explicit_interactions[i].secondary, nullptr, nullptr);
         }
     }
 }
 
-void SpadeObject::write_elements(H5::H5File &h5_file, H5::Group &group, const string &group_name, map<string, map<int, element_type>>* elements) {
-    map<string, map<int, element_type>> all_elements = *elements;
-    this->log_file->logDebug("\t\tCall to write_elements at time: " + this->command_line_arguments->getTimeStamp(true));
+void SpadeObject::write_elements(H5::H5File &h5_file, H5::Group &group, const string &group_name, const map<string, mesh_elements_type>* elements) {
+    const map<string, mesh_elements_type> &all_elements = *elements;
+    Logging::Span span(*this->log_file, "write_elements");
     if (!all_elements.empty()) {
         H5::Group elements_group = create_group(h5_file, group_name + "/elements");
-        for (auto [type, element] : all_elements) {
-            for (auto [element_id, element_members] : element) {
-                string elements_label_group_name = group_name + "/elements/" + to_string(element_id);
+        for (const auto& [type, element] : all_elements) {
+            for (size_t i=0; i<element.labels.size(); i++) {
+                string elements_label_group_name = group_name + "/elements/" + to_string(element.labels[i]);
                 H5::Group elements_label_group = create_group(h5_file, elements_label_group_name);
                 write_string_dataset(elements_label_group, "type", type);
                 H5::Group section_category_group = create_group(h5_file, elements_label_group_name + "/sectionCategory");
-                write_section_category(h5_file, section_category_group, elements_label_group_name + "/sectionCategory", element_members.sectionCategory);
-                write_string_vector_dataset(elements_label_group, "instanceNames", element_members.instanceNames);
-                write_integer_vector_dataset(elements_label_group, "connectivity", element_members.connectivity);
+                write_section_category(h5_file, section_category_group, elements_label_group_name + "/sectionCategory", this->mesh_section_categories[element.section_category_ids[i]]);
+                vector<string> instance_names;
+                for (size_t j=element.instance_name_offsets[i]; j<element.instance_name_offsets[i + 1]; j++) { instance_names.push_back(this->mesh_instance_names[element.instance_name_ids[j]]); }
+                write_string_vector_dataset(elements_label_group, "instanceNames", instance_names);
+                vector<int> connectivity(element.connectivity.begin() + element.connectivity_offsets[i], element.connectivity.begin() + element.connectivity_offsets[i + 1]);
+                write_integer_vector_dataset(elements_label_group, "connectivity", connectivity);
             }
         }
     }
-    this->log_file->logDebug("\t\tFinished write_elements at time: " + this->command_line_arguments->getTimeStamp(true));
 }
 
-void SpadeObject::write_element_set(H5::H5File &h5_file, H5::Group &group, set<int> element_set) {
-    if (!element_set.empty()) {
-        vector<int> element_labels(element_set.begin(), element_set.end());
-        write_integer_vector_dataset(group, "elements", element_labels);
+void SpadeObject::write_element_set(H5::H5File &h5_file, H5::Group &group, const mesh_set_type &element_set) {
+    if (!element_set.labels.empty()) {
+        write_integer_vector_dataset(group, "elements", element_set.labels);
     }
 }
 
-void SpadeObject::write_nodes(H5::H5File &h5_file, H5::Group &group, const string &group_name, const map<int, node_type>* nodes, const string &set_name) {
-    map<int, node_type> all_nodes = *nodes;
-    if (!all_nodes.empty()) {
+void SpadeObject::write_nodes(H5::H5File &h5_file, H5::Group &group, const string &group_name, const mesh_nodes_type* nodes, const string &set_name) {
+    const mesh_nodes_type &all_nodes = *nodes;
+    if (!all_nodes.labels.empty()) {
         H5::Group nodes_group = create_group(h5_file, group_name + "/nodes");
-        for (auto [node_id, node] : all_nodes) {
-            write_float_vector_dataset(nodes_group, to_string(node_id), (node).coordinates);
+        for (size_t i=0; i<all_nodes.labels.size(); i++) {
+            vector<float> coordinates(all_nodes.coordinates.begin() + i * all_nodes.coordinate_size, all_nodes.coordinates.begin() + (i + 1) * all_nodes.coordinate_size);
+            write_float_vector_dataset(nodes_group, to_string(all_nodes.labels[i]), coordinates);
         }
     }
 }
 
-void SpadeObject::write_node_set(H5::H5File &h5_file, H5::Group &group, set<int> node_set) {
-    if (!node_set.empty()) {
-        vector<int> node_labels(node_set.begin(), node_set.end());
-        write_integer_vector_dataset(group, "nodes", node_labels);
+void SpadeObject::write_node_set(H5::H5File &h5_file, H5::Group &group, const mesh_set_type &node_set) {
+    if (!node_set.labels.empty()) {
+        write_integer_vector_dataset(group, "nodes", node_set.labels);
     }
 }
 
-void SpadeObject::write_sets(H5::H5File &h5_file, const string &group_name, const vector<set_type> &sets, map<string, set<int>> element_sets, map<string, set<int>> node_sets) {
+void SpadeObject::write_sets(H5::H5File &h5_file, const string &group_name, const vector<set_type> &sets, const map<int, mesh_set_type> &element_sets, const map<int, mesh_set_type> &node_sets) {
     if (!sets.empty()) {
         H5::Group sets_group = create_group(h5_file, group_name);
-        for (auto odb_set : sets) { write_set(h5_file, group_name, odb_set, element_sets[odb_set.name], node_sets[odb_set.name]); }
+        for (const auto& odb_set : sets) {
+            auto set_id = this->mesh_set_name_ids.find(odb_set.name);
+            auto element_set = (set_id != this->mesh_set_name_ids.end()) ? element_sets.find(set_id->second) : element_sets.end();
+            auto node_set = (set_id != this->mesh_set_name_ids.end()) ? node_sets.find(set_id->second) : node_sets.end();
+            write_set(h5_file, group_name, odb_set,
+                      (element_set != element_sets.end()) ? &element_set->second : nullptr,
+                      (node_set != node_sets.end()) ? &node_set->second : nullptr);
+        }
     }
 }
 
-void SpadeObject::write_set(H5::H5File &h5_file, const string &group_name, const set_type &odb_set, optional<set <int>> element_set, optional<set <int>> node_set) {
+void SpadeObject::write_set(H5::H5File &h5_file, const string &group_name, const set_type &odb_set, const mesh_set_type* element_set, const mesh_set_type* node_set) {
     std::regex nodes_pattern("\\s*ALL\\s*NODES\\s*");
     std::regex elements_pattern("\\s*ALL\\s*ELEMENTS\\s*");
-    this->log_file->logDebug("\tWriting set " + odb_set.name + " at time: " + this->command_line_arguments->getTimeStamp(true));
+    this->log_file->logDebug([&] { return "\tWriting set " + odb_set.name + " at time: " + this->command_line_arguments->getTimeStamp(true); });
     if ((!odb_set.name.empty()) && (!regex_match(odb_set.name, nodes_pattern)) && (!regex_match(odb_set.name, elements_pattern))) {
         // There is no reason to write a set named ' ALL NODES' when all the nodes can be found under the 'nodes' heading
         string set_group_name = group_name + "/" + replace_slashes(odb_set.name);
@@ -3505,33 +4500,35 @@ void SpadeObject::write_set(H5::H5File &h5_file, const string &group_name, const
         write_string_attribute(set_group, "type", odb_set.type);
         write_string_vector_dataset(set_group, "instanceNames", odb_set.instanceNames);
         if (this->command_line_arguments->get("format") == "odb") {
-            if ((odb_set.type == "Node Set") && (node_set.has_value())) {
-                write_node_set(h5_file, set_group, node_set.value());
-            } else if ((odb_set.type == "Element Set") && (element_set.has_value())) {
-                write_element_set(h5_file, set_group, element_set.value());
+            if ((odb_set.type == "Node Set") && (node_set != nullptr)) {
+                write_node_set(h5_file, set_group, *node_set);
+            } else if ((odb_set.type == "Element Set") && (element_set != nullptr)) {
+                write_element_set(h5_file, set_group, *element_set);
             } else if (odb_set.type == "Surface Set") {
                 if (!odb_set.faces.empty()) {
-                    write_string_vector_dataset(set_group, "faces", odb_set.faces);
+                    hsize_t dimensions_faces[] = {odb_set.faces.size()};
+                    write_enum_dataset(set_group, "faces", this->face_enum_type, 1, dimensions_faces, odb_set.faces.data());
                 }
                 if (odb_set.elements != nullptr && !odb_set.elements->empty()) {
-                    if (element_set.has_value()) {
-                        write_element_set(h5_file, set_group, element_set.value());
+                    if (element_set != nullptr) {
+                        write_element_set(h5_file, set_group, *element_set);
                     }
                 } else {
-                    if (node_set.has_value()) {
-                        write_node_set(h5_file, set_group, node_set.value());
+                    if (node_set != nullptr) {
+                        write_node_set(h5_file, set_group, *node_set);
                     }
                 }
             }
         } else {
             if (odb_set.type == "Surface Set") {
                 if (odb_set.elements != nullptr && !odb_set.elements->empty()) {
-                    if (element_set.has_value()) {
-                        write_element_set(h5_file, set_group, element_set.value());
+                    if (element_set != nullptr) {
+                        write_element_set(h5_file, set_group, *element_set);
                     }
                 }
                 if (!odb_set.faces.empty()) {
-                    write_string_vector_dataset(set_group, "faces", odb_set.faces);
+                    hsize_t dimensions_faces[] = {odb_set.faces.size()};
+                    write_enum_dataset(set_group, "faces", this->face_enum_type, 1, dimensions_faces, odb_set.faces.data());
                 }
             }
         }
@@ -3592,6 +4589,18 @@ void SpadeObject::write_integer_array_attribute(const H5::Group &group, const st
     attribute_space.close();
 }
 
+void SpadeObject::write_scalar_attribute(const H5::Group &group, const string &attribute_name, const H5::PredType &data_type, const void* value) {
+    if (group.attrExists(attribute_name)) { return; }  // Already written when the group is written again, e.g. by another block of the same instance
+    H5::DataSpace attribute_space(H5S_SCALAR);
+    try {
+        H5::Attribute attribute = group.createAttribute(attribute_name, data_type, attribute_space);
+        attribute.write(data_type, value);
+    } catch(H5::Exception& e) {
+        this->log_file->logWarning("Unable to create attribute " + attribute_name + ". " + e.getDetailMsg());
+    }
+    attribute_space.close();
+}
+
 void SpadeObject::write_vector_attribute(const H5::Group &group, const string &attribute_name, const vector<string> &string_values) {
     if (string_values.empty()) { return; }
     // Convert the vector of strings to a C-style array of c-strings
@@ -3615,14 +4624,21 @@ void SpadeObject::write_vector_attribute(const H5::Group &group, const string &a
 
 void SpadeObject::write_string_dataset(const H5::Group& group, const string & dataset_name, const string & string_value) {
     if (string_value.empty()) { return; }
+    if (this->scalar_attributes) {
+        if (!group.attrExists(dataset_name)) { write_string_attribute(group, dataset_name, string_value); }
+        return;
+    }
+    Logging::Span span(*this->log_file, "write dataset");
+    add_dataset_arguments(span, group, dataset_name, 1, string_value.size());
     H5::DataSpace attribute_space(H5S_SCALAR);
     hsize_t dimensions[] = {1};
     H5::DataSpace dataspace(1, dimensions);  // Just one string
     int string_size = string_value.size();
     if (string_size == 0) { string_size++; }  // If the string is empty, make the string size equal to one, as StrType must have a positive size
     H5::StrType string_type (0, string_size);
+    const size_t compact_bytes = 32768;  // Compact data is kept in the object header, which is limited to 64 KiB
     try {
-        H5::DataSet dataset = group.createDataSet(dataset_name, string_type, dataspace);
+        H5::DataSet dataset = group.createDataSet(dataset_name, string_type, dataspace, (string_value.size() < compact_bytes) ? this->scalar_dataset_properties : this->contiguous_dataset_properties);
         dataset.write(&string_value[0], string_type);
         dataset.close();
     } catch(H5::Exception& e) {
@@ -3633,6 +4649,12 @@ void SpadeObject::write_string_dataset(const H5::Group& group, const string & da
 
 void SpadeObject::write_string_vector_dataset(const H5::Group& group, const string & dataset_name, const vector<string> & string_values) {
     if (string_values.empty()) { return; }
+    Logging::Span span(*this->log_file, "write dataset");
+    if (span.active()) {
+        size_t bytes = 0;
+        for (const string &string_value : string_values) { bytes += string_value.size(); }
+        add_dataset_arguments(span, group, dataset_name, string_values.size(), bytes);
+    }
     std::vector<const char*> c_string_array;
     for (int i = 0; i < string_values.size(); ++i) {
         c_string_array.push_back(string_values[i].c_str());
@@ -3652,6 +4674,12 @@ void SpadeObject::write_string_vector_dataset(const H5::Group& group, const stri
 
 void SpadeObject::write_c_string_vector_dataset(const H5::Group& group, const string & dataset_name, vector<const char*> & string_values) {
     if (string_values.empty()) { return; }
+    Logging::Span span(*this->log_file, "write dataset");
+    if (span.active()) {
+        size_t bytes = 0;
+        for (const char* string_value : string_values) { if (string_value) { bytes += strlen(string_value); } }
+        add_dataset_arguments(span, group, dataset_name, string_values.size(), bytes);
+    }
     hsize_t dimensions[] = {string_values.size()};
     H5::DataSpace  dataspace(1, dimensions);
     H5::StrType string_type(H5::PredType::C_S1, H5T_VARIABLE); // Variable length string
@@ -3665,27 +4693,18 @@ void SpadeObject::write_c_string_vector_dataset(const H5::Group& group, const st
     dataspace.close();
 }
 
-void SpadeObject::write_c_string_2D_vector(const H5::Group& group, const string & dataset_name, const int & column_size, vector<const char*> & string_data) {
-    if (string_data.empty()) { return; }
-    hsize_t dimensions[] {string_data.size(), column_size};
-    H5::DataSpace  dataspace(2, dimensions);
-    H5::StrType string_type(H5::PredType::C_S1, H5T_VARIABLE); // Variable length string
-    try {
-        H5::DataSet dataset = group.createDataSet(dataset_name, string_type, dataspace);
-        dataset.write(string_data.data(), string_type);
-        dataset.close();
-    } catch(H5::Exception& e) {
-        this->log_file->logWarning("Unable to create dataset " + dataset_name + ". " + e.getDetailMsg());
-    }
-    dataspace.close();
-}
-
 void SpadeObject::write_integer_dataset(const H5::Group& group, const string & dataset_name, const int & int_value) {
     if (!int_value) { return; }
+    if (this->scalar_attributes) {
+        write_scalar_attribute(group, dataset_name, H5::PredType::NATIVE_INT, &int_value);
+        return;
+    }
+    Logging::Span span(*this->log_file, "write dataset");
+    add_dataset_arguments(span, group, dataset_name, 1, sizeof(int));
     hsize_t dimensions[] = {1};
     H5::DataSpace dataspace(1, dimensions);  // Just one integer
     try {
-        H5::DataSet dataset = group.createDataSet(dataset_name, H5::PredType::NATIVE_INT, dataspace);
+        H5::DataSet dataset = group.createDataSet(dataset_name, H5::PredType::NATIVE_INT, dataspace, this->scalar_dataset_properties);
         dataset.write(&int_value, H5::PredType::NATIVE_INT);
         dataset.close();
     } catch(H5::Exception& e) {
@@ -3696,10 +4715,12 @@ void SpadeObject::write_integer_dataset(const H5::Group& group, const string & d
 
 void SpadeObject::write_integer_array_dataset(const H5::Group& group, const string & dataset_name, const int array_size, const int* int_array) {
     if (!int_array) { return; }
+    Logging::Span span(*this->log_file, "write dataset");
+    add_dataset_arguments(span, group, dataset_name, array_size, array_size * sizeof(int));
     hsize_t dimensions[] = {array_size};
     H5::DataSpace dataspace(1, dimensions);
     try {
-        H5::DataSet dataset = group.createDataSet(dataset_name, H5::PredType::NATIVE_INT, dataspace);
+        H5::DataSet dataset = group.createDataSet(dataset_name, H5::PredType::NATIVE_INT, dataspace, dataset_properties(1, dimensions, sizeof(int), false));
         dataset.write(int_array, H5::PredType::NATIVE_INT);
         dataset.close();
     } catch(H5::Exception& e) {
@@ -3710,6 +4731,8 @@ void SpadeObject::write_integer_array_dataset(const H5::Group& group, const stri
 
 void SpadeObject::write_integer_vector_dataset(const H5::Group& group, const string & dataset_name, const vector<int> & int_data) {
     if (int_data.empty()) { return; }
+    Logging::Span span(*this->log_file, "write dataset");
+    add_dataset_arguments(span, group, dataset_name, int_data.size(), int_data.size() * sizeof(int));
     hsize_t dimensions[] = {int_data.size()};
     H5::DataSpace dataspace(1, dimensions);
     try {
@@ -3722,12 +4745,33 @@ void SpadeObject::write_integer_vector_dataset(const H5::Group& group, const str
     dataspace.close();
 }
 
+void SpadeObject::write_enum_dataset(const H5::Group &group, const string &dataset_name, const H5::EnumType &enum_type, const int &rank, const hsize_t* dimensions, const void* codes) {
+    if (!codes) { return; }
+    Logging::Span span(*this->log_file, "write dataset");
+    if (span.active()) {
+        hsize_t size = 1;
+        for (int i=0; i<rank; i++) { size *= dimensions[i]; }
+        add_dataset_arguments(span, group, dataset_name, size, size * enum_type.getSize());
+    }
+    H5::DataSpace dataspace(rank, dimensions);
+    try {
+        H5::DataSet dataset = group.createDataSet(dataset_name, enum_type, dataspace, dataset_properties(rank, dimensions, enum_type.getSize(), false));
+        dataset.write(codes, enum_type);
+        dataset.close();
+    } catch(H5::Exception& e) {
+        this->log_file->logWarning("Unable to create dataset " + dataset_name + ". " + e.getDetailMsg());
+    }
+    dataspace.close();
+}
+
 void SpadeObject::write_integer_2D_array(const H5::Group& group, const string & dataset_name, const int &row_size, const int &column_size, int *integer_array) {
     if (!integer_array) { return; }
+    Logging::Span span(*this->log_file, "write dataset");
+    add_dataset_arguments(span, group, dataset_name, row_size * column_size, row_size * column_size * sizeof(int));
     hsize_t dimensions[] = {row_size, column_size};
     H5::DataSpace dataspace(2, dimensions);  // two dimensional data
     try {
-        H5::DataSet dataset = group.createDataSet(dataset_name, H5::PredType::NATIVE_INT, dataspace);
+        H5::DataSet dataset = group.createDataSet(dataset_name, H5::PredType::NATIVE_INT, dataspace, dataset_properties(2, dimensions, sizeof(int), false));
         dataset.write(integer_array, H5::PredType::NATIVE_INT);
         dataset.close();
     } catch(H5::Exception& e) {
@@ -3738,10 +4782,16 @@ void SpadeObject::write_integer_2D_array(const H5::Group& group, const string &
 
 void SpadeObject::write_float_dataset(const H5::Group &group, const string &dataset_name, const float &float_value) {
 //    if (!float_value) { return; }
+    if (this->scalar_attributes) {
+        write_scalar_attribute(group, dataset_name, H5::PredType::NATIVE_FLOAT, &float_value);
+        return;
+    }
+    Logging::Span span(*this->log_file, "write dataset");
+    add_dataset_arguments(span, group, dataset_name, 1, sizeof(float));
     hsize_t dimensions[] = {1};
     H5::DataSpace dataspace(1, dimensions);  // Just one integer
     try {
-        H5::DataSet dataset = group.createDataSet(dataset_name, H5::PredType::NATIVE_FLOAT, dataspace);
+        H5::DataSet dataset = group.createDataSet(dataset_name, H5::PredType::NATIVE_FLOAT, dataspace, this->scalar_dataset_properties);
         dataset.write(&float_value, H5::PredType::NATIVE_FLOAT);
         dataset.close();
     } catch(H5::Exception& e) {
@@ -3752,6 +4802,8 @@ void SpadeObject::write_float_dataset(const H5::Group &group, const string &data
 
 void SpadeObject::write_float_array_dataset(const H5::Group &group, const string &dataset_name, const int array_size, const float* float_array) {
     if (!float_array) { return; }
+    Logging::Span span(*this->log_file, "write dataset");
+    add_dataset_arguments(span, group, dataset_name, array_size, array_size * sizeof(float));
     hsize_t dimensions[] = {array_size};
     H5::DataSpace dataspace(1, dimensions);
     try {
@@ -3766,6 +4818,8 @@ void SpadeObject::write_float_array_dataset(const H5::Group &group, const string
 
 void SpadeObject::write_float_vector_dataset(const H5::Group &group, const string &dataset_name, const vector<float> &float_data) {
     if (float_data.empty()) { return; }
+    Logging::Span span(*this->log_file, "write dataset");
+    add_dataset_arguments(span, group, dataset_name, float_data.size(), float_data.size() * sizeof(float));
     hsize_t dimensions[] = {float_data.size()};
     H5::DataSpace dataspace(1, dimensions);
     try {
@@ -3780,10 +4834,12 @@ void SpadeObject::write_float_vector_dataset(const H5::Group &group, const strin
 
 void SpadeObject::write_float_2D_array(const H5::Group& group, const string & dataset_name, const int &row_size, const int &column_size, float *float_array) {
     if (!float_array) { return; }
+    Logging::Span span(*this->log_file, "write dataset");
+    add_dataset_arguments(span, group, dataset_name, row_size * column_size, row_size * column_size * sizeof(float));
     hsize_t dimensions[] = {row_size, column_size};
     H5::DataSpace dataspace(2, dimensions);  // two dimensional data
     try {
-        H5::DataSet dataset = group.createDataSet(dataset_name, H5::PredType::NATIVE_FLOAT, dataspace);
+        H5::DataSet dataset = group.createDataSet(dataset_name, H5::PredType::NATIVE_FLOAT, dataspace, dataset_properties(2, dimensions, sizeof(float), false));
         dataset.write(float_array, H5::PredType::NATIVE_FLOAT);
         dataset.close();
     } catch(H5::Exception& e) {
@@ -3794,10 +4850,12 @@ void SpadeObject::write_float_2D_array(const H5::Group& group, const string & da
 
 void SpadeObject::write_float_3D_array(const H5::Group &group, const string &dataset_name, const int &aisle_size, const int &row_size, const int &column_size, float *float_array) {
     if (!float_array) { return; }
+    Logging::Span span(*this->log_file, "write dataset");
+    add_dataset_arguments(span, group, dataset_name, aisle_size * row_size * column_size, aisle_size * row_size * column_size * sizeof(float));
     hsize_t dimensions[] = {aisle_size, row_size, column_size};
     H5::DataSpace dataspace(3, dimensions);  // three dimensional data
     try {
-        H5::DataSet dataset = group.createDataSet(dataset_name, H5::PredType::NATIVE_FLOAT, dataspace);
+        H5::DataSet dataset = group.createDataSet(dataset_name, H5::PredType::NATIVE_FLOAT, dataspace, dataset_properties(3, dimensions, sizeof(float), true));
         dataset.write(float_array, H5::PredType::NATIVE_FLOAT);
         dataset.close();
     } catch(H5::Exception& e) {
@@ -3808,6 +4866,8 @@ void SpadeObject::write_float_3D_array(const H5::Group &group, const string &dat
 
 void SpadeObject::write_float_2D_data(const H5::Group &group, const string &dataset_name, const int &row_size, const int &column_size, const vector<float> &float_data) {
     if (float_data.empty()) { return; }
+    Logging::Span span(*this->log_file, "write dataset");
+    add_dataset_arguments(span, group, dataset_name, float_data.size(), float_data.size() * sizeof(float));
     hsize_t dimensions[] = {row_size, column_size};
     H5::DataSpace dataspace(2, dimensions);  // two dimensional data
     try {
@@ -3820,8 +4880,14 @@ void SpadeObject::write_float_2D_data(const H5::Group &group, const string &data
     dataspace.close();
 }
 
-void SpadeObject::write_float_2D_vector(const H5::Group& group, const string & dataset_name, const int & max_column_size, vector<vector<float>> &float_data) {
+void SpadeObject::write_float_2D_vector(const H5::Group& group, const string & dataset_name, const int & max_column_size, const vector<vector<float>> &float_data) {
     if (float_data.empty()) { return; }
+    Logging::Span span(*this->log_file, "write dataset");
+    if (span.active()) {
+        size_t elements = 0;
+        for (const vector<float> &row : float_data) { elements += row.size(); }
+        add_dataset_arguments(span, group, dataset_name, elements, elements * sizeof(float));
+    }
     hsize_t dimensions(float_data.size());
     H5::DataSpace dataspace(1, &dimensions);
     H5::VarLenType datatype(H5::PredType::NATIVE_FLOAT);
@@ -3831,7 +4897,7 @@ void SpadeObject::write_float_2D_vector(const H5::Group& group, const string & d
         for (hsize_t i = 0; i < dimensions; ++i)
         {
             variable_length[i].len = float_data[i].size();
-            variable_length[i].p = &float_data[i][0];
+            variable_length[i].p = const_cast<float*>(float_data[i].data());  // hvl_t only holds non-const pointers
         }
         dataset.write(variable_length.data(), datatype);
         dataspace.close();
@@ -3847,10 +4913,16 @@ void SpadeObject::write_float_2D_vector(const H5::Group& group, const string & d
 
 void SpadeObject::write_double_dataset(const H5::Group &group, const string &dataset_name, const double &double_value) {
     if (!double_value) { return; }
+    if (this->scalar_attributes) {
+        write_scalar_attribute(group, dataset_name, H5::PredType::NATIVE_DOUBLE, &double_value);
+        return;
+    }
+    Logging::Span span(*this->log_file, "write dataset");
+    add_dataset_arguments(span, group, dataset_name, 1, sizeof(double));
     hsize_t dimensions[] = {1};
     H5::DataSpace dataspace(1, dimensions);  // Just one integer
     try {
-        H5::DataSet dataset = group.createDataSet(dataset_name, H5::PredType::NATIVE_DOUBLE, dataspace);
+        H5::DataSet dataset = group.createDataSet(dataset_name, H5::PredType::NATIVE_DOUBLE, dataspace, this->scalar_dataset_properties);
         dataset.write(&double_value, H5::PredType::NATIVE_DOUBLE);
         dataset.close();
     } catch(H5::Exception& e) {
@@ -3861,6 +4933,8 @@ void SpadeObject::write_double_dataset(const H5::Group &group, const string &dat
 
 void SpadeObject::write_double_array_dataset(const H5::Group &group, const string &dataset_name, const int array_size, const double* double_array) {
     if (!double_array) { return; }
+    Logging::Span span(*this->log_file, "write dataset");
+    add_dataset_arguments(span, group, dataset_name, array_size, array_size * sizeof(double));
     hsize_t dimensions[] = {array_size};
     H5::DataSpace dataspace(1, dimensions);
     try {
@@ -3875,6 +4949,8 @@ void SpadeObject::write_double_array_dataset(const H5::Group &group, const strin
 
 void SpadeObject::write_double_vector_dataset(const H5::Group &group, const string &dataset_name, const vector<double> &double_data) {
     if (double_data.empty()) { return; }
+    Logging::Span span(*this->log_file, "write dataset");
+    add_dataset_arguments(span, group, dataset_name, double_data.size(), double_data.size() * sizeof(double));
     hsize_t dimensions[] = {double_data.size()};
     H5::DataSpace dataspace(1, dimensions);
     try {
@@ -3887,12 +4963,30 @@ void SpadeObject::write_double_vector_dataset(const H5::Group &group, const stri
     dataspace.close();
 }
 
+void SpadeObject::write_long_vector_dataset(const H5::Group &group, const string &dataset_name, const vector<long long> &long_data) {
+    if (long_data.empty()) { return; }
+    Logging::Span span(*this->log_file, "write dataset");
+    add_dataset_arguments(span, group, dataset_name, long_data.size(), long_data.size() * sizeof(long long));
+    hsize_t dimensions[] = {long_data.size()};
+    H5::DataSpace dataspace(1, dimensions);
+    try {
+        H5::DataSet dataset = group.createDataSet(dataset_name, H5::PredType::NATIVE_LLONG, dataspace, dataset_properties(1, dimensions, sizeof(long long), false));
+        dataset.write(long_data.data(), H5::PredType::NATIVE_LLONG);
+        dataset.close();
+    } catch(H5::Exception& e) {
+        this->log_file->logWarning("Unable to create dataset " + dataset_name + ". " + e.getDetailMsg());
+    }
+    dataspace.close();
+}
+
 void SpadeObject::write_double_2D_array(const H5::Group& group, const string & dataset_name, const int &row_size, const int &column_size, double *double_array) {
     if (!double_array) { return; }
+    Logging::Span span(*this->log_file, "write dataset");
+    add_dataset_arguments(span, group, dataset_name, row_size * column_size, row_size * column_size * sizeof(double));
     hsize_t dimensions[] = {row_size, column_size};
     H5::DataSpace dataspace(2, dimensions);  // two dimensional data
     try {
-        H5::DataSet dataset = group.createDataSet(dataset_name, H5::PredType::NATIVE_DOUBLE, dataspace);
+        H5::DataSet dataset = group.createDataSet(dataset_name, H5::PredType::NATIVE_DOUBLE, dataspace, dataset_properties(2, dimensions, sizeof(double), false));
         dataset.write(double_array, H5::PredType::NATIVE_DOUBLE);
         dataset.close();
     } catch(H5::Exception& e) {
@@ -3903,10 +4997,12 @@ void SpadeObject::write_double_2D_array(const H5::Group& group, const string & d
 
 void SpadeObject::write_double_3D_array(const H5::Group &group, const string &dataset_name, const int &aisle_size, const int &row_size, const int &column_size, double *double_array) {
     if (!double_array) { return; }
+    Logging::Span span(*this->log_file, "write dataset");
+    add_dataset_arguments(span, group, dataset_name, aisle_size * row_size * column_size, aisle_size * row_size * column_size * sizeof(double));
     hsize_t dimensions[] = {aisle_size, row_size, column_size};
     H5::DataSpace dataspace(3, dimensions);  // three dimensional data
     try {
-        H5::DataSet dataset = group.createDataSet(dataset_name, H5::PredType::NATIVE_DOUBLE, dataspace);
+        H5::DataSet dataset = group.createDataSet(dataset_name, H5::PredType::NATIVE_DOUBLE, dataspace, dataset_properties(3, dimensions, sizeof(double), true));
         dataset.write(double_array, H5::PredType::NATIVE_DOUBLE);
         dataset.close();
     } catch(H5::Exception& e) {
@@ -3917,6 +5013,12 @@ void SpadeObject::write_double_3D_array(const H5::Group &group, const string &da
 
 void SpadeObject::write_double_2D_vector(const H5::Group& group, const string & dataset_name, const int & max_column_size, vector<vector<double>> & double_data) {
     if (double_data.empty()) { return; }
+    Logging::Span span(*this->log_file, "write dataset");
+    if (span.active()) {
+        size_t elements = 0;
+        for (const vector<double> &row : double_data) { elements += row.size(); }
+        add_dataset_arguments(span, group, dataset_name, elements, elements * sizeof(double));
+    }
      // Convert to 2D array
     hsize_t dimensions(double_data.size());
     H5::DataSpace dataspace(1, &dimensions);
@@ -3941,18 +5043,265 @@ void SpadeObject::write_double_2D_vector(const H5::Group& group, const string &
     }
 }
 
+H5::DataSet SpadeObject::write_stacked_array(const H5::Group &group, const string &dataset_name, const int &frame_index, const int &rank, const hsize_t* dimensions, const H5::PredType &data_type, const void* data, bool &created) {
+    created = false;
+    H5::DataSet dataset;
+    if (!data) { return dataset; }
+    vector<hsize_t> frame_dimensions(dimensions, dimensions + rank);  // Shape of one frame of data
+    Logging::Span span(*this->log_file, "write dataset");
+    if (span.active()) {
+        size_t elements = std::accumulate(frame_dimensions.begin(), frame_dimensions.end(), size_t(1), std::multiplies<size_t>());
+        add_dataset_arguments(span, group, dataset_name, elements, elements * data_type.getSize());
+        span.add("frame index", frame_index);
+    }
+    int stacked_rank = rank + 1;
+    vector<hsize_t> stacked_dimensions(stacked_rank);
+    try {
+        if (group.nameExists(dataset_name)) {
+            dataset = group.openDataSet(dataset_name);
+            H5::DataSpace existing_space = dataset.getSpace();
+            if (existing_space.getSimpleExtentNdims() != stacked_rank) {
+                this->log_file->logWarning("Unable to stack frame " + to_string(frame_index) + " in dataset " + dataset_name + ". The number of dimensions changed.");
+                return H5::DataSet();
+            }
+            existing_space.getSimpleExtentDims(stacked_dimensions.data());
+            if (!std::equal(frame_dimensions.begin(), frame_dimensions.end(), stacked_dimensions.begin() + 1)) {
+                this->log_file->logWarning("Unable to stack frame " + to_string(frame_index) + " in dataset " + dataset_name + ". The shape of the data changed.");
+                return H5::DataSet();
+            }
+            if (stacked_dimensions[0] < frame_index + 1) {
+                stacked_dimensions[0] = frame_index + 1;
+                dataset.extend(stacked_dimensions.data());
+            }
+        } else {
+            stacked_dimensions[0] = frame_index + 1;  // Frames before the first one with data are left at the fill value
+            std::copy(frame_dimensions.begin(), frame_dimensions.end(), stacked_dimensions.begin() + 1);
+            vector<hsize_t> maximum_dimensions(stacked_dimensions);
+            maximum_dimensions[0] = H5S_UNLIMITED;
+            H5::DataSpace dataspace(stacked_rank, stacked_dimensions.data(), maximum_dimensions.data());
+            H5::DSetCreatPropList properties = stacked_dataset_properties(rank, frame_dimensions.data(), data_type);
+            dataset = group.createDataSet(dataset_name, data_type, dataspace, properties);
+            created = true;
+        }
+        vector<hsize_t> start(stacked_rank, 0);
+        start[0] = frame_index;
+        vector<hsize_t> count(stacked_dimensions);
+        count[0] = 1;
+        H5::DataSpace file_space = dataset.getSpace();
+        file_space.selectHyperslab(H5S_SELECT_SET, count.data(), start.data());
+        H5::DataSpace memory_space = (rank > 0) ? H5::DataSpace(rank, frame_dimensions.data()) : H5::DataSpace(H5S_SCALAR);
+        dataset.write(data, data_type, memory_space, file_space);
+    } catch(H5::Exception& e) {
+        this->log_file->logWarning("Unable to write frame " + to_string(frame_index) + " to dataset " + dataset_name + ". " + e.getDetailMsg());
+    }
+    return dataset;
+}
+
+long long SpadeObject::append_rows(const H5::Group &group, const string &dataset_name, const hsize_t &row_size, const hsize_t &column_size, const H5::PredType &data_type, const H5::PredType &memory_type, const void* data) {
+    if ((!data) || (row_size == 0)) { return -1; }
+    Logging::Span span(*this->log_file, "write dataset");
+    if (span.active()) {
+        size_t elements = row_size * std::max<hsize_t>(1, column_size);
+        add_dataset_arguments(span, group, dataset_name, elements, elements * data_type.getSize());
+    }
+    int rank = (column_size > 0) ? 2 : 1;
+    hsize_t dimensions[] = {row_size, column_size};
+    hsize_t start[] = {0, 0};
+    try {
+        H5::DataSet dataset;
+        if (group.nameExists(dataset_name)) {
+            dataset = group.openDataSet(dataset_name);
+            hsize_t existing_dimensions[] = {0, 0};
+            dataset.getSpace().getSimpleExtentDims(existing_dimensions);
+            start[0] = existing_dimensions[0];
+            hsize_t extended_dimensions[] = {start[0] + row_size, column_size};
+            dataset.extend(extended_dimensions);
+        } else {
+            // Extendible datasets must be chunked, each chunk holds about a megabyte of rows
+            const hsize_t target_chunk_bytes = 1048576;
+            hsize_t row_bytes = data_type.getSize() * std::max<hsize_t>(1, column_size);
+            hsize_t chunk_dimensions[] = {std::max<hsize_t>(1, std::min<hsize_t>(row_size, target_chunk_bytes / row_bytes)), column_size};
+            hsize_t maximum_dimensions[] = {H5S_UNLIMITED, column_size};
+            H5::DataSpace dataspace(rank, dimensions, maximum_dimensions);
+            H5::DSetCreatPropList properties;
+            properties.copy(this->dataset_creation_properties);
+            properties.setChunk(rank, chunk_dimensions);
+            dataset = group.createDataSet(dataset_name, data_type, dataspace, properties);
+        }
+        H5::DataSpace file_space = dataset.getSpace();
+        file_space.selectHyperslab(H5S_SELECT_SET, dimensions, start);
+        H5::DataSpace memory_space(rank, dimensions);
+        dataset.write(data, memory_type, memory_space, file_space);
+    } catch(H5::Exception& e) {
+        this->log_file->logWarning("Unable to append rows to dataset " + dataset_name + ". " + e.getDetailMsg());
+        return -1;
+    }
+    return start[0];
+}
+
+long long SpadeObject::append_columns(const H5::Group &group, const string &dataset_name, const hsize_t &row_size, const hsize_t &column_size, const H5::PredType &data_type, const H5::PredType &memory_type, const void* data) {
+    if ((!data) || (row_size == 0) || (column_size == 0)) { return -1; }
+    Logging::Span span(*this->log_file, "write dataset");
+    add_dataset_arguments(span, group, dataset_name, row_size * column_size, row_size * column_size * data_type.getSize());
+    hsize_t dimensions[] = {row_size, column_size};
+    hsize_t start[] = {0, 0};
+    try {
+        H5::DataSet dataset;
+        if (group.nameExists(dataset_name)) {
+            dataset = group.openDataSet(dataset_name);
+            hsize_t existing_dimensions[] = {0, 0};
+            dataset.getSpace().getSimpleExtentDims(existing_dimensions);
+            if (existing_dimensions[0] != row_size) {  // E.g. history outputs added to a region since the last extraction, which would shift the rows
+                this->log_file->logErrorAndExit("Unable to append columns of " + to_string(row_size) + " rows to dataset " + dataset_name + " with " + to_string(existing_dimensions[0]) + " rows.");
+            }
+            start[1] = existing_dimensions[1];
+            hsize_t extended_dimensions[] = {row_size, start[1] + column_size};
+            dataset.extend(extended_dimensions);
+        } else {
+            // Extendible datasets must be chunked, each chunk holds about a megabyte of columns
+            const hsize_t target_chunk_bytes = 1048576;
+            hsize_t column_bytes = data_type.getSize() * row_size;
+            hsize_t chunk_dimensions[] = {row_size, std::max<hsize_t>(1, std::min<hsize_t>(column_size, target_chunk_bytes / column_bytes))};
+            hsize_t maximum_dimensions[] = {row_size, H5S_UNLIMITED};
+            H5::DataSpace dataspace(2, dimensions, maximum_dimensions);
+            H5::DSetCreatPropList properties;
+            properties.copy(this->dataset_creation_properties);
+            properties.setChunk(2, chunk_dimensions);
+            dataset = group.createDataSet(dataset_name, data_type, dataspace, properties);
+        }
+        H5::DataSpace file_space = dataset.getSpace();
+        file_space.selectHyperslab(H5S_SELECT_SET, dimensions, start);
+        H5::DataSpace memory_space(2, dimensions);
+        dataset.write(data, memory_type, memory_space, file_space);
+    } catch(H5::Exception& e) {
+        this->log_file->logWarning("Unable to append columns to dataset " + dataset_name + ". " + e.getDetailMsg());
+        return -1;
+    }
+    return start[1];
+}
+
+void SpadeObject::add_dataset_arguments(Logging::Span &span, const H5::Group &group, const string &dataset_name, const size_t &elements, const size_t &bytes) {
+    if (!span.active()) { return; }
+    string group_name;
+    try {
+        group_name = group.getObjName();
+    } catch(H5::Exception& e) {}  // The name is only used to label the span
+    span.add("dataset", (group_name.empty() || group_name == "/") ? "/" + dataset_name : group_name + "/" + dataset_name);
+    span.add("elements", static_cast<long long>(elements));
+    span.add("bytes", static_cast<long long>(bytes));
+}
+
 H5::Group SpadeObject::create_group(H5::H5File &h5_file, const string &group_name) {
-    H5::Exception::dontPrint();
+    bool exists;
+    return open_subgroup(h5_file, group_name, exists);
+}
+
+void SpadeObject::create_dataset_creation_properties () {
+    string compression = this->command_line_arguments->get("compression");
+    string chunk_shape_string = this->command_line_arguments->get("chunk-shape");
+    if (this->file_profile->skip_fill()) {  // Every dataset is written in full, so the fill values would only be overwritten
+        this->contiguous_dataset_properties.setFillTime(H5D_FILL_TIME_NEVER);
+        this->dataset_creation_properties.setFillTime(H5D_FILL_TIME_NEVER);
+    }
+    this->scalar_attributes = (this->command_line_arguments->get("metadata-layout") == "attributes");
+    this->scalar_dataset_properties.copy(this->contiguous_dataset_properties);
+    if (this->command_line_arguments->get("metadata-layout") == "compact") { this->scalar_dataset_properties.setLayout(H5D_COMPACT); }
+    this->chunk_datasets = (chunk_shape_string != "none");
+    if (!this->chunk_datasets) { return; }
+
+    stringstream string_stream(chunk_shape_string);
+    string each_dimension;
+    while (std::getline(string_stream, each_dimension, 'x')) {  // Empty chunk shape means the shape is determined automatically
+        if (each_dimension == "auto") { break; }
+        this->chunk_shape.push_back(std::stoull(each_dimension));
+    }
+
+    if (compression == "none") { return; }
+    int compression_level = (this->command_line_arguments->get("compression-level").empty()) ? 0 : std::stoi(this->command_line_arguments->get("compression-level"));
+    // Registered filter identifiers: https://github.com/HDFGroup/hdf5_plugins/blob/master/docs/RegisteredFilterPlugins.md
+    map<string, H5Z_filter_t> filter_ids = {{"gzip", H5Z_FILTER_DEFLATE}, {"szip", H5Z_FILTER_SZIP}, {"lzf", 32000}, {"zstd", 32015}};
+    if (H5Zfilter_avail(filter_ids[compression]) <= 0) {
+        this->log_file->logWarning("The " + compression + " compression filter is not available to the HDF5 library. Datasets will be written without compression.");
+        return;
+    }
     try {
-        return h5_file.createGroup(group_name.c_str());
+        this->dataset_creation_properties.setShuffle();  // Byte shuffling groups the similar exponent bytes of floats, which compress much better
+        if (compression == "gzip") {
+            this->dataset_creation_properties.setDeflate(compression_level);
+        } else if (compression == "szip") {
+            this->dataset_creation_properties.setSzip(H5_SZIP_NN_OPTION_MASK, compression_level);
+        } else if (compression == "lzf") {
+            this->dataset_creation_properties.setFilter(filter_ids[compression], H5Z_FLAG_OPTIONAL);
+        } else if (compression == "zstd") {
+            unsigned int zstd_level = compression_level;
+            this->dataset_creation_properties.setFilter(filter_ids[compression], H5Z_FLAG_OPTIONAL, 1, &zstd_level);
+        }
     } catch(H5::Exception& e) {
-        try {
-            return h5_file.openGroup(group_name.c_str());
-        } catch(H5::Exception& e) {
-            this->log_file->logErrorAndExit("Unable to create or open group " + group_name + ". " + e.getDetailMsg());
+        this->log_file->logWarning("Unable to set " + compression + " compression. " + e.getDetailMsg());
+    }
+    this->log_file->logVerbose("Numeric datasets will be chunked and written with " + compression + " compression.");
+}
+
+H5::DSetCreatPropList SpadeObject::dataset_properties (const int &rank, const hsize_t* dimensions, const size_t &type_size, const bool &split_components) {
+    if (!this->chunk_datasets) { return this->contiguous_dataset_properties; }
+    const hsize_t target_chunk_bytes = 1048576;  // Matches the default 1 MiB HDF5 chunk cache
+    const hsize_t minimum_chunked_bytes = 4096;  // Chunk index overhead outweighs any compression gain for smaller datasets
+    hsize_t dataset_bytes = type_size;
+    for (int i=0; i<rank; i++) { dataset_bytes *= dimensions[i]; }
+    if (dataset_bytes < minimum_chunked_bytes) { return this->contiguous_dataset_properties; }  // Also catches datasets with a zero dimension
+
+    vector<hsize_t> chunk_dimensions(dimensions, dimensions + rank);
+    if ((split_components) && (rank > 1)) { chunk_dimensions[rank - 1] = 1; }
+    if (this->chunk_shape.empty()) {
+        hsize_t row_bytes = type_size;
+        for (int i=1; i<rank; i++) { row_bytes *= chunk_dimensions[i]; }
+        chunk_dimensions[0] = std::max<hsize_t>(1, std::min<hsize_t>(dimensions[0], target_chunk_bytes / row_bytes));
+    } else {
+        for (int i=0; (i<rank) && (i<this->chunk_shape.size()); i++) {
+            chunk_dimensions[i] = std::min<hsize_t>(dimensions[i], this->chunk_shape[i]);
         }
     }
 
+    H5::DSetCreatPropList properties;
+    properties.copy(this->dataset_creation_properties);
+    properties.setChunk(rank, chunk_dimensions.data());
+    return properties;
+}
+
+H5::DSetCreatPropList SpadeObject::stacked_dataset_properties (const int &rank, const hsize_t* dimensions, const H5::PredType &data_type) {
+    // Extendible datasets must be chunked. Each chunk holds one frame so appending a frame never rewrites earlier chunks,
+    // and chunks are kept small so reading a few entities over all frames doesn't read whole frames.
+    const hsize_t target_chunk_bytes = 65536;
+    const hsize_t scalar_chunk_frames = 1024;  // Single values per frame, like the frame scales, would be tiny chunks otherwise
+    vector<hsize_t> chunk_dimensions(dimensions, dimensions + rank);
+    if (rank == 0) {
+        chunk_dimensions.push_back(scalar_chunk_frames);
+    } else if (this->chunk_shape.empty()) {
+        hsize_t row_bytes = data_type.getSize();
+        for (int i=1; i<rank; i++) { row_bytes *= chunk_dimensions[i]; }
+        chunk_dimensions[0] = std::max<hsize_t>(1, std::min<hsize_t>(dimensions[0], target_chunk_bytes / std::max<hsize_t>(1, row_bytes)));
+    } else {  // The chunk shape given by the user applies to the dimensions of a single frame
+        for (int i=0; (i<rank) && (i<this->chunk_shape.size()); i++) {
+            chunk_dimensions[i] = std::max<hsize_t>(1, std::min<hsize_t>(dimensions[i], this->chunk_shape[i]));
+        }
+    }
+    if (rank > 0) { chunk_dimensions.insert(chunk_dimensions.begin(), 1); }
+
+    H5::DSetCreatPropList properties;
+    properties.copy(this->dataset_creation_properties);
+    properties.setChunk(chunk_dimensions.size(), chunk_dimensions.data());
+    properties.setFillTime(H5D_FILL_TIME_IFSET);  // Frames missing from the file read as the fill value, even when the hdf5 file profile skips the fill
+    if (data_type == H5::PredType::NATIVE_FLOAT) {
+        float fill_value = NAN;
+        properties.setFillValue(data_type, &fill_value);
+    } else if (data_type == H5::PredType::NATIVE_DOUBLE) {
+        double fill_value = NAN;
+        properties.setFillValue(data_type, &fill_value);
+    } else if (data_type == H5::PredType::NATIVE_INT) {
+        int fill_value = -1;
+        properties.setFillValue(data_type, &fill_value);
+    }
+    return properties;
 }
 
 string SpadeObject::replace_slashes(const string &name) {
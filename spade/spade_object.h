@@ -2,14 +2,26 @@
 
 #include <vector>
 #include <array>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "H5Cpp.h"
 using namespace H5;
-#include <odb_API.h>
 #include <optional>
 
 #include "cmd_line_arguments.h"
 #include "logging.h"
+#include "h5_writer.h"
+#include "h5_file_profile.h"
+#include "field_invariants.h"
+#include "element_ingest.h"
+#include "model_source.h"
+#ifndef SPADE_WITHOUT_ABAQUS
+    #include <odb_API.h>
+    #include "odb_model_source.h"
+#endif
+#include "synthetic_model.h"
+#include "spade_types.h"
 
 
 #ifndef __SPADE_OBJECT_H_INCLUDED__
@@ -17,428 +29,22 @@ using namespace H5;
 
 using namespace std;
 
-struct job_data_type {
-    string analysisCode;
-    string creationTime;
-    string machineName;
-    string modificationTime;
-    string name;
-    string precision;
-    vector<string> productAddOns;
-    string version;
+struct manifest_step_type {  // What an appended extracted file already holds of a step, keyed by names with the slashes replaced
+    set<int> frames;
+    vector<int> new_frames;  // Frames extracted by this run that haven't been added to the manifest in the file yet
+    map<string, map<string, int>> history_samples;  // Samples written of each history output, keyed by history region and history output
 };
 
-struct sector_definition_type {
-    int numSectors;
-    string start_point;
-    string end_point;
+struct vtk_mesh_index_type {  // Where the mesh of an instance is stored in the points and cells of the vtk file
+    size_t point_offset = 0;  // Point of the first node, nodes follow in the order of their labels
+    const mesh_nodes_type* nodes = nullptr;
+    unordered_map<int, size_t> cell_index;  // Element label to its cell
 };
 
-struct section_point_type {
-    string number;
-    string description;
-};
-
-struct section_category_type {
-    string name;
-    string description;
-    vector<string> section_point_numbers;
-    vector<string> section_point_descriptions;
-};
-
-struct user_xy_data_type {
-    string name;
-    string sourceDescription;
-    string contentDescription;
-    string positionDescription;
-    string xAxisLabel;
-    string yAxisLabel;
-    string legendLabel;
-    string description;
-    vector<float> data;
-    int row_size;
-};
-
-struct tangential_behavior_type {
-    string formulation;
-    string directionality;
-    string slipRateDependency;  // Boolean
-    string pressureDependency;  // Boolean
-    string temperatureDependency;  // Boolean
-    int dependencies;
-    string exponentialDecayDefinition;
-    vector<vector<double>> table;  // Must remain as 2D vector due to varying sizes of columns
-    int max_column_size;
-    double shearStressLimit;  // String NONE or a double
-    string maximumElasticSlip;
-    double fraction;
-    double absoluteDistance;  // String NONE or a double
-    double elasticSlipStiffness;
-    int nStateDependentVars;
-    string useProperties;
-};
-
-struct element_type {
-    vector<int> connectivity;
-    section_category_type sectionCategory;
-    vector<string> instanceNames;
-    set<string> sets;
-};
-
-struct node_type {
-    vector<float> coordinates;
-    set<string> sets;
-};
-
-struct set_type {
-    string name;
-    string type;  // Enum [NODE_SET, ELEMENT_SET, SURFACE_SET]
-    int size;
-    vector<string> instanceNames;
-    map<int, node_type>* nodes;
-    map<string, map<int, element_type>>* elements; // accessed like elements[type][label] (e.g. elements['CAX4T'][1])
-    vector<string> faces;
-};
-
-struct contact_standard_type {
-    string sliding;  // Symbolic Constant [FINITE, SMALL]
-    double smooth;
-    double hcrit;
-    string limitSlideDistance;
-    double slideDistance;
-    double extensionZone;
-    string adjustMethod;  // Symbolic Constant [NONE, OVERCLOSED, TOLERANCE, SET]
-    double adjustTolerance;
-    string enforcement;  // Symbolic Constant [NODE_TO_SURFACE, SURFACE_TO_SURFACE]
-    string thickness;  // Boolean
-    string tied;  // Boolean
-    string contactTracking;  // Symbolic Constant [ONE_CONFIG, TWO_CONFIG]
-    string createStepName;
-
-    tangential_behavior_type interactionProperty;
-    set_type main;
-    set_type secondary;
-    set_type adjust;
-};
-
-struct contact_explicit_type {
-    string sliding;  // Symbolic Constant [FINITE, SMALL]
-    string mainNoThick;
-    string secondaryNoThick;
-    string mechanicalConstraint;
-    string weightingFactorType;
-    double weightingFactor;
-    string createStepName;
-    string useReverseDatumAxis;  // Boolean
-    string contactControls;
-  
-    tangential_behavior_type interactionProperty;
-    set_type main;
-    set_type secondary;
- 
-};
-
-struct tie_type {
-    set_type main;
-    set_type secondary;
-    string adjust;
-    string positionToleranceMethod;
-    string positionTolerance;
-    string tieRotations;
-    string constraintRatioMethod;
-    string constraintRatio;
-    string constraintEnforcement;
-    string thickness;
-};
-
-struct display_body_type {
-    string instanceName;
-    string referenceNode1InstanceName;
-    string referenceNode1Label;
-    string referenceNode2InstanceName;
-    string referenceNode2Label;
-    string referenceNode3InstanceName;
-    string referenceNode3Label;
-};
-
-struct datum_csys_type {
-    string name;
-    string type;
-    float x_axis[3];
-    float y_axis[3];
-    float z_axis[3];
-    float origin[3];
-};
-
-struct coupling_type {
-    set_type surface;
-    set_type refPoint;
-    set_type nodes;
-    string couplingType;
-    string weightingMethod;
-    string influenceRadius;
-
-    string u1;
-    string u2;
-    string u3;
-    string ur1;
-    string ur2;
-    string ur3;
-};
-
-struct mpc_type {
-    set_type surface;
-    set_type refPoint;
-    string mpcType;
-    string userMode;
-    string userType;
-};
-
-struct shell_solid_coupling_type {
-    set_type shellEdge;
-    set_type solidFace;
-    string positionToleranceMethod;
-    string positionTolerance;
-    string influenceDistanceMethod;
-    string influenceDistance;
-};
-
-struct constraint_type {
-    vector<tie_type> ties;
-    vector<display_body_type> display_bodies;
-    vector<coupling_type> couplings;
-    vector<mpc_type> mpc;
-    vector<shell_solid_coupling_type> shell_solid_couplings;
-};
-
-struct part_type {
-    string name;
-    string embeddedSpace;
-    map<int, node_type>* nodes;
-    map<string, map<int, element_type>>* elements; // accessed like elements[type][label] (e.g. elements['CAX4T'][1])
-    vector<set_type> nodeSets;
-    vector<set_type> elementSets;
-    vector<set_type> surfaces;
-};
-
-struct section_assignment_type {
-  set_type region;
-  string sectionName;
-};
-
-struct beam_orientation_type {
-  string method;
-  set_type region;
-  vector<float> beam_vector;  // vector is a reserved word, so had to name it something else
-};
-
-struct rebar_orientation_type {
-  string axis;
-  float angle;
-  set_type region;
-  datum_csys_type csys;
-};
-
-struct analytic_surface_segment_type {
-    string type;
-    vector<float> data;
-    int column_size;
-    int row_size;
-};
-
-struct analytic_surface_type {
-    string name;
-    string type;
-    double filletRadius;
-    vector<analytic_surface_segment_type> segments;
-    vector<vector<float>> localCoordData;  // Must remain as 2D vector due to varying sizes of columns
-    int max_column_size;
-};
-
-struct rigid_body_type {
-    string position;
-    string isothermal;  // Boolean
-    set_type referenceNode;
-    set_type elements;
-    set_type tieNodes;
-    set_type pinNodes;
-    analytic_surface_type analyticSurface;
-};
-
-struct instance_type {
-    string name;
-    string embeddedSpace;
-    map<int, node_type>* nodes;
-    map<string, map<int, element_type>>* elements; // accessed like elements[type][label] (e.g. elements['CAX4T'][1])
-    vector<set_type> nodeSets;
-    vector<set_type> elementSets;
-    vector<set_type> surfaces;
-    vector<rigid_body_type> rigidBodies;
-    vector<section_assignment_type> sectionAssignments;
-    vector<beam_orientation_type> beamOrientations;
-    vector<rebar_orientation_type> rebarOrientations;
-    analytic_surface_type analyticSurface;
-};
-
-struct mesh_type {
-    map<int, node_type> nodes;
-    map<string, map<int, element_type>> elements; // accessed like elements[type][label] (e.g. elements['CAX4T'][1])
-    map <string, set<int>> element_sets;
-    map <string, set<int>> node_sets;
-    int part_index;
-    int instance_index;
-};
-
-struct connector_orientation_type {
-    set_type region;
-    string axis1;  // SymbolicConstant
-    string axis2;  // SymbolicConstant
-    datum_csys_type localCsys1;
-    datum_csys_type localCsys2;
-    string orient2sameAs1; // Boolean
-    float angle1;
-    float angle2;
-};
-
-struct assembly_type {
-    string name;
-    string embeddedSpace;
-    map<int, node_type>* nodes;
-    map<string, map<int, element_type>>* elements; // accessed like elements[type][label] (e.g. elements['CAX4T'][1])
-    vector<set_type> nodeSets;
-    vector<set_type> elementSets;
-    vector<set_type> surfaces;
-    vector<instance_type> instances;
-    vector<datum_csys_type> datumCsyses;
-    vector<connector_orientation_type> connectorOrientations;
-};
-
-struct field_location_type {
-    string position;
-    vector<section_point_type> sectionPoint;
-};
-
-struct field_value_type {
-    vector<int> elementLabel;
-    vector<int> nodeLabel;
-    vector<int> integrationPoint;
-    vector<string> type;
-    vector<float> magnitude;
-    vector<float> tresca;
-    vector<float> press;
-    vector<float> inv3;
-    vector<float> maxPrincipal;
-    vector<float> midPrincipal;
-    vector<float> minPrincipal;
-    vector<float> maxInPlanePrincipal;
-    vector<float> minInPlanePrincipal;
-    vector<float> outOfPlanePrincipal;
-    vector<string> sectionPointNumber;
-    vector<string> sectionPointDescription;
-    bool magnitudeEmpty;
-    bool trescaEmpty;
-    bool pressEmpty;
-    bool inv3Empty;
-    bool maxPrincipalEmpty;
-    bool midPrincipalEmpty;
-    bool minPrincipalEmpty;
-    bool maxInPlanePrincipalEmpty;
-    bool minInPlanePrincipalEmpty;
-    bool outOfPlanePrincipalEmpty;
-
-    bool elementEmpty;
-    bool nodeEmpty;
-    bool integrationPointEmpty;
-    bool typeEmpty;
-    bool sectionPointNumberEmpty;
-    bool sectionPointDescriptionEmpty;
-};
-
-struct field_bulk_type {
-    string position;
-    string precision;
-    int orientationWidth;
-    int numberOfElements;
-    int length;
-    int valuesPerElement;
-    int width;
-    string baseElementType;
-    vector<vector<string>> faces;
-    vector<int> elementLabels;
-    vector<int> nodeLabels;
-    vector<int> integrationPoints;
-    vector<float> data;
-    vector<double> dataDouble;
-    vector<float> conjugateData;
-    vector<double> conjugateDataDouble;
-    vector<float> localCoordSystem;
-    vector<double> localCoordSystemDouble;
-    vector<float> mises;
-    vector<string> componentLabels;
-    bool emptyFaces;  // Keep track of whether any face data exists
-};
-
-struct field_data_type {
-    field_value_type fieldValues;
-    vector<field_bulk_type> bulkValues;
-};
-
-struct frame_type {
-    int number;
-    int incrementNumber;
-    int cyclicModeNumber;
-    int mode;
-    string description;
-    string domain;
-    float frameValue;
-    float frequency;
-    string loadCase;
-    int max_width;
-    int max_length;
-};
-
-struct history_point_type {
-    element_type element;
-    int element_label;
-    string elementType;
-    bool hasElement;
-    bool hasNode;
-    int ipNumber;
-    section_point_type sectionPoint;
-    string face;
-    string position;
-    int node_label;
-    float node_coordinates[3];
-    set_type region;
-    string assemblyName;  // Just storing the name not the entire assembly
-    string instanceName;  // Just storing the name not the entire instance
-};
-
-struct history_region_type {
-    string name;
-    string description;
-    string position;
-    history_point_type point;
-    string loadCase;
-};
-
-struct step_type {
-    string name;
-    string description;
-    string domain;
-    string previousStepName;
-    string procedure;
-    string nlgeom; // Boolean
-    int number;
-    double timePeriod;
-    double totalTime;
-    double mass;
-    double acousticMass;
-    vector<string> loadCases;
-    vector<double> massCenter;
-    vector<double> acousticMassCenter;
-    double inertiaAboutCenter[6];
-    double inertiaAboutOrigin[6];
+struct vtk_array_type {  // PointData or CellData array of the vtk file, which holds the rows of every step one after the other
+    int width = 1;
+    bool double_precision = false;
+    vector<long long> offsets;  // First row of each step, -1 for steps without data
 };
 
 /*!
@@ -446,6 +52,7 @@ struct step_type {
 */
 class SpadeObject {
     public:
+#ifndef SPADE_WITHOUT_ABAQUS
         //! The constructor.
         /*!
           The constructor checks to see if the odb file needs to be upgraded, upgrades if necessary, then opens it and calls the function to process the odb
@@ -454,6 +61,30 @@ class SpadeObject {
           \sa process_odb_without_steps()
         */
         SpadeObject (CmdLineArguments &command_line_arguments, Logging &log_file);
+#endif
+        //! The constructor for extracting a model that isn't read from an odb file
+        /*!
+          Read the mesh and the frames from a synthetic model, and write them with the same functions that write the data
+          read from an odb file. Only the hdf5 file type is written.
+          \param command_line_arguments CmdLineArguments object storing command line arguments
+          \param log_file Logging object for writing log messages
+          \param synthetic_model Source of the model and results data
+          \sa write_source_step_data_h5()
+        */
+        SpadeObject (CmdLineArguments &command_line_arguments, Logging &log_file, SyntheticModel &synthetic_model);
+        //! Set up the members shared by the constructors
+        /*!
+          \param command_line_arguments CmdLineArguments object storing command line arguments
+          \param log_file Logging object for writing log messages
+        */
+        void initialize (CmdLineArguments &command_line_arguments, Logging &log_file);
+        //! Open the extracted hdf5 file
+        /*!
+          Also set up the dataset and group creation properties used by all of the hdf5 writes. The file is created and opened with the properties of the h5-profile command line argument
+          \param append_file Open an existing file to add to it, instead of creating a new one
+          \return open hdf5 file
+        */
+        H5::H5File open_h5_file (const bool &append_file);
         //! Create sets of strings for arguments that can be given more than one string
         /*!
           Several command line options can have the value of 'all' or a single string or multiple strings. This function will build a set for each of those command line options. 
@@ -468,6 +99,7 @@ class SpadeObject {
           \sa create_string_sets()
         */
         set<string> create_string_set (const string &string_value, bool &all_given);
+#ifndef SPADE_WITHOUT_ABAQUS
         //! Process all but the steps data from the open odb file and store the results
         /*!
           After the odb has been opened this function will do the parsing, including calling of other functions needed for parsing
@@ -492,31 +124,76 @@ class SpadeObject {
           \sa process_odb()
         */
         tangential_behavior_type process_interaction_property (const odb_InteractionProperty &interaction_property);
+        //! Intern an odb_SectionCategory object used by mesh elements
+        /*!
+          Store each distinct section category once, so mesh elements only need to hold an index
+          \param section_category An odb_SectionCategory object in the odb
+          \return index of the section category in mesh_section_categories
+        */
+        int intern_section_category (const odb_SectionCategory &section_category);
+#endif
+        //! Intern an instance name used by mesh elements
+        /*!
+          \param instance_name Name of an instance referenced by an assembly level element
+          \return index of the instance name in mesh_instance_names
+        */
+        int intern_instance_name (const string &instance_name);
+        //! Intern the name of a node or element set
+        /*!
+          Store each set name once, so the meshes only need to hold an index for the sets they have labels of
+          \param set_name Name of a node, element, or surface set
+          \return index of the set name in mesh_set_names
+        */
+        int intern_set_name (const string &set_name);
+#ifndef SPADE_WITHOUT_ABAQUS
         //! Process odb_Node objects from the odb file
         /*!
-          Process odb_Node objects, save node data in multiple vectors inside a map, return pointer to location in map
+          Process odb_Node objects, append labels and coordinates of new nodes to the mesh node store, return pointer to the store
           \param nodes An odb_SequenceNode object in the odb
           \param instance_name An instance name where this node might be found
           \param assembly_name An assembly name where this node might be found
           \param set_name A set name where this node might be found
           \param part_name A part name where this node might be found
           \param embedded_space An int indicating what type of dimenions are being used
-          \return pointer to map that stores node data
+          \return pointer to the mesh node store
           \sa process_odb()
         */
-        map<int, node_type>* process_nodes (const odb_SequenceNode &nodes, const string &instance_name, const string &assembly_name, const string &set_name, const string &part_name, const int &embedded_space);
+        mesh_nodes_type* process_nodes (const odb_SequenceNode &nodes, const string &instance_name, const string &assembly_name, const string &set_name, const string &part_name, const int &embedded_space);
         //! Process odb_Element objects from the odb file
         /*!
-          Process odb_Element objects, save element data in data map, return pointer to location in map
+          Process odb_Element objects, append new elements to the mesh element store of their element type, return pointer to the stores
           \param elements An odb_Element object in the odb
           \param instance_name An instance name where this node might be found
           \param assembly_name An assembly name where this node might be found
           \param set_name A set name where this node might be found
           \param part_name A part name where this node might be found
-          \return pointer to map that stores element data
+          \return pointer to map of mesh element stores keyed by element type
           \sa process_odb()
         */
-        map<string, map<int, element_type>>* process_elements (const odb_SequenceElement &elements, const string &instance_name, const string &assembly_name, const string &set_name, const string &part_name);
+        map<string, mesh_elements_type>* process_elements (const odb_SequenceElement &elements, const string &instance_name, const string &assembly_name, const string &set_name, const string &part_name);
+#endif
+        //! Sort the mesh stores by label
+        /*!
+          Sort the node and element stores of every part, instance, and assembly mesh that had labels added out of order,
+          so the mesh writers can write straight from the stored arrays
+        */
+        void sort_mesh ();
+        //! Sort a mesh node store by label
+        /*!
+          \param nodes Mesh node store to be sorted in place
+        */
+        void sort_mesh_nodes (mesh_nodes_type &nodes);
+        //! Sort a mesh element store by label
+        /*!
+          \param elements Mesh element store to be sorted in place
+        */
+        void sort_mesh_elements (mesh_elements_type &elements);
+        //! Sort the labels of a mesh set and remove the repeated ones
+        /*!
+          \param mesh_set Mesh set to be sorted in place
+        */
+        void sort_mesh_set (mesh_set_type &mesh_set);
+#ifndef SPADE_WITHOUT_ABAQUS
         //! Process odb set object from the odb file
         /*!
           Process odb set object and return the values in an set_type
@@ -632,46 +309,65 @@ class SpadeObject {
           \sa process_odb()
         */
         assembly_type process_assembly (odb_Assembly &assembly, odb_Odb &odb);
-        //! Process field value from the odb file
+#endif
+        //! Move the processed blocks of a field output into a part that can be written on its own
         /*!
-          Process a field value object and store the results
-          \param field_value An odb field value object
-          \param invariants An odb sequence invariant object
-          \param values Data structure for storing processed data
-          \return field_value_type with data stored from the odb
-          \sa process_odb()
+          The part gets a copy of the field output metadata, the bulk data blocks, the instances without bulk data, and the field values written with them. The metadata is only written with the first part
+          \param field_output Processed field output data, left without bulk data blocks
+          \return part of the field output to be written
         */
-        void process_field_values(const odb_FieldValue &field_value, const odb_SequenceInvariant& invariants, field_value_type &values);
-        //! Return a string representing a type of field value
+        field_output_type split_field_output(field_output_type &field_output);
+        //! Handle a bulk data block just read from a model source
         /*!
-          From an odb_Enum return a string representation 
-          \param type An odb_Enum type to be represented as a string
-          \return string representation of odb_Enum
+          Compute the invariants of the block when they aren't read from the odb, and pass the blocks read so far to write_part whenever their size passes half of the memory ceiling
+          \param field_output Field output data, with the block just read at the end of its bulkValues
+          \param write_part Called with the field output to write the blocks read so far, it must take them with split_field_output(). Without it the whole field output is kept
+          \return number of bytes of the block
+          \sa ModelSource::read_field_output()
         */
-        string get_field_type_enum(odb_Enum::odb_DataTypeEnum type_enum);
-        //! Return a string representing a valid invariant enum
+        size_t add_field_bulk(field_output_type &field_output, const function<void(field_output_type&)> &write_part);
+        //! Check whether the field output of an instance is extracted
         /*!
-          From an odb_Enum return a string representation 
-          \param invariant An odb_Enum type to be represented as a string
-          \return string representation of odb_Enum
+          \param instance_name Name of the instance
+          \return true if the instance is selected with the instance command line argument and its partition isn't skipped
         */
-        string get_valid_invariant_enum(odb_Enum::odb_InvariantEnum invariant_enum);
-        //! Return a string representing a position enum
+        bool selected_instance(const string &instance_name);
+        //! Compute field output invariants from bulk data
         /*!
-          From an odb_Enum return a string representation 
-          \param invariant An odb_Enum type to be represented as a string
-          \return string representation of odb_Enum
+          Compute the valid invariants of a field output directly from the copied bulk data arrays, instead of reading them
+          from each field value in the odb. Mises is only computed if the odb didn't provide it with the bulk data.
+          \param field_output Processed field output data, providing the type, description, and valid invariants
+          \param field_bulk Processed field bulk data where the invariants are stored
+          \sa add_field_bulk()
         */
-        string get_position_enum(odb_Enum::odb_ResultPositionEnum position_enum);
-        //! Process a frame from the odb file
+        void compute_field_bulk_invariants(const field_output_type &field_output, field_bulk_type &field_bulk);
+        //! Approximate memory used by one block of processed bulk field output data
         /*!
-          Process a frame object and store the results
-          \param frame An odb frame object
-          \param number An integer storing the frame number
-          \return frame_type with data stored from the odb
-          \sa process_odb()
+          \param field_bulk Processed bulk field output data
+          \return number of bytes
+          \sa field_output_size()
+        */
+        size_t field_bulk_size(const field_bulk_type &field_bulk);
+        //! Approximate memory used by processed field output data
+        /*!
+          Add up the size of the arrays held by processed field output data, used to limit the memory waiting on the hdf5 writer
+          \param field_output Processed field output data
+          \return number of bytes
+          \sa field_bulk_size()
+        */
+        size_t field_output_size(const field_output_type &field_output);
+        //! Memory budget of the hdf5 writer thread
+        /*!
+          The write-buffer-mb command line argument, limited to half of the max-memory ceiling when one is given
+          \return number of bytes
+        */
+        size_t write_buffer_bytes();
+        //! Free the processed model data
+        /*!
+          Release the parts, assembly, meshes, sets, and other data outside of the steps once they have been written, so they don't take up memory while the frames are extracted
         */
-        frame_type process_frame (const odb_Frame &frame, const int &number);
+        void release_model();
+#ifndef SPADE_WITHOUT_ABAQUS
         //! Process a history point from the odb file
         /*!
           Process a history region point and store the results
@@ -688,6 +384,29 @@ class SpadeObject {
           \sa process_odb()
         */
         history_region_type process_history_region (const odb_HistoryRegion &history_region);
+        //! Read the requested history outputs of a history region into a single matrix
+        /*!
+          The matrix is sized once, from the number of requested history outputs and the union of their frame values, and
+          each history output is copied straight into its row. History outputs with fewer samples, or samples at other frame
+          values, leave NaN in the columns they have no sample for.
+          \param history_outputs The history outputs of an odb history region
+          \return history_matrix_type with the names, frame values, and data of the requested history outputs
+          \sa write_extract_history_output()
+        */
+        history_matrix_type read_history_matrix (const odb_HistoryOutputRepository &history_outputs);
+        //! Add the frame values of a history output to a sorted time axis
+        /*!
+          \param time_axis Sorted frame values, which usually already hold the frame values of the history output
+          \param data Data of a history output, with the frame value first in each sample
+        */
+        void merge_time_axis (vector<float> &time_axis, const odb_SequenceSequenceFloat &data);
+        //! Copy the values of a history output into its row of a history matrix
+        /*!
+          \param row First value of the row, which is already filled with NaN
+          \param time_axis Frame values of the columns of the row
+          \param data Data of a history output, with the frame value first in each sample
+        */
+        void fill_history_row (float* row, const vector<float> &time_axis, const odb_SequenceSequenceFloat &data);
         //! Process a step from the odb file
         /*!
           Process a step object and store the results
@@ -737,9 +456,10 @@ class SpadeObject {
           With the odb file still open and the h5 file open, loop through the history and field output data and read then write,
           rather than store all the data in memory then write it later
           \param odb An open odb object
+          \param model_source Source of the frames of the odb
           \param h5_file Open h5_file object for writing
         */
-        void write_step_data_h5 (odb_Odb &odb, H5::H5File &h5_file);
+        void write_step_data_h5 (odb_Odb &odb, ModelSource &model_source, H5::H5File &h5_file);
         //! Process and write the history output data from the odb
         /*!
           With the odb and the h5 file open, loop through and read then write the history output data
@@ -749,15 +469,39 @@ class SpadeObject {
           \param group_name Name of the group where data is to be written
         */
         void write_history_data_h5 (odb_Odb &odb, H5::H5File &h5_file, const odb_Step &step, const string &group_name);
-        //! Process and write the frame data from the odb
+#endif
+        //! Process and write the frame data of a step
         /*!
-          With the odb and the h5 file open, loop through and read then write the frame data
-          \param odb An open odb object
-          \param step An odb step object
+          With the model source and the h5 file open, loop through and read then write the frame data
+          \param model_source Source of the frames
           \param h5_file Open h5_file object for writing
+          \param step_name Name of the step
           \param group_name Name of the group where data is to be written
         */
-        void write_frame_data_h5 (odb_Odb &odb, H5::H5File &h5_file, const odb_Step &step, const string &group_name);
+        void write_frame_data_h5 (ModelSource &model_source, H5::H5File &h5_file, const string &step_name, const string &group_name);
+        //! Read and write the step data from a model source
+        /*!
+          Write the frame data of each step with write_frame_data_h5(), for a model source without history output
+          \param model_source Source of the model and results data
+          \param h5_file Open h5_file object for writing
+        */
+        void write_source_step_data_h5 (ModelSource &model_source, H5::H5File &h5_file);
+        //! Queue the write of the data describing a frame
+        /*!
+          \param h5_writer Writer that runs the hdf5 writes
+          \param h5_file Open h5_file object for writing
+          \param frame_group_name Name of the group of the frame
+          \param frame Frame data to be written
+        */
+        void enqueue_frame (H5Writer &h5_writer, H5::H5File &h5_file, const string &frame_group_name, const frame_type &frame);
+        //! Queue the write of the max width and length of a frame, once all of its field outputs have been read
+        /*!
+          \param h5_writer Writer that runs the hdf5 writes
+          \param h5_file Open h5_file object for writing
+          \param frame_group_name Name of the group of the frame
+          \param frame Frame data holding the max width and length
+        */
+        void enqueue_frame_size (H5Writer &h5_writer, H5::H5File &h5_file, const string &frame_group_name, const frame_type &frame);
 
 
         //Functions for writing out the data
@@ -781,27 +525,202 @@ class SpadeObject {
           \sa SpadeObject()
         */
         void write_h5_without_steps (H5::H5File &h5_file);
-        //! Write non-step output to an HDF5 file formatted in the vtk format
+        //! Write the mesh and field output to an HDF5 file formatted in the vtk format
         /*!
-          Write the parsed odb data to an HDF5 vtk formatted file
+          Write a time dependent VTKHDF UnstructuredGrid. The mesh of all the instances is written once and every step of the vtk file, which is a selected frame of the odb, uses it. Nodal field output is written to PointData and element field output is averaged over the integration points, section points, and element nodes of each element and written to CellData. Points and cells without a value in a step are NaN
+          \param model_source Source of the frames
           \param h5_file Open h5_file object for writing
           \sa SpadeObject()
+          \sa write_vtk_mesh()
+          \sa write_vtk_field_output()
+        */
+        void write_vtk_data (ModelSource &model_source, H5::H5File &h5_file);
+        //! Write the points and cells of the vtk file
+        /*!
+          Write the nodes of every instance and the root assembly as points and their elements as cells, storing where each instance was put in vtk_mesh_index. Elements without a matching vtk cell type are left out
+          \param h5_file Open h5_file object for writing
+          \sa add_vtk_mesh()
+          \sa vtk_cell_type()
+        */
+        void write_vtk_mesh (H5::H5File &h5_file);
+        //! Add the nodes and elements of an instance to the points and cells of the vtk file
+        /*!
+          \param instance_name Name of the instance, which field output blocks use to find its mesh
+          \param nodes Nodes of the instance
+          \param elements Elements of the instance
+          \param points Will store the coordinates of the nodes, three for each point
+          \param connectivity Will store the points of the cells
+          \param offsets Will store where the points of each cell start in connectivity
+          \param types Will store the vtk cell type of each cell
+        */
+        void add_vtk_mesh (const string &instance_name, const mesh_nodes_type &nodes, const map<string, mesh_elements_type> &elements, vector<float> &points, vector<long long> &connectivity, vector<long long> &offsets, vector<unsigned char> &types);
+        //! Get the vtk cell type of an Abaqus element
+        /*!
+          The shape of the cell is picked from the dimension of the element family and the number of nodes
+          \param element_type Abaqus element type, e.g. C3D8R
+          \param node_count Number of nodes of the element
+          \return vtk cell type, or 0 if there isn't a matching cell type
+        */
+        int vtk_cell_type (const string &element_type, const int &node_count);
+        //! Write one frame of field output to the PointData or CellData of the vtk file
+        /*!
+          \param h5_file Open h5_file object for writing
+          \param step_index Index of the vtk step holding the frame
+          \param field_output Data to be written
+          \sa write_vtk_array()
+        */
+        void write_vtk_field_output (H5::H5File &h5_file, const int &step_index, field_output_type &field_output);
+        //! Append one step of a PointData or CellData array
+        /*!
+          \param group PointData or CellData group
+          \param arrays Arrays already written to the group
+          \param array_name Name of the array
+          \param step_index Index of the vtk step
+          \param row_size Number of points or cells
+          \param width Number of components
+          \param double_precision Whether the array is written with double precision
+          \param values Values of the step, width values for each row
+        */
+        void write_vtk_array (const H5::Group &group, map<string, vtk_array_type> &arrays, const string &array_name, const int &step_index, const size_t &row_size, const int &width, const bool &double_precision, const vector<double> &values);
+        //! Write the Steps group of the vtk file
+        /*!
+          Fill the steps of each array that have no data with NaN values and write the offsets of every step
+          \param h5_file Open h5_file object for writing
+          \param step_values Time of each vtk step
+        */
+        void write_vtk_steps (H5::H5File &h5_file, const vector<double> &step_values);
+        //! Get the frames of a step selected with the frame and frame-value command line arguments
+        /*!
+          \param model_source Source of the frames
+          \param step_name Name of the step
+          \return indices of the selected frames
+        */
+        vector<int> select_frames (ModelSource &model_source, const string &step_name);
+        //! Check whether a selected frame is left to another worker or an earlier run
+        /*!
+          Without the split-by option the frames are shared round-robin between the shards. Split by step or frame range, the frames are skipped when their partition is
+          \param step_name Name of the step
+          \param frame_number Number of the frame in the step
+          \return true if the frame isn't extracted by this run
+          \sa skip_partition()
+        */
+        bool skip_frame (const string &step_name, const int &frame_number);
+        //! Check whether a partition of the split-by option is left to another worker or an earlier run
+        /*!
+          The partitions are shared round-robin between the shards in the order they are found, which is the same for every shard. A partition whose file exists was completed by an earlier run, so its file is only linked to again if it was written from the same odb file with the same options, otherwise it is removed and written again
+          \param partition Name of the partition, e.g. step_Step-1 or field_U
+          \return true if the partition isn't written by this run
+          \sa finish_partitions()
+        */
+        bool skip_partition (const string &partition);
+        //! Check whether a partition file of an earlier run was written from the same odb file with the same options
+        /*!
+          \param file_name Name of the partition file
+          \return true if the manifest attribute of the partition file matches the one this run writes
+          \sa skip_partition()
         */
-        void write_vtk_data (H5::H5File &h5_file);
+        bool partition_matches (const string &file_name);
+        //! Return the name of the frame-range partition a frame belongs to
+        /*!
+          \param step_name Name of the step with the slashes replaced
+          \param frame_number Number of the frame in the step
+          \return partition name holding the step name and the first and last frame numbers of the range
+        */
+        string frame_range_partition (const string &step_name, const int &frame_number);
+        //! Find the group linked to a partition file that holds a group of the extracted file
+        /*!
+          The partition groups are the frame groups of the odb format or the step and frame groups of the extract format when split by step or frame range, and the field output or instance groups below them when split by field or instance
+          \param group_name Full path of a group
+          \param partition Will store the name of the partition holding the group
+          \return full path of the partition group, empty if the group isn't in a partition
+        */
+        string partition_root (const string &group_name, string &partition);
+        //! Return the name of the file a partition is written to
+        /*!
+          \param partition Name of the partition
+          \return partition prefix followed by the partition name, with characters other than letters, numbers, dots, and dashes replaced
+        */
+        string partition_file_name (const string &partition);
+        //! Create the partition group holding a group in its partition file and link to it from the extracted file
+        /*!
+          The partition file is written under a temporary name until finish_partitions() renames it, so a file that exists under its own name is always complete
+          \param h5_file Open h5_file object for writing
+          \param group_name Full path of the group about to be opened or created
+          \sa open_subgroup()
+        */
+        void open_partition (H5::H5File &h5_file, const string &group_name);
+        //! Replace a link of the extracted file with an external link to a partition group
+        /*!
+          \param h5_file Open h5_file object for writing
+          \param root_name Full path of the partition group, which is the same in both files
+          \param file_name Name of the partition file, relative to the directory of the extracted file
+        */
+        void link_partition (H5::H5File &h5_file, const string &root_name, const string &file_name);
+        //! Link the partition groups of a partition file completed by an earlier run
+        /*!
+          \param h5_file Open h5_file object for writing
+          \param partition_file Open partition file
+          \param group_name Full path of the group of the partition file to search
+          \param file_name Name of the partition file, relative to the directory of the extracted file
+        */
+        void link_partition_groups (H5::H5File &h5_file, H5::H5File &partition_file, const string &group_name, const string &file_name);
+        //! Rename the partition files written by this run and link the extracted file to them and to the partition files of earlier runs
+        /*!
+          Has to be called after the writes are finished and the groups are closed, which closes the partition files
+          \param h5_file Open h5_file object for writing
+        */
+        void finish_partitions (H5::H5File &h5_file);
+        //! Read the manifest of an extracted file that is being appended to
+        /*!
+          The manifest group lists the frames and the number of history output samples already extracted for each step, so only the frames and samples written to the odb since then are extracted
+          \param h5_file Open h5_file object holding the manifest
+          \sa write_manifest_step()
+        */
+        void read_manifest (H5::H5File &h5_file);
+        //! Add the frames and history output samples extracted from a step to the manifest
+        /*!
+          \param h5_file Open h5_file object for writing
+          \param step_name Name of the step with the slashes replaced
+          \sa read_manifest()
+        */
+        void write_manifest_step (H5::H5File &h5_file, const string &step_name);
         //! Open hdf5 subgroup and create it and it's parent groups if they don't exist
         /*!
-          Open and return hdf5 group, if it doesn't exist then create it, if it's parent groups don't exist create them
+          Open and return hdf5 group, if it doesn't exist then create it, if it's parent groups don't exist create them in the same call. Opened groups are kept in a cache keyed by path, so asking for the same group again returns the open handle without touching the file
           \param h5_file Open h5_file object for writing
           \param sub_group_name Name of the sub group to open or create
           \param exists Boolean indicating if the sub group already exists
+          \sa close_groups()
         */
         H5::Group open_subgroup(H5::H5File &h5_file, const string &sub_group_name, bool &exists);
+        //! Check whether a group exists in the hdf5 file
+        /*!
+          Check each level of the path in turn, since checking for a link below a missing group is an error in hdf5
+          \param h5_file Open h5_file object for writing
+          \param group_name Full path of the group
+          \return true if every group in the path exists
+        */
+        bool group_exists(H5::H5File &h5_file, const string &group_name);
+        //! Close the groups held in the group cache
+        /*!
+          Must be called before closing the hdf5 file
+          \sa open_subgroup()
+        */
+        void close_groups();
         //! Write mesh data to an HDF5 file
         /*!
           Write mesh data in an extract format where all element and node data is in a single place
           \param h5_file Open h5_file object for writing
         */
         void write_mesh(H5::H5File &h5_file);
+        //! Write the node and element sets of a mesh in the extract format
+        /*!
+          Write each set as a dataset of labels in the element_sets and node_sets groups
+          \param h5_file Open h5_file object for writing
+          \param group_name Name of the part, assembly, or instance group holding the mesh
+          \param mesh Mesh with the sets to be written
+        */
+        void write_mesh_sets(H5::H5File &h5_file, const string &group_name, const mesh_type &mesh);
         //! Write mesh node data to an HDF5 file
         /*!
           Write mesh node data in an extract format
@@ -811,7 +730,7 @@ class SpadeObject {
           \param nodes node data to be written
           \param embedded_space string indicating what type of embedded space, which indicates the dimensions
         */
-        void write_mesh_nodes(H5::H5File &h5_file, H5::Group &group, string &group_name, map<int, node_type> nodes, const string embedded_space);
+        void write_mesh_nodes(H5::H5File &h5_file, H5::Group &group, const string &group_name, const mesh_nodes_type &nodes, const string &embedded_space);
         //! Write mesh element data to an HDF5 file
         /*!
           Write mesh element data in an extract format
@@ -820,7 +739,7 @@ class SpadeObject {
           \param group_name Name of group for writing data
           \param elements element data to be written
         */
-        void write_mesh_elements(H5::H5File &h5_file, H5::Group &group, string &group_name, map<string, map<int, element_type>> elements);
+        void write_mesh_elements(H5::H5File &h5_file, H5::Group &group, const string &group_name, const map<string, mesh_elements_type> &elements);
         //! Create the necessary group and parent groups for writing history region and output data in the hdf5 file
         /*!
           Create the necessary groups and store the name in the passed in group name argument
@@ -849,21 +768,19 @@ class SpadeObject {
           \param h5_file Open h5_file object for writing
           \param group_name Name of the group where data is to be written
           \param field_bulk_data Data to be written
-          \param complex_data Boolean indicating if the data is complex
-          \param write_mises Boolean indicating if mises data should be written
         */
-        void write_field_bulk_data(H5::H5File &h5_file, const string &group_name, const odb_FieldBulkData &field_bulk_data, bool complex_data, bool write_mises);
+        void write_field_bulk_data(H5::H5File &h5_file, const string &group_name, field_bulk_type &field_bulk_data);
         //! Write field bulk data in the extract format to an HDF5 file
         /*!
           Write field bulk data into an HDF5 file in the extract format
           \param h5_file Open h5_file object for writing
           \param group_name Name of the group where data is to be written
           \param field_bulk_data Data to be written
-          \param complex_data Boolean indicating if the data is complex
-          \param write_mises Boolean indicating if mises data should be written
           \param field_output_safe_name Safe name (i.e. no slashes) of field output data
+          \param frame_key Name of the group with the frame left out, used to find the same block in earlier frames of the step
+          \sa link_frame_datasets()
         */
-        void write_extract_field_bulk_data(H5::H5File &h5_file, const string &group_name, const odb_FieldBulkData &field_bulk_data, bool complex_data, bool write_mises, string field_output_safe_name);
+        void write_extract_field_bulk_data(H5::H5File &h5_file, const string &group_name, field_bulk_type &field_bulk_data, const string &field_output_safe_name, const string &frame_key);
         //! Write field value data to an HDF5 file
         /*!
           Write field value data into an HDF5 file
@@ -873,27 +790,156 @@ class SpadeObject {
           \param values Data to be written
         */
         void write_field_values(H5::H5File &h5_file, const string &group_name, H5::Group &group, field_value_type &values);
-        //! Write all field output data to an HDF5 file
+        //! Return the function queueing the writes of the field outputs of a frame
+        /*!
+          The function takes the blocks read so far from a field output and queues them to be written in the format and layout
+          given on the command line. In the odb format, the write of the fieldOutputs group of the frame is queued first.
+          \param h5_writer Writer that runs the hdf5 writes
+          \param h5_file Open h5_file object for writing
+          \param frame_group_name Name of the group of the frame in the odb format
+          \param frame_number Frame number of frame with field output data to be written
+          \param frame_index Position of the frame among the frames being written in the step, used by the stacked layout
+          \param step_name Name of step where data is to be written
+          \param frame_value Value of the frame, used by the stacked layout
+          \return function queueing the writes of a field output
+        */
+        function<void(field_output_type&)> field_output_writer(H5Writer &h5_writer, H5::H5File &h5_file, const string &frame_group_name, const string &frame_number, const int &frame_index, const string &step_name, const float &frame_value);
+        //! Write field output data to an HDF5 file
+        /*!
+          Write processed field output data into an HDF5 file
+          \param h5_file Open h5_file object for writing
+          \param group_name Name of the group where data is to be written
+          \param field_output Data to be written
+        */
+        void write_field_output(H5::H5File &h5_file, const string &group_name, field_output_type &field_output);
+        //! Write field output data in the extract format to an HDF5 file
+        /*!
+          Write processed field output data into an HDF5 file in the extract format
+          \param h5_file Open h5_file object for writing
+          \param frame_number Frame number of frame with field output data to be written
+          \param step_name Name of step where data is to be written
+          \param field_output Data to be written
+        */
+        void write_extract_field_output(H5::H5File &h5_file, const string &frame_number, const string &step_name, field_output_type &field_output);
+        //! Write field output metadata to an HDF5 file
+        /*!
+          Write the description, type, dimensions, labels, and locations of a field output into an HDF5 file
+          \param h5_file Open h5_file object for writing
+          \param group_name Name of the group where data is to be written
+          \param group Group where data is to be written
+          \param field_output Data to be written
+        */
+        void write_field_output_metadata(H5::H5File &h5_file, const string &group_name, const H5::Group &group, const field_output_type &field_output);
+        //! Write the name attribute of a field output group unless an earlier frame or block already wrote it
+        /*!
+          \param h5_file Open h5 file object to write to
+          \param group_name Name of the field output group
+          \param field_output_name Name of the field output
+        */
+        void write_field_output_name(H5::H5File &h5_file, const string &group_name, const string &field_output_name);
+        //! Write the single value field output metadata to an HDF5 group
         /*!
-          Write all field output data into an HDF5 file
+          Write the description, type, and dimensions of a field output, which are attributes of the group with the attributes metadata layout
+          \param group Group where data is to be written
+          \param field_output Data to be written
+          \sa write_field_output_metadata()
+        */
+        void write_field_output_scalars(const H5::Group &group, const field_output_type &field_output);
+        //! Write field output metadata for a frame of the extract format to an HDF5 file
+        /*!
+          Link to the metadata written for an earlier frame of the step if it hasn't changed, otherwise write it. Attributes can't be linked, so with the attributes metadata layout the single values are written to every frame
           \param h5_file Open h5_file object for writing
-          \param frame Frame with field output data to be written
           \param group_name Name of the group where data is to be written
-          \param max_width Will store the max width of the frame
-          \param max_length Will store the max length of the frame
+          \param group Group where data is to be written
+          \param step_group_name Name of the step group holding the frame groups
+          \param field_output Data to be written
+          \sa write_field_output_metadata()
+          \sa link_frame_datasets()
         */
-        void write_field_outputs(H5::H5File &h5_file, const odb_Frame &frame, const string &group_name, int &max_width, int &max_length);
-        //! Write all field output data to an HDF5 file
+        void write_frame_field_output_metadata(H5::H5File &h5_file, const string &group_name, const H5::Group &group, const string &step_group_name, const field_output_type &field_output);
+        //! Hard link to datasets that haven't changed since an earlier frame of the step
         /*!
-          Write all field output data into an HDF5 file
+          Datasets such as labels and metadata are usually the same in every frame of a step. Look up the content of the datasets written for frame_key in an earlier frame and, if its size and bytes match, make hard links to them in group. Otherwise remember group_name as the place to link to from later frames, so the caller writes fresh datasets whenever the content changes. Dimension scales are not linked, since attaching the datasets of every frame to one scale would grow its reference list without limit
           \param h5_file Open h5_file object for writing
-          \param frame Frame with field output data to be written
+          \param group Group where the links are to be made
+          \param group_name Name of the group where the datasets are to be written
+          \param frame_key Name identifying the datasets with the frame left out
+          \param dataset_names Names of the datasets or groups to link
+          \param content Bytes of the content of the datasets, e.g. their dimensions and data
+          \return true if the datasets were linked or already written or linked to group_name, false if the caller must write them
+        */
+        bool link_frame_datasets(H5::H5File &h5_file, const H5::Group &group, const string &group_name, const string &frame_key, const vector<string> &dataset_names, const string &content);
+        //! Append an array of bytes to the content of datasets
+        /*!
+          \param content Content of the datasets to append to
+          \param data Pointer to the bytes to append
+          \param bytes Number of bytes to append
+          \sa link_frame_datasets()
+        */
+        void append_bytes(string &content, const void* data, const size_t &bytes);
+        //! Append a vector of strings to the content of datasets
+        /*!
+          \param content Content of the datasets to append to
+          \param strings Strings to append, each after its size
+          \sa append_bytes()
+        */
+        void append_strings(string &content, const vector<string> &strings);
+        //! Write field output data in the stacked extract layout to an HDF5 file
+        /*!
+          Append one frame of processed field output data to the extendible datasets of the stacked layout, which have one
+          group per instance, field output, and step instead of one group per frame
+          \param h5_file Open h5_file object for writing
+          \param frame_index Position of the frame along the leading dimension of the stacked datasets
           \param frame_number Frame number of frame with field output data to be written
+          \param frame_value Frame value of frame with field output data to be written
           \param step_name Name of step where data is to be written
-          \param max_width Will store the max width of the frame
-          \param max_length Will store the max length of the frame
+          \param field_output Data to be written
+          \sa write_stacked_array()
+        */
+        void write_stacked_field_output(H5::H5File &h5_file, const int &frame_index, const int &frame_number, const float &frame_value, const string &step_name, field_output_type &field_output);
+        //! Append a frame to the frame_values and frame_numbers dimension scales of a step group
+        /*!
+          \param step_group Group holding the stacked data for a field output and step
+          \param frame_index Position of the frame along the leading dimension of the stacked datasets
+          \param frame_number Frame number to be written
+          \param frame_value Frame value to be written
+        */
+        void write_frame_scales(const H5::Group &step_group, const int &frame_index, const int &frame_number, const float &frame_value);
+        //! Attach dimension scales to a newly created stacked dataset
+        /*!
+          Label the leading dimension 'frames' and attach the frame_values and frame_numbers scales to it, then label the remaining dimensions and attach their scales if they exist
+          \param step_group Group holding the frame scales
+          \param group Group holding the scales of the remaining dimensions
+          \param dataset Stacked dataset
+          \param dimension_scales Pairs of dimension label and scale dataset name for the dimensions after the leading one
         */
-        void write_extract_field_outputs(H5::H5File &h5_file, const odb_Frame &frame, const string &frame_number, const string &step_name, int &max_width, int &max_length);
+        void attach_stacked_scales(const H5::Group &step_group, const H5::Group &group, const H5::DataSet &dataset, const vector<pair<string, string>> &dimension_scales);
+        //! Write field value data in the stacked layout to an HDF5 file
+        /*!
+          Write the labels of the field values with the first frame and append the invariants of each frame
+          \param group Group where data is to be written
+          \param frame_index Position of the frame along the leading dimension of the stacked datasets
+          \param values Data to be written
+        */
+        void write_stacked_field_values(const H5::Group &group, const int &frame_index, field_value_type &values);
+        //! Write field bulk data in the stacked layout to an HDF5 file
+        /*!
+          Write the labels and dimension scales of a block with the first frame and append the data of each frame
+          \param step_group Group holding the stacked data for a field output and step
+          \param group_name Name of the block group inside the step group
+          \param frame_index Position of the frame along the leading dimension of the stacked datasets
+          \param field_bulk_data Data to be written
+          \param field_output_safe_name Safe name (i.e. no slashes) of field output data
+        */
+        void write_stacked_field_bulk_data(const H5::Group &step_group, const string &group_name, const int &frame_index, field_bulk_type &field_bulk_data, const string &field_output_safe_name);
+        //! Get the label of each element in a block of field bulk data
+        /*!
+          The element labels of bulk data are repeated for every integration point, so take the first label in each row
+          \param field_bulk_data Data holding the element labels
+          \param number_of_integration_points Number of labels stored for each element
+          \return one label per element, used as the elements dimension scale
+        */
+        vector<int> first_element_labels(const field_bulk_type &field_bulk_data, const int &number_of_integration_points);
         //! Write frames data to an HDF5 file
         /*!
           Write frames data into an HDF5 file
@@ -910,22 +956,27 @@ class SpadeObject {
           \param history_point Data to be written
         */
         void write_history_point(H5::H5File &h5_file, const string &group_name, history_point_type &history_point);
+#ifndef SPADE_WITHOUT_ABAQUS
         //! Write history output data to an HDF5 file
         /*!
           Write history output data into an HDF5 file
           \param h5_file Open h5_file object for writing
           \param group_name Name of the group where data is to be written
           \param history_output Data to be written
+          \param samples Number of samples already written, which are skipped, and updated to the number of samples in the odb
         */
-        void write_history_output(H5::H5File &h5_file, const string &group_name, const odb_HistoryOutput &history_output);
+        void write_history_output(H5::H5File &h5_file, const string &group_name, const odb_HistoryOutput &history_output, int &samples);
         //! Write extract history output data to an HDF5 file
         /*!
           Write history output data into an HDF5 file in the extract format
           \param h5_file Open h5_file object for writing
           \param group_name Name of the group where data is to be written
           \param history_outputs Data to be written
+          \param samples Number of frame values already written, which are skipped, and updated to the number of frame values in the odb
+          \param conjugate_samples Number of conjugate frame values already written, which are counted apart from the frame values since the conjugate data has a time axis of its own
         */
-        void write_extract_history_output(H5::H5File &h5_file, const string &group_name, const odb_HistoryOutputRepository &history_outputs);
+        void write_extract_history_output(H5::H5File &h5_file, const string &group_name, const odb_HistoryOutputRepository &history_outputs, int &samples, int &conjugate_samples);
+#endif
         //! Write history region data to an HDF5 file
         /*!
           Write history region data into an HDF5 file
@@ -957,7 +1008,7 @@ class SpadeObject {
           \param group_name Name of the group where data is to be written
           \param instance Data to be written
         */
-        void write_instance(H5::H5File &h5_file, H5::Group &group, const string &group_name, instance_type instance);
+        void write_instance(H5::H5File &h5_file, H5::Group &group, const string &group_name, const instance_type &instance);
         //! Write Analytic Surface data to an HDF5 file
         /*!
           Write Analytic Surface data into an HDF5 file
@@ -965,7 +1016,7 @@ class SpadeObject {
           \param group_name Name of the group where data is to be written
           \param analytic_surface Data to be written
         */
-        void write_analytic_surface(H5::H5File &h5_file, const string &group_name, analytic_surface_type &analytic_surface);
+        void write_analytic_surface(H5::H5File &h5_file, const string &group_name, const analytic_surface_type &analytic_surface);
         //! Write Datum Csys data to an HDF5 file
         /*!
           Write Datum Csys data into an HDF5 file
@@ -1004,7 +1055,7 @@ class SpadeObject {
           \param group_name Name of the group where data is to be written
           \param elements Element data to be written
         */
-        void write_elements(H5::H5File &h5_file, H5::Group &group, const string &group_name, map<string, map<int, element_type>>* elements);
+        void write_elements(H5::H5File &h5_file, H5::Group &group, const string &group_name, const map<string, mesh_elements_type>* elements);
         //! Write element set data to an HDF5 file
         /*!
           Write vector of element set data into an HDF5 file
@@ -1012,7 +1063,7 @@ class SpadeObject {
           \param group HDF5 group in which to write the new data
           \param element_set Element set data to be written
         */
-        void write_element_set(H5::H5File &h5_file, H5::Group &group, set<int> element_set);
+        void write_element_set(H5::H5File &h5_file, H5::Group &group, const mesh_set_type &element_set);
         //! Write node data to an HDF5 file
         //! Write nodes data to an HDF5 file
         /*!
@@ -1023,7 +1074,7 @@ class SpadeObject {
           \param nodes Node data to be written
           \param set_name String with the name of the set if given
         */
-        void write_nodes(H5::H5File &h5_file, H5::Group &group, const string &group_name, const map<int, node_type>* nodes, const string &set_name);
+        void write_nodes(H5::H5File &h5_file, H5::Group &group, const string &group_name, const mesh_nodes_type* nodes, const string &set_name);
         //! Write node set data to an HDF5 file
         /*!
           Write vector of node set data into an HDF5 file
@@ -1031,27 +1082,27 @@ class SpadeObject {
           \param group HDF5 group in which to write the new data
           \param node_set Node set data to be written
         */
-        void write_node_set(H5::H5File &h5_file, H5::Group &group, set<int> node_set);
+        void write_node_set(H5::H5File &h5_file, H5::Group &group, const mesh_set_type &node_set);
         //! Write sets data to an HDF5 file
         /*!
           Write vector of set data into an HDF5 file
           \param h5_file Open h5_file object for writing
           \param group_name Name of the group where data is to be written
           \param sets Vector of set data to be written
-          \param element_sets Map of element set data
-          \param node_sets Map of node set data
+          \param element_sets Element sets of the mesh, keyed by set name index
+          \param node_sets Node sets of the mesh, keyed by set name index
         */
-        void write_sets(H5::H5File &h5_file, const string &group_name, const vector<set_type> &sets, map<string, set<int>> element_sets, map<string, set<int>> node_sets);
+        void write_sets(H5::H5File &h5_file, const string &group_name, const vector<set_type> &sets, const map<int, mesh_set_type> &element_sets, const map<int, mesh_set_type> &node_sets);
         //! Write set data to an HDF5 file
         /*!
           Write data from a set type into an HDF5 file
           \param h5_file Open h5_file object for writing
           \param group_name Name of the group where data is to be written
           \param odb_set Set data to be written
-          \param element_set Set of element numbers
-          \param node_set Set of node numbers
+          \param element_set Sorted element labels of the set, or nullptr if there is none
+          \param node_set Sorted node labels of the set, or nullptr if there is none
         */
-        void write_set(H5::H5File &h5_file, const string &group_name, const set_type &odb_set, optional<set <int>> element_set, optional<set <int>> node_set);
+        void write_set(H5::H5File &h5_file, const string &group_name, const set_type &odb_set, const mesh_set_type* element_set, const mesh_set_type* node_set);
         //! Write a section category type to an HDF5 file
         /*!
           Write data from section category type into an HDF5 file
@@ -1087,6 +1138,15 @@ class SpadeObject {
           \param int_array The integer array that should be written in the new attribute
         */
         void write_integer_array_attribute(const H5::Group &group, const string &attribute_name, const int array_size, const int* int_array);
+        //! Write a single number as an attribute
+        /*!
+          Create a scalar attribute holding one value of the given type, unless the group already has the attribute
+          \param group Name of HDF5 group in which to write the new attribute
+          \param attribute_name Name of the new attribute
+          \param data_type Type of the value
+          \param value Pointer to the value
+        */
+        void write_scalar_attribute(const H5::Group &group, const string &attribute_name, const H5::PredType &data_type, const void* value);
         //! Write a vector of strings as an attribute
         /*!
           Create an attribute with a vector of strings using the passed-in values
@@ -1098,7 +1158,7 @@ class SpadeObject {
         void write_vector_attribute(const H5::Group &group, const string &attribute_name, const vector<string> &string_values);
         //! Write a string as a dataset
         /*!
-          Create a dataset with a single string using the passed-in values
+          Create a dataset with a single string using the passed-in values. The string is written as an attribute of the group instead with the attributes metadata layout, and the dataset is compact with the compact metadata layout
           \param group Name of HDF5 group in which to write the new dataset
           \param dataset_name Name of the new dataset where a string is to be written
           \param string_value The string that should be written in the new dataset
@@ -1122,21 +1182,12 @@ class SpadeObject {
         void write_c_string_vector_dataset(const H5::Group &group, const string &dataset_name, vector<const char*> &string_values);
         //! Write an integer as a dataset
         /*!
-          Create a dataset with an integer using the passed-in value
+          Create a dataset with an integer using the passed-in value. The integer is written as an attribute of the group instead with the attributes metadata layout, and the dataset is compact with the compact metadata layout
           \param group Name of HDF5 group in which to write the new dataset
           \param dataset_name Name of the new dataset where an integer is to be written
           \param int_value The integer that should be written in the new dataset
         */
         void write_integer_dataset(const H5::Group &group, const string &dataset_name, const int &int_value);
-        //! Write a two dimensional vector of C strings as a dataset
-        /*!
-          Create a dataset with a two-dimensional array of strings using the passed-in values
-          \param group Name of HDF5 group in which to write the new dataset
-          \param dataset_name Name of the new dataset where a two-dimensional array is to be written
-          \param column_size Integer indicating the column dimension, row dimension is determined by size of data_array
-          \param string_data The vector of vectors of strings that should be written in the new dataset
-        */
-        void write_c_string_2D_vector(const H5::Group& group, const string & dataset_name, const int & column_size, vector<const char*> & string_data);
         //! Write an integer array as a dataset
         /*!
           Create a dataset with an array of integers using the passed-in value
@@ -1155,6 +1206,17 @@ class SpadeObject {
           \sa write_integer_array_dataset()
         */
         void write_integer_vector_dataset(const H5::Group &group, const string &dataset_name, const vector<int> &int_data);
+        //! Write the codes of an enumerated column as a dataset of an HDF5 enumerated type
+        /*!
+          The enumerated type stores the name of each code once, so the dataset holds a small integer per value instead of a variable length string
+          \param group Name of HDF5 group in which to write the new dataset
+          \param dataset_name Name of the new dataset
+          \param enum_type Enumerated type of the codes
+          \param rank Number of dimensions of the dataset
+          \param dimensions Size of each dimension of the dataset
+          \param codes Codes in the base type of the enumerated type
+        */
+        void write_enum_dataset(const H5::Group &group, const string &dataset_name, const H5::EnumType &enum_type, const int &rank, const hsize_t* dimensions, const void* codes);
         //! Write an array of arrays of integers as a dataset
         /*!
           Create a dataset with a two-dimensional array of integers using the passed-in values
@@ -1167,7 +1229,7 @@ class SpadeObject {
         void write_integer_2D_array(const H5::Group& group, const string & dataset_name, const int &row_size, const int &column_size, int *integer_array);
         //! Write an float as a dataset
         /*!
-          Create a dataset with a float using the passed-in value
+          Create a dataset with a float using the passed-in value. The float is written as an attribute of the group instead with the attributes metadata layout, and the dataset is compact with the compact metadata layout
           \param group Name of HDF5 group in which to write the new dataset
           \param dataset_name Name of the new dataset where a float is to be written
           \param float_value The float that should be written in the new dataset
@@ -1230,10 +1292,10 @@ class SpadeObject {
           \param data_array The vector of vectors of floats that should be written in the new dataset
           \sa write_float_2D_array()
         */
-        void write_float_2D_vector(const H5::Group &group, const string &dataset_name, const int &max_column_size, vector<vector<float>> &data_array);
+        void write_float_2D_vector(const H5::Group &group, const string &dataset_name, const int &max_column_size, const vector<vector<float>> &data_array);
         //! Write an double as a dataset
         /*!
-          Create a dataset with a double using the passed-in value
+          Create a dataset with a double using the passed-in value. The double is written as an attribute of the group instead with the attributes metadata layout, and the dataset is compact with the compact metadata layout
           \param group Name of HDF5 group in which to write the new dataset
           \param dataset_name Name of the new dataset where a double is to be written
           \param double_value The double that should be written in the new dataset
@@ -1256,6 +1318,51 @@ class SpadeObject {
           \sa write_double_array_dataset()
         */
         void write_double_vector_dataset(const H5::Group &group, const string &dataset_name, const vector<double> &double_data);
+        //! Write a vector of long integers as a dataset
+        /*!
+          Create a dataset with a one-dimensional array of 64 bit integers using the passed-in values
+          \param group Name of HDF5 group in which to write the new dataset
+          \param dataset_name Name of the new dataset where a one-dimensional array is to be written
+          \param long_data A vector of long integers that should be written in the new dataset
+        */
+        void write_long_vector_dataset(const H5::Group &group, const string &dataset_name, const vector<long long> &long_data);
+        //! Append rows of data to an extendible dataset
+        /*!
+          Create the dataset with an unlimited first dimension if it doesn't exist, then extend it and write the rows after the rows already in it
+          \param group Name of HDF5 group holding the dataset
+          \param dataset_name Name of the dataset
+          \param row_size Number of rows to append
+          \param column_size Number of columns, or zero for a one-dimensional dataset
+          \param data_type Type of the data in the file
+          \param memory_type Type of the data in memory
+          \param data Pointer to the rows of data
+          \return first row written, or -1 if the rows couldn't be written
+        */
+        //! Add the full name, element count, and byte count of a dataset to the arguments of a profile span
+        /*!
+          Nothing is added unless the span is active, so the name of the group is only looked up when profiling
+          \param span Span timing the dataset write
+          \param group HDF5 group holding the dataset
+          \param dataset_name Name of the dataset
+          \param elements Number of values written
+          \param bytes Number of bytes written
+        */
+        void add_dataset_arguments(Logging::Span &span, const H5::Group &group, const string &dataset_name, const size_t &elements, const size_t &bytes);
+        long long append_rows(const H5::Group &group, const string &dataset_name, const hsize_t &row_size, const hsize_t &column_size, const H5::PredType &data_type, const H5::PredType &memory_type, const void* data);
+        //! Append columns of data to an extendible two-dimensional dataset
+        /*!
+          Create the dataset with an unlimited second dimension if it doesn't exist, then extend it and write the columns after the columns already in it
+          \param group Name of HDF5 group holding the dataset
+          \param dataset_name Name of the dataset
+          \param row_size Number of rows, any other number than the rows already in the dataset is an error
+          \param column_size Number of columns to append
+          \param data_type Type of the data in the file
+          \param memory_type Type of the data in memory
+          \param data Pointer to the data, stored row by row
+          \return first column written, or -1 if the columns couldn't be written
+          \sa append_rows()
+        */
+        long long append_columns(const H5::Group &group, const string &dataset_name, const hsize_t &row_size, const hsize_t &column_size, const H5::PredType &data_type, const H5::PredType &memory_type, const void* data);
         //! Write an array of arrays of doubles as a dataset
         /*!
           Create a dataset with a two-dimensional array of doubles using the passed-in values
@@ -1287,13 +1394,57 @@ class SpadeObject {
           \sa write_double_2D_array()
         */
         void write_double_2D_vector(const H5::Group &group, const string &dataset_name, const int &max_column_size, vector<vector<double>> &data_array);
-        //! Create a group in the hdf5 file, log warning if not possible
-        /*!
+        //! Write one frame of data to an extendible dataset
+        /*!
+          Create the dataset with an unlimited leading frame dimension if it doesn't exist, extend it to hold the frame, and write the data into the row for the frame with a hyperslab selection. Rows for frames without data hold the fill value
+          \param group HDF5 group in which to write the dataset
+          \param dataset_name Name of the dataset
+          \param frame_index Position of the frame along the leading dimension
+          \param rank Integer indicating the number of dimensions of one frame of data, zero for a single value
+          \param dimensions Array with the size of each dimension of one frame of data
+          \param data_type Type of the data
+          \param data Pointer to one frame of data, nothing is written if it is null
+          \param created Will store whether the dataset was created by this call
+          \return dataset that's been written to
+          \sa stacked_dataset_properties()
+        */
+        H5::DataSet write_stacked_array(const H5::Group &group, const string &dataset_name, const int &frame_index, const int &rank, const hsize_t* dimensions, const H5::PredType &data_type, const void* data, bool &created);
+        //! Create a group in the hdf5 file, log error and exit if not possible
+        /*!
+          Return the group if it already exists
           \param h5_file Open h5_file object for writing
           \param group_name Name of the group where data is to be written
           \return group that's been created
+          \sa open_subgroup()
         */
         H5::Group create_group(H5::H5File &h5_file, const string &group_name);
+        //! Create the dataset creation property list shared by the numeric datasets
+        /*!
+          Build a property list with the shuffle and compression filters requested on the command line. The chunk dimensions are set per dataset in dataset_properties(). Datasets aren't filled before they're written when the hdf5 file profile skips the fill
+          \sa dataset_properties()
+        */
+        void create_dataset_creation_properties ();
+        //! Return the dataset creation property list for a numeric dataset of the given shape
+        /*!
+          Copy the shared dataset creation property list and set the chunk dimensions. With an 'auto' chunk shape the leading dimension is split into chunks of about a megabyte and the trailing dimensions are kept whole, so reading one frame of a block touches as few chunks as possible
+          \param rank Integer indicating the number of dimensions of the dataset
+          \param dimensions Array with the size of each dimension of the dataset
+          \param type_size Size in bytes of one value in the dataset
+          \param split_components Boolean indicating whether the last dimension holds field components, which are then chunked one component at a time
+          \return property list to be used when creating the dataset
+          \sa create_dataset_creation_properties()
+        */
+        H5::DSetCreatPropList dataset_properties (const int &rank, const hsize_t* dimensions, const size_t &type_size, const bool &split_components);
+        //! Return the dataset creation property list for an extendible dataset in the stacked layout
+        /*!
+          Copy the shared dataset creation property list, set chunks that hold one frame, and set a fill value of NaN for floating point data or -1 for integers. With an 'auto' chunk shape the first dimension of a frame is split into chunks of about 64 kilobytes, otherwise the chunk shape given by the user is used for the dimensions of a frame
+          \param rank Integer indicating the number of dimensions of one frame of data
+          \param dimensions Array with the size of each dimension of one frame of data
+          \param data_type Type of the data
+          \return property list to be used when creating the dataset
+          \sa dataset_properties()
+        */
+        H5::DSetCreatPropList stacked_dataset_properties (const int &rank, const hsize_t* dimensions, const H5::PredType &data_type);
         //! Replace forward slashes '/' with vertical bars '|' from strings that will be used in group name paths
         /*!
           \param name String with potential slashes to be replaced
@@ -1320,6 +1471,12 @@ class SpadeObject {
         map<string, mesh_type> instance_mesh;
         map<string, mesh_type> part_mesh;
         map<string, mesh_type> assembly_mesh;
+        vector<section_category_type> mesh_section_categories;
+        unordered_map<string, int> mesh_section_category_ids;
+        vector<string> mesh_instance_names;
+        unordered_map<string, int> mesh_instance_name_ids;
+        vector<string> mesh_set_names;
+        unordered_map<string, int> mesh_set_name_ids;
         set<string> instance_set;
         set<string> step_set;
         set<string> history_region_set;
@@ -1327,9 +1484,38 @@ class SpadeObject {
         set<string> field_set;
 
         string dimension_enum_strings[4];
-        map<int, string> faces_enum_strings;
+        H5::EnumType face_enum_type;  // Built from face_enum_names
+        H5::EnumType data_type_enum_type;  // Built from data_type_enum_names
         string default_instance_name;
         CmdLineArguments* command_line_arguments;
         Logging* log_file;
+        H5::DSetCreatPropList dataset_creation_properties;
+        H5::DSetCreatPropList contiguous_dataset_properties;  // Used for the numeric datasets that aren't chunked
+        H5::DSetCreatPropList scalar_dataset_properties;  // Used for the single value datasets, compact with the compact metadata layout
+        bool scalar_attributes = false;  // Write single values as attributes of their group instead of datasets
+        optional<H5FileProfile> file_profile;
+        H5::LinkCreatPropList intermediate_group_properties;
+        unordered_map<string, H5::Group> group_cache;  // Only used by the thread writing the hdf5 file
+        int selected_frame_count = 0;  // Frames selected so far in all steps, used to share the frames between shards
+        int shard_index = 0;
+        int shard_count = 1;
+        string split_by;  // Empty, step, instance, field, or frame-range
+        int frame_range_size = 0;  // Frames in each partition when split by frame range
+        map<string, bool> skipped_partitions;  // Whether each partition found so far is skipped, only used by the thread reading the odb
+        vector<string> reused_partitions;  // Partitions completed by an earlier run
+        string partition_manifest;  // Odb file and options written to each partition file, which decide whether a later run keeps it
+        map<string, set<string>> partition_links;  // Partition groups of each partition written by this run, only used by the thread writing the hdf5 file
+        unordered_map<string, tuple<const string*, string, string>> frame_datasets;  // Content and group name of datasets to link to from later frames, and the group they were last written or linked to
+        unordered_set<string> frame_dataset_contents;  // One copy of each content, which the field outputs at the same positions share
+        size_t max_memory_bytes = 0;  // Memory ceiling for buffered data, zero for no ceiling
+        size_t field_output_bytes = 0;  // Uncompressed bytes of the field output data handed to the hdf5 writer
+        map<string, manifest_step_type> manifest;  // Keyed by step name with the slashes replaced, only used with the append option
+        map<string, vtk_mesh_index_type> vtk_mesh_index;  // Keyed by instance name
+        size_t vtk_point_count = 0;
+        size_t vtk_cell_count = 0;
+        map<string, vtk_array_type> vtk_point_arrays;  // Only used by the thread writing the hdf5 file
+        map<string, vtk_array_type> vtk_cell_arrays;  // Only used by the thread writing the hdf5 file
+        bool chunk_datasets;
+        vector<hsize_t> chunk_shape;
 };
 #endif  // __SPADE_OBJECT_H_INCLUDED__
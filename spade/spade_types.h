@@ -0,0 +1,522 @@
+//! The data types holding the model and results data read from an odb, which the writers of the extracted file use
+
+#include <array>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifndef __SPADE_TYPES_H_INCLUDED__
+#define __SPADE_TYPES_H_INCLUDED__
+
+using namespace std;
+
+struct enum_name_type {  // A value of an enumerated column and the name written for it in the HDF5 enumerated type
+    short value;
+    const char* name;
+};
+
+// Values of odb_Enum::odb_ElementFaceEnum, found at: /apps/SIMULIA/EstProducts/2023/SMAOdb/PublicInterfaces/odb_Enum.h
+inline constexpr enum_name_type face_enum_names[] = {
+    {0, "FACE_UNKNOWN"}, {1, "END1"}, {2, "END2"}, {3, "END3"},
+    {11, "FACE1"}, {12, "FACE2"}, {13, "FACE3"}, {14, "FACE4"}, {15, "FACE5"}, {16, "FACE6"},
+    {101, "EDGE1"}, {102, "EDGE2"}, {103, "EDGE3"}, {104, "EDGE4"}, {105, "EDGE5"}, {106, "EDGE6"}, {107, "EDGE7"},
+    {108, "EDGE8"}, {109, "EDGE9"}, {110, "EDGE10"}, {111, "EDGE11"}, {112, "EDGE12"}, {113, "EDGE13"}, {114, "EDGE14"},
+    {115, "EDGE15"}, {116, "EDGE16"}, {117, "EDGE17"}, {118, "EDGE18"}, {119, "EDGE19"}, {120, "EDGE20"},
+    {1001, "SIDE1|SPOS"}, {1002, "SIDE2|SNEG"}, {1003, "DOUBLE_SIDED"}  // DOUBLE_SIDED = DOUBLE SIDED SHELLS
+};
+
+inline constexpr array<bool, 1004> face_enum_known = [] {
+    array<bool, 1004> known{};
+    for (const enum_name_type &face : face_enum_names) { known[face.value] = true; }
+    return known;
+}();
+
+//! Return the face value if it's in face_enum_names, otherwise the value of FACE_UNKNOWN
+inline short face_enum_value(const int &value) {
+    return ((value >= 0) && (value < static_cast<int>(face_enum_known.size())) && (face_enum_known[value])) ? value : 0;
+}
+
+// Codes written for odb_Enum::odb_DataTypeEnum, in the order of the cases of OdbModelSource::get_field_type_code()
+inline constexpr enum_name_type data_type_enum_names[] = {
+    {0, "Unknown"}, {1, "Scalar"}, {2, "Vector"}, {3, "Tensor 3D Full"}, {4, "Tensor 3D Planar"},
+    {5, "Tensor 3D Surface"}, {6, "Tensor 2D Planar"}, {7, "Tensor 2D Surface"}
+};
+
+struct job_data_type {
+    string analysisCode;
+    string creationTime;
+    string machineName;
+    string modificationTime;
+    string name;
+    string precision;
+    vector<string> productAddOns;
+    string version;
+};
+
+struct sector_definition_type {
+    int numSectors;
+    string start_point;
+    string end_point;
+};
+
+struct section_point_type {
+    string number;
+    string description;
+};
+
+struct section_category_type {
+    string name;
+    string description;
+    vector<string> section_point_numbers;
+    vector<string> section_point_descriptions;
+};
+
+struct user_xy_data_type {
+    string name;
+    string sourceDescription;
+    string contentDescription;
+    string positionDescription;
+    string xAxisLabel;
+    string yAxisLabel;
+    string legendLabel;
+    string description;
+    vector<float> data;
+    int row_size;
+};
+
+struct tangential_behavior_type {
+    string formulation;
+    string directionality;
+    string slipRateDependency;  // Boolean
+    string pressureDependency;  // Boolean
+    string temperatureDependency;  // Boolean
+    int dependencies;
+    string exponentialDecayDefinition;
+    vector<vector<double>> table;  // Must remain as 2D vector due to varying sizes of columns
+    int max_column_size;
+    double shearStressLimit;  // String NONE or a double
+    string maximumElasticSlip;
+    double fraction;
+    double absoluteDistance;  // String NONE or a double
+    double elasticSlipStiffness;
+    int nStateDependentVars;
+    string useProperties;
+};
+
+struct element_type {
+    vector<int> connectivity;
+    section_category_type sectionCategory;
+    vector<string> instanceNames;
+};
+
+struct mesh_nodes_type {
+    int coordinate_size = 0;  // Number of coordinates stored for each node
+    bool sorted = true;  // False once a label is added out of order, cleared by sort_mesh
+    vector<int> labels;
+    vector<float> coordinates;  // Row major, coordinate_size values for each entry in labels
+    unordered_map<int, size_t> label_index;  // Node label to its row in labels and coordinates
+};
+
+struct mesh_elements_type {  // All the elements of a single element type
+    bool sorted = true;  // False once a label is added out of order, cleared by sort_mesh
+    vector<int> labels;
+    vector<int> connectivity;  // Node labels of every element, in the same order as labels
+    vector<size_t> connectivity_offsets = {0};  // Element i uses connectivity[connectivity_offsets[i]] to connectivity[connectivity_offsets[i+1]]
+    vector<int> section_category_ids;  // Index into SpadeObject::mesh_section_categories for each element
+    vector<int> instance_name_ids;  // Index into SpadeObject::mesh_instance_names, only stored for assembly level elements
+    vector<size_t> instance_name_offsets = {0};  // Element i uses instance_name_ids[instance_name_offsets[i]] to instance_name_ids[instance_name_offsets[i+1]]
+    unordered_map<int, size_t> label_index;  // Element label to its position in labels
+};
+
+struct set_type {
+    string name;
+    string type;  // Enum [NODE_SET, ELEMENT_SET, SURFACE_SET]
+    int size;
+    vector<string> instanceNames;
+    mesh_nodes_type* nodes;
+    map<string, mesh_elements_type>* elements; // accessed like elements[type] (e.g. elements['CAX4T'])
+    vector<short> faces;  // Values of face_enum_names
+};
+
+struct contact_standard_type {
+    string sliding;  // Symbolic Constant [FINITE, SMALL]
+    double smooth;
+    double hcrit;
+    string limitSlideDistance;
+    double slideDistance;
+    double extensionZone;
+    string adjustMethod;  // Symbolic Constant [NONE, OVERCLOSED, TOLERANCE, SET]
+    double adjustTolerance;
+    string enforcement;  // Symbolic Constant [NODE_TO_SURFACE, SURFACE_TO_SURFACE]
+    string thickness;  // Boolean
+    string tied;  // Boolean
+    string contactTracking;  // Symbolic Constant [ONE_CONFIG, TWO_CONFIG]
+    string createStepName;
+
+    tangential_behavior_type interactionProperty;
+    set_type main;
+    set_type secondary;
+    set_type adjust;
+};
+
+struct contact_explicit_type {
+    string sliding;  // Symbolic Constant [FINITE, SMALL]
+    string mainNoThick;
+    string secondaryNoThick;
+    string mechanicalConstraint;
+    string weightingFactorType;
+    double weightingFactor;
+    string createStepName;
+    string useReverseDatumAxis;  // Boolean
+    string contactControls;
+  
+    tangential_behavior_type interactionProperty;
+    set_type main;
+    set_type secondary;
+ 
+};
+
+struct tie_type {
+    set_type main;
+    set_type secondary;
+    string adjust;
+    string positionToleranceMethod;
+    string positionTolerance;
+    string tieRotations;
+    string constraintRatioMethod;
+    string constraintRatio;
+    string constraintEnforcement;
+    string thickness;
+};
+
+struct display_body_type {
+    string instanceName;
+    string referenceNode1InstanceName;
+    string referenceNode1Label;
+    string referenceNode2InstanceName;
+    string referenceNode2Label;
+    string referenceNode3InstanceName;
+    string referenceNode3Label;
+};
+
+struct datum_csys_type {
+    string name;
+    string type;
+    float x_axis[3];
+    float y_axis[3];
+    float z_axis[3];
+    float origin[3];
+};
+
+struct coupling_type {
+    set_type surface;
+    set_type refPoint;
+    set_type nodes;
+    string couplingType;
+    string weightingMethod;
+    string influenceRadius;
+
+    string u1;
+    string u2;
+    string u3;
+    string ur1;
+    string ur2;
+    string ur3;
+};
+
+struct mpc_type {
+    set_type surface;
+    set_type refPoint;
+    string mpcType;
+    string userMode;
+    string userType;
+};
+
+struct shell_solid_coupling_type {
+    set_type shellEdge;
+    set_type solidFace;
+    string positionToleranceMethod;
+    string positionTolerance;
+    string influenceDistanceMethod;
+    string influenceDistance;
+};
+
+struct constraint_type {
+    vector<tie_type> ties;
+    vector<display_body_type> display_bodies;
+    vector<coupling_type> couplings;
+    vector<mpc_type> mpc;
+    vector<shell_solid_coupling_type> shell_solid_couplings;
+};
+
+struct part_type {
+    string name;
+    string embeddedSpace;
+    mesh_nodes_type* nodes;
+    map<string, mesh_elements_type>* elements; // accessed like elements[type] (e.g. elements['CAX4T'])
+    vector<set_type> nodeSets;
+    vector<set_type> elementSets;
+    vector<set_type> surfaces;
+};
+
+struct section_assignment_type {
+  set_type region;
+  string sectionName;
+};
+
+struct beam_orientation_type {
+  string method;
+  set_type region;
+  vector<float> beam_vector;  // vector is a reserved word, so had to name it something else
+};
+
+struct rebar_orientation_type {
+  string axis;
+  float angle;
+  set_type region;
+  datum_csys_type csys;
+};
+
+struct analytic_surface_segment_type {
+    string type;
+    vector<float> data;
+    int column_size;
+    int row_size;
+};
+
+struct analytic_surface_type {
+    string name;
+    string type;
+    double filletRadius;
+    vector<analytic_surface_segment_type> segments;
+    vector<vector<float>> localCoordData;  // Must remain as 2D vector due to varying sizes of columns
+    int max_column_size;
+};
+
+struct rigid_body_type {
+    string position;
+    string isothermal;  // Boolean
+    set_type referenceNode;
+    set_type elements;
+    set_type tieNodes;
+    set_type pinNodes;
+    analytic_surface_type analyticSurface;
+};
+
+struct instance_type {
+    string name;
+    string embeddedSpace;
+    mesh_nodes_type* nodes;
+    map<string, mesh_elements_type>* elements; // accessed like elements[type] (e.g. elements['CAX4T'])
+    vector<set_type> nodeSets;
+    vector<set_type> elementSets;
+    vector<set_type> surfaces;
+    vector<rigid_body_type> rigidBodies;
+    vector<section_assignment_type> sectionAssignments;
+    vector<beam_orientation_type> beamOrientations;
+    vector<rebar_orientation_type> rebarOrientations;
+    analytic_surface_type analyticSurface;
+};
+
+struct mesh_set_type {  // Labels of the nodes or elements of a set in a single mesh
+    bool sorted = true;  // False once a label is added out of order or twice, cleared by sort_mesh
+    vector<int> labels;  // Sorted and unique once sort_mesh has run
+};
+
+struct mesh_type {
+    mesh_nodes_type nodes;
+    map<string, mesh_elements_type> elements; // accessed like elements[type] (e.g. elements['CAX4T'])
+    map<int, mesh_set_type> element_sets;  // Keyed by index into SpadeObject::mesh_set_names
+    map<int, mesh_set_type> node_sets;  // Keyed by index into SpadeObject::mesh_set_names
+    int part_index;
+    int instance_index;
+};
+
+struct connector_orientation_type {
+    set_type region;
+    string axis1;  // SymbolicConstant
+    string axis2;  // SymbolicConstant
+    datum_csys_type localCsys1;
+    datum_csys_type localCsys2;
+    string orient2sameAs1; // Boolean
+    float angle1;
+    float angle2;
+};
+
+struct assembly_type {
+    string name;
+    string embeddedSpace;
+    mesh_nodes_type* nodes;
+    map<string, mesh_elements_type>* elements; // accessed like elements[type] (e.g. elements['CAX4T'])
+    vector<set_type> nodeSets;
+    vector<set_type> elementSets;
+    vector<set_type> surfaces;
+    vector<instance_type> instances;
+    vector<datum_csys_type> datumCsyses;
+    vector<connector_orientation_type> connectorOrientations;
+};
+
+struct field_location_type {
+    string position;
+    vector<section_point_type> sectionPoint;
+};
+
+struct field_value_type {
+    vector<int> elementLabel;
+    vector<int> nodeLabel;
+    vector<int> integrationPoint;
+    vector<signed char> type;  // Values of data_type_enum_names
+    vector<float> magnitude;
+    vector<float> tresca;
+    vector<float> press;
+    vector<float> inv3;
+    vector<float> maxPrincipal;
+    vector<float> midPrincipal;
+    vector<float> minPrincipal;
+    vector<float> maxInPlanePrincipal;
+    vector<float> minInPlanePrincipal;
+    vector<float> outOfPlanePrincipal;
+    vector<string> sectionPointNumber;
+    vector<string> sectionPointDescription;
+    bool magnitudeEmpty;
+    bool trescaEmpty;
+    bool pressEmpty;
+    bool inv3Empty;
+    bool maxPrincipalEmpty;
+    bool midPrincipalEmpty;
+    bool minPrincipalEmpty;
+    bool maxInPlanePrincipalEmpty;
+    bool minInPlanePrincipalEmpty;
+    bool outOfPlanePrincipalEmpty;
+
+    bool elementEmpty;
+    bool nodeEmpty;
+    bool integrationPointEmpty;
+    bool typeEmpty;
+    bool sectionPointNumberEmpty;
+    bool sectionPointDescriptionEmpty;
+};
+
+struct field_bulk_type {
+    string instanceName;
+    string dataName;  // Name of the group holding the block, based on the base element type or position
+    bool assemblyData;  // Block doesn't belong to an instance
+    bool writeFieldValues;  // Field values for the instance are written along with this block
+    string position;
+    string precision;
+    int orientationWidth;
+    int numberOfElements;
+    int length;
+    int valuesPerElement;
+    int width;
+    string baseElementType;
+    vector<short> faces;  // Values of face_enum_names
+    vector<int> elementLabels;
+    vector<int> nodeLabels;
+    vector<int> integrationPoints;
+    vector<float> data;
+    vector<double> dataDouble;
+    vector<float> conjugateData;
+    vector<double> conjugateDataDouble;
+    vector<float> localCoordSystem;
+    vector<double> localCoordSystemDouble;
+    vector<float> mises;
+    map<string, vector<float>> invariants;  // Invariants computed from the bulk data, keyed by dataset name
+    vector<string> componentLabels;
+    bool emptyFaces;  // Keep track of whether any face data exists
+};
+
+struct field_output_type {
+    string name;
+    string description;
+    string type;
+    int dim;
+    int dim2;
+    bool isComplex;
+    bool engineeringShear = false;  // The shear components of the tensor are engineering shear strains, which are twice the tensor shear strains
+    vector<string> componentLabels;
+    vector<string> validInvariants;
+    vector<field_location_type> locations;
+    map<string, field_value_type> values;  // String index is the name of the instance
+    vector<field_bulk_type> bulkValues;
+    set<string> remainingInstances;  // Instances with field values, but no bulk data
+    bool writeMetadata;  // False for every part after the first when the field output is written in parts
+    int maxWidth;
+    int maxLength;
+};
+
+struct field_data_type {
+    field_value_type fieldValues;
+    vector<field_bulk_type> bulkValues;
+};
+
+struct frame_type {
+    int number;
+    int incrementNumber;
+    int cyclicModeNumber;
+    int mode;
+    string description;
+    string domain;
+    float frameValue;
+    float frequency;
+    string loadCase;
+    int max_width;
+    int max_length;
+};
+
+struct history_point_type {
+    element_type element;
+    int element_label;
+    string elementType;
+    bool hasElement;
+    bool hasNode;
+    int ipNumber;
+    section_point_type sectionPoint;
+    string face;
+    string position;
+    int node_label;
+    float node_coordinates[3];
+    set_type region;
+    string assemblyName;  // Just storing the name not the entire assembly
+    string instanceName;  // Just storing the name not the entire instance
+};
+
+struct history_region_type {
+    string name;
+    string description;
+    string position;
+    history_point_type point;
+    string loadCase;
+};
+
+struct history_matrix_type {  // The requested history outputs of a history region, with a row for each history output
+    vector<string> names;
+    vector<string> descriptions;
+    vector<string> types;
+    vector<float> frame_values;  // Time axis shared by the rows, the sorted union of the frame values of every history output
+    vector<float> data;  // names.size() x frame_values.size(), NaN where a history output has no sample at a frame value
+    vector<float> conjugate_frame_values;
+    vector<float> conjugate_data;  // names.size() x conjugate_frame_values.size(), empty if no history output has conjugate data
+};
+
+struct step_type {
+    string name;
+    string description;
+    string domain;
+    string previousStepName;
+    string procedure;
+    string nlgeom; // Boolean
+    int number;
+    double timePeriod;
+    double totalTime;
+    double mass;
+    double acousticMass;
+    vector<string> loadCases;
+    vector<double> massCenter;
+    vector<double> acousticMassCenter;
+    double inertiaAboutCenter[6];
+    double inertiaAboutOrigin[6];
+};
+#endif  // __SPADE_TYPES_H_INCLUDED__
@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <element_ingest.h>
+#include <synthetic_model.h>
+
+using namespace std;
+
+SyntheticModel::SyntheticModel (const string &specification) {
+    stringstream specification_stream(specification);
+    string setting;
+    while (getline(specification_stream, setting, ',')) {
+        if (setting.empty()) { continue; }
+        size_t equals = setting.find('=');
+        if (equals == string::npos) {
+            throw std::runtime_error("Synthetic model setting " + setting + " isn't of the form key=value");
+        }
+        parse_setting(setting.substr(0, equals), setting.substr(equals + 1));
+    }
+    for (int i=0; i<this->step_count; i++) { this->steps.push_back("Step-" + to_string(i + 1)); }
+    for (int i=0; i<this->field_count; i++) { this->field_outputs.push_back("FIELD-" + to_string(i + 1)); }
+}
+
+void SyntheticModel::parse_setting (const string &key, const string &value) {
+    if (key == "instances") {
+        this->instance_count = positive_integer(key, value);
+    } else if (key == "nodes") {
+        this->node_count = positive_integer(key, value);
+    } else if (key == "elements") {
+        this->element_counts.clear();
+        stringstream element_stream(value);
+        string element_count;
+        while (getline(element_stream, element_count, '+')) {
+            size_t colon = element_count.find(':');
+            string element_type = element_count.substr(0, colon);
+            if ((colon == string::npos) || (element_node_count(element_type) == 0)) {
+                throw std::runtime_error("Synthetic model elements " + element_count + " must be a supported element type and a count, e.g. C3D8R:1000");
+            }
+            this->element_counts.emplace_back(element_type, positive_integer(key, element_count.substr(colon + 1)));
+        }
+        if (this->element_counts.empty()) {
+            throw std::runtime_error("Synthetic model elements must have at least one element type");
+        }
+    } else if (key == "sets") {
+        this->set_count = (value == "0") ? 0 : positive_integer(key, value);
+    } else if (key == "steps") {
+        this->step_count = positive_integer(key, value);
+    } else if (key == "frames") {
+        this->frames_per_step = positive_integer(key, value);
+    } else if (key == "fields") {
+        this->field_count = positive_integer(key, value);
+    } else if (key == "components") {
+        this->component_count = positive_integer(key, value);
+        if (this->component_count > 6) {
+            throw std::runtime_error("Synthetic model components must be between 1 and 6");
+        }
+    } else if (key == "integration-points") {
+        this->integration_point_count = positive_integer(key, value);
+    } else if (key == "seed") {
+        this->seed = (value == "0") ? 0 : positive_integer(key, value);
+    } else {
+        throw std::runtime_error("Unknown synthetic model setting " + key);
+    }
+}
+
+int SyntheticModel::positive_integer (const string &key, const string &value) {
+    size_t parsed_characters = 0;
+    int parsed_value = 0;
+    try {
+        parsed_value = std::stoi(value, &parsed_characters);
+    } catch (const std::logic_error&) {
+        parsed_characters = 0;
+    }
+    if ((parsed_characters != value.size()) || (parsed_value <= 0)) {
+        throw std::runtime_error("Synthetic model setting " + key + " must be a positive integer, not " + value);
+    }
+    return parsed_value;
+}
+
+int SyntheticModel::element_node_count (const string &element_type) {
+    static const map<string, int> node_counts = {
+        {"C3D4", 4}, {"C3D8", 8}, {"C3D8R", 8}, {"C3D10", 10}, {"C3D20", 20}, {"C3D20R", 20},
+        {"S3", 3}, {"S4", 4}, {"S4R", 4}, {"CPS4", 4}, {"CPE4", 4}, {"CAX4", 4}, {"B31", 2}, {"T3D2", 2}
+    };
+    auto node_count = node_counts.find(element_type);
+    return (node_count != node_counts.end()) ? node_count->second : 0;
+}
+
+int SyntheticModel::name_index (const vector<string> &names, const string &name) {
+    auto found = std::find(names.begin(), names.end(), name);
+    if (found == names.end()) {
+        throw std::runtime_error("The synthetic model has no step or field output named " + name);
+    }
+    return found - names.begin();
+}
+
+void SyntheticModel::fill_values (vector<float> &values, const uint64_t &seed) {
+    uint64_t state = (this->seed ^ seed) * 0x9E3779B97F4A7C15ULL + 1;  // xorshift64* never leaves a zero state
+    for (float &value : values) {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        value = static_cast<float>((state * 0x2545F4914F6CDD1DULL) >> 40) / 8388608.0f - 1.0f;  // 24 bits scaled to [-1, 1)
+    }
+}
+
+string SyntheticModel::name () {
+    return "synthetic";
+}
+
+void SyntheticModel::read_assembly (assembly_type &assembly, map<string, mesh_type> &instance_mesh, vector<section_category_type> &section_categories, vector<string> &set_names) {
+    assembly.name = "ASSEMBLY";
+    assembly.embeddedSpace = "Three Dimensional";
+    section_categories.push_back({"solid < SYNTHETIC >", "Synthetic solid section", {}, {}});
+
+    int grid_size = static_cast<int>(std::ceil(std::cbrt(static_cast<double>(this->node_count))));
+    int set_name_offset = set_names.size();  // Every instance has the same set names, so they share set ids
+    for (int s=0; s<this->set_count; s++) {
+        set_names.push_back("NSET-" + to_string(s + 1));
+        set_names.push_back("ESET-" + to_string(s + 1));
+    }
+    for (int i=0; i<this->instance_count; i++) {
+        instance_type new_instance = instance_type();
+        new_instance.name = "PART-" + to_string(i + 1) + "-1";
+        new_instance.embeddedSpace = "Three Dimensional";
+        mesh_type &mesh = instance_mesh[new_instance.name];
+        mesh.part_index = -1;
+        mesh.instance_index = i;
+
+        mesh.nodes.coordinate_size = 3;
+        for (int n=0; n<this->node_count; n++) {  // Nodes on a grid, with the instances side by side
+            mesh.nodes.label_index[n + 1] = n;
+            mesh.nodes.labels.push_back(n + 1);
+            mesh.nodes.coordinates.push_back(static_cast<float>(n % grid_size + i * (grid_size + 1)));
+            mesh.nodes.coordinates.push_back(static_cast<float>((n / grid_size) % grid_size));
+            mesh.nodes.coordinates.push_back(static_cast<float>(n / (grid_size * grid_size)));
+        }
+
+        // Each element type keeps a contiguous range of labels, which the field output blocks are read from, but like the
+        // elements of an odb the types are stored in short runs, so the ingest switches between their containers
+        vector<int> first_labels;
+        vector<pair<int, int>> label_ranges;  // Next and last label of each element type
+        int element_label = 1;
+        for (const auto& [element_type, element_count] : this->element_counts) {
+            first_labels.push_back(element_label);
+            label_ranges.emplace_back(element_label, element_label + element_count - 1);
+            element_label += element_count;
+        }
+        vector<int> connectivity;
+        auto add_element = [&] (ElementIngest &element_ingest, const int &label, const string &element_type) {
+            int nodes_per_element = element_node_count(element_type);
+            connectivity.resize(nodes_per_element);
+            for (int n=0; n<nodes_per_element; n++) { connectivity[n] = (label - 1 + n) % this->node_count + 1; }
+            return element_ingest.add(label, element_type.c_str(), connectivity.data(), nodes_per_element);
+        };
+        ElementIngest ingest(mesh.elements, nullptr);  // Stored the same way as the elements read from an odb
+        for (bool remaining=true; remaining; ) {
+            remaining = false;
+            for (size_t t=0; t<label_ranges.size(); t++) {
+                auto &[next_label, last_label] = label_ranges[t];
+                for (int run_end=std::min(next_label + this->element_run_length - 1, last_label); next_label<=run_end; next_label++) {
+                    mesh_elements_type* type_elements = add_element(ingest, next_label, this->element_counts[t].first);
+                    type_elements->section_category_ids.push_back(0);
+                    type_elements->instance_name_offsets.push_back(0);
+                }
+                remaining = (remaining) || (next_label <= last_label);
+            }
+        }
+
+        for (int s=0; s<this->set_count; s++) {  // Every set_count-th node and element, starting at a different label for each set
+            string set_suffix = "-" + to_string(s + 1);
+            vector<int> &node_set = mesh.node_sets[set_name_offset + 2 * s].labels;
+            for (int label=s + 1; label<=this->node_count; label += this->set_count) { node_set.push_back(label); }
+            // The elements of a set are stored again, like those of an odb set, and are found already stored
+            mesh_set_type &element_set = mesh.element_sets[set_name_offset + 2 * s + 1];
+            ElementIngest set_ingest(mesh.elements, &element_set);
+            size_t t = 0;
+            for (int label=s + 1; label<element_label; label += this->set_count) {
+                while ((t + 1 < first_labels.size()) && (label >= first_labels[t + 1])) { t++; }
+                add_element(set_ingest, label, this->element_counts[t].first);
+            }
+
+            set_type new_node_set = set_type();
+            new_node_set.name = "NSET" + set_suffix;
+            new_node_set.type = "Node Set";
+            new_node_set.size = node_set.size();
+            new_node_set.instanceNames.push_back(new_instance.name);
+            new_node_set.nodes = &mesh.nodes;
+            new_instance.nodeSets.push_back(new_node_set);
+            set_type new_element_set = set_type();
+            new_element_set.name = "ESET" + set_suffix;
+            new_element_set.type = "Element Set";
+            new_element_set.size = element_set.labels.size();
+            new_element_set.instanceNames.push_back(new_instance.name);
+            new_element_set.elements = &mesh.elements;
+            new_instance.elementSets.push_back(new_element_set);
+        }
+
+        new_instance.nodes = &mesh.nodes;
+        new_instance.elements = &mesh.elements;
+        assembly.instances.push_back(new_instance);
+    }
+}
+
+vector<string> SyntheticModel::step_names () {
+    return this->steps;
+}
+
+double SyntheticModel::step_total_time (const string &step_name) {
+    return name_index(this->steps, step_name);
+}
+
+int SyntheticModel::frame_count (const string &step_name) {
+    name_index(this->steps, step_name);
+    return this->frames_per_step;
+}
+
+frame_type SyntheticModel::read_frame (const string &step_name, const int &frame_number) {
+    name_index(this->steps, step_name);
+    frame_type new_frame = frame_type();
+    new_frame.number = frame_number;
+    new_frame.incrementNumber = frame_number;
+    new_frame.domain = "Time";
+    new_frame.frameValue = (this->frames_per_step > 1) ? static_cast<float>(frame_number) / (this->frames_per_step - 1) : 1.0f;
+    new_frame.description = "Increment " + to_string(frame_number) + ": Step Time = " + to_string(new_frame.frameValue);
+    return new_frame;
+}
+
+vector<string> SyntheticModel::field_output_names (const string &step_name, const int &) {  // Every frame has the same field outputs
+    name_index(this->steps, step_name);
+    return this->field_outputs;
+}
+
+field_output_type SyntheticModel::read_field_output (const string &step_name, const int &frame_number, const string &field_output_name, const function<bool(const string&)> &read_instance, const function<void(field_output_type&)> &add_block) {
+    int step_index = name_index(this->steps, step_name);
+    int field_index = name_index(this->field_outputs, field_output_name);
+    bool nodal = (field_index % 2 == 1);  // Fields alternate between integration point tensors and nodal vectors
+    static const vector<string> tensor_labels = {"11", "22", "33", "12", "13", "23"};
+
+    field_output_type new_field_output = field_output_type();
+    new_field_output.name = field_output_name;
+    new_field_output.isComplex = false;
+    new_field_output.writeMetadata = true;
+    field_location_type location;
+    if (nodal) {
+        new_field_output.description = "Synthetic nodal vector";
+        new_field_output.type = "Vector";
+        for (int i=0; i<std::min(this->component_count, 3); i++) { new_field_output.componentLabels.push_back("U" + to_string(i + 1)); }
+        new_field_output.validInvariants = {"Magnitude"};
+        location.position = "Nodal";
+    } else {
+        new_field_output.description = "Synthetic integration point tensor";
+        new_field_output.type = (this->component_count == 6) ? "Tensor 3D Full" : "Tensor 3D Planar";
+        for (int i=0; i<this->component_count; i++) { new_field_output.componentLabels.push_back("S" + tensor_labels[i]); }
+        new_field_output.validInvariants = {"Mises", "Tresca", "Press", "Inv3", "Max Principal", "Mid Principal", "Min Principal"};
+        location.position = "Integration Point";
+    }
+    new_field_output.dim = new_field_output.componentLabels.size();
+    new_field_output.locations.push_back(location);
+
+    for (int i=0; i<this->instance_count; i++) {
+        string instance_name = "PART-" + to_string(i + 1) + "-1";
+        if (!read_instance(instance_name)) { continue; }
+        vector<pair<string, int>> blocks = (nodal) ? vector<pair<string, int>>{{"", this->node_count}} : this->element_counts;
+        int first_label = 1;
+        for (size_t b=0; b<blocks.size(); b++) {
+            const auto& [element_type, count] = blocks[b];
+            field_bulk_type new_field_bulk = field_bulk_type();
+            new_field_bulk.instanceName = instance_name;
+            new_field_bulk.dataName = (nodal) ? location.position : element_type;
+            new_field_bulk.position = location.position;
+            new_field_bulk.precision = "Single Precision";
+            new_field_bulk.baseElementType = element_type;
+            new_field_bulk.componentLabels = new_field_output.componentLabels;
+            new_field_bulk.emptyFaces = true;
+            new_field_bulk.width = new_field_output.componentLabels.size();
+            if (nodal) {
+                new_field_bulk.length = count;
+                for (int label=1; label<=count; label++) { new_field_bulk.nodeLabels.push_back(label); }
+            } else {
+                new_field_bulk.numberOfElements = count;
+                new_field_bulk.valuesPerElement = this->integration_point_count;
+                new_field_bulk.length = count * this->integration_point_count;
+                new_field_bulk.elementLabels.reserve(new_field_bulk.length);
+                new_field_bulk.integrationPoints.reserve(new_field_bulk.length);
+                for (int label=first_label; label<first_label + count; label++) {
+                    for (int point=1; point<=this->integration_point_count; point++) {
+                        new_field_bulk.elementLabels.push_back(label);
+                        new_field_bulk.integrationPoints.push_back(point);
+                    }
+                }
+                first_label += count;
+            }
+            new_field_bulk.data.resize(static_cast<size_t>(new_field_bulk.length) * new_field_bulk.width);
+            uint64_t block_seed = ((((static_cast<uint64_t>(step_index) * 1000003 + frame_number) * 1009 + field_index) * 1009 + i) * 1009) + b;
+            fill_values(new_field_bulk.data, block_seed);
+
+            if (new_field_bulk.width > new_field_output.maxWidth) { new_field_output.maxWidth = new_field_bulk.width; }
+            if (new_field_bulk.length > new_field_output.maxLength) { new_field_output.maxLength = new_field_bulk.length; }
+            new_field_output.bulkValues.push_back(std::move(new_field_bulk));
+            add_block(new_field_output);
+        }
+    }
+    return new_field_output;
+}
@@ -0,0 +1,105 @@
+//! A model source generating a synthetic model with results of a chosen size
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "model_source.h"
+#include "spade_types.h"
+
+#ifndef __SYNTHETIC_MODEL_H_INCLUDED__
+#define __SYNTHETIC_MODEL_H_INCLUDED__
+
+using namespace std;
+
+/*!
+   This class generates a model and its field output from a specification string, so the writers of the extracted file
+   can be benchmarked at a known size without Abaqus. The specification is a comma separated list of key=value pairs,
+   e.g. instances=2,nodes=10000,elements=C3D8R:8000+S4R:2000,steps=1,frames=10,fields=2,components=6. The keys left out
+   keep their default values. The same specification always generates the same model and values.
+
+   The field outputs alternate between integration point tensors, which have one bulk data block for each instance and
+   element type, and nodal vectors, which have one bulk data block for each instance. Each step has a time period of one,
+   with its frames spread evenly over it.
+*/
+class SyntheticModel : public ModelSource {
+    public:
+        //! The constructor.
+        /*!
+          Throws a runtime_error if the specification can't be parsed.
+          \param specification Comma separated key=value pairs describing the size of the model
+        */
+        SyntheticModel (const string &specification);
+        //! Return the name of the model, which is used in place of the name of the odb
+        /*!
+          \return name of the model
+        */
+        string name ();
+        //! Generate the root assembly, its instances, and their mesh
+        /*!
+          \param assembly Will store the root assembly, with instances whose nodes and elements point into instance_mesh
+          \param instance_mesh Will store the mesh and the node and element sets of each instance, keyed by instance name
+          \param section_categories Will store the section categories the section_category_ids of the elements refer to
+          \param set_names Will store the names of the sets the set ids of the meshes refer to
+        */
+        void read_assembly (assembly_type &assembly, map<string, mesh_type> &instance_mesh, vector<section_category_type> &section_categories, vector<string> &set_names);
+        vector<string> step_names () override;
+        double step_total_time (const string &step_name) override;
+        int frame_count (const string &step_name) override;
+        frame_type read_frame (const string &step_name, const int &frame_number) override;
+        vector<string> field_output_names (const string &step_name, const int &frame_number) override;
+        field_output_type read_field_output (const string &step_name, const int &frame_number, const string &field_output_name, const function<bool(const string&)> &read_instance, const function<void(field_output_type&)> &add_block) override;
+
+    private:
+        //! Parse one key=value pair of the specification
+        /*!
+          \param key Name of the setting
+          \param value Value of the setting
+        */
+        void parse_setting (const string &key, const string &value);
+        //! Parse a positive integer value of the specification
+        /*!
+          \param key Name of the setting, used in the error message
+          \param value Value of the setting
+          \return parsed integer
+        */
+        int positive_integer (const string &key, const string &value);
+        //! Return the number of nodes of each element of an element type
+        /*!
+          \param element_type Abaqus element type, e.g. C3D8R
+          \return number of nodes, zero if the element type isn't supported
+        */
+        static int element_node_count (const string &element_type);
+        //! Return the position of a step or field output in its list of names
+        /*!
+          Throws a runtime_error if the name isn't one of the names.
+          \param names Names of the steps or field outputs
+          \param name Name to look for
+          \return index of the name
+        */
+        static int name_index (const vector<string> &names, const string &name);
+        //! Fill a vector with values between -1 and 1 generated from a seed
+        /*!
+          \param values Vector to fill, which already has its size
+          \param seed Seed of the generator, which is mixed with the seed of the specification
+        */
+        void fill_values (vector<float> &values, const uint64_t &seed);
+
+        int instance_count = 1;
+        int node_count = 1000;  // Nodes of each instance
+        vector<pair<string, int>> element_counts = {{"C3D8R", 1000}};  // Elements of each instance by element type
+        int set_count = 2;  // Node sets and element sets of each instance
+        int element_run_length = 64;  // Elements of one type stored before the next type, as in the element sequences of an odb
+        int step_count = 1;
+        int frames_per_step = 10;
+        int field_count = 2;
+        int component_count = 6;  // Components of the tensor fields, the vector fields have at most three
+        int integration_point_count = 8;
+        uint64_t seed = 0;
+        vector<string> steps;
+        vector<string> field_outputs;
+};
+#endif  // __SYNTHETIC_MODEL_H_INCLUDED__
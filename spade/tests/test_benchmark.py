@@ -0,0 +1,99 @@
+import contextlib
+
+import pytest
+
+from spade import _benchmark
+
+does_not_raise = contextlib.nullcontext()
+
+
+def test_scenarios() -> None:
+    """Test :meth:`spade._benchmark.scenarios`."""
+    matrix = _benchmark.scenarios()
+    names = [scenario["name"] for scenario in matrix]
+    assert len(matrix) == len(_benchmark.model_sizes) * len(_benchmark.format_layouts) * len(_benchmark.compressions)
+    assert len(set(names)) == len(names)
+    assert all(scenario["format"] == "extract" for scenario in matrix if scenario["layout"] == "stacked")
+
+    matrix = _benchmark.scenarios(["small"])
+    assert {scenario["synthetic"] for scenario in matrix} == {_benchmark.model_sizes["small"]}
+
+
+def test_memory_check_scenarios() -> None:
+    """Test :meth:`spade._benchmark.memory_check_scenarios`."""
+    baseline, model = _benchmark.memory_check_scenarios(32)
+    assert baseline["max_memory"] == model["max_memory"] == "32"
+    assert model["synthetic"] == _benchmark.memory_check_model
+    baseline_settings = _benchmark.parse_specification(baseline["synthetic"])
+    model_settings = _benchmark.parse_specification(model["synthetic"])
+    for key in ["instances", "nodes", "elements", "sets"]:
+        assert baseline_settings[key] == model_settings[key]
+    baseline_counts = _benchmark.model_counts(baseline["synthetic"])
+    assert baseline_counts["elements"] < _benchmark.model_counts(model["synthetic"])["elements"]
+
+
+parse_specification = {
+    "defaults": ("", _benchmark.synthetic_defaults, does_not_raise),
+    "elements": (
+        "instances=2,elements=C3D8R:10+S4R:5",
+        {**_benchmark.synthetic_defaults, "instances": 2, "elements": {"C3D8R": 10, "S4R": 5}},
+        does_not_raise,
+    ),
+    "unknown key": ("meshes=2", None, pytest.raises(ValueError, match="meshes=2")),
+    "no value": ("nodes", None, pytest.raises(ValueError, match="nodes")),
+}
+
+
+@pytest.mark.parametrize(
+    ("specification", "expected", "outcome"),
+    parse_specification.values(),
+    ids=parse_specification.keys(),
+)
+def test_parse_specification(
+    specification: str, expected: dict | None, outcome: contextlib.nullcontext | pytest.RaisesExc
+) -> None:
+    """Test :meth:`spade._benchmark.parse_specification`."""
+    with outcome:
+        try:
+            settings = _benchmark.parse_specification(specification)
+            assert settings == expected
+        finally:
+            pass
+
+
+def test_model_counts() -> None:
+    """Test :meth:`spade._benchmark.model_counts`."""
+    counts = _benchmark.model_counts("instances=2,nodes=100,elements=C3D8R:10+S4R:5,steps=2,frames=3")
+    assert counts == {"elements": 2 * 15 * 6, "nodes": 2 * 100 * 6}
+
+
+peak_memory = {
+    "reported": ("Command line used: spade\nPeak memory use: 42 MB\n", 42),
+    "missing": ("Command line used: spade\n", None),
+}
+
+
+@pytest.mark.parametrize(("log_text", "expected"), peak_memory.values(), ids=peak_memory.keys())
+def test_peak_memory(log_text: str, expected: int | None) -> None:
+    """Test :meth:`spade._benchmark.peak_memory`."""
+    assert _benchmark.peak_memory(log_text) == expected
+
+
+field_output_bytes = {
+    "reported": ("Field output data written: 1048576 bytes\nPeak memory use: 42 MB\n", 1048576),
+    "missing": ("Command line used: spade\n", None),
+}
+
+
+@pytest.mark.parametrize(("log_text", "expected"), field_output_bytes.values(), ids=field_output_bytes.keys())
+def test_field_output_bytes(log_text: str, expected: int | None) -> None:
+    """Test :meth:`spade._benchmark.field_output_bytes`."""
+    assert _benchmark.field_output_bytes(log_text) == expected
+
+
+def test_throughput() -> None:
+    """Test :meth:`spade._benchmark.throughput`."""
+    rates = _benchmark.throughput(4 * 1048576, 1000, 2.0)
+    assert rates == {"megabytes_per_second": 2.0, "elements_per_second": 500.0}
+    rates = _benchmark.throughput(1048576, 10, 0.0)
+    assert rates["megabytes_per_second"] > 0.0
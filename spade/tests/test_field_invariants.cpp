@@ -0,0 +1,174 @@
+//! Check the invariants computed from bulk data against a scalar reference
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <field_invariants.h>
+
+using namespace std;
+
+namespace {
+
+const vector<string> tensor_invariant_names = {"mises", "tresca", "press", "inv3", "maxPrincipal", "midPrincipal", "minPrincipal", "maxInPlanePrincipal", "minInPlanePrincipal", "outOfPlanePrincipal"};
+
+//! Eigenvalues of a symmetric 3x3 matrix from Jacobi rotations, sorted from largest to smallest
+array<double, 3> reference_eigenvalues (array<array<double, 3>, 3> a) {
+    for (int sweep=0; sweep<50; sweep++) {
+        double off_diagonal = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+        if (off_diagonal < 1.0e-30) { break; }
+        for (int p=0; p<2; p++) {
+            for (int q=p+1; q<3; q++) {
+                if (a[p][q] == 0.0) { continue; }
+                double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                double t = ((theta >= 0.0) ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+                double c = 1.0 / sqrt(t * t + 1.0);
+                double s = t * c;
+                for (int k=0; k<3; k++) {  // Rotate the columns, then the rows
+                    double akp = a[k][p], akq = a[k][q];
+                    a[k][p] = c * akp - s * akq;
+                    a[k][q] = s * akp + c * akq;
+                }
+                for (int k=0; k<3; k++) {
+                    double apk = a[p][k], aqk = a[q][k];
+                    a[p][k] = c * apk - s * aqk;
+                    a[q][k] = s * apk + c * aqk;
+                }
+            }
+        }
+    }
+    array<double, 3> eigenvalues = {a[0][0], a[1][1], a[2][2]};
+    sort(eigenvalues.begin(), eigenvalues.end(), greater<double>());
+    return eigenvalues;
+}
+
+//! Invariants of one tensor, computed one at a time from their textbook definitions
+map<string, double> reference_tensor_invariants (const array<double, 6> &c) {
+    array<array<double, 3>, 3> a = {{{c[0], c[3], c[4]}, {c[3], c[1], c[5]}, {c[4], c[5], c[2]}}};
+    double mean = (c[0] + c[1] + c[2]) / 3.0;
+    array<array<double, 3>, 3> deviator = a;
+    for (int i=0; i<3; i++) { deviator[i][i] -= mean; }
+    double deviator_cubed = 0.0;  // Trace of the deviator cubed
+    for (int i=0; i<3; i++) {
+        for (int j=0; j<3; j++) {
+            for (int k=0; k<3; k++) { deviator_cubed += deviator[i][j] * deviator[j][k] * deviator[k][i]; }
+        }
+    }
+    array<double, 3> principal = reference_eigenvalues(a);
+    double in_plane_radius = sqrt(pow(0.5 * (c[0] - c[1]), 2) + c[3] * c[3]);
+    return {
+        {"mises", sqrt(0.5 * (pow(c[0] - c[1], 2) + pow(c[1] - c[2], 2) + pow(c[2] - c[0], 2)) + 3.0 * (c[3] * c[3] + c[4] * c[4] + c[5] * c[5]))},
+        {"tresca", principal[0] - principal[2]},
+        {"press", -mean},
+        {"inv3", cbrt(4.5 * deviator_cubed)},
+        {"maxPrincipal", principal[0]},
+        {"midPrincipal", principal[1]},
+        {"minPrincipal", principal[2]},
+        {"maxInPlanePrincipal", 0.5 * (c[0] + c[1]) + in_plane_radius},
+        {"minInPlanePrincipal", 0.5 * (c[0] + c[1]) - in_plane_radius},
+        {"outOfPlanePrincipal", c[2]},
+    };
+}
+
+//! Compare every computed value with its reference, allowing for the single precision of the results
+int check (const string &case_name, const string &invariant_name, const vector<float> &computed, const vector<double> &expected, const double &scale) {
+    if (computed.size() != expected.size()) {
+        cerr << case_name << ": " << invariant_name << " has " << computed.size() << " values instead of " << expected.size() << endl;
+        return 1;
+    }
+    for (size_t i=0; i<expected.size(); i++) {
+        if (fabs(computed[i] - expected[i]) > 1.0e-5 * scale) {
+            cerr << case_name << ": " << invariant_name << " of row " << i << " is " << computed[i] << " instead of " << expected[i] << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+//! Compute the requested invariants of random tensors stored in the order of the labels and check them against the reference
+template <typename T>
+int check_tensors (const string &case_name, const vector<string> &labels, const bool &engineering_shear, const vector<string> &requested, mt19937 &generator) {
+    const size_t length = 1000;
+    const double scale = 100.0;
+    uniform_real_distribution<double> distribution(-scale, scale);
+    const string tensor_components[6] = {"11", "22", "33", "12", "13", "23"};
+    vector<T> data(length * labels.size());
+    vector<array<double, 6>> tensors(length);
+    for (size_t i=0; i<length; i++) {
+        tensors[i].fill(0.0);  // Components missing from the labels are zero
+        for (size_t j=0; j<labels.size(); j++) {
+            T value = static_cast<T>(distribution(generator));
+            data[i * labels.size() + j] = value;
+            int component = distance(tensor_components, find(tensor_components, tensor_components + 6, labels[j].substr(labels[j].size() - 2)));
+            tensors[i][component] = ((engineering_shear) && (component > 2)) ? 0.5 * value : value;
+        }
+    }
+    invariant_layout_type layout;
+    if (!invariant_layout(labels, true, engineering_shear, layout)) {
+        cerr << case_name << ": the component labels weren't matched" << endl;
+        return 1;
+    }
+    map<string, vector<float>> invariants;
+    for (const string &name : requested) { invariants[name]; }
+    compute_invariants(data.data(), length, layout, invariants);
+    if (invariants.size() != requested.size()) {
+        cerr << case_name << ": invariants were computed that weren't requested" << endl;
+        return 1;
+    }
+    int failures = 0;
+    for (const string &name : requested) {
+        vector<double> expected;
+        for (const array<double, 6> &tensor : tensors) { expected.push_back(reference_tensor_invariants(tensor)[name]); }
+        failures += check(case_name, name, invariants[name], expected, scale);
+    }
+    return failures;
+}
+
+int check_vectors (mt19937 &generator) {
+    const size_t length = 1000;
+    uniform_real_distribution<double> distribution(-100.0, 100.0);
+    vector<float> data(length * 3);
+    vector<double> expected(length);
+    for (size_t i=0; i<length; i++) {
+        double sum = 0.0;
+        for (int j=0; j<3; j++) {
+            data[i * 3 + j] = static_cast<float>(distribution(generator));
+            sum += static_cast<double>(data[i * 3 + j]) * data[i * 3 + j];
+        }
+        expected[i] = sqrt(sum);
+    }
+    invariant_layout_type layout;
+    if (!invariant_layout({"U1", "U2", "U3"}, false, false, layout)) {
+        cerr << "vector: the component labels weren't matched" << endl;
+        return 1;
+    }
+    map<string, vector<float>> invariants = {{"magnitude", {}}};
+    compute_invariants(data.data(), length, layout, invariants);
+    return check("vector", "magnitude", invariants["magnitude"], expected, 100.0);
+}
+
+}  // namespace
+
+int main () {
+    mt19937 generator(2024);
+    int failures = 0;
+    failures += check_vectors(generator);
+    failures += check_tensors<float>("full tensor", {"S11", "S22", "S33", "S12", "S13", "S23"}, false, tensor_invariant_names, generator);
+    failures += check_tensors<double>("double precision tensor", {"S11", "S22", "S33", "S12", "S13", "S23"}, false, tensor_invariant_names, generator);
+    failures += check_tensors<float>("reordered tensor", {"S12", "S33", "S11", "S23", "S22", "S13"}, false, tensor_invariant_names, generator);
+    failures += check_tensors<float>("plane stress", {"S11", "S22", "S12"}, false, tensor_invariant_names, generator);
+    failures += check_tensors<float>("engineering shear strain", {"E11", "E22", "E33", "E12", "E13", "E23"}, true, tensor_invariant_names, generator);
+    failures += check_tensors<float>("principal values without the others", {"S11", "S22", "S33", "S12", "S13", "S23"}, false, {"tresca", "midPrincipal"}, generator);
+    if (failures > 0) {
+        cerr << failures << " invariant checks failed" << endl;
+        return EXIT_FAILURE;
+    }
+    cout << "All invariant checks passed" << endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,168 @@
+//! Check that the upgrade cache reuses, replaces, and evicts the upgraded copies of odb files
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <getopt.h>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cmd_line_arguments.h>
+#include <logging.h>
+#include <odb_upgrade_cache.h>
+
+using namespace std;
+
+namespace {
+
+std::filesystem::path test_directory;
+int upgrades = 0;
+
+//! Stand in for the Abaqus upgrade, which writes a copy of the odb file
+void copy_upgrade (const string &odb_file_name, const string &upgraded_file_name) {
+    upgrades++;
+    std::filesystem::copy_file(odb_file_name, upgraded_file_name, std::filesystem::copy_options::overwrite_existing);
+}
+
+void write_file (const std::filesystem::path &file_path, const size_t &bytes, const char &fill) {
+    ofstream file(file_path, ios::binary);
+    file << string(bytes, fill);
+}
+
+string read_file (const std::filesystem::path &file_path) {
+    ifstream file(file_path, ios::binary);
+    return string(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+}
+
+//! Count the files of the test directory whose names contain the text
+int count_files (const string &text) {
+    int count = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(test_directory)) {
+        if (entry.path().filename().string().find(text) != string::npos) { count++; }
+    }
+    return count;
+}
+
+int fail (const string &case_name, const string &message) {
+    cerr << case_name << ": " << message << endl;
+    return 1;
+}
+
+//! Run one case with the cache built from the given command line arguments
+int run_case (const string &case_name, const vector<string> &arguments, const function<int(OdbUpgradeCache&)> &test) {
+    vector<string> argument_strings = {"test_odb_upgrade_cache", "--synthetic", "instances=1", "--force-overwrite",
+                                       "--extracted-file", (test_directory / "unused.h5").generic_string(),
+                                       "--log-file", (test_directory / "unused.log").generic_string()};
+    argument_strings.insert(argument_strings.end(), arguments.begin(), arguments.end());
+    vector<char*> argv;
+    for (string &argument : argument_strings) { argv.push_back(argument.data()); }
+    int argc = static_cast<int>(argv.size());
+    optind = 1;  // Each case parses a new command line
+    CmdLineArguments command_line_arguments(argc, argv.data());
+    Logging log_file((test_directory / (case_name + ".log")).generic_string(), false, false);
+    OdbUpgradeCache upgrade_cache(command_line_arguments, log_file);
+    upgrades = 0;
+    try {
+        return test(upgrade_cache);
+    } catch (const std::exception &e) {
+        return fail(case_name, e.what());
+    }
+}
+
+}  // namespace
+
+int main () {
+    test_directory = std::filesystem::temp_directory_path() / "spade_test_odb_upgrade_cache";
+    std::filesystem::remove_all(test_directory);
+    std::filesystem::create_directories(test_directory);
+    const std::filesystem::path first_odb = test_directory / "first.odb";
+    const std::filesystem::path second_odb = test_directory / "second.odb";
+    const size_t odb_bytes = 600 * 1024;  // Two copies don't fit in a one megabyte cache
+    write_file(first_odb, odb_bytes, 'a');
+    write_file(second_odb, odb_bytes, 'b');
+    int failures = 0;
+
+    failures += run_case("reuse", {}, [&] (OdbUpgradeCache &upgrade_cache) {
+        string upgraded = upgrade_cache.upgraded_file(first_odb.generic_string(), copy_upgrade);
+        if ((upgrades != 1) || (read_file(upgraded) != read_file(first_odb))) { return fail("reuse", "the first extraction didn't upgrade the odb file"); }
+        if (upgrade_cache.upgraded_file(first_odb.generic_string(), copy_upgrade) != upgraded) { return fail("reuse", "the second extraction used another copy"); }
+        if (upgrades != 1) { return fail("reuse", "the second extraction upgraded the odb file again"); }
+        return 0;
+    });
+
+    failures += run_case("changed content", {}, [&] (OdbUpgradeCache &upgrade_cache) {
+        string upgraded = upgrade_cache.upgraded_file(first_odb.generic_string(), copy_upgrade);
+        write_file(first_odb, odb_bytes, 'c');
+        string changed = upgrade_cache.upgraded_file(first_odb.generic_string(), copy_upgrade);
+        if ((upgrades != 1) || (changed == upgraded) || (read_file(changed) != read_file(first_odb))) {
+            return fail("changed content", "the changed odb file wasn't upgraded again");
+        }
+        return 0;
+    });
+
+    failures += run_case("concurrent upgrade", {}, [&] (OdbUpgradeCache &upgrade_cache) {
+        write_file(second_odb, odb_bytes, 'd');
+        // Another process puts the same copy in the cache while this one is still upgrading
+        string upgraded = upgrade_cache.upgraded_file(second_odb.generic_string(), [&] (const string &odb_file_name, const string &upgraded_file_name) {
+            string cached_file_name = upgraded_file_name.substr(0, upgraded_file_name.rfind(".upgrading")) + ".upgraded.odb";
+            copy_upgrade(odb_file_name, cached_file_name);
+            copy_upgrade(odb_file_name, upgraded_file_name);
+        });
+        if (read_file(upgraded) != read_file(second_odb)) { return fail("concurrent upgrade", "the copy in the cache doesn't match the odb file"); }
+        if (count_files(".upgrading") != 0) { return fail("concurrent upgrade", "a temporary upgrade was left in the cache"); }
+        return 0;
+    });
+
+    failures += run_case("failed upgrade", {}, [&] (OdbUpgradeCache &upgrade_cache) {
+        write_file(second_odb, odb_bytes, 'e');
+        try {
+            upgrade_cache.upgraded_file(second_odb.generic_string(), [] (const string &odb_file_name, const string &upgraded_file_name) {
+                write_file(upgraded_file_name, 10, 'x');
+                throw std::runtime_error("upgrade interrupted");
+            });
+        } catch (const std::runtime_error &e) {
+            if (count_files(".upgrading") != 0) { return fail("failed upgrade", "the interrupted upgrade was left in the cache"); }
+            return 0;
+        }
+        return fail("failed upgrade", "the upgrade error wasn't passed on");
+    });
+
+    std::filesystem::path cache_directory = test_directory / "cache";
+    failures += run_case("eviction", {"--upgrade-cache", cache_directory.generic_string(), "--upgrade-cache-size", "1"}, [&] (OdbUpgradeCache &upgrade_cache) {
+        std::filesystem::path first_upgraded = upgrade_cache.upgraded_file(first_odb.generic_string(), copy_upgrade);
+        std::filesystem::path second_upgraded = upgrade_cache.upgraded_file(second_odb.generic_string(), copy_upgrade);
+        if (first_upgraded.parent_path() != cache_directory) { return fail("eviction", "the copy wasn't put in the cache directory"); }
+        if (std::filesystem::exists(first_upgraded)) { return fail("eviction", "the least recently used copy wasn't removed"); }
+        if (!std::filesystem::exists(second_upgraded)) { return fail("eviction", "the copy in use was removed"); }
+        return 0;
+    });
+
+    failures += run_case("default size limit", {"--upgrade-cache", cache_directory.generic_string()}, [&] (OdbUpgradeCache &upgrade_cache) {
+        std::filesystem::path first_upgraded = upgrade_cache.upgraded_file(first_odb.generic_string(), copy_upgrade);
+        std::filesystem::path second_upgraded = upgrade_cache.upgraded_file(second_odb.generic_string(), copy_upgrade);
+        if ((!std::filesystem::exists(first_upgraded)) || (!std::filesystem::exists(second_upgraded))) {
+            return fail("default size limit", "copies were removed from a cache below the default size limit");
+        }
+        return 0;
+    });
+
+    failures += run_case("no cache", {"--upgrade-cache", "none"}, [&] (OdbUpgradeCache &upgrade_cache) {
+        string upgraded = upgrade_cache.upgraded_file(first_odb.generic_string(), copy_upgrade);
+        upgrade_cache.upgraded_file(first_odb.generic_string(), copy_upgrade);
+        if ((upgrades != 2) || (std::filesystem::path(upgraded).filename() != "first.upgraded.odb")) {
+            return fail("no cache", "the odb file wasn't upgraded next to it every time");
+        }
+        return 0;
+    });
+
+    std::filesystem::remove_all(test_directory);
+    if (failures > 0) {
+        cerr << failures << " upgrade cache checks failed" << endl;
+        return EXIT_FAILURE;
+    }
+    cout << "All upgrade cache checks passed" << endl;
+    return EXIT_SUCCESS;
+}
@@ -5,6 +5,7 @@ import os
 import pathlib
 import platform
 import re
+import shutil
 import string
 import subprocess
 import tempfile
@@ -60,6 +61,30 @@ def test_check_installed() -> None:
         assert not check_installed()
 
 
+def check_mpi() -> bool:
+    """Return True if the MPI build of the c++ executable can be compiled and run.
+
+    The MPI build needs the MPI compiler wrapper, ``mpirun``, and parallel HDF5 in the conda environment.
+    """
+    if shutil.which("mpicxx") is None or shutil.which("mpirun") is None:
+        return False
+    hdf5_configuration = pathlib.Path(os.environ.get("CONDA_PREFIX", "")) / "include/H5pubconf.h"
+    return hdf5_configuration.exists() and "#define H5_HAVE_PARALLEL 1" in hdf5_configuration.read_text()
+
+
+def test_check_mpi(tmp_path: pathlib.Path) -> None:
+    hdf5_configuration = tmp_path / "include/H5pubconf.h"
+    hdf5_configuration.parent.mkdir()
+    with patch("shutil.which", return_value=None):
+        assert not check_mpi()
+    with patch("shutil.which", return_value="mpirun"), patch.dict(os.environ, {"CONDA_PREFIX": str(tmp_path)}):
+        assert not check_mpi()
+        hdf5_configuration.write_text("/* #undef H5_HAVE_PARALLEL */\n")
+        assert not check_mpi()
+        hdf5_configuration.write_text("#define H5_HAVE_PARALLEL 1\n")
+        assert check_mpi()
+
+
 def create_valid_identifier(identifier: str) -> None:
     """Create a valid Python identifier from an arbitray string by replacing invalid characters with underscores.
 
@@ -171,6 +196,7 @@ system = platform.system().lower()
 testing_windows = system == "windows"
 testing_macos = system == "darwin"
 testing_ci_user = check_ci_user()
+testing_mpi = check_mpi()
 installed = check_installed()
 if not installed:
     spade_command = "python -m spade._main"
@@ -191,6 +217,15 @@ system_tests = [
         [string.Template("${spade_command} docs --print-local-path")],
         marks=[pytest.mark.skipif(not installed, reason="The HTML docs path only exists in the as-installed packages")],
     ),
+    # Options that can't be combined are rejected before Abaqus is searched for
+    pytest.param(
+        [
+            string.Template(
+                '${spade_command} extract missing.odb --append --jobs 2 2>&1 | grep "not available with --jobs"'
+            )
+        ],
+        marks=[pytest.mark.skipif(testing_windows, reason="The checks of the output use POSIX shell commands")],
+    ),
 ]
 
 
@@ -252,6 +287,222 @@ for inp_file in inp_files:
             id=inp_file,
         )
     )
+# Optional extract behaviors exercised against a single ODB file
+extract_option_cases = {
+    "compression": "--compression gzip --chunk-shape auto",
+    "serial-writer": "--write-buffer-mb 0",
+    "stacked-layout": "--layout stacked --compression gzip",
+    "computed-invariants": "--invariants computed",
+    "jobs": "--jobs 2",
+    "vtk-format": "--format vtk",
+    "max-memory": "--max-memory 64",
+    "profile": "--profile viewer_tutorial.profile.json --jobs 2",
+    "metadata-attributes": "--metadata-layout attributes",
+    "metadata-compact": "--metadata-layout compact",
+    "metadata-datasets": "--metadata-layout datasets",
+    "split-by-step": "--split-by step",
+    "split-by-instance": "--split-by instance",
+    "split-by-field": "--split-by field",
+    "split-by-frame-range": "--split-by frame-range:2",
+    "split-by-step-jobs": "--split-by step --jobs 2",
+    "h5-profile-lustre": "--h5-profile lustre",
+    "h5-profile-nvme": "--h5-profile nvme",
+    "h5-profile-nfs": "--h5-profile nfs --jobs 2",
+}
+for option_id, extract_options in extract_option_cases.items():
+    system_tests_require_third_party.append(
+        pytest.param(
+            [
+                string.Template("${abaqus_command} fetch -job viewer_tutorial.odb"),
+                string.Template(
+                    f"${{spade_command}} extract viewer_tutorial.odb {extract_options}"
+                    f" --abaqus-commands ${{abaqus_command}} ${{spade_options}}"
+                ),
+            ],
+            marks=[
+                pytest.mark.skipif(testing_macos, reason="Abaqus does not install on macOS"),
+            ],
+            id=f"viewer_tutorial.odb-{option_id}",
+        )
+    )
+# A custom hdf5 profile file sets the file creation and access properties it names and keeps the defaults of the others
+system_tests_require_third_party.append(
+    pytest.param(
+        [
+            string.Template("${abaqus_command} fetch -job viewer_tutorial.odb"),
+            "echo file-space-strategy = page > custom.h5profile",
+            "echo file-space-page-size = 65536 >> custom.h5profile",
+            "echo alignment = 4096 >> custom.h5profile",
+            "echo fill-time = never >> custom.h5profile",
+            string.Template(
+                "${spade_command} extract viewer_tutorial.odb --h5-profile custom:custom.h5profile"
+                " --abaqus-commands ${abaqus_command} ${spade_options}"
+            ),
+        ],
+        marks=[
+            pytest.mark.skipif(testing_macos, reason="Abaqus does not install on macOS"),
+        ],
+        id="viewer_tutorial.odb-h5-profile-custom",
+    )
+)
+# The second run appends to the file written by the first, which reads its manifest and finds no new frames
+system_tests_require_third_party.append(
+    pytest.param(
+        [
+            string.Template("${abaqus_command} fetch -job viewer_tutorial.odb"),
+            string.Template(
+                "${spade_command} extract viewer_tutorial.odb --append"
+                " --abaqus-commands ${abaqus_command} ${spade_options}"
+            ),
+            string.Template(
+                "${spade_command} extract viewer_tutorial.odb --append"
+                " --abaqus-commands ${abaqus_command} ${spade_options}"
+            ),
+        ],
+        marks=[
+            pytest.mark.skipif(testing_macos, reason="Abaqus does not install on macOS"),
+        ],
+        id="viewer_tutorial.odb-append",
+    )
+)
+
+# The shards of --jobs are merged with their dimension scales attached again in the extracted file, and nothing is left
+# in the staging group of the merge
+system_tests_require_third_party.extend(
+    pytest.param(
+        [
+            string.Template("${abaqus_command} fetch -job viewer_tutorial.odb"),
+            string.Template(
+                f"${{spade_command}} extract viewer_tutorial.odb --format {extract_format} --jobs 2"
+                " --abaqus-commands ${abaqus_command} ${spade_options}"
+            ),
+            string.Template("h5dump --header --onlyattr viewer_tutorial.h5 > viewer_tutorial.h5.txt"),
+            string.Template("grep DIMENSION_LIST viewer_tutorial.h5.txt"),
+            string.Template("! grep _spade_merge viewer_tutorial.h5.txt"),
+        ],
+        marks=[
+            pytest.mark.skipif(testing_macos, reason="Abaqus does not install on macOS"),
+            pytest.mark.skipif(testing_windows, reason="The checks of the output use POSIX shell commands"),
+        ],
+        id=f"viewer_tutorial.odb-{extract_format}-merge",
+    )
+    for extract_format in ["odb", "extract"]
+)
+# A rerun keeps the partition files written from the same odb file with the same options and replaces the others
+system_tests_require_third_party.append(
+    pytest.param(
+        [
+            string.Template("${abaqus_command} fetch -job viewer_tutorial.odb"),
+            string.Template(
+                "${spade_command} extract viewer_tutorial.odb --split-by step"
+                " --abaqus-commands ${abaqus_command} ${spade_options}"
+            ),
+            string.Template(
+                "${spade_command} extract viewer_tutorial.odb --split-by step"
+                " --abaqus-commands ${abaqus_command} ${spade_options}"
+            ),
+            string.Template('grep "Keeping partition" viewer_tutorial.spade.log'),
+            string.Template(
+                "${spade_command} extract viewer_tutorial.odb --split-by step --invariants computed"
+                " --abaqus-commands ${abaqus_command} ${spade_options}"
+            ),
+            string.Template('grep "Replacing partition" viewer_tutorial.spade.log'),
+        ],
+        marks=[
+            pytest.mark.skipif(testing_macos, reason="Abaqus does not install on macOS"),
+            pytest.mark.skipif(testing_windows, reason="The checks of the output use POSIX shell commands"),
+        ],
+        id="viewer_tutorial.odb-split-by-rerun",
+    )
+)
+
+# The invariant kernels are checked against a scalar reference when built with the optimization flags of the extract
+system_tests_require_third_party.append(
+    pytest.param(
+        [
+            string.Template(
+                f"scons -C {_settings._project_root_abspath} --build-dir=${{temporary_directory}}/build"
+                " ${temporary_directory}/build/test_field_invariants.log"
+            ),
+        ],
+        id="field-invariants-reference",
+    )
+)
+
+# The upgrade cache is checked with a copy standing in for the Abaqus upgrade, so the legacy odb files aren't needed
+system_tests_require_third_party.append(
+    pytest.param(
+        [
+            string.Template(
+                f"scons -C {_settings._project_root_abspath} --build-dir=${{temporary_directory}}/build"
+                " ${temporary_directory}/build/test_odb_upgrade_cache.log"
+            ),
+        ],
+        id="odb-upgrade-cache",
+    )
+)
+
+# The peak memory use logged by the benchmark executable stays within the --max-memory ceiling of a synthetic model
+# whose field output doesn't fit in it
+system_tests_require_third_party.append(
+    pytest.param(
+        [
+            string.Template(
+                f"scons -C {_settings._project_root_abspath} --build-dir=${{temporary_directory}}/build"
+                " ${temporary_directory}/build/max_memory.json"
+            ),
+        ],
+        id="synthetic-max-memory",
+    )
+)
+
+# Field outputs with several element type blocks per instance write or link their frame metadata once per frame, without
+# warnings about the metadata the other blocks already wrote
+system_tests_require_third_party.append(
+    pytest.param(
+        [
+            string.Template(
+                f"scons -C {_settings._project_root_abspath} --build-dir=${{temporary_directory}}/build"
+                " ${temporary_directory}/build/spade_benchmark"
+            ),
+            string.Template(
+                "${temporary_directory}/build/spade_benchmark"
+                " --synthetic instances=2,elements=C3D8R:100+S4R:50,steps=2,frames=3,fields=2"
+                " --extracted-file synthetic.h5 --log-file synthetic.spade.log --force-overwrite"
+            ),
+            "! grep WARNING synthetic.spade.log",
+        ],
+        marks=[
+            pytest.mark.skipif(testing_windows, reason="The checks of the output use POSIX shell commands"),
+        ],
+        id="synthetic-multi-block-no-warnings",
+    )
+)
+
+# The MPI build of the benchmark executable doesn't need Abaqus. Each rank extracts its share of the frames of a
+# synthetic model and the ranks merge their shard files in parallel, logging the throughput from reading the model to
+# the merged file
+system_tests_require_third_party.extend(
+    pytest.param(
+        [
+            string.Template(
+                f"scons -C {_settings._project_root_abspath} --mpi --build-dir=${{temporary_directory}}/build"
+                " ${temporary_directory}/build/spade_benchmark"
+            ),
+            string.Template(
+                f"mpirun -np {rank_count} ${{temporary_directory}}/build/spade_benchmark"
+                " --synthetic instances=2,steps=2,frames=8,fields=2 --extracted-file synthetic.h5"
+                " --log-file synthetic.spade.log --force-overwrite"
+            ),
+            string.Template(f'grep "End to end throughput of {rank_count} ranks" synthetic.spade.log'),
+        ],
+        marks=[
+            pytest.mark.skipif(not testing_mpi, reason="MPI and parallel HDF5 are not available"),
+        ],
+        id=f"synthetic-mpirun-np{rank_count}",
+    )
+    for rank_count in [2, 4]
+)
 
 
 # TODO: Remove user check when Windows CI Gitlab-Runner account can access the Abaqus license server
@@ -1,3 +1,4 @@
+import argparse
 import contextlib
 import pathlib
 import typing
@@ -91,6 +92,24 @@ def test_find_command(
             pass
 
 
+positive_integer = {
+    "one": ("1", 1, does_not_raise),
+    "many": ("8", 8, does_not_raise),
+    "zero": ("0", None, pytest.raises(argparse.ArgumentTypeError)),
+    "negative": ("-2", None, pytest.raises(argparse.ArgumentTypeError)),
+    "not an integer": ("two", None, pytest.raises(argparse.ArgumentTypeError)),
+}
+
+
+@pytest.mark.parametrize(("argument", "expected", "outcome"), positive_integer.values(), ids=positive_integer.keys())
+def test_positive_integer(
+    argument: str, expected: int | None, outcome: contextlib.nullcontext | pytest.RaisesExc
+) -> None:
+    """Test :meth:`spade._utilities.positive_integer`."""
+    with outcome:
+        assert _utilities.positive_integer(argument) == expected
+
+
 character_delimited_list = {
     "int": ([1, 2, 3], " ", "1 2 3"),
     "int: comma": ([1, 2, 3], ",", "1,2,3"),